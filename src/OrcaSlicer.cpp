@@ -152,6 +152,7 @@ typedef struct  _sliced_plate_info{
     size_t sliced_time_with_cache {0};
     size_t triangle_count{0};
     std::string warning_message;
+    std::string gcode_md5;
 }sliced_plate_info_t;
 
 typedef struct _sliced_info {
@@ -428,6 +429,8 @@ void record_exit_reson(std::string outputdir, int code, int plate_id, std::strin
             plate_json["sliced_time_with_cache"] = sliced_info.sliced_plates[index].sliced_time_with_cache;
             plate_json["triangle_count"] = sliced_info.sliced_plates[index].triangle_count;
             plate_json["warning_message"] = sliced_info.sliced_plates[index].warning_message;
+            if (!sliced_info.sliced_plates[index].gcode_md5.empty())
+                plate_json["gcode_md5"] = sliced_info.sliced_plates[index].gcode_md5;
             j["sliced_plates"].push_back(plate_json);
         }
         for (auto& iter: key_values)
@@ -1234,6 +1237,12 @@ int CLI::run(int argc, char **argv)
     if (min_save_option)
         minimum_save = min_save_option->value;
 
+    ConfigOptionBool* deterministic_option = m_config.option<ConfigOptionBool>("deterministic");
+    if (deterministic_option && deterministic_option->value) {
+        set_deterministic_execution(true);
+        BOOST_LOG_TRIVIAL(info) << "deterministic execution enabled";
+    }
+
     ConfigOptionBool* enable_timelapse_option = m_config.option<ConfigOptionBool>("enable_timelapse");
     if (enable_timelapse_option)
         enable_timelapse = enable_timelapse_option->value;
@@ -4660,6 +4669,8 @@ int CLI::run(int argc, char **argv)
             //already processed before
         } else if (opt_key == "min_save") {
             //already processed before
+        } else if (opt_key == "deterministic") {
+            //already processed before
         } else if (opt_key == "load_defaultfila") {
             //already processed before
         } else if (opt_key == "mtcpp") {
@@ -5058,6 +5069,11 @@ int CLI::run(int argc, char **argv)
                                     outfile = print_fff->export_gcode(outfile, gcode_result, nullptr);
                                     time_using_cache = time_using_cache + ((long long)Slic3r::Utils::get_current_time_utc() - temp_time);
                                     BOOST_LOG_TRIVIAL(info) << "export_gcode finished: time_using_cache update to " << time_using_cache << " secs.";
+                                    // The hash of the output allows a content addressed reuse of the G-code, which is only stable in deterministic mode.
+                                    if (bbl_calc_md5(outfile, sliced_plate_info.gcode_md5)) {
+                                        BOOST_LOG_TRIVIAL(info) << "plate " << index + 1 << ": gcode md5 " << sliced_plate_info.gcode_md5 << ", deterministic " << deterministic_execution();
+                                        boost::nowide::cout << "plate " << index + 1 << " gcode md5: " << sliced_plate_info.gcode_md5 << std::endl;
+                                    }
 
                                     //outfile_final = (dynamic_cast<Print*>(print))->print_statistics().finalize_output_path(outfile);
                                     //m_fff_print->export_gcode(m_temp_output_path, m_gcode_result, [this](const ThumbnailsParams& params) { return this->render_thumbnails(params); });
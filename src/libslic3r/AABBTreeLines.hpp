@@ -7,7 +7,10 @@
 #include "libslic3r/AABBTreeIndirect.hpp"
 #include "libslic3r/Line.hpp"
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <iterator>
+#include <limits>
 #include <type_traits>
 #include <vector>
 
@@ -155,6 +158,110 @@ namespace AABBTreeLines {
             }
         }
 
+        // Returns the number of lines in tree properly crossed by the segment (p, q). Returns a negative number if the segment
+        // touches a line, passes through an end point of a line or is collinear with it, as the crossings are not well defined then.
+        template <typename LineType, typename TreeType, typename VectorType>
+        inline int segment_crossing_count(size_t node_idx,
+            const TreeType& tree,
+            const std::vector<LineType>& lines,
+            const VectorType& p,
+            const VectorType& q,
+            const typename TreeType::BoundingBox& segment_bb)
+        {
+            using Floating = typename VectorType::Scalar;
+            const auto& node = tree.node(node_idx);
+            assert(node.is_valid());
+            if (node.is_leaf()) {
+                const LineType  &line = lines[node.idx];
+                const VectorType a    = line.a.template cast<Floating>();
+                const VectorType b    = line.b.template cast<Floating>();
+                // Sign of the orientation of w against the directed line (u, v), 0 if too close to decide.
+                auto orientation = [](const VectorType &u, const VectorType &v, const VectorType &w) {
+                    const VectorType uv  = v - u;
+                    const VectorType uw  = w - u;
+                    const Floating   o   = uv.x() * uw.y() - uv.y() * uw.x();
+                    const Floating   tol = Floating(64) * std::numeric_limits<Floating>::epsilon() * uv.norm() * uw.norm();
+                    return o > tol ? 1 : o < - tol ? -1 : 0;
+                };
+                const int op = orientation(a, b, p);
+                const int oq = orientation(a, b, q);
+                if (op == oq && op != 0)
+                    return 0;
+                const int oa = orientation(p, q, a);
+                const int ob = orientation(p, q, b);
+                if (oa == ob && oa != 0)
+                    return 0;
+                return op == 0 || oq == 0 || oa == 0 || ob == 0 ? -1 : 1;
+            } else {
+                int count = 0;
+                for (size_t child_idx : { node_idx * 2 + 1, node_idx * 2 + 2 }) {
+                    const auto& child = tree.node(child_idx);
+                    assert(child.is_valid());
+                    if (child.bbox.intersects(segment_bb)) {
+                        int child_count = segment_crossing_count<LineType, TreeType, VectorType>(child_idx, tree, lines, p, q, segment_bb);
+                        if (child_count < 0)
+                            return -1;
+                        count += child_count;
+                    }
+                }
+                return count;
+            }
+        }
+
+        // Closest line query traversing the tree iteratively with a small fixed stack, the nearer child first.
+        // Nodes not closer than up_sqr_d are pruned, and the hit outputs are only written if a closer line is found.
+        // The batched queries seed up_sqr_d with the distance to the closest line of the previous query point.
+        template <typename LineType, typename TreeType, typename VectorType>
+        inline typename VectorType::Scalar squared_distance_to_indexed_lines_bounded(const std::vector<LineType>& lines,
+            const TreeType& tree,
+            const VectorType& point,
+            typename VectorType::Scalar up_sqr_d,
+            size_t& hit_idx_out,
+            Eigen::PlainObjectBase<VectorType>& hit_point_out)
+        {
+            using Scalar = typename VectorType::Scalar;
+            struct StackEntry {
+                size_t node_idx;
+                Scalar sqr_d;
+            };
+            // The tree is balanced, each level adds at most one entry to the stack.
+            std::array<StackEntry, 64> stack;
+            size_t                     stack_size = 0;
+            auto distancer = IndexedLinesDistancer<LineType, TreeType, VectorType> { lines, tree, point };
+            stack[stack_size ++] = { 0, Scalar(0) };
+            while (stack_size > 0) {
+                const StackEntry entry = stack[-- stack_size];
+                if (entry.sqr_d >= up_sqr_d)
+                    continue;
+                const auto& node = tree.node(entry.node_idx);
+                assert(node.is_valid());
+                if (node.is_leaf()) {
+                    Scalar     sqr_d;
+                    VectorType c = distancer.closest_point_to_origin(node.idx, sqr_d);
+                    if (sqr_d < up_sqr_d) {
+                        up_sqr_d      = sqr_d;
+                        hit_idx_out   = node.idx;
+                        hit_point_out = c;
+                    }
+                } else {
+                    size_t left_node_idx  = entry.node_idx * 2 + 1;
+                    size_t right_node_idx = left_node_idx + 1;
+                    Scalar left_sqr_d     = Scalar(tree.node(left_node_idx).bbox.squaredExteriorDistance(point));
+                    Scalar right_sqr_d    = Scalar(tree.node(right_node_idx).bbox.squaredExteriorDistance(point));
+                    assert(stack_size + 2 <= stack.size());
+                    // Push the farther child first, so that the nearer one is visited first.
+                    if (left_sqr_d < right_sqr_d) {
+                        stack[stack_size ++] = { right_node_idx, right_sqr_d };
+                        stack[stack_size ++] = { left_node_idx, left_sqr_d };
+                    } else {
+                        stack[stack_size ++] = { left_node_idx, left_sqr_d };
+                        stack[stack_size ++] = { right_node_idx, right_sqr_d };
+                    }
+                }
+            }
+            return up_sqr_d;
+        }
+
     } // namespace detail
 
     // Build a balanced AABB Tree over a vector of lines, balancing the tree
@@ -351,6 +458,94 @@ namespace AABBTreeLines {
             return dist;
         }
 
+        // Batched distance_from_lines_extra() over a stream of points, which are expected to be ordered along a path,
+        // for example the points of a perimeter. The closest line of the previous point is usually the closest line
+        // of the next point or it is near to it, thus its distance bounds the search of the next point, which then
+        // visits just a few nodes of the tree.
+        // With SIGNED_DISTANCE, the sign is derived from the sign of the previous point instead of casting rays across
+        // the whole tree by outside(). If the segment between the two points lies inside the disk around either of them
+        // with the radius of its distance, it crosses no line and the sign is kept. Otherwise the lines crossed by the segment
+        // are counted, which visits just the nodes overlapping the bounding box of the segment, and the sign flips with each
+        // crossing. outside() is only called for the first point and if the segment touches a line or passes through its end point.
+        // The distances are the same as returned by distance_from_lines_extra(), except that a derived sign replaces
+        // the zero returned by outside() if it cannot determine the sign. The closest lines may differ if several lines
+        // are at the same distance. The optional outputs are resized to the number of points.
+        template <bool SIGNED_DISTANCE, typename PointRange>
+        void distances_from_lines_extra(const PointRange              &points,
+                                        std::vector<Floating>         &distances,
+                                        std::vector<size_t>           *line_indices   = nullptr,
+                                        std::vector<Vec<2, Floating>> *nearest_points = nullptr) const
+        {
+            const size_t num_points = std::distance(std::begin(points), std::end(points));
+            distances.assign(num_points, std::numeric_limits<Floating>::infinity());
+            if (line_indices)
+                line_indices->assign(num_points, size_t(-1));
+            if (nearest_points)
+                nearest_points->assign(num_points, Vec<2, Floating>::Zero());
+            if (tree.empty())
+                return;
+
+            size_t           prev_line_idx = size_t(-1);
+            Vec<2, Scalar>   prev_point    = Vec<2, Scalar>::Zero();
+            Vec<2, Floating> prev_p        = Vec<2, Floating>::Zero();
+            Floating         prev_distance = 0;
+            int              prev_sign     = 0;
+            size_t           i             = 0;
+            for (const auto &pt : points) {
+                const Vec<2, Scalar>   point         = pt;
+                const Vec<2, Floating> p             = point.template cast<Floating>();
+                size_t                 line_idx      = size_t(-1);
+                Vec<2, Floating>       nearest_point = Vec<2, Floating>::Zero();
+                Floating               up_sqr_d      = std::numeric_limits<Floating>::infinity();
+                if (prev_line_idx != size_t(-1)) {
+                    Vec<2, typename LineType::Scalar> np;
+                    up_sqr_d      = line_alg::distance_to_squared(lines[prev_line_idx], p.template cast<typename LineType::Scalar>(), &np);
+                    line_idx      = prev_line_idx;
+                    nearest_point = np.template cast<Floating>();
+                }
+                Floating distance = sqrt(detail::squared_distance_to_indexed_lines_bounded(lines, tree, p, up_sqr_d, line_idx, nearest_point));
+                if (SIGNED_DISTANCE) {
+                    int sign = 0;
+                    if (prev_sign != 0) {
+                        // Shrunk a little, so that the rounding of the distances does not let a segment touching a line pass.
+                        const Floating free_radius = Floating(0.999) * std::max(prev_distance, distance);
+                        if ((p - prev_p).squaredNorm() < free_radius * free_radius) {
+                            sign = prev_sign;
+                        } else {
+                            using TreeType = AABBTreeIndirect::Tree<2, Scalar>;
+                            typename TreeType::BoundingBox segment_bb(prev_point, prev_point);
+                            segment_bb.extend(point);
+                            if (int crossings = detail::segment_crossing_count<LineType, TreeType, Vec<2, Floating>>(0, tree, lines, prev_p, p, segment_bb);
+                                crossings >= 0)
+                                sign = crossings % 2 == 0 ? prev_sign : - prev_sign;
+                        }
+                    }
+                    if (sign == 0)
+                        sign = outside(point);
+                    prev_point    = point;
+                    prev_p        = p;
+                    prev_distance = distance;
+                    prev_sign     = sign;
+                    distance     *= sign;
+                }
+                distances[i] = distance;
+                if (line_indices)
+                    (*line_indices)[i] = line_idx;
+                if (nearest_points)
+                    (*nearest_points)[i] = nearest_point;
+                prev_line_idx = line_idx;
+                ++ i;
+            }
+        }
+
+        template <bool SIGNED_DISTANCE, typename PointRange>
+        std::vector<Floating> distances_from_lines(const PointRange &points) const
+        {
+            std::vector<Floating> distances;
+            distances_from_lines_extra<SIGNED_DISTANCE>(points, distances);
+            return distances;
+        }
+
     	std::vector<size_t> all_lines_in_radius(const Vec<2, Scalar> &point, Floating radius)
     	{
         	return AABBTreeLines::all_lines_in_radius(this->lines, this->tree, point.template cast<Floating>(), radius * radius);
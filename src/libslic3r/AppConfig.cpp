@@ -364,6 +364,10 @@ void AppConfig::set_defaults()
         set("backup_interval", "10");
     }
 
+    if (get("slice_result_store").empty()) {
+        set_bool("slice_result_store", false);
+    }
+
     if (get("curr_bed_type").empty()) {
         set("curr_bed_type", "1");
     }
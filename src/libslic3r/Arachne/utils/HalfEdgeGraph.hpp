@@ -5,8 +5,13 @@
 #define UTILS_HALF_EDGE_GRAPH_H
 
 
-#include <list>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 
 
@@ -15,14 +20,234 @@
 
 namespace Slic3r::Arachne
 {
+
+// Chunks of memory holding the nodes and edges of the half-edge graphs. The graph of an island lives only while
+// its walls are generated, so the chunks released by a graph are cached by the thread and reused by the graphs
+// of the following islands and layers processed by the same thread.
+class HalfEdgeArena
+{
+public:
+    static constexpr size_t chunk_size = 64 * 1024;
+
+    static void* allocate_chunk()
+    {
+        std::vector<void*> &chunks = cache().chunks;
+        if (chunks.empty())
+            return ::operator new(chunk_size);
+        void *chunk = chunks.back();
+        chunks.pop_back();
+        return chunk;
+    }
+
+    static void release_chunk(void *chunk)
+    {
+        std::vector<void*> &chunks = cache().chunks;
+        if (chunks.size() < max_cached_chunks)
+            chunks.emplace_back(chunk);
+        else
+            ::operator delete(chunk);
+    }
+
+    // Free the chunks cached by this thread, the following graphs are then built in newly allocated memory.
+    static void clear_cache()
+    {
+        std::vector<void*> &chunks = cache().chunks;
+        for (void *chunk : chunks)
+            ::operator delete(chunk);
+        chunks.clear();
+    }
+
+private:
+    // Up to 16MB cached per thread.
+    static constexpr size_t max_cached_chunks = 256;
+
+    struct Cache
+    {
+        std::vector<void*> chunks;
+        ~Cache() { for (void *chunk : chunks) ::operator delete(chunk); }
+    };
+
+    static Cache& cache()
+    {
+        thread_local Cache cache;
+        return cache;
+    }
+};
+
+// Doubly linked list of graph elements with the interface of the subset of std::list used by the graph.
+// The elements are stored contiguously in chunks of HalfEdgeArena instead of being allocated one by one,
+// their addresses are stable, and the slots of the erased elements are reused by the following insertions.
+// An element may be erased through its pointer, as the half-edges reference each other by pointers.
+template<class T>
+class HalfEdgeList
+{
+    struct Links
+    {
+        Links *prev;
+        Links *next;
+    };
+    struct Slot
+    {
+        Links links;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    static_assert(sizeof(Slot) <= HalfEdgeArena::chunk_size && alignof(Slot) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    static constexpr size_t slots_per_chunk = HalfEdgeArena::chunk_size / sizeof(Slot);
+
+    static T*    value(Links *links) { return std::launder(reinterpret_cast<T*>(reinterpret_cast<Slot*>(links)->storage)); }
+    static Slot* slot(const T *value) { return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(const_cast<T*>(value)) - offsetof(Slot, storage)); }
+
+public:
+    template<class Value>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = std::remove_const_t<Value>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = Value*;
+        using reference         = Value&;
+
+        Iterator() = default;
+        // Conversion of iterator to const_iterator.
+        template<class Other, typename = std::enable_if_t<std::is_same_v<const Other, Value>>>
+        Iterator(const Iterator<Other> &other) : m_links(other.m_links) {}
+
+        reference operator*() const { return *value(m_links); }
+        pointer   operator->() const { return value(m_links); }
+
+        Iterator& operator++() { m_links = m_links->next; return *this; }
+        Iterator  operator++(int) { Iterator out = *this; m_links = m_links->next; return out; }
+        Iterator& operator--() { m_links = m_links->prev; return *this; }
+        Iterator  operator--(int) { Iterator out = *this; m_links = m_links->prev; return out; }
+
+        bool operator==(const Iterator &rhs) const { return m_links == rhs.m_links; }
+        bool operator!=(const Iterator &rhs) const { return m_links != rhs.m_links; }
+
+    private:
+        explicit Iterator(Links *links) : m_links(links) {}
+
+        Links *m_links = nullptr;
+
+        friend class HalfEdgeList;
+        template<class> friend class Iterator;
+    };
+
+    using value_type     = T;
+    using iterator       = Iterator<T>;
+    using const_iterator = Iterator<const T>;
+
+    HalfEdgeList() { m_head.prev = m_head.next = &m_head; }
+    HalfEdgeList(const HalfEdgeList &) = delete;
+    HalfEdgeList& operator=(const HalfEdgeList &) = delete;
+    ~HalfEdgeList() { this->clear(); }
+
+    iterator       begin() { return iterator(m_head.next); }
+    iterator       end() { return iterator(&m_head); }
+    const_iterator begin() const { return const_iterator(m_head.next); }
+    const_iterator end() const { return const_iterator(const_cast<Links*>(&m_head)); }
+
+    bool   empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+
+    T&       front() { assert(! this->empty()); return *value(m_head.next); }
+    T&       back() { assert(! this->empty()); return *value(m_head.prev); }
+    const T& front() const { assert(! this->empty()); return *value(m_head.next); }
+    const T& back() const { assert(! this->empty()); return *value(m_head.prev); }
+
+    template<class... Args>
+    T& emplace_front(Args&&... args) { return *this->emplace(m_head.next, std::forward<Args>(args)...); }
+    template<class... Args>
+    T& emplace_back(Args&&... args) { return *this->emplace(&m_head, std::forward<Args>(args)...); }
+
+    // Returns the iterator following the erased element.
+    iterator erase(const_iterator it)
+    {
+        assert(it.m_links != &m_head);
+        Links *next = it.m_links->next;
+        this->release(it.m_links);
+        return iterator(next);
+    }
+
+    // Erase an element of this list given by its address.
+    void erase(const T *element) { this->release(&slot(element)->links); }
+
+    void clear()
+    {
+        for (Links *links = m_head.next; links != &m_head; links = links->next)
+            value(links)->~T();
+        for (void *chunk : m_chunks)
+            HalfEdgeArena::release_chunk(chunk);
+        m_chunks.clear();
+        m_head.prev = m_head.next = &m_head;
+        m_size       = 0;
+        m_free       = nullptr;
+        m_chunk_used = 0;
+    }
+
+private:
+    template<class... Args>
+    T* emplace(Links *before, Args&&... args)
+    {
+        Slot *s = this->allocate_slot();
+        try {
+            new (s->storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            s->links.next = reinterpret_cast<Links*>(m_free);
+            m_free        = s;
+            throw;
+        }
+        s->links.prev       = before->prev;
+        s->links.next       = before;
+        before->prev->next  = &s->links;
+        before->prev        = &s->links;
+        ++ m_size;
+        return value(&s->links);
+    }
+
+    Slot* allocate_slot()
+    {
+        if (m_free != nullptr) {
+            // Reuse the slot of an erased element, the free slots are chained through links.next.
+            Slot *s = m_free;
+            m_free  = reinterpret_cast<Slot*>(s->links.next);
+            return s;
+        }
+        if (m_chunks.empty() || m_chunk_used == slots_per_chunk) {
+            m_chunks.emplace_back(HalfEdgeArena::allocate_chunk());
+            m_chunk_used = 0;
+        }
+        return reinterpret_cast<Slot*>(m_chunks.back()) + m_chunk_used ++;
+    }
+
+    void release(Links *links)
+    {
+        assert(m_size > 0);
+        links->prev->next = links->next;
+        links->next->prev = links->prev;
+        value(links)->~T();
+        -- m_size;
+        links->next = reinterpret_cast<Links*>(m_free);
+        m_free      = reinterpret_cast<Slot*>(links);
+    }
+
+    Links              m_head;
+    size_t             m_size { 0 };
+    // Slots of the erased elements.
+    Slot              *m_free { nullptr };
+    std::vector<void*> m_chunks;
+    // Number of slots taken from the last chunk.
+    size_t             m_chunk_used { 0 };
+};
+
 template<class node_data_t, class edge_data_t, class derived_node_t, class derived_edge_t> // types of data contained in nodes and edges
 class HalfEdgeGraph
 {
 public:
     using edge_t = derived_edge_t;
     using node_t = derived_node_t;
-    std::list<edge_t> edges;
-    std::list<node_t> nodes;
+    HalfEdgeList<edge_t> edges;
+    HalfEdgeList<node_t> nodes;
 };
 
 } // namespace Slic3r::Arachne
@@ -4,13 +4,16 @@
 #include "libslic3r.h"
 
 #include <libnest2d/backends/libslic3r/geometries.hpp>
+#include <libnest2d/parallel.hpp>
 #include <libnest2d/optimizers/nlopt/subplex.hpp>
 #include <libnest2d/placers/nfpplacer.hpp>
 #include <libnest2d/selections/firstfit.hpp>
 #include <libnest2d/utils/rotcalipers.hpp>
 
 #include <numeric>
+#include <optional>
 #include <ClipperUtils.hpp>
+#include "Geometry/ConvexHull.hpp"
 
 #include <boost/geometry/index/rtree.hpp>
 
@@ -1141,5 +1144,271 @@ template void arrange(ArrangePolygons &items, const ArrangePolygons &excludes, c
 template void arrange(ArrangePolygons &items, const ArrangePolygons &excludes, const Polygon &bed, const ArrangeParams &params);
 template void arrange(ArrangePolygons &items, const ArrangePolygons &excludes, const InfiniteBed &bed, const ArrangeParams &params);
 
+bool is_lattice_fillable(const ArrangePolygons &items)
+{
+    return ! items.empty() && std::all_of(items.begin(), items.end(), [&front = items.front()](const ArrangePolygon &ap) {
+        return ap.poly == front.poly && ap.inflation == front.inflation && ap.rotation == front.rotation;
+    });
+}
+
+// Upper boundary of a convex polygon at the vertical line x, nothing if the line misses the polygon.
+static std::optional<double> convex_top_at(const Polygon &convex, double x)
+{
+    std::optional<double> top;
+    for (size_t i = 0; i < convex.size(); ++ i) {
+        const Vec2d a = convex.points[i].cast<double>();
+        const Vec2d b = convex.points[(i + 1) % convex.size()].cast<double>();
+        if ((a.x() <= x && x <= b.x()) || (b.x() <= x && x <= a.x())) {
+            double y = a.x() == b.x() ? std::max(a.y(), b.y()) : a.y() + (b.y() - a.y()) * (x - a.x()) / (b.x() - a.x());
+            if (! top || y > *top)
+                top = y;
+        }
+    }
+    return top;
+}
+
+// Right end of the horizontal chord of a convex polygon containing the origin at y = 0.
+static double convex_right_at_origin(const Polygon &convex)
+{
+    double right = 0.;
+    for (size_t i = 0; i < convex.size(); ++ i) {
+        const Vec2d a = convex.points[i].cast<double>();
+        const Vec2d b = convex.points[(i + 1) % convex.size()].cast<double>();
+        if ((a.y() <= 0. && 0. <= b.y()) || (b.y() <= 0. && 0. <= a.y()))
+            right = std::max(right, a.y() == b.y() ? std::max(a.x(), b.x()) : a.x() - a.y() * (b.x() - a.x()) / (b.y() - a.y()));
+    }
+    return right;
+}
+
+// The item rotated for one of the lattice candidates.
+struct LatticeShape
+{
+    double      rotation;
+    // The inflated item.
+    Polygons    shape;
+    Polygon     hull;
+    BoundingBox bbox;
+    // No-fit polygon of the hull with itself: the hull placed at a translation inside nfp overlaps the hull at the origin.
+    // Symmetric around the origin.
+    Polygon     nfp;
+};
+
+// Copies of the item are placed at origin + i * a + j * b, a being horizontal.
+struct Lattice
+{
+    size_t      shape_idx;
+    Vec2d       a;
+    Vec2d       b;
+    Vec2d       origin;
+};
+
+// Calls fn for the lattice positions whose item bounding box may touch the bed, row by row from the bottom to the top
+// and from the left to the right.
+template<class Fn> static void for_each_lattice_position(const Lattice &lattice, const BoundingBox &shape_bbox, const BoundingBox &bed_bbox, Fn &&fn)
+{
+    const double ymin = double(bed_bbox.min.y() - shape_bbox.min.y()) - lattice.origin.y();
+    const double ymax = double(bed_bbox.max.y() - shape_bbox.max.y()) - lattice.origin.y();
+    for (int j = int(std::ceil(ymin / lattice.b.y())); j <= int(std::floor(ymax / lattice.b.y())); ++ j) {
+        const Vec2d  row  = lattice.origin + double(j) * lattice.b;
+        const double xmin = double(bed_bbox.min.x() - shape_bbox.min.x()) - row.x();
+        const double xmax = double(bed_bbox.max.x() - shape_bbox.max.x()) - row.x();
+        for (int i = int(std::ceil(xmin / lattice.a.x())); i <= int(std::floor(xmax / lattice.a.x())); ++ i)
+            fn((row + double(i) * lattice.a).cast<coord_t>().eval());
+    }
+}
+
+size_t fill_bed_lattice(ArrangePolygons &items, const ArrangePolygons &excludes, const Points &bed, const ArrangeParams &params)
+{
+    if (! is_lattice_fillable(items) || bed.size() < 3)
+        return 0;
+
+    const ArrangePolygon &templ   = items.front();
+    const BoundingBox     bed_bbox(bed);
+    const Polygon         bed_poly(bed);
+    // Rectangular beds are tested by bounding boxes, the hull of the item is clipped by other beds.
+    const bool            bed_is_box = 1. - std::abs(bed_poly.area()) / bed_bbox.polygon().area() < 1e-3;
+    // Keep the copies a tiny bit apart, so that rounding of the translations does not make them overlap.
+    const double          gap        = double(SCALED_EPSILON);
+
+    // Fixed items and the regions not to be used.
+    struct Obstacle { BoundingBox bbox; Polygons shape; };
+    std::vector<Obstacle> obstacles;
+    auto add_obstacle = [&obstacles, &bed_bbox](const ArrangePolygon &ap) {
+        Polygons shape = ap.inflation == 0 ? to_polygons(ap.transformed_poly()) : offset(ap.transformed_poly(), float(ap.inflation));
+        BoundingBox bbox = get_extents(shape);
+        if (bbox.defined && bbox.overlap(bed_bbox))
+            obstacles.push_back({ bbox, std::move(shape) });
+    };
+    for (const ArrangePolygon &ap : excludes)
+        add_obstacle(ap);
+    for (const ArrangePolygon &ap : params.excluded_regions)
+        add_obstacle(ap);
+    for (const ArrangePolygon &ap : params.nonprefered_regions)
+        add_obstacle(ap);
+
+    // The no-fit polygon is calculated once per rotation.
+    std::vector<double> rotations { 0. };
+    if (params.allow_rotations) {
+        double min_area_rotation = min_area_boundingbox_rotation(ExPolygon(Geometry::convex_hull(templ.poly.contour.points)));
+        for (double r : { 0.5 * PI, PI, 1.5 * PI, min_area_rotation, min_area_rotation + 0.5 * PI })
+            if (std::find_if(rotations.begin(), rotations.end(), [r](double r2) { return std::abs(r - r2) < EPSILON; }) == rotations.end())
+                rotations.emplace_back(r);
+    }
+    std::vector<LatticeShape> shapes;
+    for (double r : rotations) {
+        LatticeShape sh;
+        sh.rotation = templ.rotation + r;
+        ExPolygon rotated = templ.poly;
+        rotated.rotate(sh.rotation);
+        sh.shape = templ.inflation == 0 ? to_polygons(rotated) : offset(rotated, float(templ.inflation));
+        if (sh.shape.empty())
+            continue;
+        sh.hull = Geometry::convex_hull(sh.shape);
+        sh.bbox = get_extents(sh.hull);
+        // Minkowski sum of the hull and the mirrored hull.
+        Points diffs;
+        diffs.reserve(sh.hull.size() * sh.hull.size());
+        for (const Point &p1 : sh.hull.points)
+            for (const Point &p2 : sh.hull.points)
+                diffs.emplace_back(p1 - p2);
+        sh.nfp = Geometry::convex_hull(std::move(diffs));
+        if (sh.nfp.size() >= 3)
+            shapes.emplace_back(std::move(sh));
+    }
+
+    // Candidate lattices: the rows are packed as tightly as the no-fit polygon allows for each horizontal shift
+    // of the next row, and the origin is moved over a lattice cell.
+    static constexpr const int NUM_SHIFTS  = 8;
+    static constexpr const int NUM_ORIGINS = 3;
+    std::vector<Lattice> lattices;
+    for (size_t shape_idx = 0; shape_idx < shapes.size(); ++ shape_idx) {
+        const Polygon &nfp     = shapes[shape_idx].nfp;
+        const BoundingBox nfp_bbox = get_extents(nfp);
+        const double   ax      = convex_right_at_origin(nfp) + gap;
+        for (int shift_idx = 0; shift_idx < NUM_SHIFTS; ++ shift_idx) {
+            const double shift = ax * shift_idx / NUM_SHIFTS;
+            // Lowest row spacing, for which the copies in row j do not overlap the copy at the origin.
+            double dy = gap;
+            for (bool changed = true; changed;) {
+                changed = false;
+                for (int j = 1; j * dy < nfp_bbox.max.y() && j < 1000; ++ j) {
+                    const double row_x = j * shift;
+                    for (int m = int(std::floor((nfp_bbox.min.x() - row_x) / ax)); m <= int(std::ceil((nfp_bbox.max.x() - row_x) / ax)); ++ m)
+                        if (std::optional<double> top = convex_top_at(nfp, row_x + m * ax); top && *top + gap > j * dy) {
+                            dy      = (*top + gap) / j;
+                            changed = true;
+                        }
+                }
+            }
+            const Vec2d a(ax, 0.);
+            const Vec2d b(shift, dy);
+            for (int u = 0; u < NUM_ORIGINS; ++ u)
+                for (int v = 0; v < NUM_ORIGINS; ++ v) {
+                    Vec2d origin = (bed_bbox.min - shapes[shape_idx].bbox.min).cast<double>() + (double(u) / NUM_ORIGINS) * a + (double(v) / NUM_ORIGINS) * b;
+                    lattices.push_back({ shape_idx, a, b, origin });
+                }
+        }
+    }
+
+    auto fits = [&](const LatticeShape &sh, const Point &pos) {
+        BoundingBox bbox = sh.bbox;
+        bbox.translate(pos.x(), pos.y());
+        if (bed_is_box) {
+            if (! bed_bbox.contains(bbox.min) || ! bed_bbox.contains(bbox.max))
+                return false;
+        } else {
+            // The bed may be concave, testing the vertices of the hull is not enough.
+            if (! bed_bbox.contains(bbox.min) || ! bed_bbox.contains(bbox.max))
+                return false;
+            Polygon hull = sh.hull;
+            hull.translate(pos);
+            if (! diff(hull, bed_poly).empty())
+                return false;
+        }
+        for (const Obstacle &obstacle : obstacles)
+            if (obstacle.bbox.overlap(bbox)) {
+                Polygons moved = sh.shape;
+                for (Polygon &p : moved)
+                    p.translate(pos);
+                if (! intersection(moved, obstacle.shape).empty())
+                    return false;
+            }
+        return true;
+    };
+
+    // Evaluate the candidates in parallel.
+    std::vector<Points> positions(lattices.size());
+    __parallel::enumerate(lattices.cbegin(), lattices.cend(),
+        [&](const Lattice &lattice, size_t idx) {
+            if (params.stopcondition && params.stopcondition())
+                return;
+            const LatticeShape &sh = shapes[lattice.shape_idx];
+            for_each_lattice_position(lattice, sh.bbox, bed_bbox, [&](const Point &pos) {
+                if (positions[idx].size() < items.size() && fits(sh, pos))
+                    positions[idx].emplace_back(pos);
+            });
+        },
+        params.parallel ? std::launch::async : std::launch::deferred);
+    if (params.stopcondition && params.stopcondition())
+        return 0;
+
+    // Most copies placed wins, then the most compact placement.
+    size_t best = size_t(-1);
+    auto   extent = [&positions](size_t idx) { return positions[idx].back().y() - positions[idx].front().y(); };
+    for (size_t idx = 0; idx < lattices.size(); ++ idx)
+        if (! positions[idx].empty() &&
+            (best == size_t(-1) || positions[idx].size() > positions[best].size() ||
+             (positions[idx].size() == positions[best].size() && extent(idx) < extent(best))))
+            best = idx;
+
+    // The lattice starts at the minimum corner of the bed. Align the placed copies the way the final alignment of the
+    // NFP placer does: to the user defined point, otherwise to the bed center, as long as all the copies still fit.
+    const bool user_defined_align = std::abs(params.align_center.x() - 0.5) > 0.001 || std::abs(params.align_center.y() - 0.5) > 0.001;
+    if (best != size_t(-1) && (user_defined_align || params.do_final_align)) {
+        const LatticeShape &sh = shapes[lattices[best].shape_idx];
+        BoundingBox         pile;
+        for (const Point &pos : positions[best]) {
+            BoundingBox bbox = sh.bbox;
+            bbox.translate(pos.x(), pos.y());
+            pile.merge(bbox);
+        }
+        const Vec2d target = user_defined_align ?
+            bed_bbox.min.cast<double>() + Vec2d(bed_bbox.size().x() * params.align_center.x(), bed_bbox.size().y() * params.align_center.y()) :
+            bed_bbox.center().cast<double>();
+        Vec2d d = target - pile.center().cast<double>();
+        // Keep the pile inside the bed.
+        for (int axis = 0; axis < 2; ++ axis)
+            d[axis] = std::clamp(d[axis], double(bed_bbox.min[axis] - pile.min[axis]), double(bed_bbox.max[axis] - pile.max[axis]));
+        // Fixed items or a bed, which is not a box, may block the aligned pile. Move it less then.
+        for (int attempt = 0; attempt < 8 && d.squaredNorm() > 0.; ++ attempt, d *= 0.5) {
+            const Point shift = d.cast<coord_t>();
+            if (std::all_of(positions[best].begin(), positions[best].end(), [&](const Point &pos) { return fits(sh, pos + shift); })) {
+                for (Point &pos : positions[best])
+                    pos += shift;
+                break;
+            }
+        }
+    }
+
+    std::vector<size_t> order(items.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&items](size_t i1, size_t i2) { return items[i1].priority > items[i2].priority; });
+    const size_t num_placed = best == size_t(-1) ? 0 : positions[best].size();
+    for (size_t i = 0; i < order.size(); ++ i) {
+        ArrangePolygon &ap = items[order[i]];
+        if (i < num_placed) {
+            ap.translation = positions[best][i];
+            ap.rotation    = shapes[lattices[best].shape_idx].rotation;
+            ap.bed_idx     = 0;
+            if (params.on_packed)
+                params.on_packed(ap);
+        } else
+            ap.bed_idx = UNARRANGED;
+    }
+    if (params.progressind)
+        params.progressind(unsigned(num_placed), "");
+    return num_placed;
+}
+
 } // namespace arr
 } // namespace Slic3r
@@ -212,6 +212,27 @@ inline void arrange(ArrangePolygons &items, const CircleBed &bed, const ArrangeP
 inline void arrange(ArrangePolygons &items, const Polygon &bed, const ArrangeParams &params = {}) { arrange(items, {}, bed, params); }
 inline void arrange(ArrangePolygons &items, const InfiniteBed &bed, const ArrangeParams &params = {}) { arrange(items, {}, bed, params); }
 
+// Returns true if all the items have the same silhouette, inflation and rotation, thus they may be placed by fill_bed_lattice().
+bool is_lattice_fillable(const ArrangePolygons &items);
+
+/**
+ * \brief Fills the bed with copies of one item placed on a lattice.
+ *
+ * The lattice vectors are derived from the no-fit polygon of the convex hull of the item with itself, which is
+ * calculated once per rotation. The candidate lattices (rotation, row shift and origin) are evaluated in parallel
+ * and the one fitting most copies on the bed wins. This is much faster than arrange() for many copies. The rows are
+ * packed as tightly as the convex hulls allow, with the next row shifted sideways; concave items do not interlock.
+ * The placed copies are aligned like by the final alignment of arrange(): to params.align_center if set, otherwise
+ * to the bed center if params.do_final_align. Sequential printing (params.is_seq_print) is not supported, the extruder
+ * clearance is not considered.
+ *
+ * \param items Copies of one item, see is_lattice_fillable(). The items are placed in the order of their priority,
+ * the ones which do not fit are marked UNARRANGED.
+ * \param excludes Fixed items on the bed to be avoided, along with params.excluded_regions and params.nonprefered_regions.
+ * \return The number of items placed.
+ */
+size_t fill_bed_lattice(ArrangePolygons &items, const ArrangePolygons &excludes, const Points &bed, const ArrangeParams &params = {});
+
 }} // namespace Slic3r::arrangement
 
 #endif // MODELARRANGE_HPP
@@ -84,10 +84,6 @@ public:
     }
     
 private:
-    // to access construct()
-    friend BoundingBox get_extents<false>(const Points &pts);
-    friend BoundingBox get_extents<true>(const Points &pts);
-
     // if IncludeBoundary, then a bounding box is defined even for a single point.
     // otherwise a bounding box is only defined if it has a positive area.
     // The output bounding box is expected to be set to "undefined" initially.
@@ -215,7 +211,7 @@ public:
     
     BoundingBox() : BoundingBoxBase<Point>() {}
     BoundingBox(const Point &pmin, const Point &pmax) : BoundingBoxBase<Point>(pmin, pmax) {}
-    BoundingBox(const Points &points) : BoundingBoxBase<Point>(points) {}
+    BoundingBox(const Points &points) : BoundingBox(get_extents(points)) {}
 
     BoundingBox inflated(coordf_t delta) const throw() { BoundingBox out(*this); out.offset(delta); return out; }
 
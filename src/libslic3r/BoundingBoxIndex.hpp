@@ -0,0 +1,83 @@
+#ifndef slic3r_BoundingBoxIndex_hpp_
+#define slic3r_BoundingBoxIndex_hpp_
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "BoundingBox.hpp"
+
+namespace Slic3r {
+
+// R-tree over the bounding boxes of a set of Polygons or ExPolygons, referenced by their position in the source container.
+// Used to clip a small area against just the items of a large set, which overlap it, instead of against the whole set.
+// The queries return the items in the order of the source container, so that clipping against the query result
+// produces the same result as clipping against all the items.
+class BoundingBoxIndex
+{
+public:
+    BoundingBoxIndex() = default;
+    // Bulk loading (packing) constructor, indexing all of src.
+    template<typename Container>
+    explicit BoundingBoxIndex(const Container &src)
+    {
+        std::vector<Element> elements;
+        elements.reserve(src.size());
+        for (size_t i = 0; i < src.size(); ++ i)
+            if (! src[i].empty())
+                elements.emplace_back(to_box(get_extents(src[i])), i);
+        m_tree = Tree(elements.begin(), elements.end());
+    }
+
+    // Index src[first], src[first + 1], ... incrementally.
+    template<typename Container>
+    void insert(const Container &src, size_t first = 0)
+    {
+        for (size_t i = first; i < src.size(); ++ i)
+            if (! src[i].empty())
+                m_tree.insert(Element(to_box(get_extents(src[i])), i));
+    }
+
+    bool empty() const { return m_tree.empty(); }
+
+    // Indices of the items with bounding box overlapping bbox, sorted.
+    std::vector<size_t> query(const BoundingBox &bbox) const
+    {
+        std::vector<Element> hits;
+        if (bbox.defined)
+            m_tree.query(boost::geometry::index::intersects(to_box(bbox)), std::back_inserter(hits));
+        std::vector<size_t> out;
+        out.reserve(hits.size());
+        for (const Element &hit : hits)
+            out.emplace_back(hit.second);
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Items of src with bounding box overlapping bbox, in the order of src. src is the container the index was built over.
+    template<typename Container>
+    Container query(const Container &src, const BoundingBox &bbox) const
+    {
+        Container out;
+        for (size_t idx : this->query(bbox))
+            out.emplace_back(src[idx]);
+        return out;
+    }
+
+private:
+    using BPoint  = boost::geometry::model::d2::point_xy<coord_t>;
+    using BBox    = boost::geometry::model::box<BPoint>;
+    using Element = std::pair<BBox, size_t>;
+    using Tree    = boost::geometry::index::rtree<Element, boost::geometry::index::rstar<16, 4>>;
+
+    static BBox to_box(const BoundingBox &bbox) { return { BPoint(bbox.min.x(), bbox.min.y()), BPoint(bbox.max.x(), bbox.max.y()) }; }
+
+    Tree m_tree;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_BoundingBoxIndex_hpp_
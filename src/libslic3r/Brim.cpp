@@ -1,5 +1,6 @@
 #include "clipper/clipper_z.hpp"
 
+#include "BoundingBoxIndex.hpp"
 #include "ClipperUtils.hpp"
 #include "EdgeGrid.hpp"
 #include "Layer.hpp"
@@ -12,6 +13,7 @@
 #include <numeric>
 #include <unordered_set>
 #include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 
 #include <boost/log/trivial.hpp>
 
@@ -850,6 +852,137 @@ static ExPolygons make_brim_ears(ExPolygons& obj_expoly, coord_t size_ear, coord
 }
 
 //BBS: create all brims
+// BBS: generate brim area by objs, the brim area is clipped by the brims already placed in its vicinity only.
+static void append_and_translate(const ExPolygons& dst, const BoundingBoxIndex& dst_index, const ExPolygons& src,
+    const PrintInstance& instance, std::map<ObjectID, ExPolygons>& brimAreaMap) {
+    ExPolygons srcShifted = src;
+    Point instance_shift = instance.shift_without_plate_offset();
+    for (size_t src_idx = 0; src_idx < srcShifted.size(); ++src_idx)
+        srcShifted[src_idx].translate(instance_shift);
+    srcShifted = diff_ex(srcShifted, dst_index.query(dst, get_extents(srcShifted)));
+    expolygons_append(brimAreaMap[instance.print_object->id()], std::move(srcShifted));
+}
+
+// BBS: brim areas of a single object before being distributed to its instances.
+struct ObjectBrimAreas
+{
+    ExPolygons brim_area;
+    ExPolygons no_brim_area;
+    Polygons   holes;
+    ExPolygons island;
+};
+
+// BBS: the brim of an object only depends on its own first layer, thus the brims of all objects are generated in parallel.
+static ObjectBrimAreas object_brim_areas(const Print& print, const PrintObject* object, const float no_brim_offset)
+{
+    Flow               flow = print.brim_flow();
+    const BrimType     brim_type = object->config().brim_type.value;
+    float              brim_offset = scale_(object->config().brim_object_gap.value);
+    double             flowWidth = print.brim_flow().scaled_spacing() * SCALING_FACTOR;
+    float              brim_width = scale_(floor(object->config().brim_width.value / flowWidth / 2) * flowWidth * 2);
+    const float        scaled_flow_width = print.brim_flow().scaled_spacing();
+    const float        scaled_additional_brim_width = scale_(floor(5 / flowWidth / 2) * flowWidth * 2);
+    const float        scaled_half_min_adh_length = scale_(1.1);
+    bool               has_brim_auto = object->config().brim_type == btAutoBrim;
+    const bool         use_brim_ears = object->config().brim_type == btEar;
+    const bool         has_inner_brim = brim_type == btInnerOnly || brim_type == btOuterAndInner || use_brim_ears;
+    const bool         has_outer_brim = brim_type == btOuterOnly || brim_type == btOuterAndInner || brim_type == btAutoBrim || use_brim_ears;
+    coord_t            ear_detection_length = scale_(object->config().brim_ears_detection_length.value);
+    coordf_t           brim_ears_max_angle = object->config().brim_ears_max_angle.value;
+
+    ObjectBrimAreas    out;
+    ExPolygons        &brim_area_object = out.brim_area;
+    ExPolygons        &no_brim_area_object = out.no_brim_area;
+    Polygons          &holes_object = out.holes;
+
+    double             adhesion = getadhesionCoeff(object);
+    double             maxSpeed = Model::findMaxSpeed(object->model_object());
+    // BBS: brims are generated by volume groups
+    for (const auto& volumeGroup : object->firstLayerObjGroups()) {
+        // find volumePtrs included in this group
+        std::vector<ModelVolume*> groupVolumePtrs;
+        for (auto& volumeID : volumeGroup.volume_ids) {
+            ModelVolume* currentModelVolumePtr = nullptr;
+            //BBS: support shared object logic
+            const PrintObject* shared_object = object->get_shared_object();
+            if (!shared_object)
+                shared_object = object;
+            for (auto volumePtr : shared_object->model_object()->volumes) {
+                if (volumePtr->id() == volumeID) {
+                    currentModelVolumePtr = volumePtr;
+                    break;
+                }
+            }
+            if (currentModelVolumePtr != nullptr) groupVolumePtrs.push_back(currentModelVolumePtr);
+        }
+        if (groupVolumePtrs.empty()) continue;
+        double groupHeight = 0.;
+        // config brim width in auto-brim mode
+        if (has_brim_auto) {
+            double brimWidthRaw = configBrimWidthByVolumeGroups(adhesion, maxSpeed, groupVolumePtrs, volumeGroup.slices, groupHeight);
+            brim_width = scale_(floor(brimWidthRaw / flowWidth / 2) * flowWidth * 2);
+        }
+        for (const ExPolygon& ex_poly : volumeGroup.slices) {
+            // BBS: additional brim width will be added if part's adhesion area is too small and brim is not generated
+            float brim_width_mod;
+            if (brim_width < scale_(5.) && has_brim_auto && groupHeight > 10.) {
+                brim_width_mod = ex_poly.area() / ex_poly.contour.length() < scaled_half_min_adh_length
+                    && brim_width < scaled_flow_width ? brim_width + scaled_additional_brim_width : brim_width;
+            }
+            else {
+                brim_width_mod = brim_width;
+            }
+            //BBS: brim width should be limited to the 1.5*boundingboxSize of a single polygon.
+            if (has_brim_auto) {
+                BoundingBox bbox2 = ex_poly.contour.bounding_box();
+                brim_width_mod = std::min(brim_width_mod, float(std::max(bbox2.size()(0), bbox2.size()(1))));
+            }
+            brim_width_mod = floor(brim_width_mod / scaled_flow_width / 2) * scaled_flow_width * 2;
+
+            Polygons ex_poly_holes_reversed = ex_poly.holes;
+            polygons_reverse(ex_poly_holes_reversed);
+
+            if (has_outer_brim) {
+                // BBS: inner and outer boundary are offset from the same polygon incase of round off error.
+                auto innerExpoly = offset_ex(ex_poly.contour, brim_offset, jtRound, SCALED_RESOLUTION);
+                auto &clipExpoly = innerExpoly;
+
+                if (use_brim_ears) {
+                    coord_t size_ear = (brim_width_mod - brim_offset - flow.scaled_spacing());
+                    append(brim_area_object, diff_ex(make_brim_ears(innerExpoly, size_ear, ear_detection_length, brim_ears_max_angle, true), clipExpoly));
+                } else {
+                    // Normal brims
+                    append(brim_area_object, diff_ex(offset_ex(innerExpoly, brim_width_mod, jtRound, SCALED_RESOLUTION), clipExpoly));
+                }
+            }
+            if (has_inner_brim) {
+                auto outerExpoly = offset_ex(ex_poly_holes_reversed, -brim_offset);
+                auto clipExpoly = offset_ex(ex_poly_holes_reversed, -brim_width - brim_offset);
+
+                if (use_brim_ears) {
+                    coord_t size_ear = (brim_width - brim_offset - flow.scaled_spacing());
+                    append(brim_area_object, diff_ex(make_brim_ears(outerExpoly, size_ear, ear_detection_length, brim_ears_max_angle, false), clipExpoly));
+                } else {
+                    // Normal brims
+                    append(brim_area_object, diff_ex(outerExpoly, clipExpoly));
+                }
+            }
+            if (!has_inner_brim) {
+                // BBS: brim should be apart from holes
+                append(no_brim_area_object, diff_ex(ex_poly_holes_reversed, offset_ex(ex_poly_holes_reversed, -scale_(5.))));
+            }
+            if (!has_outer_brim)
+                append(no_brim_area_object, diff_ex(offset(ex_poly.contour, no_brim_offset), ex_poly_holes_reversed));
+            if (!has_inner_brim && !has_outer_brim)
+                append(no_brim_area_object, offset_ex(ex_poly_holes_reversed, -no_brim_offset));
+            append(holes_object, ex_poly_holes_reversed);
+        }
+    }
+    out.island = offset_ex(object->layers().front()->lslices, brim_offset, jtRound, SCALED_RESOLUTION);
+    append(no_brim_area_object, out.island);
+    return out;
+}
+
 static ExPolygons outer_inner_brim_area(const Print& print,
     const float no_brim_offset, std::map<ObjectID, ExPolygons>& brimAreaMap,
     std::map<ObjectID, ExPolygons>& supportBrimAreaMap,
@@ -857,9 +990,9 @@ static ExPolygons outer_inner_brim_area(const Print& print,
     std::vector<unsigned int>& printExtruders)
 {
     unsigned int support_material_extruder = printExtruders.front() + 1;
-    Flow flow = print.brim_flow();
 
     ExPolygons brim_area;
+    BoundingBoxIndex brim_area_index;
     ExPolygons no_brim_area;
     Polygons   holes;
 
@@ -871,6 +1004,20 @@ static ExPolygons outer_inner_brim_area(const Print& print,
     for (const auto& objectWithExtruder : objPrintVec)
         brimToWrite.insert({ objectWithExtruder.first, {true,true} });
 
+    // BBS: the brim areas of the objects are independent of each other until they are distributed to the instances,
+    // generate them in parallel and resolve the conflicts between the objects below.
+    std::vector<const PrintObject*> brim_objects;
+    std::map<ObjectID, size_t>      brim_object_idx;
+    for (const auto& objectWithExtruder : objPrintVec)
+        if (brim_object_idx.emplace(objectWithExtruder.first, brim_objects.size()).second)
+            brim_objects.emplace_back(print.get_object(objectWithExtruder.first));
+    std::vector<ObjectBrimAreas> object_areas(brim_objects.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, brim_objects.size()),
+        [&print, &brim_objects, &object_areas, no_brim_offset](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+                object_areas[i] = object_brim_areas(print, brim_objects[i], no_brim_offset);
+        });
+
     ExPolygons objectIslands;
     auto bedPoly = Model::getBedPolygon();
     auto bedExPoly = diff_ex((offset(bedPoly, scale_(30.), jtRound, SCALED_RESOLUTION)), { bedPoly });
@@ -880,123 +1027,34 @@ static ExPolygons outer_inner_brim_area(const Print& print,
         for (const auto& objectWithExtruder : objPrintVec) {
             const PrintObject* object = print.get_object(objectWithExtruder.first);
             const BrimType     brim_type = object->config().brim_type.value;
-            float              brim_offset = scale_(object->config().brim_object_gap.value);
             double             flowWidth = print.brim_flow().scaled_spacing() * SCALING_FACTOR;
             float              brim_width = scale_(floor(object->config().brim_width.value / flowWidth / 2) * flowWidth * 2);
             const float        scaled_flow_width = print.brim_flow().scaled_spacing();
             const float        scaled_additional_brim_width = scale_(floor(5 / flowWidth / 2) * flowWidth * 2);
             const float        scaled_half_min_adh_length = scale_(1.1);
-            bool               has_brim_auto = object->config().brim_type == btAutoBrim;
             const bool         use_brim_ears = object->config().brim_type == btEar;
             const bool         has_inner_brim = brim_type == btInnerOnly || brim_type == btOuterAndInner || use_brim_ears;
             const bool         has_outer_brim = brim_type == btOuterOnly || brim_type == btOuterAndInner || brim_type == btAutoBrim || use_brim_ears;
-            coord_t            ear_detection_length = scale_(object->config().brim_ears_detection_length.value);
-            coordf_t           brim_ears_max_angle = object->config().brim_ears_max_angle.value;
 
-            ExPolygons         brim_area_object;
-            ExPolygons         no_brim_area_object;
             ExPolygons         brim_area_support;
             ExPolygons         no_brim_area_support;
-            Polygons           holes_object;
             Polygons           holes_support;
             if (objectWithExtruder.second == extruderNo && brimToWrite.at(object->id()).obj) {
-                double             adhesion = getadhesionCoeff(object);
-                double             maxSpeed = Model::findMaxSpeed(object->model_object());
-                // BBS: brims are generated by volume groups
-                for (const auto& volumeGroup : object->firstLayerObjGroups()) {
-                    // find volumePtrs included in this group
-                    std::vector<ModelVolume*> groupVolumePtrs;
-                    for (auto& volumeID : volumeGroup.volume_ids) {
-                        ModelVolume* currentModelVolumePtr = nullptr;
-                        //BBS: support shared object logic
-                        const PrintObject* shared_object = object->get_shared_object();
-                        if (!shared_object)
-                            shared_object = object;
-                        for (auto volumePtr : shared_object->model_object()->volumes) {
-                            if (volumePtr->id() == volumeID) {
-                                currentModelVolumePtr = volumePtr;
-                                break;
-                            }
-                        }
-                        if (currentModelVolumePtr != nullptr) groupVolumePtrs.push_back(currentModelVolumePtr);
-                    }
-                    if (groupVolumePtrs.empty()) continue;
-                    double groupHeight = 0.;
-                    // config brim width in auto-brim mode
-                    if (has_brim_auto) {
-                        double brimWidthRaw = configBrimWidthByVolumeGroups(adhesion, maxSpeed, groupVolumePtrs, volumeGroup.slices, groupHeight);
-                        brim_width = scale_(floor(brimWidthRaw / flowWidth / 2) * flowWidth * 2);
-                    }
-                    for (const ExPolygon& ex_poly : volumeGroup.slices) {
-                        // BBS: additional brim width will be added if part's adhesion area is too small and brim is not generated
-                        float brim_width_mod;
-                        if (brim_width < scale_(5.) && has_brim_auto && groupHeight > 10.) {
-                            brim_width_mod = ex_poly.area() / ex_poly.contour.length() < scaled_half_min_adh_length
-                                && brim_width < scaled_flow_width ? brim_width + scaled_additional_brim_width : brim_width;
-                        }
-                        else {
-                            brim_width_mod = brim_width;
-                        }
-                        //BBS: brim width should be limited to the 1.5*boundingboxSize of a single polygon.
-                        if (has_brim_auto) {
-                            BoundingBox bbox2 = ex_poly.contour.bounding_box();
-                            brim_width_mod = std::min(brim_width_mod, float(std::max(bbox2.size()(0), bbox2.size()(1))));
-                        }
-                        brim_width_mod = floor(brim_width_mod / scaled_flow_width / 2) * scaled_flow_width * 2;
-
-                        Polygons ex_poly_holes_reversed = ex_poly.holes;
-                        polygons_reverse(ex_poly_holes_reversed);
-
-                        if (has_outer_brim) {
-                            // BBS: inner and outer boundary are offset from the same polygon incase of round off error.
-                            auto innerExpoly = offset_ex(ex_poly.contour, brim_offset, jtRound, SCALED_RESOLUTION);
-                            auto &clipExpoly = innerExpoly;
-
-                            if (use_brim_ears) {
-                                coord_t size_ear = (brim_width_mod - brim_offset - flow.scaled_spacing());
-                                append(brim_area_object, diff_ex(make_brim_ears(innerExpoly, size_ear, ear_detection_length, brim_ears_max_angle, true), clipExpoly));
-                            } else {
-                                // Normal brims
-                                append(brim_area_object, diff_ex(offset_ex(innerExpoly, brim_width_mod, jtRound, SCALED_RESOLUTION), clipExpoly));
-                            }
-                        }
-                        if (has_inner_brim) {
-                            auto outerExpoly = offset_ex(ex_poly_holes_reversed, -brim_offset);
-                            auto clipExpoly = offset_ex(ex_poly_holes_reversed, -brim_width - brim_offset);
-
-                            if (use_brim_ears) {
-                                coord_t size_ear = (brim_width - brim_offset - flow.scaled_spacing());
-                                append(brim_area_object, diff_ex(make_brim_ears(outerExpoly, size_ear, ear_detection_length, brim_ears_max_angle, false), clipExpoly));
-                            } else {
-                                // Normal brims
-                                append(brim_area_object, diff_ex(outerExpoly, clipExpoly));
-                            }
-                        }
-                        if (!has_inner_brim) {
-                            // BBS: brim should be apart from holes
-                            append(no_brim_area_object, diff_ex(ex_poly_holes_reversed, offset_ex(ex_poly_holes_reversed, -scale_(5.))));
-                        }
-                        if (!has_outer_brim)
-                            append(no_brim_area_object, diff_ex(offset(ex_poly.contour, no_brim_offset), ex_poly_holes_reversed));
-                        if (!has_inner_brim && !has_outer_brim)
-                            append(no_brim_area_object, offset_ex(ex_poly_holes_reversed, -no_brim_offset));
-                        append(holes_object, ex_poly_holes_reversed);
-                    }
-                }
-                auto objectIsland = offset_ex(object->layers().front()->lslices, brim_offset, jtRound, SCALED_RESOLUTION);
-                append(no_brim_area_object, objectIsland);
-
+                const ObjectBrimAreas &areas = object_areas[brim_object_idx.at(object->id())];
                 brimToWrite.at(object->id()).obj = false;
                 for (const PrintInstance& instance : object->instances()) {
-                    if (!brim_area_object.empty())
-                        append_and_translate(brim_area, brim_area_object, instance, print, brimAreaMap);
-                    append_and_translate(no_brim_area, no_brim_area_object, instance);
-                    append_and_translate(holes, holes_object, instance);
-                    append_and_translate(objectIslands, objectIsland, instance);
+                    if (!areas.brim_area.empty())
+                        append_and_translate(brim_area, brim_area_index, areas.brim_area, instance, brimAreaMap);
+                    append_and_translate(no_brim_area, areas.no_brim_area, instance);
+                    append_and_translate(holes, areas.holes, instance);
+                    append_and_translate(objectIslands, areas.island, instance);
 
                 }
-                if (brimAreaMap.find(object->id()) != brimAreaMap.end())
+                if (brimAreaMap.find(object->id()) != brimAreaMap.end()) {
+                    size_t first = brim_area.size();
                     expolygons_append(brim_area, brimAreaMap[object->id()]);
+                    brim_area_index.insert(brim_area, first);
+                }
             }
             support_material_extruder = object->config().support_filament;
             if (support_material_extruder == 0 && object->has_support_material()) {
@@ -1047,57 +1105,103 @@ static ExPolygons outer_inner_brim_area(const Print& print,
                 brimToWrite.at(object->id()).sup = false;
                 for (const PrintInstance& instance : object->instances()) {
                     if (!brim_area_support.empty())
-                        append_and_translate(brim_area, brim_area_support, instance, print, supportBrimAreaMap);
+                        append_and_translate(brim_area, brim_area_index, brim_area_support, instance, supportBrimAreaMap);
                     append_and_translate(no_brim_area, no_brim_area_support, instance);
                     append_and_translate(holes, holes_support, instance);
                 }
-                if (supportBrimAreaMap.find(object->id()) != supportBrimAreaMap.end())
+                if (supportBrimAreaMap.find(object->id()) != supportBrimAreaMap.end()) {
+                    size_t first = brim_area.size();
                     expolygons_append(brim_area, supportBrimAreaMap[object->id()]);
+                    brim_area_index.insert(brim_area, first);
+                }
             }
         }
     }
     if (!bedExPoly.empty()){
         no_brim_area.push_back(bedExPoly.front());
     }
-    for (const PrintObject* object : print.objects()) {
-        if (brimAreaMap.find(object->id()) != brimAreaMap.end())
-        {
-            brimAreaMap[object->id()] = diff_ex(brimAreaMap[object->id()], no_brim_area);
-        }
 
-        if (supportBrimAreaMap.find(object->id()) != supportBrimAreaMap.end())
-            supportBrimAreaMap[object->id()] = diff_ex(supportBrimAreaMap[object->id()], no_brim_area);
+    // BBS: clip the brims of each object by the obstacles in their vicinity only.
+    {
+        BoundingBoxIndex no_brim_area_index;
+        no_brim_area_index.insert(no_brim_area);
+        std::vector<ExPolygons*> brims_to_clip;
+        for (const PrintObject* object : print.objects()) {
+            if (auto it = brimAreaMap.find(object->id()); it != brimAreaMap.end())
+                brims_to_clip.emplace_back(&it->second);
+            if (auto it = supportBrimAreaMap.find(object->id()); it != supportBrimAreaMap.end())
+                brims_to_clip.emplace_back(&it->second);
+        }
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, brims_to_clip.size()),
+            [&no_brim_area, &no_brim_area_index, &brims_to_clip](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); ++i) {
+                    ExPolygons &brim = *brims_to_clip[i];
+                    brim = diff_ex(brim, no_brim_area_index.query(no_brim_area, get_extents(brim)));
+                }
+            });
     }
 
-    brim_area.clear();
-    for (const PrintObject* object : print.objects()) {
-        // BBS: brim should be contacted to at least one object's island or brim area
-        if (brimAreaMap.find(object->id()) != brimAreaMap.end()) {
-            // find other objects' brim area
-            ExPolygons otherExPolys;
-            for (const PrintObject* otherObject : print.objects()) {
-                if ((otherObject->id() != object->id()) && (brimAreaMap.find(otherObject->id()) != brimAreaMap.end())) {
-                    expolygons_append(otherExPolys, brimAreaMap[otherObject->id()]);
+    // BBS: brim should be contacted to at least one object's island or brim area.
+    // A brim piece is kept if it touches an object island, another brim piece of the same object, a brim piece of an object
+    // processed later or a kept brim piece of an object processed before. The expensive intersection tests are evaluated
+    // for all the pieces in parallel, only the propagation of the kept flags in the order of the objects is sequential.
+    std::vector<ExPolygons*> object_brims;
+    for (const PrintObject* object : print.objects())
+        if (auto it = brimAreaMap.find(object->id()); it != brimAreaMap.end())
+            object_brims.emplace_back(&it->second);
+    ExPolygons          pieces;
+    std::vector<size_t> piece_owner;
+    for (size_t i = 0; i < object_brims.size(); ++i) {
+        expolygons_append(pieces, *object_brims[i]);
+        piece_owner.resize(pieces.size(), i);
+    }
+    BoundingBoxIndex pieces_index;
+    pieces_index.insert(pieces);
+    BoundingBoxIndex islands_index;
+    islands_index.insert(objectIslands);
+
+    const float               connection_offset = print.brim_flow().scaled_spacing() * 2;
+    std::vector<char>         piece_connected(pieces.size(), false);
+    std::vector<std::vector<size_t>> piece_touching(pieces.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pieces.size()),
+        [&pieces, &piece_owner, &pieces_index, &objectIslands, &islands_index, &piece_connected, &piece_touching, connection_offset](const tbb::blocked_range<size_t>& range) {
+            for (size_t ia = range.begin(); ia < range.end(); ++ia) {
+                auto        offsetedTa = offset_ex(pieces[ia], connection_offset, jtRound, SCALED_RESOLUTION);
+                BoundingBox bbox       = get_extents(offsetedTa);
+                if (!intersection_ex(offsetedTa, islands_index.query(objectIslands, bbox)).empty()) {
+                    piece_connected[ia] = true;
+                    continue;
                 }
-            }
-
-            auto tempArea = brimAreaMap[object->id()];
-            brimAreaMap[object->id()].clear();
-
-            for (int ia = 0; ia != tempArea.size(); ++ia) {
                 // find this object's other brim area
-                ExPolygons otherExPoly;
-                for (int iao = 0; iao != tempArea.size(); ++iao)
-                    if (iao != ia) otherExPoly.push_back(tempArea[iao]);
-
-                auto offsetedTa = offset_ex(tempArea[ia], print.brim_flow().scaled_spacing() * 2, jtRound, SCALED_RESOLUTION);
-                if (!intersection_ex(offsetedTa, objectIslands).empty() ||
-                    !intersection_ex(offsetedTa, otherExPoly).empty() ||
-                    !intersection_ex(offsetedTa, otherExPolys).empty())
-                    brimAreaMap[object->id()].push_back(tempArea[ia]);
+                ExPolygons          otherExPoly;
+                std::vector<size_t> otherObjectsPieces;
+                for (size_t iao : pieces_index.query(bbox))
+                    if (piece_owner[iao] != piece_owner[ia])
+                        otherObjectsPieces.emplace_back(iao);
+                    else if (iao != ia)
+                        otherExPoly.emplace_back(pieces[iao]);
+                if (!otherExPoly.empty() && !intersection_ex(offsetedTa, otherExPoly).empty()) {
+                    piece_connected[ia] = true;
+                    continue;
+                }
+                for (size_t iao : otherObjectsPieces)
+                    if (!intersection_ex(offsetedTa, pieces[iao]).empty())
+                        piece_touching[ia].emplace_back(iao);
             }
-            expolygons_append(brim_area, brimAreaMap[object->id()]);
+        });
+
+    brim_area.clear();
+    for (size_t ia = 0, i = 0; i < object_brims.size(); ++i) {
+        ExPolygons &brim = *object_brims[i];
+        brim.clear();
+        for (; ia < pieces.size() && piece_owner[ia] == i; ++ia) {
+            if (!piece_connected[ia])
+                piece_connected[ia] = std::any_of(piece_touching[ia].begin(), piece_touching[ia].end(),
+                    [&piece_owner, &piece_connected, i](size_t iao) { return piece_owner[iao] > i || piece_connected[iao]; });
+            if (piece_connected[ia])
+                brim.push_back(pieces[ia]);
         }
+        expolygons_append(brim_area, brim);
     }
     return brim_area;
 }
@@ -1696,16 +1800,27 @@ void make_brim(const Print& print, PrintTryCancel try_cancel, Polygons& islands_
     for (size_t iia = 0; iia < islands_area.size(); ++iia)
         islands_area[iia].translate(plate_shift);
 
-    for (auto iter = brimAreaMap.begin(); iter != brimAreaMap.end(); ++iter) {
-        if (!iter->second.empty()) {
-            brimMap.insert(std::make_pair(iter->first, makeBrimInfill(iter->second, print, islands_area)));
-        };
-    }
-    for (auto iter = supportBrimAreaMap.begin(); iter != supportBrimAreaMap.end(); ++iter) {
-        if (!iter->second.empty()) {
-            supportBrimMap.insert(std::make_pair(iter->first, makeBrimInfill(iter->second, print, islands_area)));
-        };
-    }
+    // BBS: the brim extrusions of the objects are independent, generate them in parallel.
+    struct BrimInfillJob {
+        ObjectID                                       id;
+        const ExPolygons                              *area;
+        std::map<ObjectID, ExtrusionEntityCollection> *out;
+    };
+    std::vector<BrimInfillJob> jobs;
+    for (auto iter = brimAreaMap.begin(); iter != brimAreaMap.end(); ++iter)
+        if (!iter->second.empty())
+            jobs.push_back({ iter->first, &iter->second, &brimMap });
+    for (auto iter = supportBrimAreaMap.begin(); iter != supportBrimAreaMap.end(); ++iter)
+        if (!iter->second.empty())
+            jobs.push_back({ iter->first, &iter->second, &supportBrimMap });
+    std::vector<ExtrusionEntityCollection> brims(jobs.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, jobs.size()),
+        [&print, &islands_area, &jobs, &brims](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+                brims[i] = makeBrimInfill(*jobs[i].area, print, islands_area);
+        });
+    for (size_t i = 0; i < jobs.size(); ++i)
+        jobs[i].out->insert(std::make_pair(jobs[i].id, std::move(brims[i])));
 
     size_t          num_loops = size_t(floor(brim_width_max / flow.spacing()));
     BOOST_LOG_TRIVIAL(debug) << "brim_width_max, num_loops: " << brim_width_max << ", " << num_loops;
@@ -9,6 +9,7 @@
 #include <tbb/task_arena.h>
 
 #include "Execution.hpp"
+#include "../Thread.hpp"
 
 namespace Slic3r {
 
@@ -57,14 +58,18 @@ public:
                     size_t     granularity = 1
                     )
     {
+        auto body = [&](const auto &range, T subinit) {
+            T acc = subinit;
+            loop_(range, [&](auto &i) { acc = mergefn(acc, access(i)); });
+            return acc;
+        };
+        if (deterministic_execution())
+            // Split the range by the granularity only and merge the partial results in the order of the range,
+            // so that a non-associative merge (floating point sums) returns the same value on each run.
+            return tbb::parallel_deterministic_reduce(
+                tbb::blocked_range{from, to, granularity}, init, body, mergefn, tbb::simple_partitioner{});
         return tbb::parallel_reduce(
-            tbb::blocked_range{from, to, granularity}, init,
-            [&](const auto &range, T subinit) {
-                T acc = subinit;
-                loop_(range, [&](auto &i) { acc = mergefn(acc, access(i)); });
-                return acc;
-            },
-            std::forward<MergeFn>(mergefn));
+            tbb::blocked_range{from, to, granularity}, init, body, mergefn);
     }
 
     static size_t max_concurrency(const ExecutionTBB &)
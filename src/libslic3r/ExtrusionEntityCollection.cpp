@@ -17,6 +17,24 @@ void filter_by_extrusion_role_in_place(ExtrusionEntitiesPtr &extrusion_entities,
 	}
 }
 
+void collect_extrusion_paths(ExtrusionEntityCollection &collection, std::vector<ExtrusionPath*> &out)
+{
+    for (ExtrusionEntity *entity : collection.entities) {
+        if (ExtrusionEntityCollection *sub_collection = dynamic_cast<ExtrusionEntityCollection*>(entity))
+            collect_extrusion_paths(*sub_collection, out);
+        else if (ExtrusionPath *path = dynamic_cast<ExtrusionPath*>(entity))
+            out.emplace_back(path);
+        else if (ExtrusionMultiPath *multipath = dynamic_cast<ExtrusionMultiPath*>(entity))
+            for (ExtrusionPath &path : multipath->paths)
+                out.emplace_back(&path);
+        else if (ExtrusionLoop *loop = dynamic_cast<ExtrusionLoop*>(entity))
+            for (ExtrusionPath &path : loop->paths)
+                out.emplace_back(&path);
+        else
+            throw Slic3r::InvalidArgument("Invalid extrusion entity supplied to collect_extrusion_paths()");
+    }
+}
+
 ExtrusionEntityCollection::ExtrusionEntityCollection(const ExtrusionPaths &paths)
     : no_sort(false)
 {
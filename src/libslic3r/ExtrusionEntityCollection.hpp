@@ -22,6 +22,12 @@ inline ExtrusionEntitiesPtr filter_by_extrusion_role(const ExtrusionEntitiesPtr
 	return out;
 }
 
+class ExtrusionEntityCollection;
+
+// Collect pointers to all the ExtrusionPaths of a collection, recursing into the nested collections, multi-paths and loops.
+// The paths stay owned by the collection. Throws InvalidArgument on an unknown extrusion entity type.
+void collect_extrusion_paths(ExtrusionEntityCollection &collection, std::vector<ExtrusionPath*> &out);
+
 class ExtrusionEntityCollection : public ExtrusionEntity
 {
 public:
@@ -6,6 +6,7 @@
 #include "../GCode.hpp"
 #include "../Geometry.hpp"
 #include "../GCode/ThumbnailData.hpp"
+#include "../PNGReadWrite.hpp"
 #include "../Semver.hpp"
 #include "../Time.hpp"
 
@@ -2467,12 +2468,9 @@ ModelVolumeType type_from_string(const std::string &s)
     {
         bool res = false;
 
-        size_t png_size = 0;
-        void* png_data = tdefl_write_image_to_png_file_in_memory_ex((const void*)thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, &png_size, MZ_DEFAULT_LEVEL, 1);
-        if (png_data != nullptr) {
-            res = mz_zip_writer_add_mem(&archive, THUMBNAIL_FILE.c_str(), (const void*)png_data, png_size, MZ_DEFAULT_COMPRESSION);
-            mz_free(png_data);
-        }
+        std::vector<uint8_t> png_data;
+        if (png::encode_png(thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, png_data, true))
+            res = mz_zip_writer_add_mem(&archive, THUMBNAIL_FILE.c_str(), (const void*)png_data.data(), png_data.size(), MZ_DEFAULT_COMPRESSION);
 
         if (!res)
             add_error("Unable to add thumbnail file to archive");
@@ -9,6 +9,8 @@
 #include "libslic3r/SLAPrint.hpp"
 
 #include <sstream>
+#include <atomic>
+#include <chrono>
 
 #include "libslic3r/Exception.hpp"
 #include "libslic3r/SlicesToTriangleMesh.hpp"
@@ -25,6 +27,10 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/spin_mutex.h>
+#include <tbb/enumerable_thread_specific.h>
+
 namespace marchsq {
 
 template<> struct _RasterTraits<Slic3r::png::ImageGreyscale> {
@@ -50,15 +56,27 @@ namespace Slic3r {
 
 namespace {
 
-struct PNGBuffer { std::vector<uint8_t> buf; std::string fname; };
+// A layer image inside the archive. It is extracted only when the layer gets vectorized.
+struct PNGEntry { mz_uint file_index; std::string fname; };
 struct ArchiveData {
+    std::string zipfname;
     boost::property_tree::ptree profile, config;
-    std::vector<PNGBuffer> images;
+    std::vector<PNGEntry> images;
 };
 
 static const constexpr char *CONFIG_FNAME  = "config.ini";
 static const constexpr char *PROFILE_FNAME = "prusaslicer.ini";
 
+// Little RAII
+struct ZipReader: public MZ_Archive {
+    ZipReader(const std::string &fname) {
+        if (!open_zip_reader(&arch, fname))
+            throw Slic3r::FileIOError(get_errorstr());
+    }
+
+    ~ZipReader() { close_zip_reader(&arch); }
+};
+
 boost::property_tree::ptree read_ini(const mz_zip_archive_file_stat &entry,
                                      MZ_Archive &                    zip)
 {
@@ -74,33 +92,27 @@ boost::property_tree::ptree read_ini(const mz_zip_archive_file_stat &entry,
     return tree;
 }
 
-PNGBuffer read_png(const mz_zip_archive_file_stat &entry,
-                   MZ_Archive &                    zip,
-                   const std::string &             name)
+void read_png(const PNGEntry &entry, MZ_Archive &zip, std::vector<uint8_t> &buf)
 {
-    std::vector<uint8_t> buf(entry.m_uncomp_size);
-
-    if (!mz_zip_reader_extract_file_to_mem(&zip.arch, entry.m_filename,
-                                           buf.data(), buf.size(), 0))
+    mz_zip_archive_file_stat stat;
+    if (!mz_zip_reader_file_stat(&zip.arch, entry.file_index, &stat))
         throw Slic3r::FileIOError(zip.get_errorstr());
 
-    return {std::move(buf), (name.empty() ? entry.m_filename : name)};
+    buf.resize(size_t(stat.m_uncomp_size));
+    if (!mz_zip_reader_extract_to_mem(&zip.arch, entry.file_index,
+                                      buf.data(), buf.size(), 0))
+        throw Slic3r::FileIOError(zip.get_errorstr());
 }
 
+// Reads the metadata of the archive and lists the layer images, the images
+// themselves are not extracted.
 ArchiveData extract_sla_archive(const std::string &zipfname,
                                 const std::string &exclude)
 {
     ArchiveData arch;
+    arch.zipfname = zipfname;
 
-    // Little RAII
-    struct Arch: public MZ_Archive {
-        Arch(const std::string &fname) {
-            if (!open_zip_reader(&arch, fname))
-                throw Slic3r::FileIOError(get_errorstr());
-        }
-
-        ~Arch() { close_zip_reader(&arch); }
-    } zip (zipfname);
+    ZipReader zip(zipfname);
 
     mz_uint num_entries = mz_zip_reader_get_num_files(&zip.arch);
 
@@ -118,18 +130,16 @@ ArchiveData extract_sla_archive(const std::string &zipfname,
             if (name == CONFIG_FNAME) arch.config = read_ini(entry, zip);
             if (name == PROFILE_FNAME) arch.profile = read_ini(entry, zip);
 
-            if (boost::filesystem::path(name).extension().string() == ".png") {
-                auto it = std::lower_bound(
-                    arch.images.begin(), arch.images.end(), PNGBuffer{{}, name},
-                    [](const PNGBuffer &r1, const PNGBuffer &r2) {
-                        return std::less<std::string>()(r1.fname, r2.fname);
-                    });
-
-                arch.images.insert(it, read_png(entry, zip, name));
-            }
+            if (boost::filesystem::path(name).extension().string() == ".png")
+                arch.images.push_back({i, name});
         }
     }
 
+    std::sort(arch.images.begin(), arch.images.end(),
+              [](const PNGEntry &r1, const PNGEntry &r2) {
+                  return std::less<std::string>()(r1.fname, r2.fname);
+              });
+
     return arch;
 }
 
@@ -252,8 +262,33 @@ std::vector<ExPolygons> extract_slices_from_sla_archive(
         tbb::spin_mutex mutex = {};
     } st {100. / slices.size(), 0., 0.};
 
+    // Time spent in the individual stages, summed over all the worker threads.
+    struct StageTimes
+    {
+        std::atomic<int64_t> extract{0}, decode{0}, vectorize{0};
+    } times;
+
+    // Each worker thread extracts the images through its own zip reader, as
+    // a miniz archive must not be read from more threads at once. Only the
+    // layers being processed are held in memory, one per thread.
+    struct Worker
+    {
+        std::unique_ptr<ZipReader> zip;
+        std::vector<uint8_t>       buf;
+    };
+    tbb::enumerable_thread_specific<Worker> workers;
+
+    auto elapsed_us = [](std::chrono::steady_clock::time_point &start) {
+        auto now = std::chrono::steady_clock::now();
+        auto ret = std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+        start = now;
+        return int64_t(ret);
+    };
+
+    auto start_time = std::chrono::steady_clock::now();
+
     tbb::parallel_for(size_t(0), arch.images.size(),
-                     [&arch, &slices, &st, &rstp, progr](size_t i) {
+                     [&arch, &slices, &st, &rstp, &times, &workers, &elapsed_us, progr](size_t i) {
         // Status indication guarded with the spinlock
         {
             std::lock_guard<tbb::spin_mutex> lck(st.mutex);
@@ -267,9 +302,19 @@ std::vector<ExPolygons> extract_slices_from_sla_archive(
             }
         }
 
+        Worker &worker = workers.local();
+        if (!worker.zip)
+            worker.zip = std::make_unique<ZipReader>(arch.zipfname);
+
+        auto t = std::chrono::steady_clock::now();
+        read_png(arch.images[i], *worker.zip, worker.buf);
+        times.extract += elapsed_us(t);
+
         png::ImageGreyscale img;
-        png::ReadBuf rb{arch.images[i].buf.data(), arch.images[i].buf.size()};
-        if (!png::decode_png(rb, img)) return;
+        png::ReadBuf rb{worker.buf.data(), worker.buf.size()};
+        bool decoded = png::decode_png(rb, img);
+        times.decode += elapsed_us(t);
+        if (!decoded) return;
 
         uint8_t isoval = 128;
         auto rings = marchsq::execute(img, isoval, rstp.win);
@@ -279,8 +324,14 @@ std::vector<ExPolygons> extract_slices_from_sla_archive(
         invert_raster_trafo(expolys, rstp.trafo, rstp.width, rstp.height);
 
         slices[i] = std::move(expolys);
+        times.vectorize += elapsed_us(t);
     });
 
+    BOOST_LOG_TRIVIAL(info) << "SLA archive import: " << arch.images.size() << " layers in "
+                            << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count()
+                            << " ms using " << workers.size() << " threads, cpu time: extract " << times.extract / 1000
+                            << " ms, decode " << times.decode / 1000 << " ms, vectorize " << times.vectorize / 1000 << " ms";
+
     if (st.stop) slices = {};
 
     return slices;
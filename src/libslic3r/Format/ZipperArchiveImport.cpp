@@ -8,6 +8,11 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/enumerable_thread_specific.h>
+
+#include <memory>
+
 namespace Slic3r {
 
 namespace {
@@ -42,6 +47,18 @@ EntryBuffer read_entry(const mz_zip_archive_file_stat &entry,
     return {std::move(buf), (name.empty() ? entry.m_filename : name)};
 }
 
+// Little RAII
+struct Arch : public MZ_Archive
+{
+    Arch(const std::string &fname)
+    {
+        if (!open_zip_reader(&arch, fname))
+            throw Slic3r::FileIOError(get_errorstr());
+    }
+
+    ~Arch() { close_zip_reader(&arch); }
+};
+
 } // namespace
 
 ZipperArchive read_zipper_archive(const std::string &zipfname,
@@ -50,20 +67,13 @@ ZipperArchive read_zipper_archive(const std::string &zipfname,
 {
     ZipperArchive arch;
 
-    // Little RAII
-    struct Arch : public MZ_Archive
-    {
-        Arch(const std::string &fname)
-        {
-            if (!open_zip_reader(&arch, fname))
-                throw Slic3r::FileIOError(get_errorstr());
-        }
-
-        ~Arch() { close_zip_reader(&arch); }
-    } zip(zipfname);
+    Arch zip(zipfname);
 
     mz_uint num_entries = mz_zip_reader_get_num_files(&zip.arch);
 
+    // Entries to extract, the index into the archive and the lowercase name.
+    std::vector<std::pair<mz_uint, std::string>> to_extract;
+
     for (mz_uint i = 0; i < num_entries; ++i) {
         mz_zip_archive_file_stat entry;
 
@@ -93,17 +103,32 @@ ZipperArchive read_zipper_archive(const std::string &zipfname,
                 continue;
             }
 
-            auto it = std::lower_bound(
-                arch.entries.begin(), arch.entries.end(),
-                EntryBuffer{{}, name},
-                [](const EntryBuffer &r1, const EntryBuffer &r2) {
-                    return std::less<std::string>()(r1.fname, r2.fname);
-                });
-
-            arch.entries.insert(it, read_entry(entry, zip, name));
+            to_extract.emplace_back(i, std::move(name));
         }
     }
 
+    std::sort(to_extract.begin(), to_extract.end(),
+              [](const auto &e1, const auto &e2) {
+                  return std::less<std::string>()(e1.second, e2.second);
+              });
+
+    // The entries are decompressed in parallel. A miniz archive must not be
+    // read from more threads at once, so every thread opens its own reader.
+    arch.entries.resize(to_extract.size());
+    tbb::enumerable_thread_specific<std::unique_ptr<Arch>> readers;
+    tbb::parallel_for(size_t(0), to_extract.size(),
+                      [&arch, &to_extract, &readers, &zipfname](size_t i) {
+        std::unique_ptr<Arch> &reader = readers.local();
+        if (!reader)
+            reader = std::make_unique<Arch>(zipfname);
+
+        mz_zip_archive_file_stat entry;
+        if (!mz_zip_reader_file_stat(&reader->arch, to_extract[i].first, &entry))
+            throw Slic3r::FileIOError(reader->get_errorstr());
+
+        arch.entries[i] = read_entry(entry, *reader, to_extract[i].second);
+    });
+
     return arch;
 }
 
@@ -7,6 +7,7 @@
 #include "../GCode.hpp"
 #include "../Geometry.hpp"
 #include "../GCode/ThumbnailData.hpp"
+#include "../PNGReadWrite.hpp"
 #include "../Semver.hpp"
 #include "../Time.hpp"
 
@@ -5457,6 +5458,8 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
         std::string m_thumbnail_small  = PRINTER_THUMBNAIL_SMALL_FILE;
         std::map<void const *, std::pair<ObjectData*, ModelVolume const *>> m_shared_meshes;
         std::map<ModelVolume const *, std::pair<std::string, int>> m_volume_paths;
+        // thumbnails encoded to png ahead of adding them into the archive
+        std::map<ThumbnailData const *, std::vector<uint8_t>> m_encoded_thumbnails;
     public:
         //BBS: add plate data related logic
 
@@ -5488,6 +5491,7 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
 
         bool _add_content_types_file_to_archive(mz_zip_archive& archive);
 
+        void _encode_thumbnails(const std::vector<const std::vector<ThumbnailData*>*>& thumbnail_lists);
         bool _add_thumbnail_file_to_archive(mz_zip_archive& archive, const ThumbnailData& thumbnail_data, const char* local_path, int index, bool generate_small_thumbnail = false);
         bool _add_calibration_file_to_archive(mz_zip_archive& archive, const ThumbnailData& thumbnail_data, int index);
         bool _add_bbox_file_to_archive(mz_zip_archive& archive, const PlateBBoxData& id_bboxes, int index);
@@ -5740,6 +5744,9 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
                     return false;
             }
 
+            _encode_thumbnails({ &thumbnail_data, &no_light_thumbnail_data, &top_thumbnail_data, &pick_thumbnail_data });
+            Slic3r::ScopeGuard encoded_thumbnails_guard([this]() { m_encoded_thumbnails.clear(); });
+
             for (unsigned int index = 0; index < thumbnail_data.size(); index++)
             {
                 if (thumbnail_data[index]->is_valid())
@@ -6138,16 +6145,41 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
         return true;
     }
 
+    // The png encoding of the plate thumbnails dominates writing them, so encode all of them in parallel first.
+    void _BBS_3MF_Exporter::_encode_thumbnails(const std::vector<const std::vector<ThumbnailData*>*>& thumbnail_lists)
+    {
+        std::vector<const ThumbnailData*> to_encode;
+        for (const std::vector<ThumbnailData*>* thumbnails : thumbnail_lists)
+            for (const ThumbnailData* thumbnail : *thumbnails)
+                if (thumbnail != nullptr && thumbnail->is_valid() && std::find(to_encode.begin(), to_encode.end(), thumbnail) == to_encode.end())
+                    to_encode.push_back(thumbnail);
+
+        std::vector<std::vector<uint8_t>> encoded(to_encode.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, to_encode.size(), 1), [&to_encode, &encoded](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                const ThumbnailData& thumbnail = *to_encode[i];
+                if (!png::encode_png(thumbnail.pixels.data(), thumbnail.width, thumbnail.height, 4, encoded[i], true))
+                    encoded[i].clear();
+            }
+        });
+
+        for (size_t i = 0; i < to_encode.size(); ++ i)
+            m_encoded_thumbnails[to_encode[i]] = std::move(encoded[i]);
+    }
+
     bool _BBS_3MF_Exporter::_add_thumbnail_file_to_archive(mz_zip_archive& archive, const ThumbnailData& thumbnail_data, const char* local_path, int index, bool generate_small_thumbnail)
     {
         bool res = false;
 
-        size_t png_size = 0;
-        void* png_data = tdefl_write_image_to_png_file_in_memory_ex((const void*)thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, &png_size, MZ_DEFAULT_COMPRESSION, 1);
-        if (png_data != nullptr) {
+        std::vector<uint8_t> png_data;
+        const std::vector<uint8_t>* encoded = &png_data;
+        if (auto it = m_encoded_thumbnails.find(&thumbnail_data); it != m_encoded_thumbnails.end())
+            encoded = &it->second;
+        else
+            png::encode_png(thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, png_data, true);
+        if (!encoded->empty()) {
             std::string thumbnail_name = (boost::format("%1%_%2%.png")%local_path % (index + 1)).str();
-            res = mz_zip_writer_add_mem(&archive, thumbnail_name.c_str(), (const void*)png_data, png_size, MZ_NO_COMPRESSION);
-            mz_free(png_data);
+            res = mz_zip_writer_add_mem(&archive, thumbnail_name.c_str(), (const void*)encoded->data(), encoded->size(), MZ_NO_COMPRESSION);
         }
 
         if (!res) {
@@ -6187,12 +6219,10 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
                     //memcpy((void*)&small_pixels[4*(i / sw * PLATE_THUMBNAIL_SMALL_WIDTH + j / sh)], thumbnail_data.pixels.data() + 4*(i * thumbnail_data.width + j), 4);
                 }
             }
-            size_t small_png_size = 0;
-            void* small_png_data = tdefl_write_image_to_png_file_in_memory_ex((const void*)small_pixels.data(), PLATE_THUMBNAIL_SMALL_WIDTH, PLATE_THUMBNAIL_SMALL_HEIGHT, 4, &small_png_size, MZ_DEFAULT_COMPRESSION, 1);
-            if (png_data != nullptr) {
+            std::vector<uint8_t> small_png_data;
+            if (png::encode_png(small_pixels.data(), PLATE_THUMBNAIL_SMALL_WIDTH, PLATE_THUMBNAIL_SMALL_HEIGHT, 4, small_png_data, true)) {
                 std::string thumbnail_name = (boost::format("%1%_%2%_small.png") % local_path % (index + 1)).str();
-                res = mz_zip_writer_add_mem(&archive, thumbnail_name.c_str(), (const void*)small_png_data, small_png_size, MZ_NO_COMPRESSION);
-                mz_free(small_png_data);
+                res = mz_zip_writer_add_mem(&archive, thumbnail_name.c_str(), (const void*)small_png_data.data(), small_png_data.size(), MZ_NO_COMPRESSION);
             }
 
             if (!res) {
@@ -0,0 +1,281 @@
+#include "FuzzySkin.hpp"
+#include "Thread.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <boost/functional/hash.hpp>
+
+namespace Slic3r {
+
+namespace {
+
+static constexpr uint64_t golden_gamma = 0x9E3779B97F4A7C15ull;
+
+// Finalizer of SplitMix64.
+inline uint64_t mix64(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Counter based SplitMix64 stream of uniform values in [0, 1), produced in batches.
+// The i-th value only depends on the stream key and on i, thus the iterations of the loop filling a batch are
+// independent and they overlap in the pipeline. The loop is not vectorized, x86-64 has no packed 64bit multiply
+// below AVX-512. The mt19937 + uniform_real_distribution pair used before produced a value at a time from
+// a serially updated state.
+class RandomStream
+{
+public:
+    explicit RandomStream(uint64_t key) : m_state(key) {}
+
+    double next()
+    {
+        if (m_next == BatchSize)
+            this->refill();
+        return m_batch[m_next ++];
+    }
+
+private:
+    static constexpr size_t BatchSize = 64;
+
+    void refill()
+    {
+        for (size_t i = 0; i < BatchSize; ++ i)
+            m_batch[i] = double(mix64(m_state + (i + 1) * golden_gamma) >> 11) * 0x1.0p-53;
+        m_state += BatchSize * golden_gamma;
+        m_next   = 0;
+    }
+
+    uint64_t                        m_state;
+    size_t                          m_next { BatchSize };
+    std::array<double, BatchSize>   m_batch;
+};
+
+// Doubled permutation table of the gradient noises. It is shuffled with a fixed key by a portable Fisher-Yates
+// (the permutation of std::shuffle is implementation defined), so that the noise field is the same on all platforms.
+struct NoisePermutation
+{
+    std::array<uint8_t, 512> p;
+
+    NoisePermutation()
+    {
+        std::array<uint8_t, 256> base;
+        std::iota(base.begin(), base.end(), 0);
+        for (size_t i = 255; i > 0; -- i)
+            std::swap(base[i], base[mix64(0x5EED5EED5EED5EEDull + i * golden_gamma) % (i + 1)]);
+        for (size_t i = 0; i < 512; ++ i)
+            p[i] = base[i & 255];
+    }
+};
+
+const NoisePermutation& noise_permutation()
+{
+    static const NoisePermutation permutation;
+    return permutation;
+}
+
+inline int fast_floor(double v) { int i = int(v); return v < i ? i - 1 : i; }
+
+inline double fade(double t) { return t * t * t * (t * (t * 6. - 15.) + 10.); }
+
+inline double lerp(double t, double a, double b) { return a + t * (b - a); }
+
+inline double perlin_grad(int hash, double x, double y, double z)
+{
+    const int    h = hash & 15;
+    const double u = h < 8 ? x : y;
+    const double v = h < 4 ? y : (h == 12 || h == 14) ? x : z;
+    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+}
+
+// Improved Perlin noise (Perlin 2002), in <-1, 1>.
+double perlin_noise(const uint8_t *p, double x, double y, double z)
+{
+    const int ix = fast_floor(x), iy = fast_floor(y), iz = fast_floor(z);
+    x -= ix; y -= iy; z -= iz;
+    const int    X = ix & 255, Y = iy & 255, Z = iz & 255;
+    const double u = fade(x), v = fade(y), w = fade(z);
+    const int    A = p[X] + Y, AA = p[A] + Z, AB = p[A + 1] + Z;
+    const int    B = p[X + 1] + Y, BA = p[B] + Z, BB = p[B + 1] + Z;
+    return lerp(w, lerp(v, lerp(u, perlin_grad(p[AA],     x,      y,      z),      perlin_grad(p[BA],     x - 1., y,      z)),
+                           lerp(u, perlin_grad(p[AB],     x,      y - 1., z),      perlin_grad(p[BB],     x - 1., y - 1., z))),
+                   lerp(v, lerp(u, perlin_grad(p[AA + 1], x,      y,      z - 1.), perlin_grad(p[BA + 1], x - 1., y,      z - 1.)),
+                           lerp(u, perlin_grad(p[AB + 1], x,      y - 1., z - 1.), perlin_grad(p[BB + 1], x - 1., y - 1., z - 1.))));
+}
+
+// 3D simplex noise (Gustavson), in <-1, 1>.
+double simplex_noise(const uint8_t *p, double x, double y, double z)
+{
+    static constexpr int    grad3[12][3] = { { 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 },
+                                             { 1, 0, 1 }, { -1, 0, 1 }, { 1, 0, -1 }, { -1, 0, -1 },
+                                             { 0, 1, 1 }, { 0, -1, 1 }, { 0, 1, -1 }, { 0, -1, -1 } };
+    static constexpr double F3 = 1. / 3.;
+    static constexpr double G3 = 1. / 6.;
+
+    // Skew the input space to find the simplex cell and unskew the cell origin back.
+    const double s = (x + y + z) * F3;
+    const int    i = fast_floor(x + s), j = fast_floor(y + s), k = fast_floor(z + s);
+    const double t = (i + j + k) * G3;
+    const double x0 = x - (i - t), y0 = y - (j - t), z0 = z - (k - t);
+
+    // Offsets of the second and third corners of the simplex.
+    int i1, j1, k1, i2, j2, k2;
+    if (x0 >= y0) {
+        if (y0 >= z0)      { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+        else if (x0 >= z0) { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1; }
+        else               { i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1; }
+    } else {
+        if (y0 < z0)       { i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1; }
+        else if (x0 < z0)  { i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1; }
+        else               { i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+    }
+
+    const int ii = i & 255, jj = j & 255, kk = k & 255;
+    auto corner = [p, ii, jj, kk](int di, int dj, int dk, double cx, double cy, double cz) {
+        double t = 0.6 - cx * cx - cy * cy - cz * cz;
+        if (t < 0.)
+            return 0.;
+        const int *g = grad3[p[ii + di + p[jj + dj + p[kk + dk]]] % 12];
+        t *= t;
+        return t * t * (g[0] * cx + g[1] * cy + g[2] * cz);
+    };
+    return 32. * (corner(0, 0, 0, x0, y0, z0) +
+                  corner(i1, j1, k1, x0 - i1 + G3, y0 - j1 + G3, z0 - k1 + G3) +
+                  corner(i2, j2, k2, x0 - i2 + 2. * G3, y0 - j2 + 2. * G3, z0 - k2 + 2. * G3) +
+                  corner(1, 1, 1, x0 - 1. + 3. * G3, y0 - 1. + 3. * G3, z0 - 1. + 3. * G3));
+}
+
+template<typename PointRange, typename PointOf>
+uint64_t random_stream_key(const PointRange &points, PointOf point_of, const FuzzySkinConfig &cfg)
+{
+    if (cfg.noise_type == FuzzySkinNoiseType::Classic && ! deterministic_execution()) {
+        thread_local std::random_device rd;
+        // Hash thread ID for random number seed if no hardware rng seed is available
+        thread_local std::mt19937_64 gen(rd.entropy() > 0 ? rd() : std::hash<std::thread::id>()(std::this_thread::get_id()));
+        return gen();
+    }
+    // Seeded by the path itself, so that the sequence does not depend on which paths were fuzzified
+    // by the same thread before.
+    size_t seed = points.size();
+    boost::hash_combine(seed, cfg.layer_id);
+    for (const auto &pt : points) {
+        const Point &p = point_of(pt);
+        boost::hash_combine(seed, p.x());
+        boost::hash_combine(seed, p.y());
+    }
+    return uint64_t(seed);
+}
+
+// Places the fuzzy points along the segments of a path, carrying the distance left over between the segments.
+class FuzzySampler
+{
+public:
+    FuzzySampler(const FuzzySkinConfig &cfg, uint64_t key) :
+        m_noise_type(cfg.noise_type),
+        m_thickness(cfg.thickness),
+        // hardcoded: the point distance may vary between 3/4 and 5/4 the supplied value
+        m_min_dist(cfg.point_distance * 3. / 4.),
+        m_range_dist(cfg.point_distance / 2.),
+        m_inv_scale(cfg.noise_scale > 0. ? 1. / cfg.noise_scale : 0.),
+        m_z(cfg.z * m_inv_scale),
+        m_random(key)
+    {
+        // the distance to be traversed on the line before making the first new point
+        m_dist_left_over = m_random.next() * (m_min_dist / 2.);
+    }
+
+    template<typename Emit>
+    void sample(const Point &p0, const Point &p1, Emit &&emit)
+    {
+        const Vec2d  p0p1      = (p1 - p0).cast<double>();
+        const double p0p1_size = p0p1.norm();
+        double       p0pa_dist = m_dist_left_over;
+        if (p0pa_dist < p0p1_size) {
+            const Vec2d dir    = p0p1 / p0p1_size;
+            const Vec2d normal = perp(dir);
+            for (; p0pa_dist < p0p1_size; p0pa_dist += m_min_dist + m_random.next() * m_range_dist) {
+                const Vec2d offset = dir * p0pa_dist;
+                emit(p0 + (offset + normal * this->displacement(p0.cast<double>() + offset)).cast<coord_t>());
+            }
+        }
+        m_dist_left_over = p0pa_dist - p0p1_size;
+    }
+
+private:
+    double displacement(const Vec2d &pt)
+    {
+        switch (m_noise_type) {
+        case FuzzySkinNoiseType::Perlin:
+            return m_thickness * std::clamp(perlin_noise(noise_permutation().p.data(), pt.x() * m_inv_scale, pt.y() * m_inv_scale, m_z), -1., 1.);
+        case FuzzySkinNoiseType::Simplex:
+            return m_thickness * std::clamp(simplex_noise(noise_permutation().p.data(), pt.x() * m_inv_scale, pt.y() * m_inv_scale, m_z), -1., 1.);
+        case FuzzySkinNoiseType::Classic:
+        default:
+            return m_random.next() * (m_thickness * 2.) - m_thickness;
+        }
+    }
+
+    FuzzySkinNoiseType  m_noise_type;
+    double              m_thickness;
+    double              m_min_dist;
+    double              m_range_dist;
+    double              m_inv_scale;
+    double              m_z;
+    double              m_dist_left_over;
+    RandomStream        m_random;
+};
+
+} // namespace
+
+// Thanks Cura developers for this function.
+void fuzzy_polygon(Polygon &poly, const FuzzySkinConfig &cfg)
+{
+    FuzzySampler sampler(cfg, random_stream_key(poly.points, [](const Point &p) -> const Point& { return p; }, cfg));
+    // The output is swapped with the input, the input buffer is then reused by the next call.
+    thread_local Points out;
+    out.clear();
+    auto emit = [](const Point &p) { out.emplace_back(p); };
+    const Point *p0 = &poly.points.back();
+    for (const Point &p1 : poly.points) {
+        sampler.sample(*p0, p1, emit);
+        p0 = &p1;
+    }
+    for (size_t point_idx = poly.size() - 1; out.size() < 3 && point_idx > 0; -- point_idx)
+        out.emplace_back(poly[point_idx - 1]);
+    if (out.size() >= 3)
+        poly.points.swap(out);
+}
+
+// Thanks Cura developers for this function.
+void fuzzy_extrusion_line(Arachne::ExtrusionLine &ext_lines, const FuzzySkinConfig &cfg)
+{
+    FuzzySampler sampler(cfg, random_stream_key(ext_lines, [](const Arachne::ExtrusionJunction &j) -> const Point& { return j.p; }, cfg));
+    thread_local std::vector<Arachne::ExtrusionJunction> out;
+    out.clear();
+    const Arachne::ExtrusionJunction *p0 = &ext_lines.front();
+    for (const Arachne::ExtrusionJunction &p1 : ext_lines) {
+        if (p0->p == p1.p) { // Connect endpoints.
+            out.emplace_back(p1.p, p1.w, p1.perimeter_index);
+            continue;
+        }
+        // 'a' is the (next) new point between p0 and p1
+        sampler.sample(p0->p, p1.p, [&p1](const Point &p) { out.emplace_back(p, p1.w, p1.perimeter_index); });
+        p0 = &p1;
+    }
+    for (size_t point_idx = ext_lines.size() - 1; out.size() < 3 && point_idx > 0; -- point_idx) {
+        const Arachne::ExtrusionJunction &j = ext_lines.junctions[point_idx - 1];
+        out.emplace_back(j.p, j.w, j.perimeter_index);
+    }
+    if (ext_lines.back().p == ext_lines.front().p) // Connect endpoints.
+        out.front().p = out.back().p;
+    if (out.size() >= 3)
+        ext_lines.junctions.swap(out);
+}
+
+} // namespace Slic3r
@@ -0,0 +1,36 @@
+#ifndef slic3r_FuzzySkin_hpp_
+#define slic3r_FuzzySkin_hpp_
+
+#include "Polygon.hpp"
+#include "PrintConfig.hpp"
+#include "Arachne/utils/ExtrusionLine.hpp"
+
+namespace Slic3r {
+
+// Parameters of the fuzzy skin of a layer, lengths in scaled coordinates.
+struct FuzzySkinConfig
+{
+    FuzzySkinNoiseType noise_type { FuzzySkinNoiseType::Classic };
+    // Maximum displacement of a point from the path, to either side.
+    double             thickness { 0. };
+    // Average distance of the points introduced along the path.
+    double             point_distance { 0. };
+    // Feature size of the coherent noises.
+    double             noise_scale { 0. };
+    // Z of the layer, the coherent noises are sampled in 3D to stay continuous across layers.
+    double             z { 0. };
+    int                layer_id { 0 };
+};
+
+// Resample the path with points spaced randomly between 3/4 and 5/4 of the point distance and displace them
+// along the path normal. The classic noise draws the displacements from a random stream, the coherent noises
+// evaluate a fixed 3D noise field at the point position. The random stream of the coherent noises is seeded
+// by the layer and the path, so that their result is reproducible between runs; the classic noise does so
+// only in deterministic execution mode.
+// The path is replaced in place, the buffers are recycled between the calls of a thread.
+void fuzzy_polygon(Polygon &poly, const FuzzySkinConfig &cfg);
+void fuzzy_extrusion_line(Arachne::ExtrusionLine &ext_lines, const FuzzySkinConfig &cfg);
+
+} // namespace Slic3r
+
+#endif // slic3r_FuzzySkin_hpp_
@@ -9,6 +9,7 @@
 #include "ExtrusionEntity.hpp"
 #include "EdgeGrid.hpp"
 #include "Geometry/ConvexHull.hpp"
+#include "GCode/GCodeStream.hpp"
 #include "GCode/PrintExtents.hpp"
 #include "GCode/Thumbnails.hpp"
 #include "GCode/WipeTower.hpp"
@@ -19,6 +20,7 @@
 #include "libslic3r.h"
 #include "LocalesUtils.hpp"
 #include "libslic3r/format.hpp"
+#include "Thread.hpp"
 #include "Time.hpp"
 #include "GCode/ExtrusionProcessor.hpp"
 #include <algorithm>
@@ -1417,10 +1419,13 @@ bool GCode::is_BBL_Printer()
     return false;
 }
 
-void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb)
+void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb, GCodeStream* stream)
 {
     PROFILE_CLEAR();
 
+    // Release the consumer of the stream if the export fails or is skipped.
+    ScopeGuard stream_guard([stream]() { if (stream != nullptr) stream->abort(); });
+
     // BBS
     m_curr_print = print;
 
@@ -1477,6 +1482,7 @@ void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* resu
         }
         throw Slic3r::RuntimeError(std::string("G-code export to ") + path + " failed.\nCannot open the file for writing.\n");
     }
+    file.set_stream(stream);
 
     try {
         this->_do_export(*print, file, thumbnail_cb);
@@ -1557,12 +1563,21 @@ void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* resu
     m_processor.finalize(true);
 //    DoExport::update_print_estimated_times_stats(m_processor, print->m_print_statistics);
     DoExport::update_print_estimated_stats(m_processor, m_writer.extruders(), print->m_print_statistics, print->config());
+    if (stream != nullptr) {
+        // The footer was held back, send it as rewritten by the post-processing, followed by the layer count
+        // replacing the placeholder in the header, which was not streamed.
+        stream->finish(GCodeStream::read_footer(path_tmp) + "; total layer number: " + std::to_string(m_processor.get_layers_count()) + "\n");
+        stream_guard.reset();
+    }
     if (result != nullptr) {
         *result = std::move(m_processor.extract_result());
         // set the filename to the correct value
         result->filename = path;
     }
 
+    if (print->config().binary_gcode)
+        this->convert_to_binary_gcode(*print, path_tmp);
+
     //BBS: add some log for error output
     BOOST_LOG_TRIVIAL(debug) << boost::format("Finished processing gcode to %1% ") % path_tmp;
 
@@ -1576,6 +1591,12 @@ void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* resu
         BOOST_LOG_TRIVIAL(info) << boost::format("rename_file from %1% to %2% successfully")% path_tmp % path;
     }
 
+    print->m_print_statistics.travel_length_saved = unscaled(m_avoid_crossing_perimeters.grid_travel_length_saved());
+    print->m_print_statistics.travel_time_saved   = m_avoid_crossing_perimeters.grid_travel_time_saved();
+    if (m_config.reduce_crossing_wall && m_config.travel_planner.value == TravelPlanner::Grid)
+        BOOST_LOG_TRIVIAL(info) << boost::format("Grid travel planner shortened the travels by %1% mm, saving %2% s of travel time")
+                                   % print->m_print_statistics.travel_length_saved
+                                   % print->m_print_statistics.travel_time_saved;
     BOOST_LOG_TRIVIAL(info) << "Exporting G-code finished" << log_memory_info();
     print->set_done(psGCodeExport);
     
@@ -1587,6 +1608,54 @@ void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* resu
     PROFILE_OUTPUT(debug_out_path("gcode-export-profile.txt").c_str());
 }
 
+void GCode::convert_to_binary_gcode(const Print &print, const std::string &path)
+{
+    BOOST_LOG_TRIVIAL(debug) << "Converting G-code to binary G-code, " << log_memory_info();
+    const DynamicPrintConfig &cfg   = print.full_print_config();
+    const PrintStatistics    &stats = print.print_statistics();
+
+    BinaryGCode::BinaryData data;
+    data.file_metadata.emplace_back("Producer", header_slic3r_generated());
+    data.printer_metadata.emplace_back("printer_model", cfg.opt_serialize("printer_model"));
+    data.printer_metadata.emplace_back("filament_type", cfg.opt_serialize("filament_type"));
+    data.printer_metadata.emplace_back("nozzle_diameter", cfg.opt_serialize("nozzle_diameter"));
+    data.print_metadata.emplace_back("estimated printing time (normal mode)", stats.estimated_normal_print_time);
+    data.print_metadata.emplace_back("filament used [mm]", float_to_string_decimal_point(stats.total_used_filament, 2));
+    data.print_metadata.emplace_back("filament used [g]", float_to_string_decimal_point(stats.total_weight, 2));
+    data.print_metadata.emplace_back("total layers count", std::to_string(m_layer_count));
+    // Same keys and values as the config block of the ASCII G-code.
+    std::string full_config;
+    append_full_config(print, full_config);
+    std::istringstream full_config_stream(full_config);
+    for (std::string line; std::getline(full_config_stream, line);)
+        if (size_t eq = line.find(" = "); boost::starts_with(line, "; ") && eq != std::string::npos)
+            data.slicer_metadata.emplace_back(line.substr(2, eq - 2), line.substr(eq + 3));
+    data.thumbnails = std::move(m_binary_thumbnails);
+    m_binary_thumbnails.clear();
+
+    std::string path_binary = path + ".binary";
+    {
+        FilePtr src{ boost::nowide::fopen(path.c_str(), "rb") };
+        FilePtr dst{ boost::nowide::fopen(path_binary.c_str(), "wb") };
+        if (src.f == nullptr || dst.f == nullptr)
+            throw Slic3r::RuntimeError(std::string("Failed to open ") + path + " for conversion to binary G-code\n");
+        try {
+            BinaryGCode::convert_ascii_to_binary(src.f, dst.f, data, BinaryGCode::BinarizerConfig());
+        } catch (const std::exception &) {
+            dst.close();
+            boost::nowide::remove(path_binary.c_str());
+            throw;
+        }
+        if (::fflush(dst.f) != 0) {
+            dst.close();
+            boost::nowide::remove(path_binary.c_str());
+            throw Slic3r::RuntimeError(std::string("G-code export to ") + path + " failed\nIs the disk full?\n");
+        }
+    }
+    if (std::error_code ret = rename_file(path_binary, path); ret)
+        throw Slic3r::RuntimeError(std::string("Failed to rename the binary G-code file from ") + path_binary + " to " + path + '\n' + "error code " + ret.message() + '\n');
+}
+
 // free functions called by GCode::_do_export()
 namespace DoExport {
     static void init_gcode_processor(const PrintConfig& config, GCodeProcessor& processor, bool& silent_time_estimator_enabled)
@@ -1895,7 +1964,11 @@ void GCode::_do_export(Print& print, GCodeOutputStream &file, ThumbnailsGenerato
 
     file.write_format("; HEADER_BLOCK_START\n");
     // Write information on the generator.
-    file.write_format("; generated by %s on %s\n", Slic3r::header_slic3r_generated().c_str(), Slic3r::Utils::local_timestamp().c_str());
+    // The time of generation would make G-code of the same input differ between runs in deterministic mode.
+    if (deterministic_execution())
+        file.write_format("; generated by %s\n", Slic3r::header_slic3r_generated().c_str());
+    else
+        file.write_format("; generated by %s on %s\n", Slic3r::header_slic3r_generated().c_str(), Slic3r::Utils::local_timestamp().c_str());
     if (is_bbl_printers)
         file.write_format(";%s\n", GCodeProcessor::reserved_tag(GCodeProcessor::ETags::Estimated_Printing_Time_Placeholder).c_str());
     //BBS: total layer number
@@ -1977,7 +2050,13 @@ void GCode::_do_export(Print& print, GCodeOutputStream &file, ThumbnailsGenerato
                 throw Slic3r::ExportError(error_str);
             }
 
-            if (!thumbnails.empty())
+            if (thumbnails.empty())
+                ;
+            else if (print.config().binary_gcode)
+                // Written into thumbnail blocks by convert_to_binary_gcode().
+                GCodeThumbnails::generate_binary_thumbnails(
+                    thumbnail_cb, print.get_plate_index(), thumbnails, m_binary_thumbnails, [&print]() { print.throw_if_canceled(); });
+            else
                 GCodeThumbnails::export_thumbnails_to_file(
                     thumbnail_cb, print.get_plate_index(), thumbnails, [&file](const char* sz) { file.write(sz); }, [&print]() { print.throw_if_canceled(); });
         }
@@ -2014,7 +2093,8 @@ void GCode::_do_export(Print& print, GCodeOutputStream &file, ThumbnailsGenerato
     // Prepare the helper object for replacing placeholders in custom G-code and output filename.
     m_placeholder_parser_integration.parser = print.placeholder_parser();
     m_placeholder_parser_integration.parser.update_timestamp();
-    m_placeholder_parser_integration.context.rng = std::mt19937(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    m_placeholder_parser_integration.context.rng = deterministic_execution() ? std::mt19937() :
+        std::mt19937(std::chrono::high_resolution_clock::now().time_since_epoch().count());
     // Enable passing global variables between PlaceholderParser invocations.
     m_placeholder_parser_integration.context.global_config = std::make_unique<DynamicConfig>();
     print.update_object_placeholders(m_placeholder_parser_integration.parser.config_writable(), ".gcode");
@@ -4927,7 +5007,10 @@ void GCode::GCodeOutputStream::write(const char *what)
     if (what != nullptr) {
         const char* gcode = what;
         // writes string to file
-        fwrite(gcode, 1, ::strlen(gcode), this->f);
+        size_t len = ::strlen(gcode);
+        fwrite(gcode, 1, len, this->f);
+        if (m_stream != nullptr)
+            m_stream->write(gcode, len);
         //FIXME don't allocate a string, maybe process a batch of lines?
         m_processor.process_buffer(std::string(gcode));
     }
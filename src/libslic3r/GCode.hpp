@@ -9,6 +9,7 @@
 #include "PlaceholderParser.hpp"
 #include "PrintConfig.hpp"
 #include "GCode/AvoidCrossingPerimeters.hpp"
+#include "GCode/BinaryGCode.hpp"
 #include "GCode/CoolingBuffer.hpp"
 #include "GCode/FanMover.hpp"
 #include "GCode/RetractWhenCrossingPerimeters.hpp"
@@ -37,6 +38,7 @@ namespace Slic3r {
 
 // Forward declarations.
 class GCode;
+class GCodeStream;
 
 namespace { struct Item; }
 struct PrintInstance;
@@ -191,7 +193,8 @@ public:
 
     // throws std::runtime_exception on error,
     // throws CanceledException through print->throw_if_canceled().
-    void            do_export(Print* print, const char* path, GCodeProcessorResult* result = nullptr, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    // If stream is set, the G-code is passed to the stream while being exported, see GCodeStream.
+    void            do_export(Print* print, const char* path, GCodeProcessorResult* result = nullptr, ThumbnailsGeneratorCallback thumbnail_cb = nullptr, GCodeStream* stream = nullptr);
 
     //BBS: set offset for gcode writer
     void set_gcode_offset(double x, double y) { m_writer.set_xy_offset(x, y); m_processor.set_xy_offset(x, y);}
@@ -299,11 +302,17 @@ private:
         // Formats and write into a file the given data.
         void write_format(const char* format, ...);
 
+        // Pass everything written into the file to the stream as well.
+        void set_stream(GCodeStream *stream) { m_stream = stream; }
+
     private:
         FILE *f = nullptr;
         GCodeProcessor &m_processor;
+        GCodeStream *m_stream = nullptr;
     };
     void            _do_export(Print &print, GCodeOutputStream &file, ThumbnailsGeneratorCallback thumbnail_cb);
+    // Replaces the finalized ASCII G-code at path by block-compressed binary G-code.
+    void            convert_to_binary_gcode(const Print &print, const std::string &path);
 
     static std::vector<LayerToPrint>        		                   collect_layers_to_print(const PrintObject &object);
     static std::vector<std::pair<coordf_t, std::vector<LayerToPrint>>> collect_layers_to_print(const Print &print);
@@ -577,6 +586,8 @@ private:
 
     // Processor
     GCodeProcessor m_processor;
+    // Thumbnails collected by _do_export() for the binary G-code.
+    std::vector<BinaryGCode::Thumbnail> m_binary_thumbnails;
 
     //some post-processing on the file, with their data class
     std::unique_ptr<FanMover> m_fan_mover;
@@ -1205,6 +1205,34 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCode &gcodegen, const Point &
             result_pl.points.front()  = start;
             result_pl.points.back()   = end;
         }
+
+        if (gcodegen.config().travel_planner.value == TravelPlanner::Grid && !gcodegen.config().printable_area.values.empty()) {
+            // Initialize the occupancy grid only when exist any external travel for the current layer.
+            if (!m_grid_planner_valid) {
+                if (m_grid_planner.empty()) {
+                    Points bed_shape;
+                    for (const Vec2d &pt : gcodegen.config().printable_area.values)
+                        bed_shape.emplace_back(Point::new_scale(pt.x(), pt.y()));
+                    m_grid_planner.init_bed_shape(bed_shape);
+                } else
+                    m_grid_planner.clear();
+                // Keep the same distance from the islands as the boundary walk, see get_boundary_external().
+                m_grid_planner.add_obstacles(*gcodegen.layer(), coord_t(get_perimeter_spacing_external(*gcodegen.layer()) / 2));
+                m_grid_planner_valid = true;
+            }
+            // Use the grid path if it is shorter than the boundary walking. The search fails if its budget is exceeded.
+            Polyline grid_pl = m_grid_planner.find_path(start, end);
+            if (!grid_pl.empty()) {
+                double boundary_length = result_pl.empty() ? travel.length() : result_pl.length();
+                double grid_length     = grid_pl.length();
+                if (grid_length < boundary_length) {
+                    m_grid_travel_length_saved += boundary_length - grid_length;
+                    m_grid_travel_time_saved   += unscaled(boundary_length - grid_length) / std::max(gcodegen.config().travel_speed.value, EPSILON);
+                    result_pl                 = std::move(grid_pl);
+                    travel_intersection_count = 0;
+                }
+            }
+        }
     }
 
     if(result_pl.empty()) {
@@ -1244,6 +1272,7 @@ void AvoidCrossingPerimeters::init_layer(const Layer &layer)
 {
     m_internal.clear();
     m_external.clear();
+    m_grid_planner_valid = false;
     m_lslices_offset.clear();
     m_lslices_offset_bboxes.clear();
 
@@ -4,6 +4,7 @@
 #include "../libslic3r.h"
 #include "../ExPolygon.hpp"
 #include "../EdgeGrid.hpp"
+#include "../JumpPointSearch.hpp"
 
 namespace Slic3r {
 
@@ -33,6 +34,10 @@ public:
 
     Polyline    travel_to(const GCode& gcodegen, const Point& point, bool* could_be_wipe_disabled);
 
+    // Length (scaled) and time (seconds) of the external travels saved by the grid travel planner against the boundary walking.
+    double      grid_travel_length_saved() const { return m_grid_travel_length_saved; }
+    double      grid_travel_time_saved() const { return m_grid_travel_time_saved; }
+
     struct Boundary {
         // Collection of boundaries used for detection of crossing perimeters for travels
         Polygons                        boundaries;
@@ -67,6 +72,12 @@ private:
     Boundary m_internal;
     // Store all needed data for travels outside object
     Boundary m_external;
+    // Occupancy grid of the layer for the travels outside object, used with TravelPlanner::Grid.
+    JPSPathFinder            m_grid_planner;
+    // The grid is built on demand by the first travel outside object of a layer.
+    bool                     m_grid_planner_valid { false };
+    double                   m_grid_travel_length_saved { 0. };
+    double                   m_grid_travel_time_saved { 0. };
 };
 
 } // namespace Slic3r
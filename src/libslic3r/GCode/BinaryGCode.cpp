@@ -0,0 +1,434 @@
+#include "BinaryGCode.hpp"
+
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/format.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/nowide/cstdio.hpp>
+#include <miniz.h>
+
+namespace Slic3r {
+namespace BinaryGCode {
+
+static constexpr const char     Magic[4]        = { 'G', 'C', 'D', 'E' };
+static constexpr const uint32_t Version         = 1;
+static constexpr const uint16_t ChecksumNone    = 0;
+static constexpr const uint16_t ChecksumCRC32   = 1;
+// The only metadata encoding defined by the format: "key=value" lines.
+static constexpr const uint16_t MetadataEncodingINI = 0;
+static constexpr const uint16_t GCodeEncodingNone   = 0;
+
+// 64bit file offsets, long is 32bit on Windows, which limits fseek() / ftell() to 2GB files.
+static int64_t file_tell(FILE *file)
+{
+#ifdef _MSC_VER
+    return int64_t(::_ftelli64(file));
+#else
+    return int64_t(::ftello(file));
+#endif
+}
+
+static int file_seek(FILE *file, int64_t offset, int origin)
+{
+#ifdef _MSC_VER
+    return ::_fseeki64(file, offset, origin);
+#else
+    return ::fseeko(file, off_t(offset), origin);
+#endif
+}
+
+static size_t block_params_size(EBlockType type)
+{
+    return type == EBlockType::Thumbnail ? 6 : 2;
+}
+
+static size_t block_header_size(ECompressionType compression)
+{
+    return compression == ECompressionType::None ? 8 : 12;
+}
+
+static void append_u16(std::string &out, uint16_t value)
+{
+    out.push_back(char(value & 0xff));
+    out.push_back(char(value >> 8));
+}
+
+static void append_u32(std::string &out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++ i)
+        out.push_back(char((value >> (8 * i)) & 0xff));
+}
+
+static uint16_t read_u16(const unsigned char *data)
+{
+    return uint16_t(data[0]) | (uint16_t(data[1]) << 8);
+}
+
+static uint32_t read_u32(const unsigned char *data)
+{
+    return uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+}
+
+static void write_all(FILE *file, const void *data, size_t size)
+{
+    if (size > 0 && ::fwrite(data, 1, size, file) != size)
+        throw Slic3r::RuntimeError("Binary G-code: failed to write the output file");
+}
+
+static void read_all(FILE *file, void *data, size_t size)
+{
+    if (size > 0 && ::fread(data, 1, size, file) != size)
+        throw Slic3r::RuntimeError("Binary G-code: unexpected end of file");
+}
+
+static std::string compress(std::string_view data)
+{
+    mz_ulong    size = mz_compressBound(mz_ulong(data.size()));
+    std::string out(size_t(size), '\0');
+    if (mz_compress2(reinterpret_cast<unsigned char*>(out.data()), &size, reinterpret_cast<const unsigned char*>(data.data()), mz_ulong(data.size()), MZ_DEFAULT_LEVEL) != MZ_OK)
+        throw Slic3r::RuntimeError("Binary G-code: deflate failed");
+    out.resize(size_t(size));
+    return out;
+}
+
+static std::string decompress(const std::string &data, size_t uncompressed_size)
+{
+    std::string out(uncompressed_size, '\0');
+    mz_ulong    size = mz_ulong(uncompressed_size);
+    if (mz_uncompress(reinterpret_cast<unsigned char*>(out.data()), &size, reinterpret_cast<const unsigned char*>(data.data()), mz_ulong(data.size())) != MZ_OK ||
+        size != mz_ulong(uncompressed_size))
+        throw Slic3r::RuntimeError("Binary G-code: corrupted compressed block");
+    return out;
+}
+
+static std::string encode_metadata(const Metadata &metadata)
+{
+    std::string out;
+    for (const auto &[key, value] : metadata) {
+        out += key;
+        out += '=';
+        out += value;
+        out += '\n';
+    }
+    return out;
+}
+
+static Metadata decode_metadata(const std::string &data)
+{
+    Metadata out;
+    size_t   begin = 0;
+    while (begin < data.size()) {
+        size_t end = data.find('\n', begin);
+        if (end == std::string::npos)
+            end = data.size();
+        std::string_view line(data.data() + begin, end - begin);
+        if (size_t eq = line.find('='); eq != std::string_view::npos)
+            out.emplace_back(std::string(line.substr(0, eq)), std::string(line.substr(eq + 1)));
+        begin = end + 1;
+    }
+    return out;
+}
+
+// Layer changes emitted by GCode::process_layer, both for the BBL and the compatible flavor of tags.
+static bool is_layer_change(std::string_view line)
+{
+    auto starts_with = [line](std::string_view prefix) { return line.size() >= prefix.size() && line.substr(0, prefix.size()) == prefix; };
+    return starts_with(";LAYER_CHANGE") || starts_with("; CHANGE_LAYER");
+}
+
+void Binarizer::write_block(EBlockType type, ECompressionType compression, const std::string &params, std::string_view data)
+{
+    assert(params.size() == block_params_size(type));
+    std::string compressed;
+    if (compression == ECompressionType::Deflate) {
+        compressed = compress(data);
+        // Not worth it, store the block uncompressed.
+        if (compressed.size() >= data.size())
+            compression = ECompressionType::None;
+    } else if (compression != ECompressionType::None)
+        throw Slic3r::RuntimeError("Binary G-code: unsupported compression type");
+
+    std::string header;
+    append_u16(header, uint16_t(type));
+    append_u16(header, uint16_t(compression));
+    append_u32(header, uint32_t(data.size()));
+    if (compression != ECompressionType::None)
+        append_u32(header, uint32_t(compressed.size()));
+    header += params;
+
+    std::string_view payload = compression == ECompressionType::None ? data : std::string_view(compressed);
+    mz_ulong crc = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(header.data()), header.size());
+    crc = mz_crc32(crc, reinterpret_cast<const unsigned char*>(payload.data()), payload.size());
+    std::string checksum;
+    append_u32(checksum, uint32_t(crc));
+
+    write_all(m_file, header.data(), header.size());
+    write_all(m_file, payload.data(), payload.size());
+    write_all(m_file, checksum.data(), checksum.size());
+}
+
+void Binarizer::write_metadata(EBlockType type, const Metadata &metadata)
+{
+    std::string params;
+    append_u16(params, MetadataEncodingINI);
+    this->write_block(type, m_config.metadata_compression, params, encode_metadata(metadata));
+}
+
+void Binarizer::write_header(const BinaryData &data)
+{
+    std::string header(Magic, Magic + 4);
+    append_u32(header, Version);
+    append_u16(header, ChecksumCRC32);
+    write_all(m_file, header.data(), header.size());
+
+    // Block order prescribed by the format.
+    if (! data.file_metadata.empty())
+        this->write_metadata(EBlockType::FileMetadata, data.file_metadata);
+    this->write_metadata(EBlockType::PrinterMetadata, data.printer_metadata);
+    for (const Thumbnail &thumbnail : data.thumbnails) {
+        std::string params;
+        append_u16(params, uint16_t(thumbnail.format));
+        append_u16(params, thumbnail.width);
+        append_u16(params, thumbnail.height);
+        // Images are compressed already.
+        this->write_block(EBlockType::Thumbnail, ECompressionType::None, params, thumbnail.data);
+    }
+    this->write_metadata(EBlockType::PrintMetadata, data.print_metadata);
+    this->write_metadata(EBlockType::SlicerMetadata, data.slicer_metadata);
+}
+
+void Binarizer::append_gcode(std::string_view gcode)
+{
+    size_t begin = 0;
+    while (begin < gcode.size()) {
+        size_t end = gcode.find('\n', begin);
+        end = (end == std::string_view::npos) ? gcode.size() : end + 1;
+        std::string_view line = gcode.substr(begin, end - begin);
+        if (! m_gcode.empty() && (is_layer_change(line) || m_gcode.size() + line.size() > m_config.max_gcode_block_size))
+            this->flush_gcode_block();
+        m_gcode += line;
+        begin = end;
+    }
+}
+
+void Binarizer::flush_gcode_block()
+{
+    if (m_gcode.empty())
+        return;
+    std::string params;
+    append_u16(params, GCodeEncodingNone);
+    this->write_block(EBlockType::GCode, m_config.gcode_compression, params, m_gcode);
+    m_gcode.clear();
+}
+
+void convert_ascii_to_binary(FILE *src, FILE *dst, const BinaryData &data, const BinarizerConfig &config)
+{
+    Binarizer binarizer(dst, config);
+    binarizer.write_header(data);
+
+    // Feed the binarizer with complete lines only, a partial line is carried over to the next chunk.
+    std::vector<char> buffer(65536);
+    std::string       pending;
+    for (;;) {
+        size_t cnt = ::fread(buffer.data(), 1, buffer.size(), src);
+        if (::ferror(src))
+            throw Slic3r::RuntimeError("Binary G-code: failed to read the source file");
+        if (cnt == 0)
+            break;
+        pending.append(buffer.data(), cnt);
+        if (size_t last_eol = pending.rfind('\n'); last_eol != std::string::npos) {
+            binarizer.append_gcode(std::string_view(pending.data(), last_eol + 1));
+            pending.erase(0, last_eol + 1);
+        }
+    }
+    if (! pending.empty())
+        binarizer.append_gcode(pending);
+    binarizer.finalize();
+}
+
+bool is_binary_gcode(FILE *file)
+{
+    unsigned char header[10];
+    int64_t       pos = file_tell(file);
+    bool          res = ::fread(header, 1, sizeof(header), file) == sizeof(header) &&
+        std::memcmp(header, Magic, 4) == 0 && read_u32(header + 4) == Version;
+    file_seek(file, pos, SEEK_SET);
+    return res;
+}
+
+bool is_binary_gcode(const std::string &filename)
+{
+    FILE *file = boost::nowide::fopen(filename.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+    bool res = is_binary_gcode(file);
+    ::fclose(file);
+    return res;
+}
+
+Reader::Reader(const std::string &filename)
+{
+    m_file = boost::nowide::fopen(filename.c_str(), "rb");
+    if (m_file == nullptr)
+        throw Slic3r::RuntimeError(format("Binary G-code: cannot open %1%", filename));
+
+    try {
+        unsigned char header[10];
+        read_all(m_file, header, sizeof(header));
+        if (std::memcmp(header, Magic, 4) != 0)
+            throw Slic3r::RuntimeError("Binary G-code: invalid magic number");
+        if (read_u32(header + 4) != Version)
+            throw Slic3r::RuntimeError("Binary G-code: unsupported version");
+        uint16_t checksum_type = read_u16(header + 8);
+        if (checksum_type != ChecksumNone && checksum_type != ChecksumCRC32)
+            throw Slic3r::RuntimeError("Binary G-code: unsupported checksum type");
+        m_checksum = checksum_type == ChecksumCRC32;
+
+        // Index the blocks by skipping over their data.
+        m_gcode_offsets.emplace_back(0);
+        for (;;) {
+            Block         block;
+            unsigned char block_header[12];
+            block.offset = uint64_t(file_tell(m_file));
+            size_t cnt = ::fread(block_header, 1, 8, m_file);
+            if (cnt == 0 && ::feof(m_file))
+                break;
+            if (cnt != 8)
+                throw Slic3r::RuntimeError("Binary G-code: truncated block header");
+            block.type              = EBlockType(read_u16(block_header));
+            block.compression       = ECompressionType(read_u16(block_header + 2));
+            block.uncompressed_size = read_u32(block_header + 4);
+            if (uint16_t(block.type) > uint16_t(EBlockType::Thumbnail))
+                throw Slic3r::RuntimeError("Binary G-code: unknown block type");
+            if (block.compression != ECompressionType::None && block.compression != ECompressionType::Deflate)
+                throw Slic3r::RuntimeError("Binary G-code: unsupported compression type");
+            if (block.compression == ECompressionType::None)
+                block.compressed_size = block.uncompressed_size;
+            else {
+                read_all(m_file, block_header + 8, 4);
+                block.compressed_size = read_u32(block_header + 8);
+            }
+            int64_t skip = int64_t(block_params_size(block.type) + block.compressed_size + (m_checksum ? 4 : 0));
+            if (file_seek(m_file, skip, SEEK_CUR) != 0)
+                throw Slic3r::RuntimeError("Binary G-code: truncated block");
+            if (block.type == EBlockType::GCode) {
+                m_gcode_blocks.emplace_back(m_blocks.size());
+                m_gcode_offsets.emplace_back(m_gcode_offsets.back() + block.uncompressed_size);
+            }
+            m_blocks.emplace_back(block);
+        }
+        // fseek() past the end of file succeeds, check the last block was complete.
+        file_seek(m_file, 0, SEEK_END);
+        if (! m_blocks.empty()) {
+            const Block &last = m_blocks.back();
+            uint64_t end = last.offset + block_header_size(last.compression) + block_params_size(last.type) + last.compressed_size + (m_checksum ? 4 : 0);
+            if (uint64_t(file_tell(m_file)) < end)
+                throw Slic3r::RuntimeError("Binary G-code: truncated block");
+        }
+    } catch (...) {
+        ::fclose(m_file);
+        throw;
+    }
+}
+
+Reader::~Reader()
+{
+    if (m_file != nullptr)
+        ::fclose(m_file);
+}
+
+std::string Reader::read_block_data(const Block &block, std::string *params)
+{
+    size_t      header_size = block_header_size(block.compression);
+    std::string raw(header_size + block_params_size(block.type) + block.compressed_size, '\0');
+    if (file_seek(m_file, int64_t(block.offset), SEEK_SET) != 0)
+        throw Slic3r::RuntimeError("Binary G-code: seek failed");
+    read_all(m_file, raw.data(), raw.size());
+    if (m_checksum) {
+        unsigned char checksum[4];
+        read_all(m_file, checksum, 4);
+        if (read_u32(checksum) != uint32_t(mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(raw.data()), raw.size())))
+            throw Slic3r::RuntimeError("Binary G-code: block checksum mismatch");
+    }
+    if (params != nullptr)
+        *params = raw.substr(header_size, block_params_size(block.type));
+    raw.erase(0, header_size + block_params_size(block.type));
+    return block.compression == ECompressionType::None ? raw : decompress(raw, block.uncompressed_size);
+}
+
+Metadata Reader::read_metadata(EBlockType type)
+{
+    assert(type != EBlockType::GCode && type != EBlockType::Thumbnail);
+    for (const Block &block : m_blocks)
+        if (block.type == type) {
+            std::string params;
+            std::string data = this->read_block_data(block, &params);
+            if (read_u16(reinterpret_cast<const unsigned char*>(params.data())) != MetadataEncodingINI)
+                throw Slic3r::RuntimeError("Binary G-code: unsupported metadata encoding");
+            return decode_metadata(data);
+        }
+    return {};
+}
+
+std::vector<Thumbnail> Reader::read_thumbnails()
+{
+    std::vector<Thumbnail> out;
+    for (const Block &block : m_blocks)
+        if (block.type == EBlockType::Thumbnail) {
+            std::string params;
+            Thumbnail   thumbnail;
+            thumbnail.data = this->read_block_data(block, &params);
+            const auto *p = reinterpret_cast<const unsigned char*>(params.data());
+            thumbnail.format = EThumbnailFormat(read_u16(p));
+            thumbnail.width  = read_u16(p + 2);
+            thumbnail.height = read_u16(p + 4);
+            out.emplace_back(std::move(thumbnail));
+        }
+    return out;
+}
+
+size_t Reader::gcode_block_at(size_t offset) const
+{
+    assert(! m_gcode_blocks.empty());
+    auto it = std::upper_bound(m_gcode_offsets.begin(), m_gcode_offsets.end(), offset);
+    return std::min<size_t>(std::max<ptrdiff_t>(it - m_gcode_offsets.begin() - 1, 0), m_gcode_blocks.size() - 1);
+}
+
+std::string Reader::read_gcode_block(size_t gcode_block_idx)
+{
+    std::string params;
+    std::string data = this->read_block_data(m_blocks[m_gcode_blocks[gcode_block_idx]], &params);
+    if (read_u16(reinterpret_cast<const unsigned char*>(params.data())) != GCodeEncodingNone)
+        throw Slic3r::RuntimeError("Binary G-code: unsupported G-code encoding");
+    return data;
+}
+
+std::string Reader::read_gcode(size_t begin, size_t end)
+{
+    std::string out;
+    end = std::min(end, this->gcode_size());
+    if (begin >= end)
+        return out;
+    for (size_t idx = this->gcode_block_at(begin); idx < m_gcode_blocks.size() && m_gcode_offsets[idx] < end; ++ idx) {
+        std::string block = this->read_gcode_block(idx);
+        size_t      from  = std::max(begin, m_gcode_offsets[idx]) - m_gcode_offsets[idx];
+        size_t      to    = std::min(end, m_gcode_offsets[idx + 1]) - m_gcode_offsets[idx];
+        out.append(block, from, to - from);
+    }
+    return out;
+}
+
+void Reader::convert_to_ascii(FILE *dst)
+{
+    for (size_t idx = 0; idx < m_gcode_blocks.size(); ++ idx) {
+        std::string block = this->read_gcode_block(idx);
+        write_all(dst, block.data(), block.size());
+    }
+}
+
+} // namespace BinaryGCode
+} // namespace Slic3r
@@ -0,0 +1,158 @@
+#ifndef slic3r_GCode_BinaryGCode_hpp_
+#define slic3r_GCode_BinaryGCode_hpp_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Slic3r {
+namespace BinaryGCode {
+
+// Block structured binary G-code, following the layout of the open bgcode format (version 1):
+// file header, file / printer metadata, thumbnails, print / slicer metadata and finally the G-code blocks.
+// Every block is checksummed by CRC32 and may be compressed by deflate independently of the other blocks,
+// thus any block may be read without decoding the preceding ones.
+
+enum class EBlockType : uint16_t
+{
+    FileMetadata    = 0,
+    GCode           = 1,
+    SlicerMetadata  = 2,
+    PrinterMetadata = 3,
+    PrintMetadata   = 4,
+    Thumbnail       = 5,
+};
+
+enum class ECompressionType : uint16_t
+{
+    None    = 0,
+    Deflate = 1,
+    // 2 and 3 are reserved for heatshrink 11/4 and 12/4, which are not supported.
+};
+
+enum class EThumbnailFormat : uint16_t
+{
+    PNG = 0,
+    JPG = 1,
+    QOI = 2,
+};
+
+using Metadata = std::vector<std::pair<std::string, std::string>>;
+
+struct Thumbnail
+{
+    EThumbnailFormat format { EThumbnailFormat::PNG };
+    uint16_t         width  { 0 };
+    uint16_t         height { 0 };
+    // Encoded image.
+    std::string      data;
+};
+
+struct BinaryData
+{
+    Metadata               file_metadata;
+    Metadata               printer_metadata;
+    Metadata               print_metadata;
+    Metadata               slicer_metadata;
+    std::vector<Thumbnail> thumbnails;
+};
+
+struct BinarizerConfig
+{
+    ECompressionType metadata_compression { ECompressionType::None };
+    ECompressionType gcode_compression    { ECompressionType::Deflate };
+    // A G-code block is closed when it grows over this size. It is also closed at each layer change,
+    // so that the G-code of a layer may be loaded by decoding its own blocks only.
+    size_t           max_gcode_block_size { 65535 };
+};
+
+// Streams binary G-code into a file. Throws Slic3r::RuntimeError on write errors.
+class Binarizer
+{
+public:
+    Binarizer(FILE *file, const BinarizerConfig &config) : m_file(file), m_config(config) {}
+    ~Binarizer() = default;
+
+    // Writes the file header followed by the metadata and thumbnail blocks.
+    void write_header(const BinaryData &data);
+    // Appends complete lines of G-code, including the trailing new line characters.
+    void append_gcode(std::string_view gcode);
+    // Closes the current G-code block, the following G-code starts a new block.
+    void flush_gcode_block();
+    // Closes the last G-code block.
+    void finalize() { this->flush_gcode_block(); }
+
+private:
+    void write_block(EBlockType type, ECompressionType compression, const std::string &params, std::string_view data);
+    void write_metadata(EBlockType type, const Metadata &metadata);
+
+    FILE           *m_file;
+    BinarizerConfig m_config;
+    std::string     m_gcode;
+};
+
+// Converts the ASCII G-code of src into binary G-code written into dst. The G-code blocks decode to exactly the ASCII G-code,
+// so that the line numbers referenced by GCodeProcessorResult stay valid. Throws Slic3r::RuntimeError on I/O errors.
+void convert_ascii_to_binary(FILE *src, FILE *dst, const BinaryData &data, const BinarizerConfig &config);
+
+// Checks the magic number and version of the file header.
+bool is_binary_gcode(FILE *file);
+bool is_binary_gcode(const std::string &filename);
+
+// Random access reader of binary G-code. Opening the file indexes the blocks by reading their headers only,
+// the data of a block is decoded when requested. Throws Slic3r::RuntimeError on invalid files or corrupted blocks.
+class Reader
+{
+public:
+    struct Block
+    {
+        EBlockType       type;
+        ECompressionType compression;
+        uint32_t         uncompressed_size;
+        uint32_t         compressed_size;
+        // Offset of the block header in the file.
+        uint64_t         offset;
+    };
+
+    explicit Reader(const std::string &filename);
+    ~Reader();
+    Reader(const Reader &) = delete;
+    Reader& operator=(const Reader &) = delete;
+
+    const std::vector<Block>& blocks() const { return m_blocks; }
+
+    // Key / value pairs of the first metadata block of the given type, empty if there is no such block.
+    Metadata               read_metadata(EBlockType type);
+    std::vector<Thumbnail> read_thumbnails();
+
+    size_t                 gcode_blocks_count() const { return m_gcode_blocks.size(); }
+    // Offset of the G-code block in the decoded G-code stream, known without decoding the preceding blocks.
+    size_t                 gcode_block_offset(size_t gcode_block_idx) const { return m_gcode_offsets[gcode_block_idx]; }
+    // Index of the G-code block containing the given offset of the decoded G-code stream.
+    size_t                 gcode_block_at(size_t offset) const;
+    std::string            read_gcode_block(size_t gcode_block_idx);
+    // Decodes [begin, end) of the G-code stream, reading the G-code blocks overlapping the range only.
+    std::string            read_gcode(size_t begin, size_t end);
+    size_t                 gcode_size() const { return m_gcode_offsets.back(); }
+
+    // Writes the G-code stream as ASCII G-code.
+    void                   convert_to_ascii(FILE *dst);
+
+private:
+    std::string read_block_data(const Block &block, std::string *params);
+
+    FILE                *m_file { nullptr };
+    bool                 m_checksum { false };
+    std::vector<Block>   m_blocks;
+    std::vector<size_t>  m_gcode_blocks;
+    // Offsets of the G-code blocks in the decoded stream, with the total size appended.
+    std::vector<size_t>  m_gcode_offsets;
+};
+
+} // namespace BinaryGCode
+} // namespace Slic3r
+
+#endif // slic3r_GCode_BinaryGCode_hpp_
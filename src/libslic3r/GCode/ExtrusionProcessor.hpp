@@ -80,18 +80,22 @@ std::vector<ExtendedPoint> estimate_points_properties(const POINTS
     std::vector<ExtendedPoint> points;
     points.reserve(input_points.size() * (ADD_INTERSECTIONS ? 1.5 : 1));
 
+    // The input points are queried in a single batch, which walks the tree coherently along the path.
+    std::vector<Vec<2, AABBScalar>> input_positions;
+    input_positions.reserve(input_points.size());
+    for (const P &p : input_points)
+        input_positions.emplace_back(maybe_unscale(p).template cast<AABBScalar>());
+    std::vector<typename AABBTreeLines::LinesDistancer<L>::Floating> input_distances;
+    unscaled_prev_layer.template distances_from_lines_extra<SIGNED_DISTANCE>(input_positions, input_distances);
+
     {
         ExtendedPoint start_point{maybe_unscale(input_points.front())};
-        auto [distance, nearest_line,
-              x] = unscaled_prev_layer.template distance_from_lines_extra<SIGNED_DISTANCE>(start_point.position.cast<AABBScalar>());
-        start_point.distance = distance + boundary_offset;
+        start_point.distance = input_distances.front() + boundary_offset;
         points.push_back(start_point);
     }
     for (size_t i = 1; i < input_points.size(); i++) {
         ExtendedPoint next_point{maybe_unscale(input_points[i])};
-        auto [distance, nearest_line,
-              x] = unscaled_prev_layer.template distance_from_lines_extra<SIGNED_DISTANCE>(next_point.position.cast<AABBScalar>());
-        next_point.distance = distance + boundary_offset;
+        next_point.distance = input_distances[i] + boundary_offset;
 
         if (ADD_INTERSECTIONS &&
             ((points.back().distance > boundary_offset + EPSILON) != (next_point.distance > boundary_offset + EPSILON))) {
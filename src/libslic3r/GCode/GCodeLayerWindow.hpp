@@ -0,0 +1,71 @@
+#ifndef slic3r_GCodeLayerWindow_hpp_
+#define slic3r_GCodeLayerWindow_hpp_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Slic3r {
+
+// Window of layers of a large G-code file, whose preview geometry is built at once.
+// The layers are given by the ids of their first and last moves (Endpoints::first, Endpoints::last), ordered by the layer z.
+namespace GCodeLayerWindow {
+
+// Range of layers [first, last], both included.
+using LayersRange = std::array<unsigned int, 2>;
+
+// Number of moves of the layers of the range.
+template<class Endpoints>
+size_t moves_count(const std::vector<Endpoints> &layers, const LayersRange &range)
+{
+    assert(range[0] <= range[1] && range[1] < layers.size());
+    return layers[range[1]].last - layers[range[0]].first;
+}
+
+// Bottom layers shown when the preview opens. They take half of the budget, so that the window built around them
+// has room for the layers above them.
+template<class Endpoints>
+LayersRange initial_range(const std::vector<Endpoints> &layers, size_t budget)
+{
+    assert(! layers.empty());
+    unsigned int top_layer = 0;
+    while (top_layer + 1 < layers.size() && moves_count(layers, { 0, top_layer + 1 }) <= budget / 2)
+        ++ top_layer;
+    return { 0, top_layer };
+}
+
+// Grows the selected layers with their neighbours, alternately above and below, while the window holds at most budget moves,
+// so that small moves of the selection are served by the window already built. The window always contains the selected layers,
+// even if they alone exceed the budget.
+template<class Endpoints>
+LayersRange grow_range(const std::vector<Endpoints> &layers, const LayersRange &selected, size_t budget)
+{
+    assert(! layers.empty());
+    const unsigned int top_layer = static_cast<unsigned int>(layers.size() - 1);
+    LayersRange out = { std::min(selected[0], top_layer), std::min(selected[1], top_layer) };
+    for (bool grown = true; grown;) {
+        grown = false;
+        if (out[1] < top_layer && moves_count(layers, { out[0], out[1] + 1 }) <= budget) {
+            ++ out[1];
+            grown = true;
+        }
+        if (out[0] > 0 && moves_count(layers, { out[0] - 1, out[1] }) <= budget) {
+            -- out[0];
+            grown = true;
+        }
+    }
+    return out;
+}
+
+// Whether all the selected layers are in the window.
+inline bool contains(const LayersRange &window, const LayersRange &selected)
+{
+    return window[0] <= selected[0] && selected[1] <= window[1];
+}
+
+} // namespace GCodeLayerWindow
+} // namespace Slic3r
+
+#endif // slic3r_GCodeLayerWindow_hpp_
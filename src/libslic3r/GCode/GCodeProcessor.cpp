@@ -7,6 +7,7 @@
 #include "libslic3r/LocalesUtils.hpp"
 #include "libslic3r/format.hpp"
 #include "GCodeProcessor.hpp"
+#include "BinaryGCode.hpp"
 
 #include <boost/log/trivial.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -1049,6 +1050,12 @@ GCodeProcessor::GCodeProcessor()
     m_time_processor.machines[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Stealth)].line_m73_stop_mask = "M73 D%s\n";
 }
 
+bool GCodeProcessor::is_backtrace_enabled(const PrintConfig& config)
+{
+    return config.preheat_time > 0 &&
+        (is_XL_printer(config) || (!config.single_extruder_multi_material && config.filament_diameter.values.size() > 1));
+}
+
 void GCodeProcessor::apply_config(const PrintConfig& config)
 {
     m_parser.apply_config(config);
@@ -1067,7 +1074,7 @@ void GCodeProcessor::apply_config(const PrintConfig& config)
     // sanity check
     if(m_preheat_steps < 1)
         m_preheat_steps = 1;
-    m_result.backtrace_enabled = m_preheat_time > 0 && (m_is_XL_printer || (!m_single_extruder_multi_material && extruders_count > 1));
+    m_result.backtrace_enabled = is_backtrace_enabled(config);
 
     m_extruder_offsets.resize(extruders_count);
     m_extruder_colors.resize(extruders_count);
@@ -1601,6 +1608,21 @@ static inline const char* remove_eols(const char *begin, const char *end) {
 
 // Load a G-code into a stand-alone G-code viewer.
 // throws CanceledException through print->throw_if_canceled() (sent by the caller as callback).
+// Binary G-code stores the full config in the slicer metadata block, the G-code blocks are parsed as the ASCII G-code.
+static void load_config_from_binary_gcode(DynamicPrintConfig &config, const std::string &filename)
+{
+    BinaryGCode::Reader       reader(filename);
+    ConfigSubstitutionContext substitutions(ForwardCompatibilitySubstitutionRule::EnableSilent);
+    for (const auto &[key, value] : reader.read_metadata(BinaryGCode::EBlockType::SlicerMetadata)) {
+        try {
+            config.set_deserialize(key, value, substitutions);
+        } catch (UnknownOptionException & /* e */) {
+            // ignore
+        }
+    }
+    config.handle_legacy_composite();
+}
+
 void GCodeProcessor::process_file(const std::string& filename, std::function<void()> cancel_callback)
 {
     CNumericLocalesSetter locales_setter;
@@ -1639,7 +1661,10 @@ void GCodeProcessor::process_file(const std::string& filename, std::function<voi
             // Silently substitute unknown values by new ones for loading configurations from OrcaSlicer's own G-code.
             // Showing substitution log or errors may make sense, but we are not really reading many values from the G-code config,
             // thus a probability of incorrect substitution is low and the G-code viewer is a consumer-only anyways.
-            config.load_from_gcode_file(filename, ForwardCompatibilitySubstitutionRule::EnableSilent);
+            if (BinaryGCode::is_binary_gcode(filename))
+                load_config_from_binary_gcode(config, filename);
+            else
+                config.load_from_gcode_file(filename, ForwardCompatibilitySubstitutionRule::EnableSilent);
             apply_config(config);
         }
         else if (m_producer == EProducer::Simplify3D)
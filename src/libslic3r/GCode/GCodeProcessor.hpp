@@ -773,6 +773,8 @@ class Print;
         GCodeProcessor();
 
         void apply_config(const PrintConfig& config);
+        // Whether finalize() inserts the M104 lines preheating the next tool ahead of the tool changes.
+        static bool is_backtrace_enabled(const PrintConfig& config);
         void set_print(Print* print) { m_print = print; }
         void enable_stealth_time_estimator(bool enabled);
         bool is_stealth_time_estimator_enabled() const {
@@ -784,6 +786,8 @@ class Print;
         const GCodeProcessorResult& get_result() const { return m_result; }
         GCodeProcessorResult& result() { return m_result; }
         GCodeProcessorResult&& extract_result() { return std::move(m_result); }
+        // Id for a result not produced by a GCodeProcessor, e.g. loaded from the SliceResultStore.
+        static unsigned int next_result_id() { return ++ s_result_id; }
 
         // Load a G-code into a stand-alone G-code viewer.
         // throws CanceledException through print->throw_if_canceled() (sent by the caller as callback).
@@ -802,6 +806,8 @@ class Print;
         std::vector<std::pair<EMoveType, float>> get_moves_time(PrintEstimatedStatistics::ETimeMode mode) const;
         std::vector<std::pair<ExtrusionRole, float>> get_roles_time(PrintEstimatedStatistics::ETimeMode mode) const;
         std::vector<float> get_layers_time(PrintEstimatedStatistics::ETimeMode mode) const;
+        // Number of layers processed, written by finalize() in place of the total layer number placeholder.
+        unsigned int get_layers_count() const { return m_layer_id; }
 
         //BBS: set offset for gcode writer
         void set_xy_offset(double x, double y) { m_x_offset = x; m_y_offset = y; }
@@ -0,0 +1,184 @@
+#include "GCodeStream.hpp"
+#include "GCodeProcessor.hpp"
+
+#include "../PrintConfig.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include <boost/nowide/cstdio.hpp>
+
+namespace Slic3r {
+
+// Written by GCode::_do_export() after the last line of the executable block.
+static constexpr std::string_view footer_start = "; EXECUTABLE_BLOCK_END\n";
+
+bool GCodeStream::is_placeholder_line(const char *begin, const char *end)
+{
+    // All the placeholders start with ";_GP_".
+    if (end - begin < 5 || begin[0] != ';' || begin[1] != '_')
+        return false;
+    if (end[-1] == '\n')
+        -- end;
+    if (end > begin && end[-1] == '\r')
+        -- end;
+    const std::string_view tag(begin + 1, end - begin - 1);
+    for (GCodeProcessor::ETags t : { GCodeProcessor::ETags::First_Line_M73_Placeholder, GCodeProcessor::ETags::Last_Line_M73_Placeholder,
+                                     GCodeProcessor::ETags::Estimated_Printing_Time_Placeholder, GCodeProcessor::ETags::Total_Layer_Number_Placeholder })
+        if (tag == GCodeProcessor::reserved_tag(t))
+            return true;
+    return false;
+}
+
+std::string GCodeStream::read_footer(const std::string &path)
+{
+    FILE *file = boost::nowide::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        throw Slic3r::RuntimeError(std::string("Cannot open the G-code file ") + path + " to read its footer.");
+    // The footer is at most a few hundred kB long, read the file backwards until the start of the footer is found.
+    const std::string footer_line = "\n" + std::string(footer_start);
+    std::string       tail;
+    std::vector<char> buffer(65536);
+    size_t            footer_pos = std::string::npos;
+    ::fseek(file, 0, SEEK_END);
+    for (long pos = ::ftell(file); pos > 0 && footer_pos == std::string::npos;) {
+        const long len = std::min<long>(pos, long(buffer.size()));
+        pos -= len;
+        if (::fseek(file, pos, SEEK_SET) != 0 || ::fread(buffer.data(), 1, len, file) != size_t(len)) {
+            ::fclose(file);
+            throw Slic3r::RuntimeError(std::string("Error while reading the footer of the G-code file ") + path);
+        }
+        tail.insert(tail.begin(), buffer.begin(), buffer.begin() + len);
+        if (size_t i = tail.rfind(footer_line); i != std::string::npos)
+            footer_pos = i + 1;
+    }
+    ::fclose(file);
+    return footer_pos == std::string::npos ? std::string() : tail.substr(footer_pos);
+}
+
+bool GCodeStream::can_stream(const PrintConfig &config)
+{
+    // Post-processing scripts and the binary G-code conversion run on the finished file.
+    return config.post_process.values.empty() && ! config.binary_gcode && ! GCodeProcessor::is_backtrace_enabled(config);
+}
+
+void GCodeStream::write(const char *data, size_t len)
+{
+    if (len == 0 || this->aborted())
+        return;
+
+    const char *end = data + len;
+    // Only the complete lines are streamed, so that the placeholder lines could be filtered out.
+    const char *last_eol = end;
+    while (last_eol != data && *(-- last_eol) != '\n') ;
+    if (*last_eol != '\n') {
+        m_partial_line.append(data, len);
+        return;
+    }
+    std::string chunk;
+    chunk.reserve(m_partial_line.size() + (last_eol + 1 - data));
+    auto append_lines = [this, &chunk](const char *begin, const char *end) {
+        while (begin != end && ! m_footer) {
+            const char *eol = std::find(begin, end, '\n');
+            if (eol != end)
+                ++ eol;
+            if (std::string_view(begin, eol - begin) == footer_start)
+                m_footer = true;
+            else if (! is_placeholder_line(begin, eol))
+                chunk.append(begin, eol);
+            begin = eol;
+        }
+    };
+    const char *begin = data;
+    if (! m_partial_line.empty()) {
+        const char *eol = std::find(data, end, '\n') + 1;
+        m_partial_line.append(data, eol);
+        append_lines(m_partial_line.data(), m_partial_line.data() + m_partial_line.size());
+        m_partial_line.clear();
+        begin = eol;
+    }
+    append_lines(begin, last_eol + 1);
+    m_partial_line.assign(last_eol + 1, end);
+    if (! chunk.empty())
+        this->push(std::move(chunk));
+}
+
+void GCodeStream::push(std::string &&chunk)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this]() { return m_aborted || ! m_reading || m_buffered < m_max_buffered; });
+    if (m_aborted)
+        return;
+    m_buffered += chunk.size();
+    m_chunks.emplace_back(std::move(chunk));
+    lock.unlock();
+    m_cond.notify_all();
+}
+
+void GCodeStream::finish(const std::string &trailer)
+{
+    std::string last = std::move(m_partial_line);
+    m_partial_line.clear();
+    if (! m_footer && ! last.empty() && ! is_placeholder_line(last.data(), last.data() + last.size()))
+        this->push(last + "\n");
+    if (! trailer.empty())
+        this->push(std::string(trailer));
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished = true;
+    }
+    m_cond.notify_all();
+}
+
+void GCodeStream::abort()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_aborted = true;
+        m_chunks.clear();
+        m_buffered = 0;
+    }
+    m_cond.notify_all();
+}
+
+bool GCodeStream::aborted() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_aborted;
+}
+
+size_t GCodeStream::read(char *buffer, size_t len)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_reading = true;
+    m_cond.wait(lock, [this]() { return m_aborted || m_finished || ! m_chunks.empty(); });
+    if (m_aborted)
+        throw GCodeStreamAborted();
+    size_t copied = 0;
+    while (copied < len && ! m_chunks.empty()) {
+        const std::string &front = m_chunks.front();
+        size_t n = std::min(len - copied, front.size() - m_front_pos);
+        ::memcpy(buffer + copied, front.data() + m_front_pos, n);
+        copied      += n;
+        m_front_pos += n;
+        if (m_front_pos == front.size()) {
+            m_buffered -= front.size();
+            m_chunks.pop_front();
+            m_front_pos = 0;
+        }
+    }
+    m_bytes_read += copied;
+    lock.unlock();
+    m_cond.notify_all();
+    return copied;
+}
+
+size_t GCodeStream::bytes_read() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes_read;
+}
+
+} // namespace Slic3r
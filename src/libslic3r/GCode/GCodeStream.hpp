@@ -0,0 +1,91 @@
+#ifndef slic3r_GCodeStream_hpp_
+#define slic3r_GCodeStream_hpp_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "../Exception.hpp"
+
+namespace Slic3r {
+
+class PrintConfig;
+
+// Raised by GCodeStream::read() when the stream was aborted before the G-code export finished.
+class GCodeStreamAborted : public Slic3r::RuntimeError
+{
+public:
+    GCodeStreamAborted() : Slic3r::RuntimeError("G-code stream aborted") {}
+};
+
+// Pipe passing the G-code from a running G-code export to a consumer on another thread, f.e. an upload to a print host,
+// so that the upload does not have to wait for the export to finish.
+//
+// The streamed G-code is the G-code before GCodeProcessor::finalize() post-processed it: the placeholder lines, whose values
+// are known only at the end of the export, are left out. The footer following the executable block, whose print statistics
+// are rewritten by the post-processing, is held back and sent from the finished G-code file together with the layer count
+// as a trailer, see read_footer(). The M73 progress lines inserted by the post-processing are not streamed, printers fall
+// back to reporting the progress based on the file position. The preheating M104 lines cannot be inserted into the G-code
+// already streamed, such configurations are not streamed at all, see can_stream().
+//
+// Once the consumer started reading, the amount of buffered G-code is bounded: if the consumer falls behind, write() blocks.
+// Before that, f.e. while the upload waits in the queue for another upload to the same host, the G-code is buffered without
+// a limit, so that the export is not stalled. Once the stream is aborted by either side, write() drops the data, so that
+// the G-code export always runs to completion.
+class GCodeStream
+{
+public:
+    explicit GCodeStream(size_t max_buffered = 16 * 1024 * 1024) : m_max_buffered(max_buffered) {}
+
+    // Producer side, to be called from a single thread.
+    void write(const char *data, size_t len);
+    void write(const std::string &data) { this->write(data.data(), data.size()); }
+    // Appends the trailer and marks the end of the stream.
+    void finish(const std::string &trailer);
+
+    // Either side. Wakes up a blocked write() or read().
+    void abort();
+    bool aborted() const;
+
+    // Consumer side. Blocks until some data is available, returns the number of bytes copied to buffer or zero at the end
+    // of the stream. Throws GCodeStreamAborted if the stream was aborted.
+    size_t read(char *buffer, size_t len);
+
+    // Total number of bytes passed to the consumer so far.
+    size_t bytes_read() const;
+
+    // Lines of the raw G-code replaced by GCodeProcessor::post_process(), which are not streamed.
+    static bool is_placeholder_line(const char *begin, const char *end);
+    // Footer of the post-processed G-code file, starting with the line closing the executable block, to be passed to finish().
+    // Returns an empty string if the file has no footer.
+    static std::string read_footer(const std::string &path);
+    // Whether the G-code exported with the given configuration differs from the streamed G-code only by the M73 lines
+    // and by the position of the layer count.
+    static bool can_stream(const PrintConfig &config);
+
+private:
+    void push(std::string &&chunk);
+
+    const size_t                    m_max_buffered;
+    // Incomplete last line written, to be completed by the next write().
+    std::string                     m_partial_line;
+    // The footer started, the rest of the written G-code is not streamed.
+    bool                            m_footer { false };
+
+    mutable std::mutex              m_mutex;
+    std::condition_variable         m_cond;
+    std::deque<std::string>         m_chunks;
+    // Read position in m_chunks.front().
+    size_t                          m_front_pos { 0 };
+    size_t                          m_buffered { 0 };
+    size_t                          m_bytes_read { 0 };
+    // Set by the first read(), from then on write() blocks if more than m_max_buffered bytes are buffered.
+    bool                            m_reading { false };
+    bool                            m_finished { false };
+    bool                            m_aborted { false };
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_GCodeStream_hpp_
@@ -1,5 +1,6 @@
 #include "Thumbnails.hpp"
 #include "../miniz_extension.hpp"
+#include "../PNGReadWrite.hpp"
 #include "format.hpp"
 
 #include <boost/algorithm/string/case_conv.hpp>
@@ -15,7 +16,7 @@ using namespace std::literals;
 
 struct CompressedPNG : CompressedImageBuffer
 {
-    ~CompressedPNG() override { if (data) mz_free(data); }
+    ~CompressedPNG() override { free(data); }
     std::string_view tag() const override { return "thumbnail"sv; }
 };
 
@@ -46,7 +47,12 @@ struct CompressedColPic : CompressedImageBuffer
 std::unique_ptr<CompressedImageBuffer> compress_thumbnail_png(const ThumbnailData &data)
 {
     auto out = std::make_unique<CompressedPNG>();
-    out->data = tdefl_write_image_to_png_file_in_memory_ex((const void*)data.pixels.data(), data.width, data.height, 4, &out->size, MZ_DEFAULT_LEVEL, 1);
+    std::vector<uint8_t> png_data;
+    if (png::encode_png(data.pixels.data(), data.width, data.height, 4, png_data, true)) {
+        out->size = png_data.size();
+        out->data = malloc(out->size);
+        memcpy(out->data, png_data.data(), out->size);
+    }
     return out;
 }
 
@@ -5,6 +5,7 @@
 #include "../PrintConfig.hpp"
 #include "../enum_bitmask.hpp"
 #include "ThumbnailData.hpp"
+#include "BinaryGCode.hpp"
 #include "../enum_bitmask.hpp"
 
 #include <vector>
@@ -104,6 +105,43 @@ inline void export_thumbnails_to_file(ThumbnailsGeneratorCallback&
     }
 }
 
+// Binary G-code stores the compressed images in thumbnail blocks instead of base64 encoded comments.
+// Formats which are not representable by the binary G-code (BTT TFT, ColPic) are skipped.
+template<typename ThrowIfCanceledCallback>
+inline void generate_binary_thumbnails(ThumbnailsGeneratorCallback&                                thumbnail_cb,
+                                       int                                                         plate_id,
+                                       const std::vector<std::pair<GCodeThumbnailsFormat, Vec2d>>& thumbnails_list,
+                                       std::vector<BinaryGCode::Thumbnail>&                        out_thumbnails,
+                                       ThrowIfCanceledCallback                                     throw_if_canceled)
+{
+    out_thumbnails.clear();
+    if (thumbnail_cb == nullptr)
+        return;
+    for (const auto& [format, size] : thumbnails_list) {
+        BinaryGCode::EThumbnailFormat binary_format;
+        switch (format) {
+        case GCodeThumbnailsFormat::PNG: binary_format = BinaryGCode::EThumbnailFormat::PNG; break;
+        case GCodeThumbnailsFormat::JPG: binary_format = BinaryGCode::EThumbnailFormat::JPG; break;
+        case GCodeThumbnailsFormat::QOI: binary_format = BinaryGCode::EThumbnailFormat::QOI; break;
+        default: continue;
+        }
+        ThumbnailsList thumbnails = thumbnail_cb(ThumbnailsParams{{size}, true, true, true, true, plate_id});
+        for (const ThumbnailData &data : thumbnails) {
+            if (data.is_valid()) {
+                auto compressed = compress_thumbnail(data, format);
+                if (compressed->data && compressed->size) {
+                    BinaryGCode::Thumbnail &thumbnail = out_thumbnails.emplace_back();
+                    thumbnail.format = binary_format;
+                    thumbnail.width  = uint16_t(data.width);
+                    thumbnail.height = uint16_t(data.height);
+                    thumbnail.data.assign(reinterpret_cast<const char*>(compressed->data), compressed->size);
+                }
+                throw_if_canceled();
+            }
+        }
+    }
+}
+
 } // namespace Slic3r::GCodeThumbnails
 
 #endif // slic3r_GCodeThumbnails_hpp_
@@ -5,17 +5,69 @@
 #include <boost/nowide/fstream.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <fstream>
+#include <memory>
 #include <iostream>
 #include <iomanip>
 #include "Utils.hpp"
+#include "GCode/BinaryGCode.hpp"
 
 #include "LocalesUtils.hpp"
 
 #include <Shiny/Shiny.h>
 #include <fast_float/fast_float.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+    #define SLIC3R_GCODEREADER_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define SLIC3R_GCODEREADER_NEON
+#endif
+
 namespace Slic3r {
 
+namespace {
+
+// Returns pointer to the first character in [begin, end) equal to one of Chars, or end if there is none.
+// G-code lines and comments are scanned 16 characters at a time with vector compares.
+template<char... Chars>
+inline const char* find_first_of(const char *begin, const char *end)
+{
+#if defined(SLIC3R_GCODEREADER_SSE2)
+    for (; end - begin >= 16; begin += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        __m128i       eq    = _mm_setzero_si128();
+        ((eq = _mm_or_si128(eq, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Chars)))), ...);
+        if (const int mask = _mm_movemask_epi8(eq); mask != 0) {
+    #ifdef _MSC_VER
+            unsigned long idx;
+            _BitScanForward(&idx, (unsigned long)mask);
+            return begin + idx;
+    #else
+            return begin + __builtin_ctz((unsigned int)mask);
+    #endif
+        }
+    }
+#elif defined(SLIC3R_GCODEREADER_NEON)
+    for (; end - begin >= 16; begin += 16) {
+        const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(begin));
+        uint8x16_t       eq    = vdupq_n_u8(0);
+        ((eq = vorrq_u8(eq, vceqq_u8(chunk, vdupq_n_u8(uint8_t(Chars))))), ...);
+        if (vmaxvq_u8(eq) != 0)
+            // Found in this chunk, the scalar loop below locates it.
+            break;
+    }
+#endif
+    for (; begin != end && ! ((*begin == Chars) || ...); ++ begin)
+        ; // silence -Wempty-body
+    return begin;
+}
+
+} // namespace
+
 void GCodeReader::apply_config(const GCodeConfig &config)
 {
     m_config = config;
@@ -86,8 +138,8 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
     if (gline.has(E) && m_config.use_relative_e_distances)
         m_position[E] = 0;
 
-    // Skip the rest of the line.
-    for (; ! is_end_of_line(*c); ++ c);
+    // Skip the rest of the line. The line is terminated before or at end, usually by a long comment.
+    c = find_first_of<'\r', '\n', '\0'>(c, end);
 
     // Copy the raw string including the comment, without the trailing newlines.
     if (c > ptr) {
@@ -127,6 +179,19 @@ bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLine
 {
     FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
 
+    // Binary G-code is decoded one block at a time. The decoded stream is the ASCII G-code the binary G-code was made of,
+    // thus the file positions reported to line_end_callback are positions in the decoded stream.
+    std::unique_ptr<BinaryGCode::Reader> binary;
+    size_t                               binary_block = 0;
+    if (in.f != nullptr && BinaryGCode::is_binary_gcode(in.f)) {
+        try {
+            binary = std::make_unique<BinaryGCode::Reader>(filename);
+        } catch (const std::exception &ex) {
+            BOOST_LOG_TRIVIAL(error) << "Failed to open binary G-code " << filename << ": " << ex.what();
+            return false;
+        }
+    }
+
     // Read the input stream 64kB at a time, extract lines and process them.
     std::vector<char> buffer(65536 * 10, 0);
     // Line buffer.
@@ -134,19 +199,34 @@ bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLine
     size_t file_pos = 0;
     m_parsing = true;
     for (;;) {
-        size_t cnt_read = ::fread(buffer.data(), 1, buffer.size(), in.f);
-        if (::ferror(in.f))
-            return false;
+        size_t cnt_read = 0;
+        if (binary) {
+            if (binary_block < binary->gcode_blocks_count()) {
+                std::string block;
+                try {
+                    block = binary->read_gcode_block(binary_block ++);
+                } catch (const std::exception &ex) {
+                    BOOST_LOG_TRIVIAL(error) << "Failed to read binary G-code " << filename << ": " << ex.what();
+                    return false;
+                }
+                if (block.size() > buffer.size())
+                    buffer.resize(block.size());
+                std::copy(block.begin(), block.end(), buffer.begin());
+                cnt_read = block.size();
+            }
+        } else {
+            cnt_read = ::fread(buffer.data(), 1, buffer.size(), in.f);
+            if (::ferror(in.f))
+                return false;
+        }
         bool eof       = cnt_read == 0;
         auto it        = buffer.begin();
         auto it_bufend = buffer.begin() + cnt_read;
         while (it != it_bufend || (eof && ! gcode_line.empty())) {
             // Find end of line.
-            bool eol    = false;
-            auto it_end = it;
-            for (; it_end != it_bufend && ! (eol = *it_end == '\r' || *it_end == '\n'); ++ it_end)
-                if (*it_end == '\n')
-                    line_end_callback(file_pos + (it_end - buffer.begin()) + 1);
+            const char *data = buffer.data();
+            auto it_end = buffer.begin() + (find_first_of<'\r', '\n'>(data + (it - buffer.begin()), data + cnt_read) - data);
+            bool eol    = it_end != it_bufend;
             // End of line is indicated also if end of file was reached.
             eol |= eof && it_end == it_bufend;
             if (eol) {
@@ -1,4 +1,7 @@
 #include "GCodeSender.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <iostream>
 #include <istream>
 #include <string>
@@ -51,9 +54,57 @@ std::fstream fs;
 
 namespace Slic3r {
 
+std::string
+MeatPack::command(unsigned char cmd)
+{
+    return std::string({ char(SignalByte), char(SignalByte), char(cmd) });
+}
+
+unsigned char
+MeatPack::pack_char(char c, bool no_spaces)
+{
+    switch (c) {
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        return (unsigned char)(c - '0');
+    case '.':  return 10;
+    case ' ':  return no_spaces ? FullCharCode : 11;
+    case 'E':  return no_spaces ? 11 : FullCharCode;
+    case '\n': return 12;
+    case 'G':  return 13;
+    case 'X':  return 14;
+    default:   return FullCharCode;
+    }
+}
+
+std::string
+MeatPack::pack_line(const std::string &line, bool no_spaces)
+{
+    assert(! line.empty() && line.back() == '\n');
+    std::string out;
+    out.reserve(line.size());
+    for (size_t i = 0; i < line.size(); i += 2) {
+        // The firmware ignores the second code of a byte starting with a new line, thus a line of odd length
+        // is padded by an arbitrary packable code.
+        const char          c1    = line[i];
+        const bool          pad   = i + 1 == line.size();
+        const char          c2    = pad ? '0' : line[i + 1];
+        const unsigned char code1 = pack_char(c1, no_spaces);
+        const unsigned char code2 = pack_char(c2, no_spaces);
+        out += char(code1 | (code2 << 4));
+        if (code1 == FullCharCode)
+            out += c1;
+        if (code2 == FullCharCode)
+            out += c2;
+    }
+    return out;
+}
+
 GCodeSender::GCodeSender()
     : io(), serial(io), can_send(false), sent(0), open(false), error(false),
-      connected(false), queue_paused(false)
+      connected(false), queue_paused(false), in_flight_bytes(0), window_lines(1), window_bytes(0),
+      writing(false), resend_from(0), resend_stale(0), meatpack(false), meatpack_no_spaces(false),
+      meatpack_active(false), written(0)
 {
 #ifdef DEBUG_SERIAL
     std::srand(std::time(nullptr));
@@ -96,6 +147,14 @@ GCodeSender::connect(std::string devname, unsigned int baud_rate)
     // a reset firmware expect line numbers to start again from 1
     this->sent = 0;
     this->last_sent.clear();
+    // a reset firmware starts with MeatPack disabled
+    this->in_flight.clear();
+    this->in_flight_bytes = 0;
+    this->writing = false;
+    this->resend_from = 0;
+    this->resend_stale = 0;
+    this->meatpack_active = false;
+    this->written = 0;
 
     /* Initialize debugger */
 #ifdef DEBUG_SERIAL
@@ -198,6 +257,29 @@ GCodeSender::wait_connected(unsigned int timeout) const
     return true;
 }
 
+void
+GCodeSender::set_meatpack(bool enable, bool omit_spaces)
+{
+    boost::lock_guard<boost::mutex> l(this->queue_mutex);
+    this->meatpack = enable;
+    this->meatpack_no_spaces = enable && omit_spaces;
+}
+
+void
+GCodeSender::set_send_window(size_t max_lines, size_t max_bytes)
+{
+    boost::lock_guard<boost::mutex> l(this->queue_mutex);
+    this->window_lines = std::max<size_t>(max_lines, 1);
+    this->window_bytes = max_bytes;
+}
+
+size_t
+GCodeSender::bytes_written() const
+{
+    boost::lock_guard<boost::mutex> l(this->queue_mutex);
+    return this->written;
+}
+
 size_t
 GCodeSender::queue_size() const
 {
@@ -356,6 +438,13 @@ GCodeSender::on_read(const boost::system::error_code& error,
         } else if (boost::starts_with(line, "ok")) {
             {
                 boost::lock_guard<boost::mutex> l(this->queue_mutex);
+                // each "ok" acknowledges the oldest line in flight, including the lines rejected after a resend request
+                if (!this->in_flight.empty()) {
+                    this->in_flight_bytes -= this->in_flight.front();
+                    this->in_flight.pop_front();
+                }
+                if (this->resend_stale > 0)
+                    -- this->resend_stale;
                 this->can_send = true;
             }
             this->send();
@@ -369,9 +458,15 @@ GCodeSender::on_read(const boost::system::error_code& error,
             fs << "!! line num out of sync: toresend = " << toresend << ", sent = " << sent << ", last_sent.size = " << last_sent.size() << std::endl;
 #endif
 
-            if (toresend > this->sent - this->last_sent.size() && toresend <= this->sent) {
+            boost::unique_lock<boost::mutex> lock(this->queue_mutex);
+            if (this->resend_stale > 0 && toresend == this->resend_from) {
+                // repeated request for a line sent ahead before the resend request was received, already being resent
+                lock.unlock();
+            } else if (toresend > this->sent - this->last_sent.size() && toresend <= this->sent) {
                 {
-                    boost::lock_guard<boost::mutex> l(this->queue_mutex);
+                    // the lines in flight will be rejected by the firmware, each repeating this request
+                    this->resend_from = toresend;
+                    this->resend_stale = this->in_flight.size();
                     
                     const auto lines_to_resend = this->sent - toresend + 1;
 #ifdef DEBUG_SERIAL
@@ -391,8 +486,10 @@ GCodeSender::on_read(const boost::system::error_code& error,
                     this->sent = toresend - 1;
                     this->can_send = true;
                 }
+                lock.unlock();
                 this->send();
             } else {
+                lock.unlock();
                 printf("Cannot resend %zu (oldest we have is %zu)\n", toresend, this->sent - this->last_sent.size());
             }
         } else if (boost::starts_with(line, "wait")) {
@@ -460,71 +557,101 @@ GCodeSender::send()
     this->io.post(boost::bind(&GCodeSender::do_send, this));
 }
 
+// Commands taking a string argument, which keep their spaces when MeatPack omits spaces.
+static bool has_string_argument(const std::string &line)
+{
+    for (const char *cmd : { "M23", "M28", "M30", "M32", "M117", "M118", "M928" })
+        if (boost::starts_with(line, cmd) && (line.size() == strlen(cmd) || line[strlen(cmd)] == ' '))
+            return true;
+    return false;
+}
+
 void
 GCodeSender::do_send()
 {
     boost::lock_guard<boost::mutex> l(this->queue_mutex);
     
-    // printer is not connected or we're still waiting for the previous ack
-    if (!this->can_send) return;
+    // printer is not connected or the previous write did not finish yet
+    if (!this->can_send || this->writing) return;
     
-    std::string line;
-    while (!this->priqueue.empty() || (!this->queue.empty() && !this->queue_paused)) {
-        if (!this->priqueue.empty()) {
-            line = this->priqueue.front();
-            this->priqueue.pop_front();
-        } else {
-            line = this->queue.front();
-            this->queue.pop();
-        }
-        
-        // strip comments
-        size_t comment_pos = line.find_first_of(';');
-        if (comment_pos != std::string::npos)
-            line.erase(comment_pos, std::string::npos);
-        boost::algorithm::trim(line);
-        
-        // if line is not empty, send it
-        if (!line.empty()) break;
-        // if line is empty, process next item in queue
+    std::ostream os(&this->write_buffer);
+    if (this->meatpack && !this->meatpack_active) {
+        os << MeatPack::command(MeatPack::CmdEnablePacking);
+        os << MeatPack::command(this->meatpack_no_spaces ? MeatPack::CmdEnableNoSpaces : MeatPack::CmdDisableNoSpaces);
+        this->meatpack_active = true;
     }
-    if (line.empty()) return;
     
-    // compute full line
-    ++ this->sent;
+    // fill the send-ahead window
+    while (this->in_flight.size() < this->window_lines) {
+        std::string line;
+        while (!this->priqueue.empty() || (!this->queue.empty() && !this->queue_paused)) {
+            if (!this->priqueue.empty()) {
+                line = this->priqueue.front();
+                this->priqueue.pop_front();
+            } else {
+                line = this->queue.front();
+                this->queue.pop();
+            }
+            
+            // strip comments
+            size_t comment_pos = line.find_first_of(';');
+            if (comment_pos != std::string::npos)
+                line.erase(comment_pos, std::string::npos);
+            boost::algorithm::trim(line);
+            
+            // if line is not empty, send it
+            if (!line.empty()) break;
+            // if line is empty, process next item in queue
+        }
+        if (line.empty()) break;
+        
+        // compute full line
+        ++ this->sent;
 #ifndef DEBUG_SERIAL
-    const auto line_num = this->sent;
+        const auto line_num = this->sent;
 #else
-    // In DEBUG_SERIAL mode, test line re-synchronization by sending bad line number 1/4 of the time
-    const auto line_num = std::rand() < RAND_MAX/4 ? 0 : this->sent;
+        // In DEBUG_SERIAL mode, test line re-synchronization by sending bad line number 1/4 of the time
+        const auto line_num = std::rand() < RAND_MAX/4 ? 0 : this->sent;
 #endif
-    std::string full_line = "N" + boost::lexical_cast<std::string>(line_num) + " " + line;
-    
-    // calculate checksum
-    int cs = 0;
-    for (std::string::const_iterator it = full_line.begin(); it != full_line.end(); ++it)
-       cs = cs ^ *it;
-    
-    // write line to device
-    full_line += "*";
-    full_line += boost::lexical_cast<std::string>(cs);
-    full_line += "\n";
-    
+        std::string full_line = "N" + boost::lexical_cast<std::string>(line_num) + " " + line;
+        if (this->meatpack_no_spaces && !has_string_argument(line))
+            full_line.erase(std::remove(full_line.begin(), full_line.end(), ' '), full_line.end());
+        
+        // calculate checksum
+        int cs = 0;
+        for (std::string::const_iterator it = full_line.begin(); it != full_line.end(); ++it)
+           cs = cs ^ *it;
+        
+        // write line to device
+        full_line += "*";
+        full_line += boost::lexical_cast<std::string>(cs);
+        full_line += "\n";
+        
 #ifdef DEBUG_SERIAL
-    fs << ">> " << full_line << std::flush;
+        fs << ">> " << full_line << std::flush;
 #endif
-    
-    this->last_sent.push_back(line);
-    this->can_send = false;
-    
-    while (this->last_sent.size() > KEEP_SENT) {
-        this->last_sent.pop_front();
+        
+        this->last_sent.push_back(line);
+        while (this->last_sent.size() > std::max<size_t>(KEEP_SENT, 2 * this->window_lines)) {
+            this->last_sent.pop_front();
+        }
+        
+        if (this->meatpack)
+            full_line = MeatPack::pack_line(full_line, this->meatpack_no_spaces);
+        this->in_flight.push_back(full_line.size());
+        this->in_flight_bytes += full_line.size();
+        
+        // we can't supply boost::asio::buffer(full_line) to async_write() because full_line is on the
+        // stack and the buffer would lose its underlying storage causing memory corruption
+        os << full_line;
+        
+        // stop if the next line may not fit the receive buffer of the firmware
+        if (this->window_bytes > 0 && this->in_flight_bytes >= this->window_bytes) break;
     }
     
-    // we can't supply boost::asio::buffer(full_line) to async_write() because full_line is on the
-    // stack and the buffer would lose its underlying storage causing memory corruption
-    std::ostream os(&this->write_buffer);
-    os << full_line;
+    if (this->write_buffer.size() == 0) return;
+    this->written += this->write_buffer.size();
+    this->writing = true;
     boost::asio::async_write(this->serial, this->write_buffer, boost::bind(&GCodeSender::on_write, this, boost::asio::placeholders::error,
                 boost::asio::placeholders::bytes_transferred));
 }
@@ -533,6 +660,10 @@ void
 GCodeSender::on_write(const boost::system::error_code& error,
     size_t bytes_transferred)
 {
+    {
+        boost::lock_guard<boost::mutex> l(this->queue_mutex);
+        this->writing = false;
+    }
     this->set_error_status(false);
     if (error) {
         if (this->open) {
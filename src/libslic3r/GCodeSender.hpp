@@ -2,10 +2,13 @@
 #define slic3r_GCodeSender_hpp_
 
 #include "libslic3r.h"
+#include <deque>
+#include <list>
 #include <queue>
 #include <string>
 #include <vector>
 #include <boost/asio.hpp>
+#include <boost/noncopyable.hpp>
 #include <boost/bind/bind.hpp>
 #include <boost/thread.hpp>
 
@@ -13,6 +16,30 @@ namespace Slic3r {
 
 namespace asio = boost::asio;
 
+// MeatPack stream compression as implemented by Marlin (MEATPACK_ON_SERIAL_PORT_x) and the Prusa firmware.
+// The 15 most frequent G-code characters are packed into 4 bit codes, two characters per byte,
+// the other characters are sent in full after the byte holding their 0b1111 code.
+class MeatPack {
+    public:
+    // Two signal bytes followed by a command byte switch the state of the firmware decoder.
+    static constexpr unsigned char SignalByte           = 0xFF;
+    static constexpr unsigned char CmdEnablePacking     = 0xFB;
+    static constexpr unsigned char CmdDisablePacking    = 0xFA;
+    static constexpr unsigned char CmdResetAll          = 0xF9;
+    static constexpr unsigned char CmdQueryConfig       = 0xF8;
+    static constexpr unsigned char CmdEnableNoSpaces    = 0xF7;
+    static constexpr unsigned char CmdDisableNoSpaces   = 0xF6;
+    // Code of a character sent in full.
+    static constexpr unsigned char FullCharCode         = 0x0F;
+
+    static std::string command(unsigned char cmd);
+    // Returns the 4 bit code of a character, FullCharCode if the character cannot be packed.
+    static unsigned char pack_char(char c, bool no_spaces);
+    // Packs a line ending with '\n'. With no_spaces the line shall not contain spaces to be packed,
+    // the code of the space is taken by 'E'.
+    static std::string pack_line(const std::string &line, bool no_spaces);
+};
+
 class GCodeSender : private boost::noncopyable {
     public:
     GCodeSender();
@@ -33,6 +60,15 @@ class GCodeSender : private boost::noncopyable {
     std::string getB() const;
     void set_DTR(bool on);
     void reset();
+    // To be called before connect(). The firmware has to be built with MeatPack support.
+    // With omit_spaces the spaces are stripped from the G-code lines, except for the commands taking a string argument.
+    void set_meatpack(bool enable, bool omit_spaces = false);
+    // To be called before connect(). Send up to max_lines lines (max_bytes bytes on the wire) ahead without waiting
+    // for "ok", to keep the serial line busy. The default of a single line waits for "ok" after each line.
+    // max_bytes shall not exceed the size of the receive buffer of the firmware.
+    void set_send_window(size_t max_lines, size_t max_bytes);
+    // Number of bytes written to the serial port since connect(), for throughput statistics.
+    size_t bytes_written() const;
     
     private:
     asio::io_service io;
@@ -52,6 +88,17 @@ class GCodeSender : private boost::noncopyable {
     bool queue_paused;
     size_t sent;
     std::deque<std::string> last_sent;
+    // wire sizes of the lines sent and not acknowledged by "ok" yet, oldest first
+    std::deque<size_t> in_flight;
+    size_t in_flight_bytes;
+    size_t window_lines, window_bytes;
+    // whether an async_write() is pending on write_buffer
+    bool writing;
+    // Resend requested from this line. The lines in flight at the time of the request are rejected by the firmware
+    // one by one, each of them repeating the same request, which shall be ignored.
+    size_t resend_from, resend_stale;
+    bool meatpack, meatpack_no_spaces, meatpack_active;
+    size_t written;
     
     // this mutex guards log, T, B
     mutable boost::mutex log_mutex;
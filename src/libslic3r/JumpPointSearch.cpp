@@ -2,17 +2,21 @@
 #include "BoundingBox.hpp"
 #include "Point.hpp"
 #include "libslic3r/AStar.hpp"
-#include "libslic3r/KDTreeIndirect.hpp"
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/Print.hpp"
 #include "libslic3r/Polyline.hpp"
 #include "libslic3r/libslic3r.h"
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <iterator>
-#include <limits>
-#include <optional>
 #include <unordered_map>
 #include <vector>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
 //#define DEBUG_FILES
 #ifdef DEBUG_FILES
 #include "libslic3r/SVG.hpp"
@@ -71,11 +75,21 @@ public:
         CellPositionType incoming_dir;
     };
 
-    JPSTracer(CellPositionType target, CellQueryFn is_passable) : target(target), is_passable(is_passable) {}
+    // Cells are identified by their position relative to id_origin in rows of id_row_size cells.
+    // At most max_expanded nodes are expanded, then the search runs out of nodes and fails.
+    JPSTracer(CellPositionType target, CellQueryFn is_passable, CellPositionType id_origin, size_t id_row_size, size_t max_expanded)
+        : target(target), is_passable(is_passable), id_origin(id_origin), id_row_size(id_row_size), max_expanded(max_expanded)
+    {}
+
+    bool budget_exceeded() const { return expanded > max_expanded; }
 
 private:
     CellPositionType target;
     CellQueryFn      is_passable; // should return boolean whether the cell is passable or not
+    CellPositionType id_origin;
+    size_t           id_row_size;
+    size_t           max_expanded;
+    mutable size_t   expanded { 0 };
 
     CellPositionType find_jump_point(CellPositionType start, CellPositionType forward_dir) const
     {
@@ -119,6 +133,9 @@ private:
 public:
     template<class Fn> void foreach_reachable(const Node &from, Fn &&fn) const
     {
+        if (++ expanded > max_expanded)
+            return;
+
         const CellPositionType &      pos         = from.position;
         const CellPositionType &      forward_dir = from.incoming_dir;
         std::vector<CellPositionType> dirs_to_check{};
@@ -161,27 +178,41 @@ public:
 
     float goal_heuristic(Node n) const { return n.position == target ? -1.f : (target - n.position).template cast<double>().norm(); }
 
-    size_t unique_id(Node n) const { return (static_cast<size_t>(uint16_t(n.position.x())) << 16) + static_cast<size_t>(uint16_t(n.position.y())); }
+    size_t unique_id(Node n) const { return size_t(n.position.y() - id_origin.y()) * id_row_size + size_t(n.position.x() - id_origin.x()); }
 
     const std::vector<CellPositionType> all_directions{{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
 };
 
+void JPSPathFinder::init_bed_shape(const Points &bed_shape)
+{
+    this->bed_shape = to_lines(Polygon{bed_shape});
+    BoundingBox bbox(bed_shape);
+    // Keep a margin of free pixels around the bed outline, so that the travels may follow it from outside.
+    grid_origin   = pixelize(bbox.min) - Pixel(2, 2);
+    grid_width    = pixelize(bbox.max).x() + 3 - grid_origin.x();
+    grid_height   = pixelize(bbox.max).y() + 3 - grid_origin.y();
+    words_per_row = (size_t(grid_width) + 63) / 64;
+    this->clear();
+}
+
 void JPSPathFinder::clear()
 {
-    inpassable.clear();
-    max_search_box.max = Pixel(std::numeric_limits<coord_t>::min(), std::numeric_limits<coord_t>::min());
-    max_search_box.min = Pixel(std::numeric_limits<coord_t>::max(), std::numeric_limits<coord_t>::max());
+    occupancy.assign(words_per_row * size_t(grid_height), 0);
     add_obstacles(bed_shape);
 }
 
+void JPSPathFinder::set_inpassable(std::vector<uint64_t> &grid, const Pixel &p) const
+{
+    coord_t x = p.x() - grid_origin.x();
+    coord_t y = p.y() - grid_origin.y();
+    if (x >= 0 && y >= 0 && x < grid_width && y < grid_height)
+        grid[size_t(y) * words_per_row + (size_t(x) >> 6)] |= uint64_t(1) << (x & 63);
+}
+
 void JPSPathFinder::add_obstacles(const Lines &obstacles)
 {
     auto store_obstacle = [&](coord_t x, coord_t y) {
-        max_search_box.max.x() = std::max(max_search_box.max.x(), x);
-        max_search_box.max.y() = std::max(max_search_box.max.y(), y);
-        max_search_box.min.x() = std::min(max_search_box.min.x(), x);
-        max_search_box.min.y() = std::min(max_search_box.min.y(), y);
-        inpassable.insert(Pixel{x, y});
+        set_inpassable(occupancy, Pixel{x, y});
         return true;
     };
 
@@ -192,25 +223,118 @@ void JPSPathFinder::add_obstacles(const Lines &obstacles)
     }
 }
 
+void JPSPathFinder::rasterize(const ExPolygon &expolygon, const Point &shift, std::vector<uint64_t> &grid) const
+{
+    BoundingBox bbox = get_extents(expolygon.contour);
+    bbox.translate(shift.x(), shift.y());
+    coord_t y_min = std::max(pixelize(bbox.min).y(), grid_origin.y());
+    coord_t y_max = std::min(pixelize(bbox.max).y(), grid_origin.y() + grid_height - 1);
+
+    // Fill the spans between the intersections of the pixel row centers with the contour and the holes.
+    std::vector<coord_t> xs;
+    for (coord_t y = y_min; y <= y_max; ++ y) {
+        const coord_t yc = y * resolution + resolution / 2 - shift.y();
+        xs.clear();
+        auto intersect = [&xs, yc](const Polygon &polygon) {
+            for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i ++) {
+                const Point &a = polygon[j];
+                const Point &b = polygon[i];
+                if ((a.y() <= yc) != (b.y() <= yc))
+                    xs.emplace_back(a.x() + coord_t(double(yc - a.y()) * double(b.x() - a.x()) / double(b.y() - a.y())));
+            }
+        };
+        intersect(expolygon.contour);
+        for (const Polygon &hole : expolygon.holes)
+            intersect(hole);
+        std::sort(xs.begin(), xs.end());
+
+        const size_t row = size_t(y - grid_origin.y()) * words_per_row;
+        for (size_t i = 0; i + 1 < xs.size(); i += 2) {
+            coord_t x0 = std::max(floor_div(xs[i] + shift.x()) - grid_origin.x(), coord_t(0));
+            coord_t x1 = std::min(floor_div(xs[i + 1] + shift.x()) - grid_origin.x(), grid_width - 1);
+            if (x0 > x1)
+                continue;
+            size_t w0 = size_t(x0) >> 6;
+            size_t w1 = size_t(x1) >> 6;
+            uint64_t mask0 = ~uint64_t(0) << (x0 & 63);
+            uint64_t mask1 = ~uint64_t(0) >> (63 - (x1 & 63));
+            if (w0 == w1) {
+                grid[row + w0] |= mask0 & mask1;
+            } else {
+                grid[row + w0] |= mask0;
+                for (size_t w = w0 + 1; w < w1; ++ w)
+                    grid[row + w] = ~uint64_t(0);
+                grid[row + w1] |= mask1;
+            }
+        }
+    }
+
+    // The spans miss the features thinner than a pixel, block the pixels of the outlines as well.
+    auto store_obstacle = [&](coord_t x, coord_t y) {
+        set_inpassable(grid, Pixel{x, y});
+        return true;
+    };
+    for (const Line &l : to_lines(expolygon)) {
+        Pixel start = pixelize(l.a + shift);
+        Pixel end   = pixelize(l.b + shift);
+        dda(start.x(), start.y(), end.x(), end.y(), store_obstacle);
+    }
+}
+
+void JPSPathFinder::add_obstacles(const Layer &layer, coord_t clearance)
+{
+    assert(! this->empty());
+    print_z = layer.print_z;
+
+    // Islands of all objects and their instances printed at the same time as the layer.
+    std::vector<std::pair<const ExPolygon*, Point>> islands;
+    for (const PrintObject *object : layer.object()->print()->objects())
+        if (const Layer *l = object->get_layer_at_printz(layer.print_z, EPSILON); l)
+            for (const PrintInstance &instance : object->instances())
+                for (const ExPolygon &island : l->lslices)
+                    islands.emplace_back(&island, instance.shift);
+
+    tbb::enumerable_thread_specific<std::vector<uint64_t>> grids([this]() { return std::vector<uint64_t>(occupancy.size(), 0); });
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, islands.size()), [this, clearance, &islands, &grids](const tbb::blocked_range<size_t> &range) {
+        std::vector<uint64_t> &grid = grids.local();
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            if (clearance > 0) {
+                for (const ExPolygon &expolygon : offset_ex(*islands[i].first, float(clearance)))
+                    rasterize(expolygon, islands[i].second, grid);
+            } else
+                rasterize(*islands[i].first, islands[i].second, grid);
+    });
+    grids.combine_each([this](const std::vector<uint64_t> &grid) {
+        for (size_t i = 0; i < occupancy.size(); ++ i)
+            occupancy[i] |= grid[i];
+    });
+}
+
 Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
 {
     Pixel start = pixelize(p0);
     Pixel end   = pixelize(p1);
-    if (inpassable.empty() || (start - end).cast<float>().norm() < 3.0) { return Polyline{p0, p1}; }
+    if (occupancy.empty() || (start - end).cast<float>().norm() < 3.0) { return Polyline{p0, p1}; }
 
-    if (inpassable.find(start) != inpassable.end()) {
+    // Leave the obstacles containing the start and the end along the straight line between them.
+    bool start_found = ! is_inpassable(start);
+    if (! start_found) {
         dda(start.x(), start.y(), end.x(), end.y(), [&](coord_t x, coord_t y) {
-            if (inpassable.find(Pixel(x, y)) == inpassable.end() || start == end) { // new start not found yet, and xy passable
-                start = Pixel(x, y);
+            if (! is_inpassable(Pixel(x, y))) {
+                start       = Pixel(x, y);
+                start_found = true;
                 return false;
             }
             return true;
         });
+        if (! start_found)
+            // The whole travel runs inside obstacles, there is nothing to plan around.
+            return {};
     }
 
-    if (inpassable.find(end) != inpassable.end()) {
+    if (is_inpassable(end)) {
         dda(end.x(), end.y(), start.x(), start.y(), [&](coord_t x, coord_t y) {
-            if (inpassable.find(Pixel(x, y)) == inpassable.end() || start == end) { // new start not found yet, and xy passable
+            if (! is_inpassable(Pixel(x, y))) {
                 end = Pixel(x, y);
                 return false;
             }
@@ -218,7 +342,7 @@ Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
         });
     }
 
-    BoundingBox search_box = max_search_box;
+    BoundingBox search_box(grid_origin, grid_origin + Pixel(grid_width - 1, grid_height - 1));
     search_box.max -= Pixel(1, 1);
     search_box.min += Pixel(1, 1);
 
@@ -235,34 +359,21 @@ Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
     search_box.max = search_box.max.cwiseMin(bounding_square.max);
     search_box.min = search_box.min.cwiseMax(bounding_square.min);
 
-    auto cell_query = [&](Pixel pixel) { return search_box.contains(pixel) && (pixel == start || pixel == end || inpassable.find(pixel) == inpassable.end()); };
+    auto cell_query = [&](Pixel pixel) { return search_box.contains(pixel) && (pixel == start || pixel == end || ! is_inpassable(pixel)); };
 
-    JPSTracer<Pixel, decltype(cell_query)> tracer(end, cell_query);
+    JPSTracer<Pixel, decltype(cell_query)> tracer(end, cell_query, grid_origin, size_t(grid_width), search_budget);
     using QNode = astar::QNode<JPSTracer<Pixel, decltype(cell_query)>>;
 
     std::unordered_map<size_t, QNode>          astar_cache{};
     std::vector<Pixel> out_path;
     std::vector<decltype(tracer)::Node>        out_nodes;
 
-    if (!astar::search_route(tracer, {start, {0, 0}}, std::back_inserter(out_nodes), astar_cache)) {
-        // path not found - just reconstruct the best path from astar cache.
-        // Note that astar_cache is NOT empty - at least the starting point should always be there
-        auto                coordiante_func = [&astar_cache](size_t idx, size_t dim) { return float(astar_cache[idx].node.position[dim]); };
-        std::vector<size_t> keys;
-        keys.reserve(astar_cache.size());
-        for (const auto &pair : astar_cache) { keys.push_back(pair.first); }
-        KDTreeIndirect<2, float, decltype(coordiante_func)> kd_tree(coordiante_func, keys);
-        size_t                                              closest_qnode = find_closest_point(kd_tree, end.cast<float>());
-
-        out_path.push_back(end);
-        while (closest_qnode != astar::Unassigned) {
-            out_path.push_back(astar_cache[closest_qnode].node.position);
-            closest_qnode = astar_cache[closest_qnode].parent;
-        }
-    } else {
-        for (const auto &node : out_nodes) { out_path.push_back(node.position); }
-        out_path.push_back(start);
-    }
+    if (!astar::search_route(tracer, {start, {0, 0}}, std::back_inserter(out_nodes), astar_cache))
+        // Path not found within the search box or the search budget.
+        return {};
+
+    for (const auto &node : out_nodes) { out_path.push_back(node.position); }
+    out_path.push_back(start);
 
 #ifdef DEBUG_FILES
     auto scaled_points = [](const Points &ps) {
@@ -273,7 +384,9 @@ Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
     auto          scaled_point = [](const Point &p) { return Point::new_scale(p.x(), p.y()); };
     ::Slic3r::SVG svg(debug_out_path(("path_jps" + std::to_string(print_z) + "_" + std::to_string(rand() % 1000)).c_str()).c_str(),
                       BoundingBox(scaled_point(search_box.min), scaled_point(search_box.max)));
-    for (const auto &p : inpassable) { svg.draw(scaled_point(p), "black", scale_(0.4)); }
+    for (coord_t y = search_box.min.y(); y <= search_box.max.y(); ++ y)
+        for (coord_t x = search_box.min.x(); x <= search_box.max.x(); ++ x)
+            if (is_inpassable(Pixel(x, y))) { svg.draw(scaled_point(Pixel(x, y)), "black", scale_(0.4)); }
     for (const auto &qn : astar_cache) { svg.draw(scaled_point(qn.second.node.position), "blue", scale_(0.3)); }
     svg.draw(Polyline(scaled_points(out_path)), "yellow", scale_(0.25));
     svg.draw(scaled_point(end), "purple", scale_(0.4));
@@ -308,7 +421,7 @@ Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
             if (i - index_of_last_stored_point < 2) continue;
             bool passable       = true;
             auto store_obstacle = [&](coord_t x, coord_t y) {
-                if (Pixel(x, y) != start && Pixel(x, y) != end && inpassable.find(Pixel(x, y)) != inpassable.end()) {
+                if (Pixel(x, y) != start && Pixel(x, y) != end && is_inpassable(Pixel(x, y))) {
                     passable = false;
                     return false;
                 }
@@ -330,10 +443,17 @@ Polyline JPSPathFinder::find_path(const Point &p0, const Point &p1)
 #endif
 
     // before returing the path, transform it from pixels back to points.
-    // Also replace the first and last pixel by input points so that result path patches input params exactly.
+    // Also replace the first and last pixel by input points so that result path patches input params exactly,
+    // unless the search started or ended outside of the obstacle containing the input point.
     for (Pixel &p : out_path) { p = unpixelize(p); }
-    out_path.front() = p0;
-    out_path.back()  = p1;
+    if (start == pixelize(p0))
+        out_path.front() = p0;
+    else
+        out_path.insert(out_path.begin(), p0);
+    if (end == pixelize(p1))
+        out_path.back() = p1;
+    else
+        out_path.push_back(p1);
 
     return Polyline(out_path);
 }
@@ -8,28 +8,60 @@
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Polyline.hpp"
 #include "libslic3r/libslic3r.h"
-#include <unordered_map>
-#include <unordered_set>
+#include <cstdint>
+#include <vector>
 
 namespace Slic3r {
 
+// Planner of collision free travels on a grid of the bed, using the Jump Point Search variant of A*.
+// The obstacles are held in a packed occupancy grid spanning the bed shape, one bit per pixel.
 class JPSPathFinder
 {
     using Pixel = Point;
-    std::unordered_set<Pixel, PointHash> inpassable;
-    coordf_t                             print_z;
-    BoundingBox                          max_search_box;
-    Lines                                bed_shape;
+    // Bit set for each inpassable pixel, row by row. Pixels outside of the grid are inpassable.
+    std::vector<uint64_t> occupancy;
+    // Pixel of the first bit of the grid and the size of the grid in pixels.
+    Pixel                 grid_origin { 0, 0 };
+    coord_t               grid_width { 0 };
+    coord_t               grid_height { 0 };
+    size_t                words_per_row { 0 };
+    coordf_t              print_z { 0. };
+    Lines                 bed_shape;
+    // Maximum number of nodes expanded by a single search.
+    size_t                search_budget { 100000 };
 
-    const coord_t resolution = scaled(1.5);
-    Pixel         pixelize(const Point &p) { return p / resolution; }
-    Point         unpixelize(const Pixel &p) { return p * resolution; }
+    const coord_t resolution;
+    Pixel         pixelize(const Point &p) const { return { floor_div(p.x()), floor_div(p.y()) }; }
+    // Center of the pixel.
+    Point         unpixelize(const Pixel &p) const { return p * resolution + Point(resolution / 2, resolution / 2); }
+    coord_t       floor_div(coord_t v) const { return v >= 0 ? v / resolution : - ((- v + resolution - 1) / resolution); }
+
+    bool          is_inpassable(const Pixel &p) const
+    {
+        coord_t x = p.x() - grid_origin.x();
+        coord_t y = p.y() - grid_origin.y();
+        return x < 0 || y < 0 || x >= grid_width || y >= grid_height ||
+               (occupancy[size_t(y) * words_per_row + (size_t(x) >> 6)] >> (x & 63)) & 1;
+    }
+    void          set_inpassable(std::vector<uint64_t> &grid, const Pixel &p) const;
+    // Mark the pixels covered by the expolygon shifted by shift, including its outline.
+    void          rasterize(const ExPolygon &expolygon, const Point &shift, std::vector<uint64_t> &grid) const;
 
 public:
-    JPSPathFinder() = default;
-    void     init_bed_shape(const Points &bed_shape) { this->bed_shape = (to_lines(Polygon{bed_shape})); };
+    explicit JPSPathFinder(coord_t resolution = scaled<coord_t>(1.5)) : resolution(resolution) {}
+    // Sets up the grid spanning the bed shape and clears it.
+    void     init_bed_shape(const Points &bed_shape);
+    void     set_search_budget(size_t max_expanded_nodes) { this->search_budget = max_expanded_nodes; }
+    bool     empty() const { return this->occupancy.empty(); }
     void     clear();
     void     add_obstacles(const Lines &obstacles);
+    // Add the lslices of all objects and their instances printed at the print_z of the layer, in the world coordinates.
+    // The islands are grown by clearance, so that the paths keep the same distance from the islands as the boundary walk
+    // of AvoidCrossingPerimeters. The islands are rasterized in parallel.
+    void     add_obstacles(const Layer &layer, coord_t clearance = 0);
+    // Path from start to end around the obstacles. Start and end may lie inside obstacles, the path leaves them along
+    // the straight line between start and end. Returns an empty polyline if the straight line never leaves the obstacles
+    // or if no path was found within the search budget.
     Polyline find_path(const Point &start, const Point &end);
 };
 
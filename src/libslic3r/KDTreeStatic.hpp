@@ -0,0 +1,257 @@
+// Static KD tree with the coordinates of the points stored in an implicit array layout.
+
+#ifndef slic3r_KDTreeStatic_hpp_
+#define slic3r_KDTreeStatic_hpp_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+
+namespace Slic3r {
+
+// KD tree for N-dimensional closest point and radius search over a point set, which does not change after the tree is built.
+// Contrary to KDTreeIndirect, the coordinates are copied into the nodes, so the queries do not call back into the user data,
+// and the tree is stored in a left balanced implicit layout: the children of node i are nodes 2i+1 and 2i+2 and the n points
+// occupy exactly the first n nodes, without any holes. The split dimension cycles with the depth of the node.
+// The tree is built in parallel, the batched queries are evaluated in parallel.
+template<size_t ANumDimensions, typename ACoordType>
+class KDTreeStatic
+{
+public:
+    static constexpr size_t NumDimensions = ANumDimensions;
+    using                   CoordType     = ACoordType;
+    enum : size_t {
+        npos = size_t(-1)
+    };
+
+    KDTreeStatic() = default;
+    // point_fn(idx) returns the idx'th point, its coordinates accessed by operator[].
+    template<typename PointFn>
+    KDTreeStatic(size_t num_points, PointFn point_fn) { this->build(num_points, point_fn); }
+
+    template<typename PointFn>
+    void build(size_t num_points, PointFn point_fn)
+    {
+        assert(num_points < size_t(std::numeric_limits<uint32_t>::max()));
+        std::vector<Node> input(num_points);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_points, parallel_grain_size),
+            [&input, &point_fn](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i < range.end(); ++ i) {
+                    const auto &pt = point_fn(i);
+                    for (size_t dim = 0; dim < NumDimensions; ++ dim)
+                        input[i].coord[dim] = CoordType(pt[dim]);
+                    input[i].idx = uint32_t(i);
+                }
+            });
+        m_nodes.assign(num_points, Node());
+        if (num_points > 0)
+            this->build_recursive(input.data(), input.data() + num_points, 0, 0);
+    }
+
+    void   clear()       { m_nodes.clear(); }
+    bool   empty() const { return m_nodes.empty(); }
+    size_t size()  const { return m_nodes.size(); }
+
+    // Returns the K points closest to pt accepted by filter(idx), sorted by distance, padded with npos.
+    template<size_t K, typename PointType, typename FilterFn>
+    std::array<size_t, K> closest_points(const PointType &pt, FilterFn filter) const
+    {
+        std::array<std::pair<size_t, CoordType>, K> results;
+        results.fill(std::make_pair(size_t(npos), std::numeric_limits<CoordType>::max()));
+        this->traverse(pt,
+            [&results, &pt, &filter](const Node &node) {
+                if (filter(size_t(node.idx))) {
+                    const CoordType dist = squared_distance(node, pt);
+                    if (dist < results.back().second) {
+                        auto it = std::upper_bound(results.begin(), results.end(), dist, [](CoordType d, const auto &r) { return d < r.second; });
+                        std::move_backward(it, std::prev(results.end()), results.end());
+                        *it = std::make_pair(size_t(node.idx), dist);
+                    }
+                }
+            },
+            [&results]() { return results.back().second; });
+        std::array<size_t, K> out;
+        for (size_t i = 0; i < K; ++ i)
+            out[i] = results[i].first;
+        return out;
+    }
+
+    template<typename PointType, typename FilterFn>
+    size_t closest_point(const PointType &pt, FilterFn filter) const { return this->closest_points<1>(pt, filter).front(); }
+
+    // Appends the points closer to pt than radius accepted by filter(idx), in no particular order.
+    template<typename PointType, typename FilterFn>
+    void nearby_points(const PointType &pt, CoordType radius, FilterFn filter, std::vector<size_t> &out) const
+    {
+        const CoordType radius_squared = radius * radius;
+        this->traverse(pt,
+            [radius_squared, &pt, &filter, &out](const Node &node) {
+                if (filter(size_t(node.idx)) && squared_distance(node, pt) < radius_squared)
+                    out.emplace_back(size_t(node.idx));
+            },
+            [radius_squared]() { return radius_squared; });
+    }
+
+    // Batched closest_points() for num_queries points returned by query_point(query_idx), evaluated in parallel.
+    // The candidates are filtered by filter(query_idx, idx).
+    template<size_t K, typename QueryPointFn, typename FilterFn>
+    std::vector<std::array<size_t, K>> closest_points_batch(size_t num_queries, QueryPointFn query_point, FilterFn filter) const
+    {
+        std::vector<std::array<size_t, K>> out(num_queries);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_queries, parallel_grain_size),
+            [this, &out, &query_point, &filter](const tbb::blocked_range<size_t> &range) {
+                for (size_t query_idx = range.begin(); query_idx < range.end(); ++ query_idx)
+                    out[query_idx] = this->closest_points<K>(query_point(query_idx), [&filter, query_idx](size_t idx) { return filter(query_idx, idx); });
+            });
+        return out;
+    }
+
+    // Batched nearby_points() for num_queries points returned by query_point(query_idx), evaluated in parallel.
+    // The candidates are filtered by filter(query_idx, idx).
+    template<typename QueryPointFn, typename FilterFn>
+    std::vector<std::vector<size_t>> nearby_points_batch(size_t num_queries, QueryPointFn query_point, CoordType radius, FilterFn filter) const
+    {
+        std::vector<std::vector<size_t>> out(num_queries);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_queries, parallel_grain_size),
+            [this, &out, &query_point, radius, &filter](const tbb::blocked_range<size_t> &range) {
+                for (size_t query_idx = range.begin(); query_idx < range.end(); ++ query_idx)
+                    this->nearby_points(query_point(query_idx), radius, [&filter, query_idx](size_t idx) { return filter(query_idx, idx); }, out[query_idx]);
+            });
+        return out;
+    }
+
+private:
+    struct Node {
+        std::array<CoordType, NumDimensions> coord;
+        // Index of the point in the input sequence.
+        uint32_t                             idx;
+    };
+
+    // Ranges shorter than this are processed serially.
+    static constexpr size_t parallel_grain_size = 1024;
+
+    template<typename PointType>
+    static CoordType squared_distance(const Node &node, const PointType &pt)
+    {
+        CoordType dist = CoordType(0);
+        for (size_t dim = 0; dim < NumDimensions; ++ dim) {
+            CoordType d = CoordType(pt[dim]) - node.coord[dim];
+            dist += d * d;
+        }
+        return dist;
+    }
+
+    // Number of nodes of the left subtree of a left balanced tree of n nodes: all levels are full except the last one,
+    // which is filled from the left.
+    static size_t left_subtree_size(size_t n)
+    {
+        // The complete levels hold full - 1 nodes, the last level holds the rest.
+        size_t full = 1;
+        while (2 * full - 1 <= n)
+            full *= 2;
+        const size_t half = full / 2;
+        return (half - 1) + std::min(n - (full - 1), half);
+    }
+
+    void build_recursive(Node *begin, Node *end, size_t node, size_t dimension)
+    {
+        const size_t n = end - begin;
+        if (n == 0)
+            return;
+        assert(node < m_nodes.size());
+        Node *median = begin + left_subtree_size(n);
+        std::nth_element(begin, median, end, [dimension](const Node &l, const Node &r) { return l.coord[dimension] < r.coord[dimension]; });
+        m_nodes[node] = *median;
+        const size_t next_dimension = (dimension + 1 == NumDimensions) ? 0 : dimension + 1;
+        auto build_left  = [this, begin, median, node, next_dimension]() { this->build_recursive(begin, median, node * 2 + 1, next_dimension); };
+        auto build_right = [this, median, end, node, next_dimension]() { this->build_recursive(median + 1, end, node * 2 + 2, next_dimension); };
+        if (n > parallel_grain_size)
+            tbb::parallel_invoke(build_left, build_right);
+        else {
+            build_left();
+            build_right();
+        }
+    }
+
+    // Visits the nodes, which may be closer to pt than sqrt(bound_fn()), the nearer child first.
+    // The bound may only shrink during the traversal.
+    template<typename PointType, typename VisitFn, typename BoundFn>
+    void traverse(const PointType &pt, VisitFn visit, BoundFn bound_fn) const
+    {
+        if (m_nodes.empty())
+            return;
+        struct StackEntry {
+            size_t    node;
+            size_t    dimension;
+            // Lower bound of the squared distance of the subtree points to pt.
+            CoordType bound;
+        };
+        // The tree is balanced, each level adds at most one entry to the stack.
+        std::array<StackEntry, 2 * sizeof(size_t) * 8> stack;
+        size_t stack_size = 0;
+        stack[stack_size ++] = { 0, 0, CoordType(0) };
+        while (stack_size > 0) {
+            const StackEntry entry = stack[-- stack_size];
+            if (entry.bound >= bound_fn())
+                continue;
+            const Node &node = m_nodes[entry.node];
+            visit(node);
+            const CoordType diff           = CoordType(pt[entry.dimension]) - node.coord[entry.dimension];
+            const size_t    next_dimension = (entry.dimension + 1 == NumDimensions) ? 0 : entry.dimension + 1;
+            const size_t    left           = entry.node * 2 + 1;
+            const size_t    near_child     = diff < CoordType(0) ? left : left + 1;
+            const size_t    far_child      = diff < CoordType(0) ? left + 1 : left;
+            assert(stack_size + 2 <= stack.size());
+            if (far_child < m_nodes.size())
+                stack[stack_size ++] = { far_child, next_dimension, std::max(entry.bound, diff * diff) };
+            if (near_child < m_nodes.size())
+                stack[stack_size ++] = { near_child, next_dimension, entry.bound };
+        }
+    }
+
+    std::vector<Node> m_nodes;
+};
+
+// Overloads of the KDTreeIndirect queries for KDTreeStatic, so that the two trees are interchangeable.
+template<size_t K, typename PointType, typename FilterFn, size_t D, typename CoordT>
+std::array<size_t, K> find_closest_points(const KDTreeStatic<D, CoordT> &kdtree, const PointType &point, FilterFn filter)
+{
+    return kdtree.template closest_points<K>(point, filter);
+}
+
+template<typename PointType, typename FilterFn, size_t D, typename CoordT>
+size_t find_closest_point(const KDTreeStatic<D, CoordT> &kdtree, const PointType &point, FilterFn filter)
+{
+    return kdtree.closest_point(point, filter);
+}
+
+template<typename PointType, size_t D, typename CoordT>
+size_t find_closest_point(const KDTreeStatic<D, CoordT> &kdtree, const PointType &point)
+{
+    return kdtree.closest_point(point, [](size_t) { return true; });
+}
+
+template<typename PointType, typename FilterFn, size_t D, typename CoordT>
+std::vector<size_t> find_nearby_points(const KDTreeStatic<D, CoordT> &kdtree, const PointType &center, const CoordT &max_distance, FilterFn filter)
+{
+    std::vector<size_t> out;
+    kdtree.nearby_points(center, max_distance, filter, out);
+    return out;
+}
+
+template<typename PointType, size_t D, typename CoordT>
+std::vector<size_t> find_nearby_points(const KDTreeStatic<D, CoordT> &kdtree, const PointType &center, const CoordT &max_distance)
+{
+    return find_nearby_points(kdtree, center, max_distance, [](size_t) { return true; });
+}
+
+} // namespace Slic3r
+
+#endif /* slic3r_KDTreeStatic_hpp_ */
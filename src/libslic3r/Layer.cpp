@@ -2,12 +2,16 @@
 #include "ClipperUtils.hpp"
 #include "Print.hpp"
 #include "Fill/Fill.hpp"
+#include "PerimeterGenerator.hpp"
 #include "ShortestPath.hpp"
 #include "SVG.hpp"
 #include "BoundingBox.hpp"
 
 #include <boost/log/trivial.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 namespace Slic3r {
 
 Layer::~Layer()
@@ -145,6 +149,8 @@ void Layer::make_perimeters()
     
     // keep track of regions whose perimeters we have already generated
     std::vector<unsigned char> done(m_regions.size(), false);
+    //BBS: lower layer slices grown for the overhang detection, shared by all the regions of this layer
+    LowerPolygonsSeriesCache lower_polygons_series_cache;
     
     for (LayerRegionPtrs::iterator layerm = m_regions.begin(); layerm != m_regions.end(); ++ layerm) 
     	if ((*layerm)->slices.empty()) {
@@ -186,6 +192,8 @@ void Layer::make_perimeters()
                         && config.fuzzy_skin_thickness        == other_config.fuzzy_skin_thickness
                         && config.fuzzy_skin_point_distance       == other_config.fuzzy_skin_point_distance
                         && config.fuzzy_skin_first_layer          == other_config.fuzzy_skin_first_layer
+                        && config.fuzzy_skin_noise_type           == other_config.fuzzy_skin_noise_type
+                        && config.fuzzy_skin_scale                == other_config.fuzzy_skin_scale
                         && config.seam_slope_type         == other_config.seam_slope_type
                         && config.seam_slope_conditional == other_config.seam_slope_conditional
                         && config.scarf_angle_threshold  == other_config.scarf_angle_threshold
@@ -208,7 +216,7 @@ void Layer::make_perimeters()
 	        
 	        if (layerms.size() == 1) {  // optimization
 	            (*layerm)->fill_surfaces.surfaces.clear();
-	            (*layerm)->make_perimeters((*layerm)->slices, &(*layerm)->fill_surfaces, &(*layerm)->fill_no_overlap_expolygons);
+	            (*layerm)->make_perimeters((*layerm)->slices, &(*layerm)->fill_surfaces, &(*layerm)->fill_no_overlap_expolygons, &lower_polygons_series_cache);
 	            (*layerm)->fill_expolygons = to_expolygons((*layerm)->fill_surfaces.surfaces);
 	        } else {
 	            SurfaceCollection new_slices;
@@ -232,7 +240,7 @@ void Layer::make_perimeters()
 	            SurfaceCollection fill_surfaces;
                 //BBS
                 ExPolygons fill_no_overlap;
-	            layerm_config->make_perimeters(new_slices, &fill_surfaces, &fill_no_overlap);
+	            layerm_config->make_perimeters(new_slices, &fill_surfaces, &fill_no_overlap, &lower_polygons_series_cache);
 
 	            // assign fill_surfaces to each layer
 	            if (!fill_surfaces.surfaces.empty()) { 
@@ -298,67 +306,21 @@ void Layer::export_region_fill_surfaces_to_svg(const char *path) const
 //BBS: method to simplify support path
 void Layer::simplify_support_entity_collection(ExtrusionEntityCollection* entity_collection)
 {
-    for (size_t i = 0; i < entity_collection->entities.size(); i++) {
-        if (ExtrusionEntityCollection* collection = dynamic_cast<ExtrusionEntityCollection*>(entity_collection->entities[i]))
-            this->simplify_support_entity_collection(collection);
-        else if (ExtrusionPath* path = dynamic_cast<ExtrusionPath*>(entity_collection->entities[i]))
-            this->simplify_support_path(path);
-        else if (ExtrusionMultiPath* multipath = dynamic_cast<ExtrusionMultiPath*>(entity_collection->entities[i]))
-            this->simplify_support_multi_path(multipath);
-        else if (ExtrusionLoop* loop = dynamic_cast<ExtrusionLoop*>(entity_collection->entities[i]))
-            this->simplify_support_loop(loop);
-        else
-            throw Slic3r::InvalidArgument("Invalid extrusion entity supplied to simplify_support_entity_collection()");
-    }
-}
-//BBS: method to simplify support path
-void Layer::simplify_support_path(ExtrusionPath * path)
-{
-    const auto print_config = this->object()->print()->config();
-    const bool spiral_mode = print_config.spiral_mode;
-    const bool enable_arc_fitting = print_config.enable_arc_fitting;
-    const auto scaled_resolution = scaled<double>(print_config.resolution.value);
+    const auto &print_config      = this->object()->print()->config();
+    const bool  fit_arcs          = print_config.enable_arc_fitting && !print_config.spiral_mode;
+    const auto  scaled_resolution = scaled<double>(print_config.resolution.value);
 
-    if (enable_arc_fitting &&
-        !spiral_mode) {
-        path->simplify_by_fitting_arc(SCALED_SUPPORT_RESOLUTION);
-    } else {
-        path->simplify(scaled_resolution);
-    }
-}
-//BBS: method to simplify support path
-void Layer::simplify_support_multi_path(ExtrusionMultiPath* multipath)
-{
-    const auto print_config = this->object()->print()->config();
-    const bool spiral_mode = print_config.spiral_mode;
-    const bool enable_arc_fitting = print_config.enable_arc_fitting;
-    const auto scaled_resolution = scaled<double>(print_config.resolution.value);
-
-    for (size_t i = 0; i < multipath->paths.size(); ++i) {
-        if (enable_arc_fitting &&
-            !spiral_mode) {
-            multipath->paths[i].simplify_by_fitting_arc(SCALED_SUPPORT_RESOLUTION);
-        } else {
-            multipath->paths[i].simplify(scaled_resolution);
-        }
-    }
-}
-//BBS: method to simplify support path
-void Layer::simplify_support_loop(ExtrusionLoop* loop)
-{
-    const auto print_config = this->object()->print()->config();
-    const bool spiral_mode = print_config.spiral_mode;
-    const bool enable_arc_fitting = print_config.enable_arc_fitting;
-    const auto scaled_resolution = scaled<double>(print_config.resolution.value);
-
-    for (size_t i = 0; i < loop->paths.size(); ++i) {
-        if (enable_arc_fitting &&
-            !spiral_mode) {
-            loop->paths[i].simplify_by_fitting_arc(SCALED_SUPPORT_RESOLUTION);
-        } else {
-            loop->paths[i].simplify(scaled_resolution);
-        }
-    }
+    std::vector<ExtrusionPath*> paths;
+    collect_extrusion_paths(*entity_collection, paths);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, paths.size(), 8),
+        [&paths, fit_arcs, scaled_resolution](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                if (fit_arcs)
+                    paths[i]->simplify_by_fitting_arc(SCALED_SUPPORT_RESOLUTION);
+                else
+                    paths[i]->simplify(scaled_resolution);
+            }
+        });
 }
 
 // Export to "out/LayerRegion-name-%d.svg" with an increasing index with every export.
@@ -17,6 +17,7 @@ class LayerRegion;
 using LayerRegionPtrs = std::vector<LayerRegion*>;
 class PrintRegion;
 class PrintObject;
+class LowerPolygonsSeriesCache;
 
 namespace FillAdaptive {
     struct Octree;
@@ -78,7 +79,8 @@ public:
     void    slices_to_fill_surfaces_clipped();
     void    prepare_fill_surfaces();
     //BBS
-    void    make_perimeters(const SurfaceCollection &slices, SurfaceCollection* fill_surfaces, ExPolygons* fill_no_overlap);
+    void    make_perimeters(const SurfaceCollection &slices, SurfaceCollection* fill_surfaces, ExPolygons* fill_no_overlap,
+                            LowerPolygonsSeriesCache *lower_polygons_series_cache = nullptr);
     void    process_external_surfaces(const Layer *lower_layer, const Polygons *lower_layer_covered);
     double  infill_area_threshold() const;
     // Trim surfaces by trimming polygons. Used by the elephant foot compensation at the 1st layer.
@@ -100,9 +102,6 @@ public:
     void    simplify_wall_extrusion_entity() { simplify_entity_collection(&perimeters); }
 private:
     void    simplify_entity_collection(ExtrusionEntityCollection* entity_collection);
-    void    simplify_path(ExtrusionPath* path);
-    void    simplify_multi_path(ExtrusionMultiPath* multipath);
-    void    simplify_loop(ExtrusionLoop* loop);
 
 protected:
     friend class Layer;
@@ -250,9 +249,6 @@ protected:
 
 //BBS: method to simplify support path
     void    simplify_support_entity_collection(ExtrusionEntityCollection* entity_collection);
-    void    simplify_support_path(ExtrusionPath* path);
-    void    simplify_support_multi_path(ExtrusionMultiPath* multipath);
-    void    simplify_support_loop(ExtrusionLoop* loop);
 
 private:
     // Sequential index of layer, 0-based, offsetted by number of raft layers.
@@ -15,6 +15,9 @@
 #include <boost/log/trivial.hpp>
 #include <boost/algorithm/clamp.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 namespace Slic3r {
 
 Flow LayerRegion::flow(FlowRole role) const
@@ -68,7 +71,8 @@ void LayerRegion::slices_to_fill_surfaces_clipped()
     }
 }
 
-void LayerRegion::make_perimeters(const SurfaceCollection &slices, SurfaceCollection* fill_surfaces, ExPolygons* fill_no_overlap)
+void LayerRegion::make_perimeters(const SurfaceCollection &slices, SurfaceCollection* fill_surfaces, ExPolygons* fill_no_overlap,
+                                  LowerPolygonsSeriesCache *lower_polygons_series_cache)
 {
     this->perimeters.clear();
     this->thin_fills.clear();
@@ -100,13 +104,16 @@ void LayerRegion::make_perimeters(const SurfaceCollection &slices, SurfaceCollec
         fill_no_overlap
     );
     
-    if (this->layer()->lower_layer != nullptr)
+    if (this->layer()->lower_layer != nullptr) {
         // Cummulative sum of polygons over all the regions.
         g.lower_slices = &this->layer()->lower_layer->lslices;
+        g.lower_polygons_series_cache = lower_polygons_series_cache;
+    }
     if (this->layer()->upper_layer != NULL)
         g.upper_slices = &this->layer()->upper_layer->lslices;
     
     g.layer_id              = (int)this->layer()->id();
+    g.slice_z               = this->layer()->slice_z;
     g.ext_perimeter_flow    = this->flow(frExternalPerimeter);
     g.overhang_flow         = this->bridging_flow(frPerimeter, object_config.thick_bridges);
     g.solid_infill_flow     = this->flow(frSolidInfill);
@@ -898,76 +905,24 @@ void LayerRegion::export_region_fill_surfaces_to_svg_debug(const char *name) con
 
 void LayerRegion::simplify_entity_collection(ExtrusionEntityCollection* entity_collection)
 {
-    for (size_t i = 0; i < entity_collection->entities.size(); i++) {
-        if (ExtrusionEntityCollection* collection = dynamic_cast<ExtrusionEntityCollection*>(entity_collection->entities[i]))
-            this->simplify_entity_collection(collection);
-        else if (ExtrusionPath* path = dynamic_cast<ExtrusionPath*>(entity_collection->entities[i]))
-            this->simplify_path(path);
-        else if (ExtrusionMultiPath* multipath = dynamic_cast<ExtrusionMultiPath*>(entity_collection->entities[i]))
-            this->simplify_multi_path(multipath);
-        else if (ExtrusionLoop* loop = dynamic_cast<ExtrusionLoop*>(entity_collection->entities[i]))
-            this->simplify_loop(loop);
-        else
-            throw Slic3r::InvalidArgument("Invalid extrusion entity supplied to simplify_entity_collection()");
-    }
-}
-
-void LayerRegion::simplify_path(ExtrusionPath* path)
-{
-    const auto print_config = this->layer()->object()->print()->config();
-    const bool spiral_mode = print_config.spiral_mode;
-    const bool enable_arc_fitting = print_config.enable_arc_fitting;
-    const auto scaled_resolution = scaled<double>(print_config.resolution.value);
-
-    if (enable_arc_fitting &&
-        !spiral_mode) {
-        if (path->role() == erInternalInfill)
-            path->simplify_by_fitting_arc(SCALED_SPARSE_INFILL_RESOLUTION);
-        else
-            path->simplify_by_fitting_arc(scaled_resolution);
-    } else {
-        path->simplify(scaled_resolution);
-    }
-}
-
-void LayerRegion::simplify_multi_path(ExtrusionMultiPath* multipath)
-{
-    const auto print_config = this->layer()->object()->print()->config();
-    const bool spiral_mode = print_config.spiral_mode;
-    const bool enable_arc_fitting = print_config.enable_arc_fitting;
-    const auto scaled_resolution = scaled<double>(print_config.resolution.value);
-
-    for (size_t i = 0; i < multipath->paths.size(); ++i) {
-        if (enable_arc_fitting &&
-            !spiral_mode) {
-            if (multipath->paths[i].role() == erInternalInfill)
-                multipath->paths[i].simplify_by_fitting_arc(SCALED_SPARSE_INFILL_RESOLUTION);
-            else
-                multipath->paths[i].simplify_by_fitting_arc(scaled_resolution);
-        } else {
-            multipath->paths[i].simplify(scaled_resolution);
-        }
-    }
-}
-
-void LayerRegion::simplify_loop(ExtrusionLoop* loop)
-{
-    const auto print_config = this->layer()->object()->print()->config();
-    const bool spiral_mode = print_config.spiral_mode;
-    const bool enable_arc_fitting = print_config.enable_arc_fitting;
-    const auto scaled_resolution = scaled<double>(print_config.resolution.value);
-
-    for (size_t i = 0; i < loop->paths.size(); ++i) {
-        if (enable_arc_fitting &&
-            !spiral_mode) {
-            if (loop->paths[i].role() == erInternalInfill)
-                loop->paths[i].simplify_by_fitting_arc(SCALED_SPARSE_INFILL_RESOLUTION);
-            else
-                loop->paths[i].simplify_by_fitting_arc(scaled_resolution);
-        } else {
-            loop->paths[i].simplify(scaled_resolution);
-        }
-    }
+    const auto &print_config      = this->layer()->object()->print()->config();
+    const bool  fit_arcs          = print_config.enable_arc_fitting && !print_config.spiral_mode;
+    const auto  scaled_resolution = scaled<double>(print_config.resolution.value);
+
+    // Simplify all the paths of the region as one flat batch. The paths are independent of each other,
+    // thus the arc fitting of a single dense layer is spread over the worker threads.
+    std::vector<ExtrusionPath*> paths;
+    collect_extrusion_paths(*entity_collection, paths);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, paths.size(), 8),
+        [&paths, fit_arcs, scaled_resolution](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                ExtrusionPath *path = paths[i];
+                if (fit_arcs)
+                    path->simplify_by_fitting_arc(path->role() == erInternalInfill ? SCALED_SPARSE_INFILL_RESOLUTION : scaled_resolution);
+                else
+                    path->simplify(scaled_resolution);
+            }
+        });
 }
 
 }
@@ -8,6 +8,7 @@
 #include "MutablePolygon.hpp"
 #include "format.hpp"
 
+#include <tuple>
 #include <utility>
 #include <unordered_set>
 
@@ -687,15 +688,24 @@ static std::vector<std::vector<PaintedLine>> post_process_painted_lines(const st
     if (painted_lines.empty())
         return {};
 
+    // The painted lines are collected by the worker threads in the order of their scheduling,
+    // the comparator has to be a total order to sort them the same way on each run.
     auto comp = [&contours](const PaintedLine &first, const PaintedLine &second) {
-        Point first_start_p = contours[first.contour_idx].segment_start(first.line_idx);
-        return first.contour_idx < second.contour_idx ||
-               (first.contour_idx == second.contour_idx &&
-                (first.line_idx < second.line_idx ||
-                 (first.line_idx == second.line_idx &&
-                  ((first.projected_line.a - first_start_p).cast<double>().squaredNorm() < (second.projected_line.a - first_start_p).cast<double>().squaredNorm() ||
-                   ((first.projected_line.a - first_start_p).cast<double>().squaredNorm() == (second.projected_line.a - first_start_p).cast<double>().squaredNorm() &&
-                    (first.projected_line.b - first.projected_line.a).cast<double>().squaredNorm() < (second.projected_line.b - second.projected_line.a).cast<double>().squaredNorm())))));
+        if (first.contour_idx != second.contour_idx)
+            return first.contour_idx < second.contour_idx;
+        if (first.line_idx != second.line_idx)
+            return first.line_idx < second.line_idx;
+        const Point  first_start_p = contours[first.contour_idx].segment_start(first.line_idx);
+        const double first_dist    = (first.projected_line.a - first_start_p).cast<double>().squaredNorm();
+        const double second_dist   = (second.projected_line.a - first_start_p).cast<double>().squaredNorm();
+        if (first_dist != second_dist)
+            return first_dist < second_dist;
+        const double first_length  = (first.projected_line.b - first.projected_line.a).cast<double>().squaredNorm();
+        const double second_length = (second.projected_line.b - second.projected_line.a).cast<double>().squaredNorm();
+        if (first_length != second_length)
+            return first_length < second_length;
+        return std::make_tuple(first.projected_line.a.x(), first.projected_line.a.y(), first.projected_line.b.x(), first.projected_line.b.y(), first.color) <
+               std::make_tuple(second.projected_line.a.x(), second.projected_line.a.y(), second.projected_line.b.x(), second.projected_line.b.y(), second.color);
     };
     std::sort(painted_lines.begin(), painted_lines.end(), comp);
 
@@ -1,5 +1,8 @@
 #include "MultiPoint.hpp"
 #include "BoundingBox.hpp"
+#include "PolygonKernels.hpp"
+
+#include <algorithm>
 
 namespace Slic3r {
 
@@ -101,8 +104,11 @@ bool MultiPoint::has_duplicate_points() const
 
 bool MultiPoint::remove_duplicate_points()
 {
-    size_t j = 0;
-    for (size_t i = 1; i < points.size(); ++i) {
+    // Skip the leading run without duplicates, which is usually the whole path, without writing to it.
+    size_t j = PolygonKernels::find_consecutive_duplicate(points.data(), points.size());
+    if (j == points.size())
+        return false;
+    for (size_t i = j + 1; i < points.size(); ++i) {
         if (points[j] == points[i]) {
             // Just increase index i.
         } else {
@@ -178,16 +184,8 @@ std::vector<Point> MultiPoint::_douglas_peucker(const std::vector<Point>& pts, c
             dpStack.reserve(pts.size());
             dpStack.emplace_back(floater_idx);
             for (;;) {
-                double max_dist_sq  = 0.0;
-                size_t furthest_idx = anchor_idx;
                 // find point furthest from line seg created by (anchor, floater) and note it
-                for (size_t i = anchor_idx + 1; i < floater_idx; ++ i) {
-                    double dist_sq = Line::distance_to_squared(pts[i], *anchor, *floater);
-                    if (dist_sq > max_dist_sq) {
-                        max_dist_sq  = dist_sq;
-                        furthest_idx = i;
-                    }
-                }
+                auto [furthest_idx, max_dist_sq] = PolygonKernels::furthest_from_segment(pts.data(), anchor_idx + 1, floater_idx, *anchor, *floater);
                 // remove point if less than tolerance
                 if (max_dist_sq <= tolerance_sq) {
                     result_pts.emplace_back(*floater);
@@ -1,9 +1,13 @@
 #include "PNGReadWrite.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 #include <cstdio>
+#include <cstdlib>
 #include <png.h>
+#include <miniz.h>
 
 #include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
@@ -182,6 +186,125 @@ bool decode_colored_png(const ReadBuf &in_buf, ImageColorscale &out_img)
 }
 
 
+static inline uint8_t paeth_predictor(int a, int b, int c)
+{
+    int p  = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    return uint8_t((pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c));
+}
+
+template<int Filter> static inline uint8_t filter_byte(int x, int a, int b, int c)
+{
+    if constexpr (Filter == 1)
+        return uint8_t(x - a);
+    else if constexpr (Filter == 2)
+        return uint8_t(x - b);
+    else if constexpr (Filter == 3)
+        return uint8_t(x - ((a + b) >> 1));
+    else if constexpr (Filter == 4)
+        return uint8_t(x - paeth_predictor(a, b, c));
+    else
+        return uint8_t(x);
+}
+
+// Filter a row with one of the five png filters. prev is the unfiltered
+// previous row, a row of zeros for the first row. Returns the sum of the
+// absolute values of the filtered bytes taken as signed, lower sums compress
+// better.
+template<int Filter>
+static size_t filter_row(const uint8_t *row, const uint8_t *prev, size_t len, size_t bpp, uint8_t *out)
+{
+    size_t sum = 0;
+    for (size_t i = 0; i < bpp; ++ i) {
+        out[i] = filter_byte<Filter>(row[i], 0, prev[i], 0);
+        sum += size_t(std::abs(int(int8_t(out[i]))));
+    }
+    for (size_t i = bpp; i < len; ++ i) {
+        out[i] = filter_byte<Filter>(row[i], row[i - bpp], prev[i], prev[i - bpp]);
+        sum += size_t(std::abs(int(int8_t(out[i]))));
+    }
+    return sum;
+}
+
+static void append_be32(std::vector<uint8_t> &out, uint32_t value)
+{
+    out.push_back(uint8_t(value >> 24));
+    out.push_back(uint8_t(value >> 16));
+    out.push_back(uint8_t(value >> 8));
+    out.push_back(uint8_t(value));
+}
+
+static void append_chunk(std::vector<uint8_t> &out, const char *type, const uint8_t *data, size_t len)
+{
+    append_be32(out, uint32_t(len));
+    const size_t crc_start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + len);
+    append_be32(out, uint32_t(mz_crc32(MZ_CRC32_INIT, out.data() + crc_start, len + 4)));
+}
+
+bool encode_png(const uint8_t *data, size_t width, size_t height, size_t channels,
+                std::vector<uint8_t> &out, bool flip, int level)
+{
+    // png color types indexed by the number of channels
+    static constexpr uint8_t color_types[] = { 0, 0, 4, 2, 6 };
+    if (data == nullptr || width == 0 || height == 0 || channels < 1 || channels > 4)
+        return false;
+
+    const size_t row_len = width * channels;
+
+    // Each filtered row is prefixed with its filter type.
+    std::vector<uint8_t> filtered((row_len + 1) * height);
+    std::vector<uint8_t> candidate(row_len);
+    const std::vector<uint8_t> zeros(row_len, 0);
+    for (size_t y = 0; y < height; ++ y) {
+        const uint8_t *row  = data + row_len * (flip ? height - 1 - y : y);
+        const uint8_t *prev = y == 0 ? zeros.data() : data + row_len * (flip ? height - y : y - 1);
+        uint8_t       *dst  = filtered.data() + (row_len + 1) * y;
+
+        // Start with the up filter, identical rows are frequent and filter to zeros.
+        uint8_t best = 2;
+        size_t  best_sum = filter_row<2>(row, prev, row_len, channels, dst + 1);
+        auto try_filter = [&](uint8_t filter, auto fn) {
+            if (best_sum == 0)
+                return;
+            size_t sum = fn(row, prev, row_len, channels, candidate.data());
+            if (sum < best_sum) {
+                best_sum = sum;
+                best     = filter;
+                std::copy(candidate.begin(), candidate.end(), dst + 1);
+            }
+        };
+        try_filter(1, filter_row<1>);
+        try_filter(0, filter_row<0>);
+        try_filter(4, filter_row<4>);
+        try_filter(3, filter_row<3>);
+        dst[0] = best;
+    }
+
+    mz_ulong             compressed_len = mz_compressBound(mz_ulong(filtered.size()));
+    std::vector<uint8_t> compressed(compressed_len);
+    if (mz_compress2(compressed.data(), &compressed_len, filtered.data(), mz_ulong(filtered.size()), level) != MZ_OK)
+        return false;
+
+    static constexpr uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    std::vector<uint8_t> ihdr;
+    ihdr.reserve(13);
+    append_be32(ihdr, uint32_t(width));
+    append_be32(ihdr, uint32_t(height));
+    ihdr.insert(ihdr.end(), { 8, color_types[channels], 0, 0, 0 });
+
+    out.clear();
+    out.reserve(sizeof(signature) + compressed_len + 3 * 12 + ihdr.size());
+    out.insert(out.end(), std::begin(signature), std::end(signature));
+    append_chunk(out, "IHDR", ihdr.data(), ihdr.size());
+    append_chunk(out, "IDAT", compressed.data(), size_t(compressed_len));
+    append_chunk(out, "IEND", nullptr, 0);
+    return true;
+}
+
 // Down to earth function to store a packed RGB image to file. Mostly useful for debugging purposes.
 // Based on https://www.lemoda.net/c/write-png/
 // png_color_type is PNG_COLOR_TYPE_RGB or PNG_COLOR_TYPE_GRAY
@@ -80,6 +80,19 @@ bool decode_colored_png(const ReadBuf &in_buf, ImageColorscale &out_img);
 
 // TODO: std::istream of FILE* could be similarly adapted in case its needed...
 
+// Deflate level used by encode_png by default. The row filters do most of the
+// work on thumbnails and rasters, so a fast level loses little in size.
+static constexpr int FastEncodeLevel = 2;
+
+// Encode a packed 8 bit image with 1 (grayscale), 2 (grayscale + alpha),
+// 3 (RGB) or 4 (RGBA) channels into a png image in memory. Every row gets
+// the png filter with the smallest sum of absolute differences, the heuristic
+// recommended by the png specification, and the filtered data is deflated at
+// the given miniz level. If flip is set, the rows are stored bottom up, as
+// read back from OpenGL. Returns false if the image could not be encoded.
+bool encode_png(const uint8_t *data, size_t width, size_t height, size_t channels,
+                std::vector<uint8_t> &out, bool flip = false, int level = FastEncodeLevel);
+
 
 
 // Down to earth function to store a packed RGB image to file. Mostly useful for debugging purposes.
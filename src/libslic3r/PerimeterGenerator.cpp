@@ -12,13 +12,12 @@
 #include "Arachne/WallToolPaths.hpp"
 #include "Geometry/ConvexHull.hpp"
 #include "ExPolygonCollection.hpp"
+#include "FuzzySkin.hpp"
 #include "Geometry.hpp"
 #include "Line.hpp"
 #include <cmath>
 #include <cassert>
-#include <random>
 #include <unordered_set>
-#include <thread>
 #include "libslic3r/AABBTreeLines.hpp"
 static const int overhang_sampling_number = 6;
 static const double narrow_loop_length_threshold = 10;
@@ -31,15 +30,6 @@ static constexpr double SMALLER_EXT_INSET_OVERLAP_TOLERANCE = 0.22;
 
 namespace Slic3r {
 
-// Produces a random value between 0 and 1. Thread-safe.
-static double random_value() {
-    thread_local std::random_device rd;
-    // Hash thread ID for random number seed if no hardware rng seed is available
-    thread_local std::mt19937 gen(rd.entropy() > 0 ? rd() : std::hash<std::thread::id>()(std::this_thread::get_id()));
-    thread_local std::uniform_real_distribution<double> dist(0.0, 1.0);
-    return dist(gen);
-}
-
 // Hierarchy of perimeters.
 class PerimeterGeneratorLoop {
 public:
@@ -64,81 +54,17 @@ public:
     bool is_internal_contour() const;
 };
 
-// Thanks Cura developers for this function.
-static void fuzzy_polygon(Polygon &poly, double fuzzy_skin_thickness, double fuzzy_skin_point_distance)
+static FuzzySkinConfig make_fuzzy_skin_config(const PerimeterGenerator &perimeter_generator)
 {
-    const double min_dist_between_points = fuzzy_skin_point_distance * 3. / 4.; // hardcoded: the point distance may vary between 3/4 and 5/4 the supplied value
-    const double range_random_point_dist = fuzzy_skin_point_distance / 2.;
-    double dist_left_over = random_value() * (min_dist_between_points / 2.); // the distance to be traversed on the line before making the first new point
-    Point* p0 = &poly.points.back();
-    Points out;
-    out.reserve(poly.points.size());
-    for (Point &p1 : poly.points)
-    { // 'a' is the (next) new point between p0 and p1
-        Vec2d  p0p1      = (p1 - *p0).cast<double>();
-        double p0p1_size = p0p1.norm();
-        double p0pa_dist = dist_left_over;
-        for (; p0pa_dist < p0p1_size;
-            p0pa_dist += min_dist_between_points + random_value() * range_random_point_dist)
-        {
-            double r = random_value() * (fuzzy_skin_thickness * 2.) - fuzzy_skin_thickness;
-            out.emplace_back(*p0 + (p0p1 * (p0pa_dist / p0p1_size) + perp(p0p1).cast<double>().normalized() * r).cast<coord_t>());
-        }
-        dist_left_over = p0pa_dist - p0p1_size;
-        p0 = &p1;
-    }
-    while (out.size() < 3) {
-        size_t point_idx = poly.size() - 2;
-        out.emplace_back(poly[point_idx]);
-        if (point_idx == 0)
-            break;
-        -- point_idx;
-    }
-    if (out.size() >= 3)
-        poly.points = std::move(out);
-}
-
-// Thanks Cura developers for this function.
-static void fuzzy_extrusion_line(Arachne::ExtrusionLine& ext_lines, double fuzzy_skin_thickness, double fuzzy_skin_point_dist)
-{
-    const double min_dist_between_points = fuzzy_skin_point_dist * 3. / 4.; // hardcoded: the point distance may vary between 3/4 and 5/4 the supplied value
-    const double range_random_point_dist = fuzzy_skin_point_dist / 2.;
-    double dist_left_over = double(rand()) * (min_dist_between_points / 2) / double(RAND_MAX); // the distance to be traversed on the line before making the first new point
-
-    auto* p0 = &ext_lines.front();
-    std::vector<Arachne::ExtrusionJunction> out;
-    out.reserve(ext_lines.size());
-    for (auto& p1 : ext_lines) {
-        if (p0->p == p1.p) { // Connect endpoints.
-            out.emplace_back(p1.p, p1.w, p1.perimeter_index);
-            continue;
-        }
-
-        // 'a' is the (next) new point between p0 and p1
-        Vec2d  p0p1 = (p1.p - p0->p).cast<double>();
-        double p0p1_size = p0p1.norm();
-        double p0pa_dist = dist_left_over;
-        for (; p0pa_dist < p0p1_size; p0pa_dist += min_dist_between_points + double(rand()) * range_random_point_dist / double(RAND_MAX)) {
-            double r = double(rand()) * (fuzzy_skin_thickness * 2.) / double(RAND_MAX) - fuzzy_skin_thickness;
-            out.emplace_back(p0->p + (p0p1 * (p0pa_dist / p0p1_size) + perp(p0p1).cast<double>().normalized() * r).cast<coord_t>(), p1.w, p1.perimeter_index);
-        }
-        dist_left_over = p0pa_dist - p0p1_size;
-        p0 = &p1;
-    }
-
-    while (out.size() < 3) {
-        size_t point_idx = ext_lines.size() - 2;
-        out.emplace_back(ext_lines[point_idx].p, ext_lines[point_idx].w, ext_lines[point_idx].perimeter_index);
-        if (point_idx == 0)
-            break;
-        --point_idx;
-    }
-
-    if (ext_lines.back().p == ext_lines.front().p) // Connect endpoints.
-        out.front().p = out.back().p;
-
-    if (out.size() >= 3)
-        ext_lines.junctions = std::move(out);
+    const PrintRegionConfig &config = *perimeter_generator.config;
+    FuzzySkinConfig          cfg;
+    cfg.noise_type     = config.fuzzy_skin_noise_type.value;
+    cfg.thickness      = scaled<double>(config.fuzzy_skin_thickness.value);
+    cfg.point_distance = scaled<double>(config.fuzzy_skin_point_distance.value);
+    cfg.noise_scale    = scaled<double>(config.fuzzy_skin_scale.value);
+    cfg.z              = scaled<double>(perimeter_generator.slice_z);
+    cfg.layer_id       = perimeter_generator.layer_id;
+    return cfg;
 }
 
 using PerimeterGeneratorLoops = std::vector<PerimeterGeneratorLoop>;
@@ -336,19 +262,49 @@ public:
     }
 };
 
-static std::deque<PolylineWithDegree> detect_overahng_degree(Polygons        lower_polygons,
+LowerPolygonsSeries::LowerPolygonsSeries() = default;
+LowerPolygonsSeries::~LowerPolygonsSeries() = default;
+
+const OverhangDistancer& LowerPolygonsSeries::distancer() const
+{
+    std::call_once(m_distancer_once, [this]() {
+        m_distancer = std::make_unique<OverhangDistancer>(this->polygons.empty() ? Polygons() : this->polygons.front());
+    });
+    return *m_distancer;
+}
+
+std::shared_ptr<const LowerPolygonsSeries> LowerPolygonsSeriesCache::get(const ExPolygons &lower_slices, float width, float nozzle_diameter)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Entry &entry : m_entries)
+        if (entry.width == width && entry.nozzle_diameter == nozzle_diameter)
+            return entry.series;
+
+    float start_offset = -0.5 * width;
+    float end_offset   = 0.5 * nozzle_diameter;
+
+    assert(overhang_sampling_number >= 3);
+    // generate offsets
+    std::vector<float> offset_series;
+    offset_series.reserve(2);
+    offset_series.push_back(start_offset + 0.5 * (end_offset - start_offset) / (overhang_sampling_number - 1));
+    offset_series.push_back(end_offset);
+
+    // offset expolygon to generate series of polygons
+    auto series = std::make_shared<LowerPolygonsSeries>();
+    series->polygons.reserve(offset_series.size());
+    for (float delta : offset_series)
+        series->polygons.emplace_back(offset(lower_slices, float(scale_(delta))));
+    m_entries.push_back({ width, nozzle_diameter, series });
+    return series;
+}
+
+static std::deque<PolylineWithDegree> detect_overahng_degree(const OverhangDistancer &prev_layer_distancer,
                                                              Polylines       middle_overhang_polyines,
                                                              const double    &lower_bound,
                                                              const double    &upper_bound,
                                                              Polylines       &too_short_polylines)
 {
-    // BBS: collect lower_polygons points
-    //Polylines;
-    Points lower_polygon_points;
-    std::vector<size_t> polygons_bound;
-
-    std::unique_ptr<OverhangDistancer> prev_layer_distancer;
-    prev_layer_distancer = std::make_unique<OverhangDistancer>(lower_polygons);
     std::deque<PolylineWithDegree> out;
     std::deque<double>             points_overhang;
     //BBS: get overhang degree and split path
@@ -367,7 +323,7 @@ static std::deque<PolylineWithDegree> detect_overahng_degree(Polygons        low
         for (size_t point_idx = 0; point_idx < middle_poly.points.size(); ++point_idx) {
             Point pt = middle_poly.points[point_idx];
 
-            float overhang_dist = prev_layer_distancer->distance_from_perimeter(pt.cast<float>());
+            float overhang_dist = prev_layer_distancer.distance_from_perimeter(pt.cast<float>());
             overhang_dist       = overhang_dist > upper_bound ? upper_bound : overhang_dist;
             // BBS : calculate overhang degree
             int    max_overhang = max_overhang_degree;
@@ -483,27 +439,27 @@ static ExtrusionEntityCollection traverse_loops(const PerimeterGenerator &perime
         ExtrusionPaths paths;
 
         // BBS: get lower polygons series, width, mm3_per_mm
-        const std::vector<Polygons> *lower_polygons_series;
+        const LowerPolygonsSeries *lower_polygons_series;
         const std::pair<double, double> *overhang_dist_boundary;
         double extrusion_mm3_per_mm;
         double extrusion_width;
         if (is_external) {
             if (is_small_width) {
                 //BBS: smaller width external perimeter
-                lower_polygons_series = &perimeter_generator.m_smaller_external_lower_polygons_series;
+                lower_polygons_series = perimeter_generator.m_smaller_external_lower_polygons_series.get();
                 overhang_dist_boundary = &perimeter_generator.m_smaller_external_overhang_dist_boundary;
                 extrusion_mm3_per_mm = perimeter_generator.smaller_width_ext_mm3_per_mm();
                 extrusion_width = perimeter_generator.smaller_ext_perimeter_flow.width();
             } else {
                 //BBS: normal external perimeter
-                lower_polygons_series = &perimeter_generator.m_external_lower_polygons_series;
+                lower_polygons_series = perimeter_generator.m_external_lower_polygons_series.get();
                 overhang_dist_boundary = &perimeter_generator.m_external_overhang_dist_boundary;
                 extrusion_mm3_per_mm = perimeter_generator.ext_mm3_per_mm();
                 extrusion_width = perimeter_generator.ext_perimeter_flow.width();
             }
         } else {
             //BBS: normal perimeter
-            lower_polygons_series = &perimeter_generator.m_lower_polygons_series;
+            lower_polygons_series = perimeter_generator.m_lower_polygons_series.get();
             overhang_dist_boundary = &perimeter_generator.m_lower_overhang_dist_boundary;
             extrusion_mm3_per_mm = perimeter_generator.mm3_per_mm();
             extrusion_width = perimeter_generator.perimeter_flow.width();
@@ -513,7 +469,7 @@ static ExtrusionEntityCollection traverse_loops(const PerimeterGenerator &perime
         const Polygon &polygon = loop.fuzzify ? fuzzified : loop.polygon;
         if (loop.fuzzify) {
             fuzzified = loop.polygon;
-            fuzzy_polygon(fuzzified, scaled<float>(perimeter_generator.config->fuzzy_skin_thickness.value), scaled<float>(perimeter_generator.config->fuzzy_skin_point_distance.value));
+            fuzzy_polygon(fuzzified, make_fuzzy_skin_config(perimeter_generator));
         }
         if (perimeter_generator.config->detect_overhang_wall && perimeter_generator.layer_id > perimeter_generator.object_config->raft_layers) {
             // get non 100% overhang paths by intersecting this loop with the grown lower slices
@@ -539,7 +495,7 @@ static ExtrusionEntityCollection traverse_loops(const PerimeterGenerator &perime
 
             Polylines remain_polines;
 
-            Polygons lower_polygons_series_clipped = ClipperUtils::clip_clipper_polygons_with_subject_bbox(lower_polygons_series->back(), bbox);
+            Polygons lower_polygons_series_clipped = ClipperUtils::clip_clipper_polygons_with_subject_bbox(lower_polygons_series->polygons.back(), bbox);
 
             Polylines inside_polines = intersection_pl({polygon}, lower_polygons_series_clipped);
 
@@ -560,7 +516,7 @@ static ExtrusionEntityCollection traverse_loops(const PerimeterGenerator &perime
                         extrusion_width,
                         (float)perimeter_generator.layer_height);
             } else {
-                Polygons lower_polygons_series_clipped = ClipperUtils::clip_clipper_polygons_with_subject_bbox(lower_polygons_series->front(), bbox);
+                Polygons lower_polygons_series_clipped = ClipperUtils::clip_clipper_polygons_with_subject_bbox(lower_polygons_series->polygons.front(), bbox);
 
                 Polylines middle_overhang_polyines = diff_pl({inside_polines}, lower_polygons_series_clipped);
                 //BBS: add zero_degree_path
@@ -578,7 +534,7 @@ static ExtrusionEntityCollection traverse_loops(const PerimeterGenerator &perime
                 //BBS: detect middle line overhang
                 if (!middle_overhang_polyines.empty()) {
                     Polylines                      too_short_polylines;
-                    std::deque<PolylineWithDegree> polylines_degree_collection = detect_overahng_degree(lower_polygons_series->front(),
+                    std::deque<PolylineWithDegree> polylines_degree_collection = detect_overahng_degree(lower_polygons_series->distancer(),
                                                                                                         middle_overhang_polyines,
                                                                                                         overhang_dist_boundary->first,
                                                                                                         overhang_dist_boundary->second,
@@ -865,7 +821,7 @@ static ExtrusionEntityCollection traverse_extrusions(const PerimeterGenerator& p
         ExtrusionRole role = is_external ? erExternalPerimeter : erPerimeter;
 
         if (pg_extrusion.fuzzify)
-            fuzzy_extrusion_line(*extrusion, scaled<float>(perimeter_generator.config->fuzzy_skin_thickness.value), scaled<float>(perimeter_generator.config->fuzzy_skin_point_distance.value));
+            fuzzy_extrusion_line(*extrusion, make_fuzzy_skin_config(perimeter_generator));
 
         ExtrusionPaths paths;
         // detect overhanging/bridging perimeters
@@ -2924,29 +2880,17 @@ bool PerimeterGeneratorLoop::is_internal_contour() const
     return true;
 }
 
-std::vector<Polygons> PerimeterGenerator::generate_lower_polygons_series(float width)
+std::shared_ptr<const LowerPolygonsSeries> PerimeterGenerator::generate_lower_polygons_series(float width)
 {
-    float nozzle_diameter = print_config->nozzle_diameter.get_at(config->wall_filament - 1);
-    float start_offset = -0.5 * width;
-    float end_offset = 0.5 * nozzle_diameter;
-
-    assert(overhang_sampling_number >= 3);
-    // generate offsets
-    std::vector<float> offset_series;
-    offset_series.reserve(2);
-
-     offset_series.push_back(start_offset + 0.5 * (end_offset - start_offset) / (overhang_sampling_number - 1));
-     offset_series.push_back(end_offset);
-    std::vector<Polygons> lower_polygons_series;
-    if (this->lower_slices == NULL) {
-        return lower_polygons_series;
-    }
+    if (this->lower_slices == nullptr)
+        return std::make_shared<LowerPolygonsSeries>();
 
-    // offset expolygon to generate series of polygons
-    for (int i = 0; i < offset_series.size(); i++) {
-        lower_polygons_series.emplace_back(offset(*this->lower_slices, float(scale_(offset_series[i]))));
-    }
-    return lower_polygons_series;
+    float nozzle_diameter = print_config->nozzle_diameter.get_at(config->wall_filament - 1);
+    // The series depends on the lower layer only, share it with the other regions of this layer.
+    if (this->lower_polygons_series_cache != nullptr)
+        return this->lower_polygons_series_cache->get(*this->lower_slices, width, nozzle_diameter);
+    LowerPolygonsSeriesCache cache;
+    return cache.get(*this->lower_slices, width, nozzle_diameter);
 }
 
 }
@@ -2,6 +2,8 @@
 #define slic3r_PerimeterGenerator_hpp_
 
 #include "libslic3r.h"
+#include <memory>
+#include <mutex>
 #include <vector>
 #include "Flow.hpp"
 #include "Polygon.hpp"
@@ -10,6 +12,41 @@
 
 namespace Slic3r {
 
+class OverhangDistancer;
+
+//BBS: lower layer slices grown for the overhang detection of perimeters of a single width,
+// see PerimeterGenerator::generate_lower_polygons_series().
+struct LowerPolygonsSeries
+{
+    std::vector<Polygons>   polygons;
+
+    LowerPolygonsSeries();
+    ~LowerPolygonsSeries();
+    // Distance to polygons.front(), built on the first call.
+    const OverhangDistancer& distancer() const;
+
+private:
+    mutable std::once_flag                      m_distancer_once;
+    mutable std::unique_ptr<OverhangDistancer>  m_distancer;
+};
+
+// The grown lower layer slices only depend on the lower layer, the extrusion width and the nozzle diameter,
+// thus they are shared read only by the perimeter generators of all regions of a layer.
+class LowerPolygonsSeriesCache
+{
+public:
+    std::shared_ptr<const LowerPolygonsSeries> get(const ExPolygons &lower_slices, float width, float nozzle_diameter);
+
+private:
+    struct Entry {
+        float                                       width;
+        float                                       nozzle_diameter;
+        std::shared_ptr<const LowerPolygonsSeries>  series;
+    };
+    std::mutex          m_mutex;
+    std::vector<Entry>  m_entries;
+};
+
 class PerimeterGenerator {
 public:
     // Inputs:
@@ -18,6 +55,8 @@ public:
     const ExPolygons            *lower_slices;
     double                       layer_height;
     int                          layer_id;
+    // Z used for slicing in unscaled coordinates.
+    double                       slice_z;
     Flow                         perimeter_flow;
     Flow                         ext_perimeter_flow;
     Flow                         overhang_flow;
@@ -25,6 +64,8 @@ public:
     const PrintRegionConfig     *config;
     const PrintObjectConfig     *object_config;
     const PrintConfig           *print_config;
+    // Optional, shared by the regions of a layer.
+    LowerPolygonsSeriesCache    *lower_polygons_series_cache;
     // Outputs:
     ExtrusionEntityCollection   *loops;
     ExtrusionEntityCollection   *gap_fill;
@@ -34,9 +75,9 @@ public:
 
     //BBS
     Flow                        smaller_ext_perimeter_flow;
-    std::vector<Polygons>       m_lower_polygons_series;
-    std::vector<Polygons>       m_external_lower_polygons_series;
-    std::vector<Polygons>       m_smaller_external_lower_polygons_series;
+    std::shared_ptr<const LowerPolygonsSeries>  m_lower_polygons_series;
+    std::shared_ptr<const LowerPolygonsSeries>  m_external_lower_polygons_series;
+    std::shared_ptr<const LowerPolygonsSeries>  m_smaller_external_lower_polygons_series;
     std::pair<double, double>   m_lower_overhang_dist_boundary;
     std::pair<double, double>   m_external_overhang_dist_boundary;
     std::pair<double, double>   m_smaller_external_overhang_dist_boundary;
@@ -61,9 +102,9 @@ public:
         //BBS
         ExPolygons*                 fill_no_overlap)
         : slices(slices), upper_slices(nullptr), lower_slices(nullptr), layer_height(layer_height),
-            layer_id(-1), perimeter_flow(flow), ext_perimeter_flow(flow),
+            layer_id(-1), slice_z(0.), perimeter_flow(flow), ext_perimeter_flow(flow),
             overhang_flow(flow), solid_infill_flow(flow),
-            config(config), object_config(object_config), print_config(print_config),
+            config(config), object_config(object_config), print_config(print_config), lower_polygons_series_cache(nullptr),
             m_spiral_vase(spiral_mode),
             m_scaled_resolution(scaled<double>(print_config->resolution.value > EPSILON ? print_config->resolution.value : EPSILON)),
             loops(loops), gap_fill(gap_fill), fill_surfaces(fill_surfaces), fill_no_overlap(fill_no_overlap),
@@ -83,7 +124,7 @@ public:
     Polygons    lower_slices_polygons() const { return m_lower_slices_polygons; }
 
 private:
-    std::vector<Polygons>     generate_lower_polygons_series(float width);
+    std::shared_ptr<const LowerPolygonsSeries> generate_lower_polygons_series(float width);
     void split_top_surfaces(const ExPolygons &orig_polygons, ExPolygons &top_fills, ExPolygons &non_top_polygons, ExPolygons &fill_clip) const;
     void apply_extra_perimeters(ExPolygons& infill_area);
     void process_no_bridge(Surfaces& all_surfaces, coord_t perimeter_spacing, coord_t ext_perimeter_width);
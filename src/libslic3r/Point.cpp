@@ -3,6 +3,7 @@
 #include "MultiPoint.hpp"
 #include "Int128.hpp"
 #include "BoundingBox.hpp"
+#include "PolygonKernels.hpp"
 #include <algorithm>
 
 namespace Slic3r {
@@ -157,7 +158,10 @@ template<bool IncludeBoundary>
 BoundingBox get_extents(const Points &pts)
 { 
     BoundingBox out;
-    BoundingBox::construct<IncludeBoundary>(out, pts.begin(), pts.end());
+    if (! pts.empty()) {
+        PolygonKernels::extents(pts.data(), pts.size(), out.min, out.max);
+        out.defined = IncludeBoundary || (out.min.x() < out.max.x() && out.min.y() < out.max.y());
+    }
     return out;
 }
 template BoundingBox get_extents<false>(const Points &pts);
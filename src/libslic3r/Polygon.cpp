@@ -3,6 +3,7 @@
 #include "Exception.hpp"
 #include "Polygon.hpp"
 #include "Polyline.hpp"
+#include "PolygonKernels.hpp"
 
 namespace Slic3r {
 
@@ -46,16 +47,7 @@ Polyline Polygon::split_at_index(int index) const
 
 double Polygon::area(const Points &points)
 {
-    double a = 0.;
-    if (points.size() >= 3) {
-        Vec2d p1 = points.back().cast<double>();
-        for (const Point &p : points) {
-            Vec2d p2 = p.cast<double>();
-            a += cross2(p1, p2);
-            p1 = p2;
-        }
-    }
-    return 0.5 * a;
+    return 0.5 * PolygonKernels::signed_area2(points.data(), points.size());
 }
 
 double Polygon::area() const
@@ -676,7 +668,7 @@ bool overlaps(const Polygons& polys1, const Polygons& polys2)
 
 bool contains(const Polygon &polygon, const Point &p, bool border_result)
 {
-    if (const int poly_count_inside = ClipperLib::PointInPolygon(p, polygon.points); 
+    if (const int poly_count_inside = PolygonKernels::point_in_polygon(polygon.points.data(), polygon.points.size(), p); 
         poly_count_inside == -1)
         return border_result;
     else
@@ -687,7 +679,7 @@ bool contains(const Polygons &polygons, const Point &p, bool border_result)
 {
     int poly_count_inside = 0;
     for (const Polygon &poly : polygons) {
-        const int is_inside_this_poly = ClipperLib::PointInPolygon(p, poly.points);
+        const int is_inside_this_poly = PolygonKernels::point_in_polygon(poly.points.data(), poly.points.size(), p);
         if (is_inside_this_poly == -1)
             return border_result;
         poly_count_inside += is_inside_this_poly;
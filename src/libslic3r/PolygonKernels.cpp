@@ -0,0 +1,390 @@
+#include "PolygonKernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define SLIC3R_POLYGON_KERNELS_AVX2
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        // MSVC compiles the AVX2 intrinsics without enabling AVX2 for the whole translation unit.
+        #define SLIC3R_AVX2_TARGET
+    #else
+        #define SLIC3R_AVX2_TARGET __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace Slic3r {
+namespace PolygonKernels {
+
+#ifdef SLIC3R_POLYGON_KERNELS_AVX2
+
+static bool cpu_supports_avx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // AVX supported by the CPU and the YMM registers saved by the OS.
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool has_avx2()
+{
+    static const bool avx2 = cpu_supports_avx2();
+    return avx2;
+}
+
+namespace avx2 {
+
+static constexpr const int popcount4[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+template<typename PointType>
+SLIC3R_AVX2_TARGET static inline __m256i load(const PointType *p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// Coordinates of the points p[0, 4) relative to the origin o, converted to doubles. The coordinates relative
+// to the first point of a polygon usually fit 32 bits, then they are converted as 32bit integers, which is exact.
+// out_of_range collects the lanes, which do not fit.
+SLIC3R_AVX2_TARGET static inline void load_relative(const Point *p, __m256i o, __m256d &x, __m256d &y, __m256i &out_of_range)
+{
+    const __m256i a0 = _mm256_sub_epi64(load(p), o);
+    const __m256i a1 = _mm256_sub_epi64(load(p + 2), o);
+    const __m256i bias = _mm256_set1_epi64x(int64_t(1) << 31);
+    out_of_range = _mm256_or_si256(out_of_range, _mm256_or_si256(
+        _mm256_srli_epi64(_mm256_add_epi64(a0, bias), 32), _mm256_srli_epi64(_mm256_add_epi64(a1, bias), 32)));
+    // Lower 32 bits of (x0, y0, x2, y2 | x1, y1, x3, y3), permuted to (x0, x1, x2, x3 | y0, y1, y2, y3).
+    const __m256i lo = _mm256_permutevar8x32_epi32(
+        _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a0), _mm256_castsi256_ps(a1), _MM_SHUFFLE(2, 0, 2, 0))),
+        _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7));
+    x = _mm256_cvtepi32_pd(_mm256_castsi256_si128(lo));
+    y = _mm256_cvtepi32_pd(_mm256_extracti128_si256(lo, 1));
+}
+
+// (v[1], v[2], v[3], next[0])
+SLIC3R_AVX2_TARGET static inline __m256d shift_in(__m256d v, __m256d next)
+{
+    return _mm256_blend_pd(_mm256_permute4x64_pd(v, 0x39), _mm256_permute4x64_pd(next, 0), 0x8);
+}
+
+// Edges (pts[i], pts[i + 1]) are processed in blocks of four, one edge per lane of a partial sum.
+// The converted points of the next block provide the second end points of the edges of the current block,
+// so that each point is converted once.
+SLIC3R_AVX2_TARGET static double signed_area2(const Point *pts, size_t n)
+{
+    const __m256i o   = _mm256_setr_epi64x(pts[0].x(), pts[0].y(), pts[0].x(), pts[0].y());
+    __m256d       acc = _mm256_setzero_pd();
+    __m256i       out_of_range = _mm256_setzero_si256();
+    size_t        i   = 1;
+    if (i + 8 <= n) {
+        __m256d x1, y1;
+        load_relative(pts + i, o, x1, y1, out_of_range);
+        for (; i + 8 <= n; i += 4) {
+            __m256d xn, yn;
+            load_relative(pts + i + 4, o, xn, yn, out_of_range);
+            const __m256d x2 = shift_in(x1, xn);
+            const __m256d y2 = shift_in(y1, yn);
+            acc = _mm256_add_pd(acc, _mm256_sub_pd(_mm256_mul_pd(x1, y2), _mm256_mul_pd(x2, y1)));
+            x1 = xn;
+            y1 = yn;
+        }
+    }
+    // A polygon spanning more than 2^31 units, which is over two meters.
+    if (! _mm256_testz_si256(out_of_range, out_of_range))
+        return scalar::signed_area2(pts, n);
+    alignas(32) double sums[4];
+    _mm256_store_pd(sums, acc);
+    // The last block has no next block to take its end points from.
+    for (; i + 4 < n; i += 4)
+        for (size_t k = 0; k < 4; ++ k)
+            sums[k] += scalar::area_cross(pts, i + k, pts[0].x(), pts[0].y());
+    return scalar::signed_area2_finish(pts, n, i, sums);
+}
+
+SLIC3R_AVX2_TARGET static double signed_area2(const Vec2i32 *pts, size_t n)
+{
+    // Gathers the x coordinates of four points into the lower half, the y coordinates into the upper half.
+    const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256d ox  = _mm256_set1_pd(double(pts[0].x()));
+    const __m256d oy  = _mm256_set1_pd(double(pts[0].y()));
+    __m256d       acc = _mm256_setzero_pd();
+    size_t        i   = 1;
+    for (; i + 4 < n; i += 4) {
+        const __m256i a  = _mm256_permutevar8x32_epi32(load(pts + i), deinterleave);
+        const __m256i b  = _mm256_permutevar8x32_epi32(load(pts + i + 1), deinterleave);
+        // The differences of two 32bit integers are exact in doubles.
+        const __m256d x1 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(a)), ox);
+        const __m256d y1 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)), oy);
+        const __m256d x2 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(b)), ox);
+        const __m256d y2 = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1)), oy);
+        acc = _mm256_add_pd(acc, _mm256_sub_pd(_mm256_mul_pd(x1, y2), _mm256_mul_pd(x2, y1)));
+    }
+    alignas(32) double sums[4];
+    _mm256_store_pd(sums, acc);
+    return scalar::signed_area2_finish(pts, n, i, sums);
+}
+
+SLIC3R_AVX2_TARGET static inline __m256i min_epi64(__m256i a, __m256i b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+SLIC3R_AVX2_TARGET static inline __m256i max_epi64(__m256i a, __m256i b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a)); }
+
+// Interleaved (x, y) pairs are reduced as they are, four independent accumulators of two points each
+// hide the latency of the 64bit compare.
+SLIC3R_AVX2_TARGET static void extents(const Point *pts, size_t n, Point &out_min, Point &out_max)
+{
+    __m256i mn0 = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pts)));
+    __m256i mn1 = mn0, mn2 = mn0, mn3 = mn0, mx0 = mn0, mx1 = mn0, mx2 = mn0, mx3 = mn0;
+    size_t i = 1;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v0 = load(pts + i);
+        const __m256i v1 = load(pts + i + 2);
+        const __m256i v2 = load(pts + i + 4);
+        const __m256i v3 = load(pts + i + 6);
+        mn0 = min_epi64(mn0, v0);
+        mx0 = max_epi64(mx0, v0);
+        mn1 = min_epi64(mn1, v1);
+        mx1 = max_epi64(mx1, v1);
+        mn2 = min_epi64(mn2, v2);
+        mx2 = max_epi64(mx2, v2);
+        mn3 = min_epi64(mn3, v3);
+        mx3 = max_epi64(mx3, v3);
+    }
+    alignas(32) int64_t lmin[4], lmax[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lmin), min_epi64(min_epi64(mn0, mn1), min_epi64(mn2, mn3)));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lmax), max_epi64(max_epi64(mx0, mx1), max_epi64(mx2, mx3)));
+    out_min = Point(std::min(lmin[0], lmin[2]), std::min(lmin[1], lmin[3]));
+    out_max = Point(std::max(lmax[0], lmax[2]), std::max(lmax[1], lmax[3]));
+    for (; i < n; ++ i) {
+        out_min = out_min.cwiseMin(pts[i]);
+        out_max = out_max.cwiseMax(pts[i]);
+    }
+}
+
+SLIC3R_AVX2_TARGET static void extents(const Vec2i32 *pts, size_t n, Vec2i32 &out_min, Vec2i32 &out_max)
+{
+    __m256i mn0 = _mm256_broadcastq_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pts)));
+    __m256i mn1 = mn0, mx0 = mn0, mx1 = mn0;
+    size_t i = 1;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v0 = load(pts + i);
+        const __m256i v1 = load(pts + i + 4);
+        mn0 = _mm256_min_epi32(mn0, v0);
+        mx0 = _mm256_max_epi32(mx0, v0);
+        mn1 = _mm256_min_epi32(mn1, v1);
+        mx1 = _mm256_max_epi32(mx1, v1);
+    }
+    alignas(32) int32_t lmin[8], lmax[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lmin), _mm256_min_epi32(mn0, mn1));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lmax), _mm256_max_epi32(mx0, mx1));
+    out_min = Vec2i32(lmin[0], lmin[1]);
+    out_max = Vec2i32(lmax[0], lmax[1]);
+    for (int k = 2; k < 8; k += 2) {
+        out_min = out_min.cwiseMin(Vec2i32(lmin[k], lmin[k + 1]));
+        out_max = out_max.cwiseMax(Vec2i32(lmax[k], lmax[k + 1]));
+    }
+    for (; i < n; ++ i) {
+        out_min = out_min.cwiseMin(pts[i]);
+        out_max = out_max.cwiseMax(pts[i]);
+    }
+}
+
+// The boundary and crossing flags of ClipperLib::PointInPolygon() are evaluated for four edges at once. Only the edges
+// crossing the horizontal line through pt with one end point left and the other right of pt need the cross product,
+// which is rare. These edges are passed to the scalar edge test, which evaluates the cross product the same way as Clipper.
+// Returns -1 if pt lies on the boundary of the block, otherwise adds the crossings of the block.
+template<typename PointType>
+static inline int point_in_polygon_block(const PointType *pts, size_t i, const int *lane_to_edge, const PointType &pt,
+    int mask_boundary, int mask_crossing, int mask_needs_cross_product, int &crossings)
+{
+    if (mask_boundary)
+        return -1;
+    crossings += popcount4[mask_crossing];
+    for (int k = 0; mask_needs_cross_product; ++ k, mask_needs_cross_product >>= 1)
+        if ((mask_needs_cross_product & 1) != 0) {
+            const size_t e = i + lane_to_edge[k];
+            if (scalar::point_in_polygon_edge(pts[e], pts[e + 1], pt.x(), pt.y(), crossings))
+                return -1;
+        }
+    return 0;
+}
+
+SLIC3R_AVX2_TARGET static int point_in_polygon(const Point *pts, size_t n, const Point &pt)
+{
+    static constexpr const int lane_to_edge[4] = { 0, 2, 1, 3 };
+    const __m256i px = _mm256_set1_epi64x(pt.x());
+    const __m256i py = _mm256_set1_epi64x(pt.y());
+    int           crossings = 0;
+    size_t        i = 0;
+    for (; i + 4 < n; i += 4) {
+        const __m256i a0 = load(pts + i);
+        const __m256i a1 = load(pts + i + 2);
+        const __m256i b0 = load(pts + i + 1);
+        const __m256i b1 = load(pts + i + 3);
+        const __m256i ax = _mm256_unpacklo_epi64(a0, a1);
+        const __m256i ay = _mm256_unpackhi_epi64(a0, a1);
+        const __m256i bx = _mm256_unpacklo_epi64(b0, b1);
+        const __m256i by = _mm256_unpackhi_epi64(b0, b1);
+        const __m256i ax_lt  = _mm256_cmpgt_epi64(px, ax);
+        const __m256i bx_gt  = _mm256_cmpgt_epi64(bx, px);
+        const __m256i ay_lt  = _mm256_cmpgt_epi64(py, ay);
+        const __m256i by_lt  = _mm256_cmpgt_epi64(py, by);
+        const __m256i boundary = _mm256_and_si256(_mm256_cmpeq_epi64(by, py),
+            _mm256_or_si256(_mm256_cmpeq_epi64(bx, px), _mm256_andnot_si256(_mm256_xor_si256(bx_gt, ax_lt), _mm256_cmpeq_epi64(ay, py))));
+        const __m256i straddles = _mm256_xor_si256(ay_lt, by_lt);
+        const __m256i crossing  = _mm256_and_si256(straddles, _mm256_andnot_si256(ax_lt, bx_gt));
+        const __m256i needs_cross_product = _mm256_andnot_si256(_mm256_xor_si256(ax_lt, bx_gt), straddles);
+        if (point_in_polygon_block(pts, i, lane_to_edge, pt,
+                _mm256_movemask_pd(_mm256_castsi256_pd(boundary)), _mm256_movemask_pd(_mm256_castsi256_pd(crossing)),
+                _mm256_movemask_pd(_mm256_castsi256_pd(needs_cross_product)), crossings) == -1)
+            return -1;
+    }
+    for (; i + 1 < n; ++ i)
+        if (scalar::point_in_polygon_edge(pts[i], pts[i + 1], pt.x(), pt.y(), crossings))
+            return -1;
+    if (scalar::point_in_polygon_edge(pts[n - 1], pts[0], pt.x(), pt.y(), crossings))
+        return -1;
+    return crossings & 1;
+}
+
+// Four 32bit points per register are compared against (px, py) pairs. A point's x flag is shifted to the upper half
+// of its 64bit lane, where its y flag is, and the combined flags are extracted by the sign bits of the 64bit lanes.
+SLIC3R_AVX2_TARGET static int point_in_polygon(const Vec2i32 *pts, size_t n, const Vec2i32 &pt)
+{
+    static constexpr const int lane_to_edge[4] = { 0, 1, 2, 3 };
+    const __m256i p = _mm256_setr_epi32(pt.x(), pt.y(), pt.x(), pt.y(), pt.x(), pt.y(), pt.x(), pt.y());
+    int           crossings = 0;
+    size_t        i = 0;
+    for (; i + 4 < n; i += 4) {
+        const __m256i a     = load(pts + i);
+        const __m256i b     = load(pts + i + 1);
+        const __m256i a_lt  = _mm256_cmpgt_epi32(p, a);
+        const __m256i b_lt  = _mm256_cmpgt_epi32(p, b);
+        const __m256i b_eq  = _mm256_cmpeq_epi32(b, p);
+        const __m256i ax_lt = _mm256_slli_epi64(a_lt, 32);
+        const __m256i bx_gt = _mm256_slli_epi64(_mm256_cmpgt_epi32(b, p), 32);
+        const __m256i boundary = _mm256_and_si256(b_eq,
+            _mm256_or_si256(_mm256_slli_epi64(b_eq, 32), _mm256_andnot_si256(_mm256_xor_si256(bx_gt, ax_lt), _mm256_cmpeq_epi32(a, p))));
+        const __m256i straddles = _mm256_xor_si256(a_lt, b_lt);
+        const __m256i crossing  = _mm256_and_si256(straddles, _mm256_andnot_si256(ax_lt, bx_gt));
+        const __m256i needs_cross_product = _mm256_andnot_si256(_mm256_xor_si256(ax_lt, bx_gt), straddles);
+        if (point_in_polygon_block(pts, i, lane_to_edge, pt,
+                _mm256_movemask_pd(_mm256_castsi256_pd(boundary)), _mm256_movemask_pd(_mm256_castsi256_pd(crossing)),
+                _mm256_movemask_pd(_mm256_castsi256_pd(needs_cross_product)), crossings) == -1)
+            return -1;
+    }
+    for (; i + 1 < n; ++ i)
+        if (scalar::point_in_polygon_edge(pts[i], pts[i + 1], pt.x(), pt.y(), crossings))
+            return -1;
+    if (scalar::point_in_polygon_edge(pts[n - 1], pts[0], pt.x(), pt.y(), crossings))
+        return -1;
+    return crossings & 1;
+}
+
+// Points are compared with their successors in 128bit (64bit points) or 64bit (32bit points) units.
+SLIC3R_AVX2_TARGET static size_t find_consecutive_duplicate(const Point *pts, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 < n; i += 4) {
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(load(pts + i), load(pts + i + 1)))) |
+                  (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(load(pts + i + 2), load(pts + i + 3)))) << 4);
+        // Both coordinates equal.
+        if (mask &= (mask >> 1) & 0x55)
+            for (int k = 0;; ++ k, mask >>= 2)
+                if (mask & 1)
+                    return i + k;
+    }
+    for (; i + 1 < n; ++ i)
+        if (pts[i] == pts[i + 1])
+            return i;
+    return n;
+}
+
+SLIC3R_AVX2_TARGET static size_t find_consecutive_duplicate(const Vec2i32 *pts, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 < n; i += 8) {
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(load(pts + i), load(pts + i + 1)))) |
+                  (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(load(pts + i + 4), load(pts + i + 5)))) << 4);
+        if (mask)
+            for (int k = 0;; ++ k, mask >>= 1)
+                if (mask & 1)
+                    return i + k;
+    }
+    for (; i + 1 < n; ++ i)
+        if (pts[i] == pts[i + 1])
+            return i;
+    return n;
+}
+
+} // namespace avx2
+
+#define SLIC3R_POLYGON_KERNEL_DISPATCH(NAME, ...) \
+    return has_avx2() ? avx2::NAME(__VA_ARGS__) : scalar::NAME(__VA_ARGS__)
+
+#else // SLIC3R_POLYGON_KERNELS_AVX2
+
+bool has_avx2() { return false; }
+
+#define SLIC3R_POLYGON_KERNEL_DISPATCH(NAME, ...) \
+    return scalar::NAME(__VA_ARGS__)
+
+#endif // SLIC3R_POLYGON_KERNELS_AVX2
+
+double signed_area2(const Point *pts, size_t n)
+{
+    if (n < 3)
+        return 0.;
+    SLIC3R_POLYGON_KERNEL_DISPATCH(signed_area2, pts, n);
+}
+
+double signed_area2(const Vec2i32 *pts, size_t n)
+{
+    if (n < 3)
+        return 0.;
+    SLIC3R_POLYGON_KERNEL_DISPATCH(signed_area2, pts, n);
+}
+
+void extents(const Point *pts, size_t n, Point &out_min, Point &out_max)
+{
+    SLIC3R_POLYGON_KERNEL_DISPATCH(extents, pts, n, out_min, out_max);
+}
+
+void extents(const Vec2i32 *pts, size_t n, Vec2i32 &out_min, Vec2i32 &out_max)
+{
+    SLIC3R_POLYGON_KERNEL_DISPATCH(extents, pts, n, out_min, out_max);
+}
+
+int point_in_polygon(const Point *pts, size_t n, const Point &pt)
+{
+    if (n < 3)
+        return 0;
+    SLIC3R_POLYGON_KERNEL_DISPATCH(point_in_polygon, pts, n, pt);
+}
+
+int point_in_polygon(const Vec2i32 *pts, size_t n, const Vec2i32 &pt)
+{
+    if (n < 3)
+        return 0;
+    SLIC3R_POLYGON_KERNEL_DISPATCH(point_in_polygon, pts, n, pt);
+}
+
+size_t find_consecutive_duplicate(const Point *pts, size_t n)
+{
+    SLIC3R_POLYGON_KERNEL_DISPATCH(find_consecutive_duplicate, pts, n);
+}
+
+size_t find_consecutive_duplicate(const Vec2i32 *pts, size_t n)
+{
+    SLIC3R_POLYGON_KERNEL_DISPATCH(find_consecutive_duplicate, pts, n);
+}
+
+} // namespace PolygonKernels
+} // namespace Slic3r
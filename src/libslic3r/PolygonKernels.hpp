@@ -0,0 +1,181 @@
+#ifndef slic3r_PolygonKernels_hpp_
+#define slic3r_PolygonKernels_hpp_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "Point.hpp"
+
+// Kernels over contiguous arrays of 2D integer points, shared by Polygon, MultiPoint and BoundingBox.
+// The signed area, extents, point in polygon and duplicate point kernels are implemented for both 64bit coord_t
+// Points and 32bit Vec2i32 with AVX2 intrinsics in PolygonKernels.cpp. The instruction set is detected at runtime,
+// the scalar implementations below are used on CPUs without AVX2 and on other architectures.
+// Both paths return bit exact the same results, thus the output does not depend on the CPU the slicer runs on.
+
+namespace Slic3r {
+namespace PolygonKernels {
+
+static constexpr const size_t block_size = 64;
+
+// Twice the signed area of the closed polygon pts[0, n), positive if counter clockwise.
+// The cross products are taken relative to the first point, which keeps their magnitudes low and drops the two edges
+// touching the first point. The edges are summed into four partial sums, the way the AVX2 kernel sums them.
+double signed_area2(const Point *pts, size_t n);
+double signed_area2(const Vec2i32 *pts, size_t n);
+
+// Minimum and maximum coordinates of pts[0, n), n > 0.
+void extents(const Point *pts, size_t n, Point &out_min, Point &out_max);
+void extents(const Vec2i32 *pts, size_t n, Vec2i32 &out_min, Vec2i32 &out_max);
+
+// Point in polygon test with the semantic of ClipperLib::PointInPolygon(): returns 0 if pt is outside,
+// 1 if inside, -1 if on the boundary of the closed polygon pts[0, n).
+int point_in_polygon(const Point *pts, size_t n, const Point &pt);
+int point_in_polygon(const Vec2i32 *pts, size_t n, const Vec2i32 &pt);
+
+// Index of the first point of pts[0, n) equal to its successor, n if there is none.
+size_t find_consecutive_duplicate(const Point *pts, size_t n);
+size_t find_consecutive_duplicate(const Vec2i32 *pts, size_t n);
+
+// Whether the kernels above run the AVX2 implementation on this CPU.
+bool has_avx2();
+
+namespace scalar {
+
+// Cross product of the edge (pts[i], pts[i + 1]) relative to the origin (ox, oy).
+// The differences are taken in 64bit integers, thus they are exact for 32bit points.
+template<typename PointType>
+inline double area_cross(const PointType *pts, size_t i, int64_t ox, int64_t oy)
+{
+    const double x1 = double(int64_t(pts[i].x()) - ox);
+    const double y1 = double(int64_t(pts[i].y()) - oy);
+    const double x2 = double(int64_t(pts[i + 1].x()) - ox);
+    const double y2 = double(int64_t(pts[i + 1].y()) - oy);
+    return x1 * y2 - x2 * y1;
+}
+
+// Add the edges starting with the i-th point, which did not fill a block of four, to the first partial sum and sum up.
+template<typename PointType>
+inline double signed_area2_finish(const PointType *pts, size_t n, size_t i, double acc[4])
+{
+    for (; i + 1 < n; ++ i)
+        acc[0] += area_cross(pts, i, pts[0].x(), pts[0].y());
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+template<typename PointType>
+inline double signed_area2(const PointType *pts, size_t n)
+{
+    if (n < 3)
+        return 0.;
+    double acc[4] = { 0., 0., 0., 0. };
+    size_t i = 1;
+    for (; i + 4 < n; i += 4)
+        for (size_t k = 0; k < 4; ++ k)
+            acc[k] += area_cross(pts, i + k, pts[0].x(), pts[0].y());
+    return signed_area2_finish(pts, n, i, acc);
+}
+
+template<typename PointType>
+inline void extents(const PointType *pts, size_t n, PointType &out_min, PointType &out_max)
+{
+    out_min = pts[0];
+    out_max = pts[0];
+    for (size_t i = 1; i < n; ++ i) {
+        out_min = out_min.cwiseMin(pts[i]);
+        out_max = out_max.cwiseMax(pts[i]);
+    }
+}
+
+// One edge (a, b) of ClipperLib::PointInPolygon(): returns true if pt lies on the edge,
+// otherwise increments crossings if the edge crosses the ray from pt to the right.
+template<typename PointType>
+inline bool point_in_polygon_edge(const PointType &a, const PointType &b, int64_t px, int64_t py, int &crossings)
+{
+    const int64_t ax = a.x();
+    const int64_t ay = a.y();
+    const int64_t bx = b.x();
+    const int64_t by = b.y();
+    if (by == py && (bx == px || (ay == py && ((bx > px) == (ax < px)))))
+        return true;
+    if ((ay < py) != (by < py)) {
+        if (ax >= px && bx > px)
+            ++ crossings;
+        else if (ax >= px || bx > px) {
+            const double d = double(ax - px) * double(by - py) - double(bx - px) * double(ay - py);
+            if (d == 0)
+                return true;
+            if ((d > 0) == (by > ay))
+                ++ crossings;
+        }
+    }
+    return false;
+}
+
+template<typename PointType>
+inline int point_in_polygon(const PointType *pts, size_t n, const PointType &pt)
+{
+    if (n < 3)
+        return 0;
+    int crossings = 0;
+    for (size_t i = 0; i + 1 < n; ++ i)
+        if (point_in_polygon_edge(pts[i], pts[i + 1], pt.x(), pt.y(), crossings))
+            return -1;
+    if (point_in_polygon_edge(pts[n - 1], pts[0], pt.x(), pt.y(), crossings))
+        return -1;
+    return crossings & 1;
+}
+
+template<typename PointType>
+inline size_t find_consecutive_duplicate(const PointType *pts, size_t n)
+{
+    for (size_t i = 0; i + 1 < n; ++ i)
+        if (pts[i] == pts[i + 1])
+            return i;
+    return n;
+}
+
+} // namespace scalar
+
+// Find the point of pts[begin, end) furthest from the segment (a, b), return its index and squared distance.
+// The distances are evaluated in blocks into a local buffer by a branch free loop, the arg max is then searched for
+// in a second short pass. Clamping the projection parameter to <0, 1> produces bit exact the same squared distances
+// as Line::distance_to_squared(), as the coordinates are integers representable by a double.
+template<typename PointType>
+inline std::pair<size_t, double> furthest_from_segment(const PointType *pts, size_t begin, size_t end, const PointType &a, const PointType &b)
+{
+    // Returns the anchor index (begin - 1) if all the points lie on the segment.
+    std::pair<size_t, double> out { begin - 1, 0. };
+    const double ax  = double(a.x());
+    const double ay  = double(a.y());
+    const double vx  = double(b.x()) - ax;
+    const double vy  = double(b.y()) - ay;
+    const double l2  = vx * vx + vy * vy;
+    // a == b: the distance to the segment is the distance to a, which is achieved with t = 0 / 1.
+    const double div = l2 == 0. ? 1. : l2;
+    double dist_sq[block_size];
+    for (size_t block_begin = begin; block_begin < end; block_begin += block_size) {
+        const size_t     n = std::min(block_size, end - block_begin);
+        const PointType *p = pts + block_begin;
+        for (size_t i = 0; i < n; ++ i) {
+            const double px = double(p[i].x()) - ax;
+            const double py = double(p[i].y()) - ay;
+            const double t  = std::clamp((px * vx + py * vy) / div, 0., 1.);
+            const double dx = t * vx - px;
+            const double dy = t * vy - py;
+            dist_sq[i] = dx * dx + dy * dy;
+        }
+        for (size_t i = 0; i < n; ++ i)
+            if (dist_sq[i] > out.second) {
+                out.first  = block_begin + i;
+                out.second = dist_sq[i];
+            }
+    }
+    return out;
+}
+
+} // namespace PolygonKernels
+} // namespace Slic3r
+
+#endif // slic3r_PolygonKernels_hpp_
@@ -83,6 +83,7 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
         "additional_cooling_fan_speed",
         "reduce_crossing_wall",
         "max_travel_detour_distance",
+        "travel_planner",
         "printable_area",
         //BBS: add bed_exclude_area
         "bed_exclude_area",
@@ -183,6 +184,7 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
         "role_based_wipe_speed",
         "wipe_speed",
         "use_relative_e_distances",
+        "binary_gcode",
         "accel_to_decel_enable",
         "accel_to_decel_factor",
         "wipe_on_loops",
@@ -1067,6 +1069,14 @@ StringObjectException Print::validate(StringObjectException *warning, Polygons*
         }
     }
 
+    if (m_config.binary_gcode) {
+        // BBL printers expect the ASCII G-code inside the 3mf, the post-processing scripts expect ASCII G-code as well.
+        if (this->is_BBL_printer())
+            return { L("Binary G-code is not supported by this printer.") };
+        if (! m_config.post_process.values.empty())
+            return { L("Binary G-code can not be combined with post-processing scripts.") };
+    }
+
     if (m_config.print_sequence == PrintSequence::ByObject) {
         if (m_config.timelapse_type == TimelapseType::tlSmooth)
             return {L("Smooth mode of timelapse is not supported when \"by object\" sequence is enabled.")};
@@ -2162,7 +2172,7 @@ void Print::process(long long *time_cost_with_cache, bool use_cache)
 // The export_gcode may die for various reasons (fails to process filename_format,
 // write error into the G-code, cannot execute post-processing scripts).
 // It is up to the caller to show an error message.
-std::string Print::export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb)
+std::string Print::export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb, GCodeStream* stream)
 {
     // output everything to a G-code file
     // The following call may die if the filename_format template substitution fails.
@@ -2182,7 +2192,7 @@ std::string Print::export_gcode(const std::string& path_template, GCodeProcessor
     //BBS: compute plate offset for gcode-generator
     const Vec3d origin = this->get_plate_origin();
     gcode.set_gcode_offset(origin(0), origin(1));
-    gcode.do_export(this, path.c_str(), result, thumbnail_cb);
+    gcode.do_export(this, path.c_str(), result, thumbnail_cb, stream);
 
     //BBS
     result->conflict_result = m_conflict_result;
@@ -2845,7 +2855,7 @@ std::string Print::output_filename(const std::string &filename_base) const
     config.set_key_value("plate_number", new ConfigOptionString(get_plate_number_formatted()));
     config.set_key_value("model_name", new ConfigOptionString(get_model_name()));
 
-    return this->PrintBase::output_filename(m_config.filename_format.value, ".gcode", filename_base, &config);
+    return this->PrintBase::output_filename(m_config.filename_format.value, m_config.binary_gcode ? ".bgcode" : ".gcode", filename_base, &config);
 }
 
 std::string Print::get_model_name() const
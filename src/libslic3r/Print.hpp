@@ -29,6 +29,7 @@
 namespace Slic3r {
 
 class GCode;
+class GCodeStream;
 class Layer;
 class ModelObject;
 class Print;
@@ -752,6 +753,9 @@ struct PrintStatistics
     double                          total_wipe_tower_filament;
     unsigned int                    initial_tool;
     std::map<size_t, double>        filament_stats;
+    // Length (mm) and time (s) of the travels saved by the grid travel planner against walking the boundaries.
+    double                          travel_length_saved;
+    double                          travel_time_saved;
 
     // Config with the filled in print statistics.
     DynamicConfig           config() const;
@@ -770,6 +774,8 @@ struct PrintStatistics
         total_wipe_tower_filament = 0.;
         initial_tool           = 0;
         filament_stats.clear();
+        travel_length_saved    = 0.;
+        travel_time_saved      = 0.;
     }
     static const std::string FilamentUsedG;
     static const std::string FilamentUsedGMask;
@@ -841,7 +847,8 @@ public:
     void                process(long long *time_cost_with_cache = nullptr, bool use_cache = false) override;
     // Exports G-code into a file name based on the path_template, returns the file path of the generated G-code file.
     // If preview_data is not null, the preview_data is filled in for the G-code visualization (not used by the command line Slic3r).
-    std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    // If stream is set, the G-code is passed to it while being exported, see GCodeStream.
+    std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr, GCodeStream* stream = nullptr);
     //return 0 means successful
     int                 export_cached_data(const std::string& dir_path, bool with_space=false);
     int                 load_cached_data(const std::string& directory);
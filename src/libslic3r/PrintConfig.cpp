@@ -122,6 +122,13 @@ static t_config_enum_values s_keys_map_FuzzySkinType {
 };
 CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(FuzzySkinType)
 
+static t_config_enum_values s_keys_map_FuzzySkinNoiseType {
+    { "classic",        int(FuzzySkinNoiseType::Classic) },
+    { "perlin",         int(FuzzySkinNoiseType::Perlin) },
+    { "simplex",        int(FuzzySkinNoiseType::Simplex) }
+};
+CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(FuzzySkinNoiseType)
+
 static t_config_enum_values s_keys_map_InfillPattern {
     { "concentric",         ipConcentric },
     { "zig-zag",            ipRectilinear },
@@ -182,6 +189,12 @@ static t_config_enum_values s_keys_map_WallDirection{
 };
 CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(WallDirection)
 
+static t_config_enum_values s_keys_map_TravelPlanner{
+    { "boundary", int(TravelPlanner::Boundary) },
+    { "grid",     int(TravelPlanner::Grid) },
+};
+CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(TravelPlanner)
+
 //BBS
 static t_config_enum_values s_keys_map_PrintSequence {
     { "by layer",     int(PrintSequence::ByLayer) },
@@ -649,6 +662,21 @@ void PrintConfigDef::init_fff_params()
     def->mode = comAdvanced;
     def->set_default_value(new ConfigOptionFloatOrPercent(0., false));
 
+    def = this->add("travel_planner", coEnum);
+    def->label = L("Avoid crossing wall - Travel planner");
+    def->category = L("Quality");
+    def->tooltip = L("How the travels between objects are planned when avoiding crossing walls. "
+                     "Boundary follows the outlines of the objects. "
+                     "Grid searches the shortest path around the objects on a grid of the layer, "
+                     "falling back to Boundary if no path is found within a limited search");
+    def->enum_keys_map = &ConfigOptionEnum<TravelPlanner>::get_enum_values();
+    def->enum_values.push_back("boundary");
+    def->enum_values.push_back("grid");
+    def->enum_labels.push_back(L("Boundary"));
+    def->enum_labels.push_back(L("Grid"));
+    def->mode = comAdvanced;
+    def->set_default_value(new ConfigOptionEnum<TravelPlanner>(TravelPlanner::Boundary));
+
     // BBS
     def = this->add("cool_plate_temp", coInts);
     def->label = L("Other layers");
@@ -2538,6 +2566,35 @@ void PrintConfigDef::init_fff_params()
     def->mode = comSimple;
     def->set_default_value(new ConfigOptionBool(0));
 
+    def = this->add("fuzzy_skin_noise_type", coEnum);
+    def->label = L("Fuzzy skin noise type");
+    def->category = L("Others");
+    def->tooltip = L("Noise used to displace the fuzzy skin points.\n"
+                     "Classic: Random jitter of every point.\n"
+                     "Perlin: Smooth coherent noise, giving a more organic texture.\n"
+                     "Simplex: Coherent noise with less directional artifacts than Perlin noise.\n"
+                     "The coherent noises are continuous across layers and reproducible between runs.");
+    def->enum_keys_map = &ConfigOptionEnum<FuzzySkinNoiseType>::get_enum_values();
+    def->enum_values.push_back("classic");
+    def->enum_values.push_back("perlin");
+    def->enum_values.push_back("simplex");
+    def->enum_labels.push_back(L("Classic"));
+    def->enum_labels.push_back(L("Perlin"));
+    def->enum_labels.push_back(L("Simplex"));
+    def->mode = comAdvanced;
+    def->set_default_value(new ConfigOptionEnum<FuzzySkinNoiseType>(FuzzySkinNoiseType::Classic));
+
+    def = this->add("fuzzy_skin_scale", coFloat);
+    def->label = L("Fuzzy skin feature size");
+    def->category = L("Others");
+    def->tooltip = L("The base size of the features of the coherent fuzzy skin noises. "
+                     "Smaller values give a finer texture");
+    def->sidetext = L("mm");
+    def->min = 0.1;
+    def->max = 500;
+    def->mode = comAdvanced;
+    def->set_default_value(new ConfigOptionFloat(1.0));
+
     def = this->add("filter_out_gap_fill", coFloat);
     def->label = L("Filter out tiny gaps");
     def->category = L("Layers and Perimeters");
@@ -5145,6 +5202,13 @@ void PrintConfigDef::init_fff_params()
     def->mode = comAdvanced;
     def->set_default_value(new ConfigOptionBool(true));
 
+    def = this->add("binary_gcode", coBool);
+    def->label = L("Binary G-code");
+    def->tooltip = L("Export block-compressed binary G-code (.bgcode) instead of plain text. "
+                     "The printer firmware or the print host has to support the binary format.");
+    def->mode = comAdvanced;
+    def->set_default_value(new ConfigOptionBool(false));
+
     def = this->add("wall_generator", coEnum);
     def->label = L("Wall generator");
     def->category = L("Quality");
@@ -6951,6 +7015,13 @@ CLIActionsConfigDef::CLIActionsConfigDef()
     def->tooltip = L("Do not run any validity checks, such as gcode path conflicts check.");
     def->set_default_value(new ConfigOptionBool(false));
 
+    def = this->add("deterministic", coBool);
+    def->label = "Deterministic";
+    def->tooltip = "Produce the same G-code for the same input independently of the number of threads and of their scheduling. "
+                   "The MD5 of each exported G-code is reported. Slicing may be slower.";
+    def->cli_params = "option";
+    def->set_default_value(new ConfigOptionBool(false));
+
     def = this->add("normative_check", coBool);
     def->label = "Normative check";
     def->tooltip = "Check the normative items.";
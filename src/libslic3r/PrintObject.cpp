@@ -1,6 +1,7 @@
 #include "Exception.hpp"
 #include "Print.hpp"
 #include "BoundingBox.hpp"
+#include "BoundingBoxIndex.hpp"
 #include "ClipperUtils.hpp"
 #include "ElephantFootCompensation.hpp"
 #include "Geometry.hpp"
@@ -1114,6 +1115,8 @@ bool PrintObject::invalidate_state_by_config_options(
             || opt_key == "fuzzy_skin_thickness"
             || opt_key == "fuzzy_skin_point_distance"
             || opt_key == "fuzzy_skin_first_layer"
+            || opt_key == "fuzzy_skin_noise_type"
+            || opt_key == "fuzzy_skin_scale"
             || opt_key == "detect_overhang_wall"
             || opt_key == "overhang_reverse"
             || opt_key == "overhang_reverse_internal_only"
@@ -2076,11 +2079,17 @@ void PrintObject::bridge_over_infill()
                 // By shrinking the unsupported area, we avoid making bridges from narrow ensuring region along perimeters.
                 unsupported_area   = shrink(unsupported_area, expansion_multiplier * spacing);
                 unsupported_area   = diff(unsupported_area, lower_layer_solids);
-                
+                if (unsupported_area.empty() && po->config().dont_filter_internal_bridges.value != ibfNofilter)
+                    // No internal solid surface of this layer could become a candidate.
+                    continue;
+                // Only the unsupported islands overlapping an internal solid surface take part in its clipping.
+                const BoundingBoxIndex unsupported_area_index(unsupported_area);
+
                 for (const LayerRegion *region : layer->regions()) {
                     SurfacesPtr region_internal_solids = region->fill_surfaces.filter_by_type(stInternalSolid);
                     for (const Surface *s : region_internal_solids) {
-                        Polygons unsupported         = intersection(to_polygons(s->expolygon), unsupported_area);
+                        Polygons unsupported_near    = unsupported_area_index.query(unsupported_area, get_extents(s->expolygon.contour));
+                        Polygons unsupported         = unsupported_near.empty() ? Polygons() : intersection(to_polygons(s->expolygon), unsupported_near);
                         
                         // Orca: If the user has selected to always support internal overhanging regions, no matter how small
                         // skip the filtering
@@ -2686,6 +2695,7 @@ void PrintObject::bridge_over_infill()
                 expansion_area    = intersection(expansion_area, deep_infill_area);
                 Polylines anchors = intersection_pl(infill_lines[lidx - 1], shrink(expansion_area, spacing));
                 Polygons internal_unsupported_area = shrink(deep_infill_area, spacing * 4.5);
+                const BoundingBoxIndex internal_unsupported_area_index(internal_unsupported_area);
 
 #ifdef DEBUG_BRIDGE_OVER_INFILL
                 debug_draw(std::to_string(lidx) + "_" + std::to_string(cluster_idx) + "_" + std::to_string(job_idx) + "_" + "_total_area",
@@ -2700,8 +2710,9 @@ void PrintObject::bridge_over_infill()
                     area_to_be_bridge             = intersection(area_to_be_bridge, deep_infill_area);
 
                     area_to_be_bridge.erase(std::remove_if(area_to_be_bridge.begin(), area_to_be_bridge.end(),
-                                                           [internal_unsupported_area](const Polygon &p) {
-                                                               return intersection({p}, internal_unsupported_area).empty();
+                                                           [&internal_unsupported_area, &internal_unsupported_area_index](const Polygon &p) {
+                                                               Polygons near = internal_unsupported_area_index.query(internal_unsupported_area, get_extents(p));
+                                                               return near.empty() || intersection({p}, near).empty();
                                                            }),
                                             area_to_be_bridge.end());
 
@@ -2742,9 +2753,13 @@ void PrintObject::bridge_over_infill()
 
                     // Check collision with other expanded surfaces
                     {
-                        bool     reconstruct       = false;
-                        Polygons tmp_expanded_area = expand(bridging_area, 3.0 * flow.scaled_spacing());
+                        bool        reconstruct       = false;
+                        Polygons    tmp_expanded_area = expand(bridging_area, 3.0 * flow.scaled_spacing());
+                        BoundingBox tmp_expanded_bbox = get_extents(tmp_expanded_area);
                         for (const CandidateSurface &s : expanded_surfaces) {
+                            // Cheap rejection of surfaces far away from the current one before running Clipper.
+                            if (!tmp_expanded_bbox.defined || !tmp_expanded_bbox.overlap(get_extents(s.new_polys)))
+                                continue;
                             if (!intersection(s.new_polys, tmp_expanded_area).empty()) {
                                 bridging_angle = s.bridge_angle;
                                 reconstruct    = true;
@@ -54,13 +54,17 @@ static std::vector<ExPolygons> slice_volume(
 {
     std::vector<ExPolygons> layers;
     if (! zs.empty()) {
-        indexed_triangle_set its = volume.mesh().its;
+        const indexed_triangle_set &its = volume.mesh().its;
         if (its.indices.size() > 0) {
             MeshSlicingParamsEx params2 { params };
             params2.trafo = params2.trafo * volume.get_matrix();
-            if (params2.trafo.rotation().determinant() < 0.)
-                its_flip_triangles(its);
-            layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
+            if (params2.trafo.rotation().determinant() < 0.) {
+                // Only copy the mesh if it needs to be flipped.
+                indexed_triangle_set its_flipped = its;
+                its_flip_triangles(its_flipped);
+                layers = slice_mesh_ex(its_flipped, zs, params2, throw_on_cancel_callback);
+            } else
+                layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
             throw_on_cancel_callback();
         }
     }
@@ -128,13 +132,6 @@ static std::vector<VolumeSlices> slice_volumes_inner(
 {
     model_volumes_sort_by_id(model_volumes);
 
-    std::vector<VolumeSlices> out;
-    out.reserve(model_volumes.size());
-
-    std::vector<t_layer_height_range> slicing_ranges;
-    if (layer_ranges.size() > 1)
-        slicing_ranges.reserve(layer_ranges.size());
-
     MeshSlicingParamsEx params_base;
     params_base.closing_radius = print_object_config.slice_closing_radius.value;
     params_base.extra_offset   = 0;
@@ -158,8 +155,17 @@ static std::vector<VolumeSlices> slice_volumes_inner(
     //const auto   extra_offset  = is_mm_painted ? 0.f : std::max(0.f, float(print_object_config.xy_contour_compensation.value));
     const auto   extra_offset = 0.f;
 
-    for (const ModelVolume *model_volume : model_volumes)
-        if (model_volume_needs_slicing(*model_volume)) {
+    // Slice the volumes in parallel. Each slice_mesh_ex() call is parallel over the layers already, however with dozens of small
+    // modifier meshes or height range modifiers, each of which only touches a fraction of the layers, the serial loop over the volumes
+    // leaves most of the worker threads idle.
+    std::vector<VolumeSlices> out(model_volumes.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, model_volumes.size(), 1),
+        [&](const tbb::blocked_range<size_t> &range) {
+        std::vector<t_layer_height_range> slicing_ranges;
+        for (size_t volume_idx = range.begin(); volume_idx < range.end(); ++ volume_idx) {
+            const ModelVolume *model_volume = model_volumes[volume_idx];
+            if (! model_volume_needs_slicing(*model_volume))
+                continue;
             MeshSlicingParamsEx params { params_base };
             if (! model_volume->is_negative_volume())
                 params.extra_offset = extra_offset;
@@ -176,10 +182,10 @@ static std::vector<VolumeSlices> slice_volumes_inner(
                         for (; params.slicing_mode_normal_below_layer < zs.size() && zs[params.slicing_mode_normal_below_layer] < region_config.bottom_shell_thickness - EPSILON;
                             ++ params.slicing_mode_normal_below_layer);
                     }
-                    out.push_back({
+                    out[volume_idx] = {
                         model_volume->id(),
                         slice_volume(*model_volume, zs, params, throw_on_cancel_callback)
-                    });
+                    };
                 }
             } else {
                 assert(! print_config.spiral_mode);
@@ -188,15 +194,16 @@ static std::vector<VolumeSlices> slice_volumes_inner(
                     if (layer_range.has_volume(model_volume->id()))
                         slicing_ranges.emplace_back(layer_range.layer_height_range);
                 if (! slicing_ranges.empty())
-                    out.push_back({
+                    out[volume_idx] = {
                         model_volume->id(),
                         slice_volume(*model_volume, zs, slicing_ranges, params, throw_on_cancel_callback)
-                    });
+                    };
             }
-            if (! out.empty() && out.back().slices.empty())
-                out.pop_back();
         }
+    });
 
+    // Remove the volumes not sliced or producing no slices, keep the order by ModelVolume::id().
+    out.erase(std::remove_if(out.begin(), out.end(), [](const VolumeSlices &vs) { return vs.slices.empty(); }), out.end());
     return out;
 }
 
@@ -364,7 +371,10 @@ static std::vector<std::vector<ExPolygons>> slices_to_regions(
                     expolys_b = diff_ex(expolys_b, trimming_b);
                 }; */
 
-                std::vector<RegionSlice> temp_slices;
+                std::vector<RegionSlice>      temp_slices;
+                // Slices of the clipping volumes and per region indices of clipping slices not yet subtracted from that region.
+                std::vector<Polygons>         clipping_polygons;
+                std::vector<std::vector<int>> pending_clipping;
                 for (size_t zs_complex_idx = range.begin(); zs_complex_idx < range.end(); ++ zs_complex_idx) {
                     auto [z_idx, z] = zs_complex[zs_complex_idx];
                     it_layer_range = layer_range_next(print_object_regions.layer_ranges, it_layer_range, z);
@@ -379,12 +389,33 @@ static std::vector<std::vector<ExPolygons>> slices_to_regions(
                             temp_slices.push_back({ std::move(slices->slices[z_idx]), volume_region.region ? volume_region.region->print_object_region_id() : -1, volume_region.model_volume->id() });
                         }
                     }
+                    // Clipping of the preceding regions by a model part or by a negative volume is deferred: the clipping slices
+                    // are collected per region and subtracted from it by a single diff_ex() once the region is read by a modifier or
+                    // when all the volumes of this layer were processed. The pairwise clipping of each preceding region by each
+                    // clipping volume was quadratic in the number of volumes.
+                    clipping_polygons.clear();
+                    pending_clipping.assign(temp_slices.size(), std::vector<int>());
+                    auto apply_pending_clipping = [&temp_slices, &clipping_polygons, &pending_clipping](int idx_region) {
+                        std::vector<int> &clip_ids = pending_clipping[idx_region];
+                        if (clip_ids.empty())
+                            return;
+                        if (clip_ids.size() == 1)
+                            temp_slices[idx_region].expolygons = diff_ex(temp_slices[idx_region].expolygons, clipping_polygons[clip_ids.front()]);
+                        else {
+                            Polygons clip;
+                            for (int clip_id : clip_ids)
+                                append(clip, clipping_polygons[clip_id]);
+                            temp_slices[idx_region].expolygons = diff_ex(temp_slices[idx_region].expolygons, clip);
+                        }
+                        clip_ids.clear();
+                    };
                     for (int idx_region = 0; idx_region < int(layer_range.volume_regions.size()); ++ idx_region)
                         if (! temp_slices[idx_region].expolygons.empty()) {
                             const PrintObjectRegions::VolumeRegion &region = layer_range.volume_regions[idx_region];
                             if (region.model_volume->is_modifier()) {
                                 assert(region.parent > -1);
                                 bool next_region_same_modifier = idx_region + 1 < int(temp_slices.size()) && layer_range.volume_regions[idx_region + 1].model_volume == region.model_volume;
+                                apply_pending_clipping(region.parent);
                                 RegionSlice &parent_slice = temp_slices[region.parent];
                                 RegionSlice &this_slice   = temp_slices[idx_region];
                                 ExPolygons   source       = std::move(this_slice.expolygons);
@@ -399,13 +430,20 @@ static std::vector<std::vector<ExPolygons>> slices_to_regions(
                                     temp_slices[idx_region + 1].expolygons = std::move(source);
                             } else if ((region.model_volume->is_model_part() && clip_multipart_objects) || region.model_volume->is_negative_volume()) {
                                 // Clip every non-zero region preceding it.
+                                int clip_id = -1;
                                 for (int idx_region2 = 0; idx_region2 < idx_region; ++ idx_region2)
                                     if (! temp_slices[idx_region2].expolygons.empty()) {
                                         // Skip trim_overlap for now, because it slow down the performace so much for some special cases
 #if 1
                                         if (const PrintObjectRegions::VolumeRegion& region2 = layer_range.volume_regions[idx_region2];
-                                            !region2.model_volume->is_negative_volume() && overlap_in_xy(*region.bbox, *region2.bbox))
-                                            temp_slices[idx_region2].expolygons = diff_ex(temp_slices[idx_region2].expolygons, temp_slices[idx_region].expolygons);
+                                            !region2.model_volume->is_negative_volume() && overlap_in_xy(*region.bbox, *region2.bbox)) {
+                                            if (clip_id == -1) {
+                                                // Snapshot of this volume's slices, they may be clipped or split by modifiers later.
+                                                clip_id = int(clipping_polygons.size());
+                                                clipping_polygons.emplace_back(to_polygons(temp_slices[idx_region].expolygons));
+                                            }
+                                            pending_clipping[idx_region2].emplace_back(clip_id);
+                                        }
 #else
                                         const PrintObjectRegions::VolumeRegion& region2 = layer_range.volume_regions[idx_region2];
                                         if (!region2.model_volume->is_negative_volume() && overlap_in_xy(*region.bbox, *region2.bbox))
@@ -418,6 +456,8 @@ static std::vector<std::vector<ExPolygons>> slices_to_regions(
                                     }
                             }
                         }
+                    for (int idx_region = 0; idx_region < int(temp_slices.size()); ++ idx_region)
+                        apply_pending_clipping(idx_region);
                     // Sort by region_id, push empty slices to the end.
                     std::sort(temp_slices.begin(), temp_slices.end());
                     // Remove the empty slices.
@@ -6,7 +6,7 @@
 
 #include "clipper.hpp"
 #include "ShortestPath.hpp"
-#include "KDTreeIndirect.hpp"
+#include "KDTreeStatic.hpp"
 #include "MutablePriorityQueue.hpp"
 #include "Print.hpp"
 
@@ -101,8 +101,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 	    }
 
 	    // Construct the closest point KD tree over end points of segments.
-		auto coordinate_fn = [&end_points](size_t idx, size_t dimension) -> double { return end_points[idx].pos[dimension]; };
-		KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree(coordinate_fn, end_points.size());
+		KDTreeStatic<2, double> kdtree(end_points.size(), [&end_points](size_t idx) -> const Vec2d& { return end_points[idx].pos; });
 
 		// Helper to detect loops in already connected paths.
 		// Unique chain IDs are assigned to paths. If paths are connected, end points will not have their chain IDs updated, but the chain IDs
@@ -179,14 +178,16 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 		EndPoint *last_point = nullptr;
 
 		// Assign the closest point and distance to the end points.
+		// Find the closest point to each end_point, which lies on a different extrusion path (filtered by the lambda).
+		// Ignore the starting point as the starting point is considered to be occupied, no end point coud connect to it.
+		// The queries are independent, they are evaluated in a batch.
+		const std::vector<std::array<size_t, 1>> closest_end_points = kdtree.closest_points_batch<1>(end_points.size(),
+			[&end_points](size_t idx) -> const Vec2d& { return end_points[idx].pos; },
+			[first_point_idx](size_t this_idx, size_t idx){ return idx != first_point_idx && (idx ^ this_idx) > 1; });
 		for (EndPoint &end_point : end_points) {
 	    	assert(end_point.edge_out == nullptr);
 	    	if (&end_point != first_point) {
-		    	size_t this_idx = &end_point - &end_points.front();
-		    	// Find the closest point to this end_point, which lies on a different extrusion path (filtered by the lambda).
-		    	// Ignore the starting point as the starting point is considered to be occupied, no end point coud connect to it.
-				size_t next_idx = find_closest_point(kdtree, end_point.pos, 
-					[this_idx, first_point_idx](size_t idx){ return idx != first_point_idx && (idx ^ this_idx) > 1; });
+				size_t next_idx = closest_end_points[&end_point - &end_points.front()].front();
 				assert(next_idx < end_points.size());
 				EndPoint &end_point2 = end_points[next_idx];
 				end_point.edge_out = &end_point2;
@@ -512,8 +513,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 	    }
 
 	    // Construct the closest point KD tree over end points of segments.
-		auto coordinate_fn = [&end_points](size_t idx, size_t dimension) -> double { return end_points[idx].pos[dimension]; };
-		KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree(coordinate_fn, end_points.size());
+		KDTreeStatic<2, double> kdtree(end_points.size(), [&end_points](size_t idx) -> const Vec2d& { return end_points[idx].pos; });
 
 	    // Chained segments with their sum of connection lengths.
 	    // The chain supports flipping all the segments, connecting the segments at the opposite ends.
@@ -675,14 +675,16 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 		EndPoint *last_point = nullptr;
 
 		// Assign the closest point and distance to the end points.
+		// Find the closest point to each end_point, which lies on a different extrusion path (filtered by the lambda).
+		// Ignore the starting point as the starting point is considered to be occupied, no end point coud connect to it.
+		// The queries are independent, they are evaluated in a batch.
+		const std::vector<std::array<size_t, 1>> closest_end_points = kdtree.closest_points_batch<1>(end_points.size(),
+			[&end_points](size_t idx) -> const Vec2d& { return end_points[idx].pos; },
+			[first_point_idx](size_t this_idx, size_t idx){ return idx != first_point_idx && (idx ^ this_idx) > 1; });
 		for (EndPoint &end_point : end_points) {
 	    	assert(end_point.edge_candidate == nullptr);
 	    	if (&end_point != first_point) {
-		    	size_t this_idx = end_point.index(end_points);
-		    	// Find the closest point to this end_point, which lies on a different extrusion path (filtered by the lambda).
-		    	// Ignore the starting point as the starting point is considered to be occupied, no end point coud connect to it.
-				size_t next_idx = find_closest_point(kdtree, end_point.pos, 
-					[this_idx, first_point_idx](size_t idx){ return idx != first_point_idx && (idx ^ this_idx) > 1; });
+				size_t next_idx = closest_end_points[end_point.index(end_points)].front();
 				assert(next_idx < end_points.size());
 				EndPoint &end_point2 = end_points[next_idx];
 				end_point.edge_candidate = &end_point2;
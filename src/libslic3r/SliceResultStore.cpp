@@ -0,0 +1,554 @@
+#include "SliceResultStore.hpp"
+
+#include "Exception.hpp"
+#include "Model.hpp"
+#include "Print.hpp"
+#include "Utils.hpp"
+#include "GCode/GCodeProcessor.hpp"
+
+#include "libslic3r_version.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <type_traits>
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <openssl/md5.h>
+
+namespace Slic3r {
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+static constexpr const char     RESULT_MAGIC[4]    = { 'O', 'S', 'R', 'S' };
+static constexpr uint32_t       RESULT_VERSION     = 2;
+static constexpr const char    *RESULT_FILE        = "result.bin";
+static constexpr const char    *GCODE_FILE         = "plate.gcode";
+
+struct ResultHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint64_t moves_count;
+    uint64_t interpolation_points_count;
+};
+
+// Fixed size record of GCodeProcessorResult::MoveVertex, the interpolation points of the arcs are stored
+// in a separate array following the moves.
+struct MoveRecord
+{
+    uint32_t gcode_id;
+    uint8_t  type;
+    uint8_t  extrusion_role;
+    uint8_t  extruder_id;
+    uint8_t  cp_color_id;
+    float    position[3];
+    float    delta_extruder;
+    float    feedrate;
+    float    width;
+    float    height;
+    float    mm3_per_mm;
+    float    fan_speed;
+    float    temperature;
+    float    time;
+    float    layer_duration;
+    uint8_t  move_path_type;
+    uint8_t  padding[3];
+    float    arc_center_position[3];
+    uint32_t interpolation_points_count;
+};
+static_assert(std::is_trivially_copyable_v<MoveRecord> && sizeof(MoveRecord) % 4 == 0, "MoveRecord is written as raw memory");
+
+class ResultWriter
+{
+public:
+    explicit ResultWriter(std::ostream &os) : m_os(os) {}
+
+    void write_raw(const void *data, size_t size) { m_os.write(reinterpret_cast<const char*>(data), std::streamsize(size)); }
+
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> write(const T &value) { this->write_raw(&value, sizeof(T)); }
+    void write(const std::string &s) { this->write(uint64_t(s.size())); this->write_raw(s.data(), s.size()); }
+    void write(const Vec2d &v) { this->write(v.x()); this->write(v.y()); }
+    template<typename A, typename B>
+    void write(const std::pair<A, B> &p) { this->write(p.first); this->write(p.second); }
+    template<typename T>
+    void write(const std::vector<T> &v) { this->write(uint64_t(v.size())); for (const T &item : v) this->write(item); }
+    template<typename K, typename V>
+    void write(const std::map<K, V> &m) { this->write(uint64_t(m.size())); for (const auto &item : m) this->write(item); }
+
+    void write(const CustomGCode::Item &item) {
+        this->write(item.print_z); this->write(item.type); this->write(item.extruder); this->write(item.color); this->write(item.extra);
+    }
+    void write(const GCodeProcessorResult::SliceWarning &warning) {
+        this->write(warning.level); this->write(warning.msg); this->write(warning.error_code); this->write(warning.params);
+    }
+    void write(const PrintEstimatedStatistics::Mode &mode) {
+        this->write(mode.time); this->write(mode.prepare_time); this->write(mode.custom_gcode_times);
+        this->write(mode.moves_times); this->write(mode.roles_times); this->write(mode.layers_times);
+    }
+
+private:
+    std::ostream &m_os;
+};
+
+class ResultReader
+{
+public:
+    ResultReader(const char *begin, const char *end) : m_ptr(begin), m_end(end) {}
+
+    const char* read_raw(size_t size) {
+        if (size_t(m_end - m_ptr) < size)
+            throw Slic3r::FileIOError("Truncated slicing result");
+        const char *out = m_ptr;
+        m_ptr += size;
+        return out;
+    }
+    bool at_end() const { return m_ptr == m_end; }
+
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> read(T &value) { memcpy(&value, this->read_raw(sizeof(T)), sizeof(T)); }
+    void read(std::string &s) { uint64_t n; this->read(n); const char *data = this->read_raw(n); s.assign(data, data + n); }
+    void read(Vec2d &v) { this->read(v.x()); this->read(v.y()); }
+    template<typename A, typename B>
+    void read(std::pair<A, B> &p) { this->read(p.first); this->read(p.second); }
+    template<typename T>
+    void read(std::vector<T> &v) {
+        uint64_t n;
+        this->read(n);
+        // Each item takes at least one byte, don't let a corrupted count allocate the world.
+        if (n > uint64_t(m_end - m_ptr))
+            throw Slic3r::FileIOError("Corrupted slicing result");
+        v.assign(n, T());
+        for (T &item : v)
+            this->read(item);
+    }
+    template<typename K, typename V>
+    void read(std::map<K, V> &m) {
+        uint64_t n;
+        this->read(n);
+        m.clear();
+        for (uint64_t i = 0; i < n; ++ i) {
+            std::pair<K, V> item;
+            this->read(item);
+            m.emplace(std::move(item));
+        }
+    }
+
+    void read(CustomGCode::Item &item) {
+        this->read(item.print_z); this->read(item.type); this->read(item.extruder); this->read(item.color); this->read(item.extra);
+    }
+    void read(GCodeProcessorResult::SliceWarning &warning) {
+        this->read(warning.level); this->read(warning.msg); this->read(warning.error_code); this->read(warning.params);
+    }
+    void read(PrintEstimatedStatistics::Mode &mode) {
+        this->read(mode.time); this->read(mode.prepare_time); this->read(mode.custom_gcode_times);
+        this->read(mode.moves_times); this->read(mode.roles_times); this->read(mode.layers_times);
+    }
+
+private:
+    const char *m_ptr;
+    const char *m_end;
+};
+
+// Fields of GCodeProcessorResult and PrintStatistics following the moves, in the order of the file.
+// The same function drives both the writer and the reader.
+template<typename Archive, typename Result, typename Statistics>
+void serialize_fields(Archive &ar, Result &result, Statistics &statistics)
+{
+    ar.write_or_read(result.lines_ends);
+    ar.write_or_read(result.printable_area);
+    ar.write_or_read(result.bed_exclude_area);
+    ar.write_or_read(result.toolpath_outside);
+    ar.write_or_read(result.label_object_enabled);
+    ar.write_or_read(result.long_retraction_when_cut);
+    ar.write_or_read(result.timelapse_warning_code);
+    ar.write_or_read(result.support_traditional_timelapse);
+    ar.write_or_read(result.printable_height);
+    ar.write_or_read(result.settings_ids.print);
+    ar.write_or_read(result.settings_ids.filament);
+    ar.write_or_read(result.settings_ids.printer);
+    ar.write_or_read(result.extruders_count);
+    ar.write_or_read(result.backtrace_enabled);
+    ar.write_or_read(result.extruder_colors);
+    ar.write_or_read(result.filament_diameters);
+    ar.write_or_read(result.required_nozzle_HRC);
+    ar.write_or_read(result.filament_densities);
+    ar.write_or_read(result.filament_costs);
+    ar.write_or_read(result.filament_flow_ratios);
+    ar.write_or_read(result.filament_vitrification_temperature);
+    auto &ps = result.print_statistics;
+    ar.write_or_read(ps.volumes_per_color_change);
+    ar.write_or_read(ps.model_volumes_per_extruder);
+    ar.write_or_read(ps.wipe_tower_volumes_per_extruder);
+    ar.write_or_read(ps.support_volumes_per_extruder);
+    ar.write_or_read(ps.total_volumes_per_extruder);
+    ar.write_or_read(ps.flush_per_filament);
+    ar.write_or_read(ps.used_filaments_per_role);
+    for (auto &mode : ps.modes)
+        ar.write_or_read(mode);
+    ar.write_or_read(ps.total_filamentchanges);
+    ar.write_or_read(result.custom_gcode_per_print_z);
+    ar.write_or_read(result.spiral_vase_layers);
+    ar.write_or_read(result.warnings);
+    ar.write_or_read(result.nozzle_hrc);
+    ar.write_or_read(result.nozzle_type);
+    ar.write_or_read(result.bed_type);
+    ar.write_or_read(result.bed_match_result.match);
+    ar.write_or_read(result.bed_match_result.bed_type_name);
+    ar.write_or_read(result.bed_match_result.extruder_id);
+
+    ar.write_or_read(statistics.estimated_normal_print_time);
+    ar.write_or_read(statistics.estimated_silent_print_time);
+    ar.write_or_read(statistics.total_used_filament);
+    ar.write_or_read(statistics.total_extruded_volume);
+    ar.write_or_read(statistics.total_cost);
+    ar.write_or_read(statistics.total_toolchanges);
+    ar.write_or_read(statistics.total_weight);
+    ar.write_or_read(statistics.total_wipe_tower_cost);
+    ar.write_or_read(statistics.total_wipe_tower_filament);
+    ar.write_or_read(statistics.initial_tool);
+    ar.write_or_read(statistics.filament_stats);
+    ar.write_or_read(statistics.travel_length_saved);
+    ar.write_or_read(statistics.travel_time_saved);
+}
+
+struct FieldWriter : ResultWriter
+{
+    using ResultWriter::ResultWriter;
+    template<typename T> void write_or_read(const T &value) { this->write(value); }
+};
+
+struct FieldReader : ResultReader
+{
+    using ResultReader::ResultReader;
+    template<typename T> void write_or_read(T &value) { this->read(value); }
+};
+
+class KeyHasher
+{
+public:
+    KeyHasher() { MD5_Init(&m_ctx); }
+
+    void update(const void *data, size_t size) { MD5_Update(&m_ctx, data, size); }
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> update(const T &value) { this->update(&value, sizeof(T)); }
+    void update(const std::string &s) { this->update(uint64_t(s.size())); this->update(s.data(), s.size()); }
+    void update(const Transform3d &t) { this->update(t.data(), sizeof(double) * 16); }
+    void update(const DynamicPrintConfig &config) {
+        // Keys of a DynamicConfig are sorted, so the hash does not depend on the order the options were set in.
+        for (const std::string &opt_key : config.keys()) {
+            this->update(opt_key);
+            this->update(config.opt_serialize(opt_key));
+        }
+    }
+    void update(const FacetsAnnotation &facets) {
+        const auto &[triangles, bitstream] = facets.get_data();
+        this->update(uint64_t(triangles.size()));
+        this->update(triangles.data(), triangles.size() * sizeof(triangles.front()));
+        this->update(uint64_t(bitstream.size()));
+        for (bool bit : bitstream)
+            this->update(uint8_t(bit));
+    }
+
+    std::string hex_digest() {
+        unsigned char digest[MD5_DIGEST_LENGTH];
+        MD5_Final(digest, &m_ctx);
+        std::string out;
+        for (unsigned char c : digest)
+            out += (boost::format("%02x") % int(c)).str();
+        return out;
+    }
+
+private:
+    MD5_CTX m_ctx;
+};
+
+static std::string model_hash(const Print &print)
+{
+    KeyHasher hasher;
+    hasher.update(print.get_plate_index());
+    const Vec3d origin = print.get_plate_origin();
+    hasher.update(origin.data(), sizeof(double) * 3);
+    for (const PrintObject *print_object : print.objects()) {
+        const ModelObject *model_object = print_object->model_object();
+        hasher.update(model_object->config.get());
+        for (const auto &[range, config] : model_object->layer_config_ranges) {
+            hasher.update(range.first);
+            hasher.update(range.second);
+            hasher.update(config.get());
+        }
+        const std::vector<coordf_t> layer_height_profile = model_object->layer_height_profile.get();
+        hasher.update(layer_height_profile.data(), layer_height_profile.size() * sizeof(coordf_t));
+        for (const ModelVolume *volume : model_object->volumes) {
+            const indexed_triangle_set &its = volume->mesh().its;
+            hasher.update(volume->type());
+            hasher.update(uint64_t(its.vertices.size()));
+            hasher.update(its.vertices.data(), its.vertices.size() * sizeof(its.vertices.front()));
+            hasher.update(uint64_t(its.indices.size()));
+            hasher.update(its.indices.data(), its.indices.size() * sizeof(its.indices.front()));
+            hasher.update(volume->get_matrix());
+            hasher.update(volume->config.get());
+            hasher.update(volume->supported_facets);
+            hasher.update(volume->seam_facets);
+            hasher.update(volume->mmu_segmentation_facets);
+        }
+        hasher.update(print_object->trafo());
+        for (const PrintInstance &instance : print_object->instances()) {
+            hasher.update(instance.shift.x());
+            hasher.update(instance.shift.y());
+            hasher.update(instance.model_instance->get_matrix());
+        }
+    }
+    const CustomGCode::Info custom_gcodes = print.model().get_curr_plate_custom_gcodes();
+    hasher.update(custom_gcodes.mode);
+    for (const CustomGCode::Item &item : custom_gcodes.gcodes) {
+        hasher.update(item.print_z);
+        hasher.update(item.type);
+        hasher.update(item.extruder);
+        hasher.update(item.color);
+        hasher.update(item.extra);
+    }
+    return hasher.hex_digest();
+}
+
+} // namespace
+
+SliceResultStore::SliceResultStore(const std::string &directory, size_t max_entries, size_t max_bytes)
+    : m_directory(directory), m_max_entries(max_entries), m_max_bytes(max_bytes)
+{}
+
+std::string SliceResultStore::key(const Print &print)
+{
+    if (print.objects().empty())
+        return std::string();
+
+    KeyHasher config_hasher;
+    config_hasher.update(print.full_print_config());
+
+    KeyHasher hasher;
+    hasher.update(model_hash(print));
+    hasher.update(config_hasher.hex_digest());
+    hasher.update(std::string(SLIC3R_VERSION "-" SoftFever_VERSION "-" SLIC3R_BUILD_ID));
+    return hasher.hex_digest();
+}
+
+bool SliceResultStore::contains(const std::string &key) const
+{
+    return ! key.empty() && fs::exists(fs::path(m_directory) / key / RESULT_FILE);
+}
+
+bool SliceResultStore::store(const std::string &key, const std::string &gcode_path, const GCodeProcessorResult &result, const PrintStatistics &statistics) const
+{
+    if (key.empty() || result.moves.empty())
+        return false;
+    // The conflicts refer to the objects of the print by their addresses, they can't be restored.
+    if (result.conflict_result.has_value())
+        return false;
+
+    const fs::path entry_dir = fs::path(m_directory) / key;
+    // Written next to the final entry and renamed once complete, a half written entry is never loaded.
+    const fs::path temp_dir  = fs::path(m_directory) / (key + ".part");
+    try {
+        fs::remove_all(temp_dir);
+        fs::create_directories(temp_dir);
+        std::string error_message;
+        if (copy_file(gcode_path, (temp_dir / GCODE_FILE).string(), error_message) != SUCCESS)
+            throw Slic3r::FileIOError(error_message);
+        save_result((temp_dir / RESULT_FILE).string(), result, statistics);
+        fs::remove_all(entry_dir);
+        fs::rename(temp_dir, entry_dir);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << boost::format(": failed to store the slicing result %1%: %2%") % key % ex.what();
+        boost::system::error_code ec;
+        fs::remove_all(temp_dir, ec);
+        return false;
+    }
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": stored the slicing result %1%, %2% moves") % key % result.moves.size();
+    this->prune();
+    // The new entry alone may be over the size limit.
+    return this->contains(key);
+}
+
+bool SliceResultStore::load(const std::string &key, const std::string &gcode_path, GCodeProcessorResult &result, PrintStatistics &statistics) const
+{
+    if (! this->contains(key))
+        return false;
+
+    const fs::path entry_dir = fs::path(m_directory) / key;
+    try {
+        load_result((entry_dir / RESULT_FILE).string(), result, statistics);
+        std::string error_message;
+        if (copy_file((entry_dir / GCODE_FILE).string(), gcode_path, error_message) != SUCCESS)
+            throw Slic3r::FileIOError(error_message);
+        // Keep the recently used entries when pruning.
+        fs::last_write_time(entry_dir, std::time(nullptr));
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << __FUNCTION__ << boost::format(": failed to load the slicing result %1%: %2%") % key % ex.what();
+        result.reset();
+        statistics.clear();
+        return false;
+    }
+    result.filename = gcode_path;
+    result.id       = GCodeProcessor::next_result_id();
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": loaded the slicing result %1%, %2% moves") % key % result.moves.size();
+    return true;
+}
+
+void SliceResultStore::save_result(const std::string &path, const GCodeProcessorResult &result, const PrintStatistics &statistics)
+{
+    boost::nowide::ofstream os(path, std::ios::binary);
+    if (! os)
+        throw Slic3r::FileIOError("Failed to open " + path);
+
+    ResultHeader header;
+    memcpy(header.magic, RESULT_MAGIC, sizeof(header.magic));
+    header.version                    = RESULT_VERSION;
+    header.moves_count                = result.moves.size();
+    header.interpolation_points_count = 0;
+    for (const GCodeProcessorResult::MoveVertex &move : result.moves)
+        header.interpolation_points_count += move.interpolation_points.size();
+
+    FieldWriter writer(os);
+    writer.write_raw(&header, sizeof(header));
+    for (const GCodeProcessorResult::MoveVertex &move : result.moves) {
+        MoveRecord record;
+        memset(&record, 0, sizeof(record));
+        record.gcode_id        = move.gcode_id;
+        record.type            = uint8_t(move.type);
+        record.extrusion_role  = uint8_t(move.extrusion_role);
+        record.extruder_id     = move.extruder_id;
+        record.cp_color_id     = move.cp_color_id;
+        memcpy(record.position, move.position.data(), sizeof(record.position));
+        record.delta_extruder  = move.delta_extruder;
+        record.feedrate        = move.feedrate;
+        record.width           = move.width;
+        record.height          = move.height;
+        record.mm3_per_mm      = move.mm3_per_mm;
+        record.fan_speed       = move.fan_speed;
+        record.temperature     = move.temperature;
+        record.time            = move.time;
+        record.layer_duration  = move.layer_duration;
+        record.move_path_type  = uint8_t(move.move_path_type);
+        memcpy(record.arc_center_position, move.arc_center_position.data(), sizeof(record.arc_center_position));
+        record.interpolation_points_count = uint32_t(move.interpolation_points.size());
+        writer.write_raw(&record, sizeof(record));
+    }
+    for (const GCodeProcessorResult::MoveVertex &move : result.moves)
+        writer.write_raw(move.interpolation_points.data(), move.interpolation_points.size() * sizeof(Vec3f));
+    serialize_fields(writer, result, statistics);
+    writer.write_raw(RESULT_MAGIC, sizeof(RESULT_MAGIC));
+
+    os.close();
+    if (os.fail())
+        throw Slic3r::FileIOError("Failed to write " + path);
+}
+
+void SliceResultStore::load_result(const std::string &path, GCodeProcessorResult &result, PrintStatistics &statistics)
+{
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(path);
+    } catch (const std::exception &ex) {
+        throw Slic3r::FileIOError(std::string("Failed to open ") + path + ": " + ex.what());
+    }
+    if (! file.is_open())
+        throw Slic3r::FileIOError("Failed to open " + path);
+
+    FieldReader reader(file.data(), file.data() + file.size());
+    ResultHeader header;
+    memcpy(&header, reader.read_raw(sizeof(header)), sizeof(header));
+    if (memcmp(header.magic, RESULT_MAGIC, sizeof(RESULT_MAGIC)) != 0 || header.version != RESULT_VERSION)
+        throw Slic3r::FileIOError("Unsupported slicing result " + path);
+    if (header.moves_count > file.size() / sizeof(MoveRecord) || header.interpolation_points_count > file.size() / sizeof(Vec3f))
+        throw Slic3r::FileIOError("Corrupted slicing result " + path);
+
+    const char *records = reader.read_raw(header.moves_count * sizeof(MoveRecord));
+    const char *points  = reader.read_raw(header.interpolation_points_count * sizeof(Vec3f));
+    uint64_t    points_used = 0;
+
+    result.lock();
+    try {
+        result.moves.assign(header.moves_count, GCodeProcessorResult::MoveVertex());
+        for (size_t i = 0; i < result.moves.size(); ++ i) {
+            MoveRecord record;
+            memcpy(&record, records + i * sizeof(MoveRecord), sizeof(MoveRecord));
+            GCodeProcessorResult::MoveVertex &move = result.moves[i];
+            move.gcode_id        = record.gcode_id;
+            move.type            = EMoveType(record.type);
+            move.extrusion_role  = ExtrusionRole(record.extrusion_role);
+            move.extruder_id     = record.extruder_id;
+            move.cp_color_id     = record.cp_color_id;
+            move.position        = Vec3f(record.position[0], record.position[1], record.position[2]);
+            move.delta_extruder  = record.delta_extruder;
+            move.feedrate        = record.feedrate;
+            move.width           = record.width;
+            move.height          = record.height;
+            move.mm3_per_mm      = record.mm3_per_mm;
+            move.fan_speed       = record.fan_speed;
+            move.temperature     = record.temperature;
+            move.time            = record.time;
+            move.layer_duration  = record.layer_duration;
+            move.move_path_type  = EMovePathType(record.move_path_type);
+            move.arc_center_position = Vec3f(record.arc_center_position[0], record.arc_center_position[1], record.arc_center_position[2]);
+            if (record.interpolation_points_count > 0) {
+                if (points_used + record.interpolation_points_count > header.interpolation_points_count)
+                    throw Slic3r::FileIOError("Corrupted slicing result " + path);
+                move.interpolation_points.resize(record.interpolation_points_count);
+                memcpy(move.interpolation_points.data(), points + points_used * sizeof(Vec3f), record.interpolation_points_count * sizeof(Vec3f));
+                points_used += record.interpolation_points_count;
+            }
+        }
+        serialize_fields(reader, result, statistics);
+        if (memcmp(reader.read_raw(sizeof(RESULT_MAGIC)), RESULT_MAGIC, sizeof(RESULT_MAGIC)) != 0 || ! reader.at_end())
+            throw Slic3r::FileIOError("Corrupted slicing result " + path);
+        result.conflict_result.reset();
+    } catch (...) {
+        result.unlock();
+        throw;
+    }
+    result.unlock();
+}
+
+void SliceResultStore::prune() const
+{
+    struct Entry {
+        std::time_t time;
+        fs::path    path;
+        uintmax_t   size;
+    };
+    std::vector<Entry> entries;
+    boost::system::error_code ec;
+    for (fs::directory_iterator it(m_directory, ec), end; ! ec && it != end; it.increment(ec))
+        if (fs::is_directory(it->status()) && it->path().extension() != ".part") {
+            boost::system::error_code ec_entry;
+            Entry entry { fs::last_write_time(it->path(), ec_entry), it->path(), 0 };
+            for (fs::recursive_directory_iterator it_file(entry.path, ec_entry), end_file; ! ec_entry && it_file != end_file; it_file.increment(ec_entry))
+                if (fs::is_regular_file(it_file->status())) {
+                    boost::system::error_code ec_size;
+                    const uintmax_t file_size = fs::file_size(it_file->path(), ec_size);
+                    if (! ec_size)
+                        entry.size += file_size;
+                }
+            entries.emplace_back(std::move(entry));
+        }
+    std::sort(entries.begin(), entries.end(), [](const Entry &l, const Entry &r) { return l.time > r.time; });
+    // Keep the most recently used entries as long as they fit both limits.
+    size_t    num_kept = 0;
+    uintmax_t size     = 0;
+    for (; num_kept < std::min(entries.size(), m_max_entries) && size + entries[num_kept].size <= m_max_bytes; ++ num_kept)
+        size += entries[num_kept].size;
+    for (size_t i = num_kept; i < entries.size(); ++ i) {
+        BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": removing the slicing result %1%, %2% bytes") % entries[i].path.filename().string() % entries[i].size;
+        fs::remove_all(entries[i].path, ec);
+    }
+}
+
+} // namespace Slic3r
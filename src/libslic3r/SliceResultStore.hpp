@@ -0,0 +1,50 @@
+#ifndef slic3r_SliceResultStore_hpp_
+#define slic3r_SliceResultStore_hpp_
+
+#include <string>
+
+namespace Slic3r {
+
+class Print;
+struct GCodeProcessorResult;
+struct PrintStatistics;
+
+// Sidecar store of finished slicing results, so that reopening an unchanged project restores
+// the G-code preview and the print statistics without slicing or processing the G-code again.
+// Each entry is a directory named by the key of the print, holding the final G-code and
+// the GCodeProcessorResult in a compact binary form, see save_result().
+class SliceResultStore
+{
+public:
+    // Each entry holds a full copy of the G-code, so the store is bounded both by the number of entries and by their total size.
+    explicit SliceResultStore(const std::string &directory, size_t max_entries = 32, size_t max_bytes = size_t(2) << 30);
+
+    // Key of a print, combining the hashes of the model, of the full configuration and of the slicer version.
+    // The print has to be applied. Returns an empty string for an empty print.
+    static std::string key(const Print &print);
+
+    bool contains(const std::string &key) const;
+    // Store the final G-code and its processor result under key, replacing an older entry.
+    // The least recently used entries over max_entries or over max_bytes in total are removed.
+    // Returns false on failure or if the new entry alone is larger than max_bytes.
+    bool store(const std::string &key, const std::string &gcode_path, const GCodeProcessorResult &result, const PrintStatistics &statistics) const;
+    // Copy the stored G-code to gcode_path and load its processor result, result.filename is set to gcode_path.
+    // Returns false if there is no such entry or it could not be read.
+    bool load(const std::string &key, const std::string &gcode_path, GCodeProcessorResult &result, PrintStatistics &statistics) const;
+
+    // Binary serialization of the processor result. The moves are written as an array of fixed size records
+    // first, so the file may be memory mapped. Throw Slic3r::FileIOError.
+    static void save_result(const std::string &path, const GCodeProcessorResult &result, const PrintStatistics &statistics);
+    static void load_result(const std::string &path, GCodeProcessorResult &result, PrintStatistics &statistics);
+
+private:
+    void prune() const;
+
+    std::string m_directory;
+    size_t      m_max_entries;
+    size_t      m_max_bytes;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_SliceResultStore_hpp_
@@ -22,6 +22,7 @@
 #include "SupportMaterial.hpp"
 #include "TriangleMeshSlicer.hpp"
 #include "TreeSupport.hpp"
+#include "Thread.hpp"
 #include "I18N.hpp"
 
 #include <cassert>
@@ -1283,7 +1284,7 @@ void generate_initial_areas(
 
     RichInterfacePlacer rich_interface_placer{ interface_placer, volumes, force_tip_to_roof, num_support_layers, move_bounds };
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, raw_overhangs.size()),
+    auto sample_overhangs =
         [&volumes, &config, &raw_overhangs, &mesh_group_settings,
          min_xy_dist, roof_enabled, num_support_roof_layers, extra_outset, circle_length_to_half_linewidth_change, connect_length,
          &rich_interface_placer, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
@@ -1411,7 +1412,13 @@ void generate_initial_areas(
                 throw_on_cancel();
             }
         }
-    });
+    };
+    if (deterministic_execution())
+        // The tips sampled from neighbouring overhangs are deduplicated in the order of their insertion,
+        // keep the order independent of the scheduling of the worker threads.
+        sample_overhangs(tbb::blocked_range<size_t>(0, raw_overhangs.size()));
+    else
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, raw_overhangs.size()), sample_overhangs);
 
     finalize_raft_contact(print_object, raft_contact_layer_idx, interface_placer.top_contacts_mutable(), move_bounds);
 }
@@ -207,6 +207,18 @@ bool is_main_thread_active()
 	return get_main_thread_id() == boost::this_thread::get_id();
 }
 
+static std::atomic<bool> g_deterministic_execution { false };
+
+void set_deterministic_execution(bool deterministic)
+{
+	g_deterministic_execution = deterministic;
+}
+
+bool deterministic_execution()
+{
+	return g_deterministic_execution;
+}
+
 // Spawn (n - 1) worker threads on Intel TBB thread pool and name them by an index and a system thread ID.
 // Also it sets locale of the worker threads to "C" for the G-code generator to produce "." as a decimal separator.
 void name_tbb_thread_pool_threads_set_locale()
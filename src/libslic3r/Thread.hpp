@@ -43,6 +43,27 @@ std::optional<std::string> get_current_thread_name();
 // Also it sets locale of the worker threads to "C" for the G-code generator to produce "." as a decimal separator.
 void name_tbb_thread_pool_threads_set_locale();
 
+// Deterministic execution mode: the parallel algorithms, which would otherwise produce results depending on the scheduling
+// of the worker threads (order of insertion into shared containers, random number sequences), produce the same output
+// for the same input independently of the number of threads, at the cost of some performance.
+// Used by the command line slicer to produce reproducible G-code.
+void set_deterministic_execution(bool deterministic);
+bool deterministic_execution();
+
+// Switches the deterministic execution mode for the life time of the guard, restores the previous mode when destroyed.
+class DeterministicExecutionGuard
+{
+public:
+    explicit DeterministicExecutionGuard(bool deterministic) : m_previous(deterministic_execution()) { set_deterministic_execution(deterministic); }
+    ~DeterministicExecutionGuard() { set_deterministic_execution(m_previous); }
+
+    DeterministicExecutionGuard(const DeterministicExecutionGuard &) = delete;
+    DeterministicExecutionGuard &operator=(const DeterministicExecutionGuard &) = delete;
+
+private:
+    bool m_previous;
+};
+
 template<class Fn>
 inline boost::thread create_thread(boost::thread::attributes &attrs, Fn &&fn)
 {
@@ -3,6 +3,7 @@
 #include "Tesselate.hpp"
 #include "TriangleMesh.hpp"
 #include "TriangleMeshSlicer.hpp"
+#include "Thread.hpp"
 #include "Utils.hpp"
 // BBS
 #include "MeshBoolean.hpp"
@@ -12,6 +13,7 @@
 #include <deque>
 #include <queue>
 #include <mutex>
+#include <tuple>
 #include <utility>
 
 #include <boost/log/trivial.hpp>
@@ -507,6 +509,22 @@ void slice_facet_at_zs(
     }
 }
 
+// The lines of a slice are appended by the worker threads in the order of their scheduling.
+// The loops chained from them then start at a different line on each run, sort the lines
+// of each slice to make the output independent of the scheduling.
+static void sort_lines_if_deterministic(std::vector<IntersectionLines> &lines)
+{
+    if (! deterministic_execution())
+        return;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, lines.size()), [&lines](const tbb::blocked_range<size_t> &range) {
+        for (size_t slice_id = range.begin(); slice_id < range.end(); ++ slice_id)
+            std::sort(lines[slice_id].begin(), lines[slice_id].end(), [](const IntersectionLine &l, const IntersectionLine &r) {
+                return std::make_tuple(l.a.x(), l.a.y(), l.b.x(), l.b.y(), l.a_id, l.b_id, l.edge_a_id, l.edge_b_id, l.edge_type, l.flags) <
+                       std::make_tuple(r.a.x(), r.a.y(), r.b.x(), r.b.y(), r.a_id, r.b_id, r.edge_a_id, r.edge_b_id, r.edge_type, r.flags);
+            });
+    });
+}
+
 template<typename TransformVertex, typename ThrowOnCancel>
 static inline std::vector<IntersectionLines> slice_make_lines(
     const std::vector<stl_vertex>                   &vertices,
@@ -528,6 +546,7 @@ static inline std::vector<IntersectionLines> slice_make_lines(
             }
         }
     );
+    sort_lines_if_deterministic(lines);
     return lines;
 }
 
@@ -972,6 +991,10 @@ inline std::pair<SlabLines, SlabLines> slice_slabs_make_lines(
             }
         }
     );
+    for (SlabLines *lines : { &lines_top, &lines_bottom }) {
+        sort_lines_if_deterministic(lines->at_slice);
+        sort_lines_if_deterministic(lines->between_slices);
+    }
     return out;
 }
 
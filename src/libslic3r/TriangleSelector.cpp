@@ -1,15 +1,104 @@
 #include "TriangleSelector.hpp"
 #include "Model.hpp"
 
+#include <atomic>
+
 #include <boost/container/small_vector.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #ifndef NDEBUG
 //    #define EXPENSIVE_DEBUG_CHECKS
 #endif // NDEBUG
 
 namespace Slic3r {
 
+// Flood fill over a graph of num_nodes nodes starting at seed, expanding each frontier of the breadth-first search in parallel.
+// visit(node, push) is called once for each reached node, possibly concurrently. It returns whether the node belongs to the filled region,
+// and it calls push(neighbor) for the neighbors the region should grow to. A node pushed multiple times is only visited once.
+// progress(num_reached) is called after each frontier with the number of nodes reached so far.
+// Returns the nodes of the filled region in no particular order.
+template<typename VisitFn, typename ProgressFn>
+static std::vector<int> flood_fill_parallel(int seed, size_t num_nodes, VisitFn &&visit, ProgressFn &&progress)
+{
+    // Below this frontier size, expanding the frontier is cheaper than spawning the tasks.
+    static constexpr size_t min_parallel_frontier = 256;
+    // Below this graph size, most of the frontiers stay below min_parallel_frontier.
+    static constexpr size_t min_parallel_nodes    = 65536;
+
+    if (num_nodes < min_parallel_nodes || tbb::this_task_arena::max_concurrency() < 2) {
+        // The atomic flags and the frontier vectors of the parallel search make it 15-20% slower than a serial queue
+        // when there is no other thread to share the frontier with.
+        std::vector<bool> reached(num_nodes, false);
+        std::vector<int>  region;
+        std::vector<int>  queue{seed};
+        reached[seed] = true;
+        auto push = [&reached, &queue](int node) {
+            if (!reached[node]) {
+                reached[node] = true;
+                queue.emplace_back(node);
+            }
+        };
+        for (size_t i = 0; i < queue.size(); ++i) {
+            if (visit(queue[i], push))
+                region.emplace_back(queue[i]);
+            if ((i & 0x0fff) == 0x0fff)
+                progress(queue.size());
+        }
+        progress(queue.size());
+        return region;
+    }
+
+    std::vector<std::atomic<bool>> reached(num_nodes);
+    auto                           push_to = [&reached](std::vector<int> &frontier) {
+        return [&reached, &frontier](int node) {
+            if (!reached[node].load(std::memory_order_relaxed) && !reached[node].exchange(true, std::memory_order_relaxed))
+                frontier.emplace_back(node);
+        };
+    };
+
+    std::vector<int> region;
+    std::vector<int> frontier{seed};
+    std::vector<int> next_frontier;
+    size_t           num_reached = 1;
+    reached[seed] = true;
+    while (!frontier.empty()) {
+        next_frontier.clear();
+        if (frontier.size() < min_parallel_frontier) {
+            auto push = push_to(next_frontier);
+            for (int node : frontier)
+                if (visit(node, push))
+                    region.emplace_back(node);
+        } else {
+            struct ThreadData
+            {
+                std::vector<int> region;
+                std::vector<int> frontier;
+            };
+            tbb::enumerable_thread_specific<ThreadData> thread_data;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, frontier.size()), [&frontier, &thread_data, &visit, &push_to](const tbb::blocked_range<size_t> &range) {
+                ThreadData &data = thread_data.local();
+                auto        push = push_to(data.frontier);
+                for (size_t i = range.begin(); i < range.end(); ++i)
+                    if (visit(frontier[i], push))
+                        data.region.emplace_back(frontier[i]);
+            });
+            for (const ThreadData &data : thread_data) {
+                append(region, data.region);
+                append(next_frontier, data.frontier);
+            }
+        }
+        frontier.swap(next_frontier);
+        num_reached += frontier.size();
+        progress(num_reached);
+    }
+    return region;
+}
+
 // Check if the line is whole inside the sphere, or it is partially inside (intersecting) the sphere.
 // Inspired by Christer Ericson's Real-Time Collision Detection, pp. 177-179.
 static bool test_line_inside_sphere(const Vec3f &line_a, const Vec3f &line_b, const Vec3f &sphere_p, const float sphere_radius)
@@ -255,18 +344,25 @@ void TriangleSelector::select_patch(int facet_start, std::unique_ptr<Cursor> &&c
         }
     }
 
-    const float highlight_angle_limit = -cos(Geometry::deg2rad(highlight_by_angle_deg));
+    const float    highlight_angle_limit = -cos(Geometry::deg2rad(highlight_by_angle_deg));
+    const Matrix3f normal_matrix         = static_cast<Matrix3f>(trafo_no_translate.matrix().block(0, 0, 3, 3).inverse().transpose().cast<float>());
 
     // BBS
     std::vector<int> start_facets;
     HeightRange* hr_cursor = dynamic_cast<HeightRange*>(m_cursor.get());
     if (hr_cursor) {
-        for (int facet_id = 0; facet_id < m_orig_size_indices; facet_id++) {
-            const Triangle& tr = m_triangles[facet_id];
-            if (m_cursor->is_edge_inside_cursor(tr, m_vertices)) {
-                start_facets.push_back(facet_id);
-            }
-        }
+        // Only test the facets in the subtrees of the AABB tree, which span the height range.
+        if (m_orig_facets_tree.empty())
+            m_orig_facets_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(m_mesh.its.vertices, m_mesh.its.indices);
+        AABBTreeIndirect::traverse(m_orig_facets_tree,
+            [hr_cursor](const AABBTreeIndirect::Tree3f::Node &node) { return hr_cursor->is_box_inside_cursor(node.bbox); },
+            [this, &start_facets](const AABBTreeIndirect::Tree3f::Node &node) {
+                if (m_cursor->is_edge_inside_cursor(m_triangles[node.idx], m_vertices))
+                    start_facets.push_back(int(node.idx));
+                return true;
+            });
+        // Keep the order of the facets of the original mesh.
+        std::sort(start_facets.begin(), start_facets.end());
     }
     else {
         start_facets.push_back(facet_start);
@@ -291,7 +387,6 @@ void TriangleSelector::select_patch(int facet_start, std::unique_ptr<Cursor> &&c
         while (facet_idx < int(facets_to_check.size())) {
             int          facet = facets_to_check[facet_idx];
             const Vec3f& facet_normal = m_face_normals[m_triangles[facet].source_triangle];
-            Matrix3f     normal_matrix = static_cast<Matrix3f>(trafo_no_translate.matrix().block(0, 0, 3, 3).inverse().transpose().cast<float>());
             float        world_normal_z = (normal_matrix* facet_normal).normalized().z();
             if (!visited[facet] && (highlight_by_angle_deg == 0.f || world_normal_z < highlight_angle_limit)) {
                 if (select_triangle(facet, new_state, triangle_splitting)) {
@@ -316,59 +411,82 @@ bool TriangleSelector::is_facet_clipped(int facet_idx, const ClippingPlane &clp)
     return false;
 }
 
+bool TriangleSelector::is_orig_facet_clipped(int facet_idx, const ClippingPlane &clp) const
+{
+    assert(facet_idx < m_orig_size_indices);
+    if (clp.is_active())
+        for (int vert_idx : m_mesh.its.indices[facet_idx])
+            if (clp.is_mesh_point_clipped(m_mesh.its.vertices[vert_idx]))
+                return true;
+
+    return false;
+}
+
+bool TriangleSelector::seed_fill_needs_update(const Vec3f &hit, int facet_start, const ClippingPlane &clp) const
+{
+    assert(facet_start < m_orig_size_indices);
+    // Recompute seed fill only if the cursor is pointing on facet unselected by seed fill or a clipping plane is active.
+    int start_facet_idx = select_unsplit_triangle(hit, facet_start);
+    return start_facet_idx < 0 || !m_triangles[start_facet_idx].is_selected_by_seed_fill() || clp.is_active();
+}
+
 void TriangleSelector::seed_fill_select_triangles(const Vec3f &hit, int facet_start, const Transform3d& trafo_no_translate,
                                                   const ClippingPlane &clp, float seed_fill_angle, float highlight_by_angle_deg,
                                                   bool force_reselection)
 {
-    assert(facet_start < m_orig_size_indices);
-
-    // Recompute seed fill only if the cursor is pointing on facet unselected by seed fill or a clipping plane is active.
-    if (int start_facet_idx = select_unsplit_triangle(hit, facet_start); start_facet_idx >= 0 && m_triangles[start_facet_idx].is_selected_by_seed_fill() && !force_reselection && !clp.is_active())
+    if (!force_reselection && !this->seed_fill_needs_update(hit, facet_start, clp))
         return;
 
     this->seed_fill_unselect_all_triangles();
+    this->seed_fill_select_region(this->seed_fill_region(facet_start, trafo_no_translate, clp, seed_fill_angle, highlight_by_angle_deg));
+}
 
-    std::vector<bool> visited(m_triangles.size(), false);
-    std::queue<int>   facet_queue;
-    facet_queue.push(facet_start);
-
-    const double facet_angle_limit     = cos(Geometry::deg2rad(seed_fill_angle)) - EPSILON;
-    const float  highlight_angle_limit = -cos(Geometry::deg2rad(highlight_by_angle_deg));
+std::vector<int> TriangleSelector::seed_fill_region(int facet_start, const Transform3d &trafo_no_translate, const ClippingPlane &clp,
+                                                    float seed_fill_angle, float highlight_by_angle_deg,
+                                                    const std::function<void()> &throw_on_cancel, const std::function<void(int)> &status_fn) const
+{
+    assert(facet_start < m_orig_size_indices);
 
-    // Depth-first traversal of neighbors of the face hit by the ray thrown from the mouse cursor.
-    while (!facet_queue.empty()) {
-        int current_facet = facet_queue.front();
-        facet_queue.pop();
+    const double   facet_angle_limit     = cos(Geometry::deg2rad(seed_fill_angle)) - EPSILON;
+    const float    highlight_angle_limit = -cos(Geometry::deg2rad(highlight_by_angle_deg));
+    const Matrix3f normal_matrix         = static_cast<Matrix3f>(trafo_no_translate.matrix().block(0, 0, 3, 3).inverse().transpose().cast<float>());
 
-        const Vec3f &facet_normal = m_face_normals[m_triangles[current_facet].source_triangle];
-        Matrix3f     normal_matrix  = static_cast<Matrix3f>(trafo_no_translate.matrix().block(0, 0, 3, 3).inverse().transpose().cast<float>());
+    // Breadth-first search over the facets of the original mesh, starting at the facet hit by the ray thrown from the mouse cursor.
+    // Children triangles share normal with their parent, thus whole subtrees of the reached facets are selected.
+    return flood_fill_parallel(facet_start, size_t(m_orig_size_indices), [&](int current_facet, auto &&push) {
+        const Vec3f &facet_normal   = m_face_normals[current_facet];
         float        world_normal_z = (normal_matrix * facet_normal).normalized().z();
-        if (!visited[current_facet] && (highlight_by_angle_deg == 0.f || world_normal_z < highlight_angle_limit)) {
-            if (m_triangles[current_facet].is_split()) {
-                for (int split_triangle_idx = 0; split_triangle_idx <= m_triangles[current_facet].number_of_split_sides(); ++split_triangle_idx) {
-                    assert(split_triangle_idx < int(m_triangles[current_facet].children.size()));
-                    assert(m_triangles[current_facet].children[split_triangle_idx] < int(m_triangles.size()));
-                    if (int child = m_triangles[current_facet].children[split_triangle_idx]; !visited[child])
-                        // Child triangle shares normal with its parent. Select it.
-                        facet_queue.push(child);
-                }
-            } else
-                m_triangles[current_facet].select_by_seed_fill();
-
-            if (current_facet < m_orig_size_indices)
-                // Propagate over the original triangles.
-                for (int neighbor_idx : m_neighbors[current_facet]) {
-                    assert(neighbor_idx >= -1);
-                    if (neighbor_idx >= 0 && !visited[neighbor_idx] && !is_facet_clipped(neighbor_idx, clp)) {
-                        // Check if neighbour_facet_idx is satisfies angle in seed_fill_angle and append it to facet_queue if it do.
-                        const Vec3f &n1 = m_face_normals[m_triangles[neighbor_idx].source_triangle];
-                        const Vec3f &n2 = m_face_normals[m_triangles[current_facet].source_triangle];
-                        if (std::clamp(n1.dot(n2), 0.f, 1.f) >= facet_angle_limit)
-                            facet_queue.push(neighbor_idx);
-                    }
-                }
+        if (highlight_by_angle_deg != 0.f && world_normal_z >= highlight_angle_limit)
+            return false;
+
+        for (int neighbor_idx : m_neighbors[current_facet]) {
+            assert(neighbor_idx >= -1);
+            if (neighbor_idx >= 0 && !is_orig_facet_clipped(neighbor_idx, clp)) {
+                // Check if neighbour_facet_idx is satisfies angle in seed_fill_angle and append it to facet_queue if it do.
+                const Vec3f &n1 = m_face_normals[neighbor_idx];
+                if (std::clamp(n1.dot(facet_normal), 0.f, 1.f) >= facet_angle_limit)
+                    push(neighbor_idx);
+            }
         }
-        visited[current_facet] = true;
+        return true;
+    }, [this, &throw_on_cancel, &status_fn](size_t num_reached) {
+        if (throw_on_cancel)
+            throw_on_cancel();
+        if (status_fn)
+            status_fn(int(num_reached * 100 / size_t(m_orig_size_indices)));
+    });
+}
+
+void TriangleSelector::seed_fill_select_region(const std::vector<int> &facets)
+{
+    std::vector<int> leaf_triangles;
+    for (int facet_idx : facets) {
+        leaf_triangles.clear();
+        this->append_leaf_triangles(facet_idx, leaf_triangles);
+        for (int triangle_idx : leaf_triangles)
+            m_triangles[triangle_idx].select_by_seed_fill();
+        this->mark_dirty(facet_idx);
+        m_seed_fill_dirty = true;
     }
 }
 
@@ -405,13 +523,16 @@ std::pair<std::vector<Vec3i32>, std::vector<Vec3i32>> TriangleSelector::precompu
 {
     std::vector<Vec3i32> neighbors(m_triangles.size(), Vec3i32(-1, -1, -1));
     std::vector<Vec3i32> neighbors_propagated(m_triangles.size(), Vec3i32(-1, -1, -1));
-    for (int facet_idx = 0; facet_idx < this->m_orig_size_indices; ++facet_idx) {
-        neighbors[facet_idx]            = m_neighbors[facet_idx];
-        neighbors_propagated[facet_idx] = neighbors[facet_idx];
-        assert(this->verify_triangle_neighbors(m_triangles[facet_idx], neighbors[facet_idx]));
-        if (m_triangles[facet_idx].is_split())
-            this->precompute_all_neighbors_recursive(facet_idx, neighbors[facet_idx], neighbors_propagated[facet_idx], neighbors, neighbors_propagated);
-    }
+    // The subtrees of the facets of the original mesh are disjoint, thus they may be processed in parallel.
+    tbb::parallel_for(tbb::blocked_range<int>(0, m_orig_size_indices), [this, &neighbors, &neighbors_propagated](const tbb::blocked_range<int> &range) {
+        for (int facet_idx = range.begin(); facet_idx < range.end(); ++facet_idx) {
+            neighbors[facet_idx]            = m_neighbors[facet_idx];
+            neighbors_propagated[facet_idx] = neighbors[facet_idx];
+            assert(this->verify_triangle_neighbors(m_triangles[facet_idx], neighbors[facet_idx]));
+            if (m_triangles[facet_idx].is_split())
+                this->precompute_all_neighbors_recursive(facet_idx, neighbors[facet_idx], neighbors_propagated[facet_idx], neighbors, neighbors_propagated);
+        }
+    });
     return std::make_pair(std::move(neighbors), std::move(neighbors_propagated));
 }
 
@@ -491,6 +612,8 @@ void TriangleSelector::bucket_fill_select_triangles(const Vec3f& hit, int facet_
 
     if (!propagate) {
         m_triangles[start_facet_idx].select_by_seed_fill();
+        this->mark_dirty(m_triangles[start_facet_idx].source_triangle);
+        m_seed_fill_dirty = true;
         return;
     }
 
@@ -514,35 +637,30 @@ void TriangleSelector::bucket_fill_select_triangles(const Vec3f& hit, int facet_
     };
 
     auto [neighbors, neighbors_propagated] = this->precompute_all_neighbors();
-    std::vector<bool>  visited(m_triangles.size(), false);
-    std::queue<int>    facet_queue;
 
-    facet_queue.push(start_facet_idx);
-    while (!facet_queue.empty()) {
-        int current_facet = facet_queue.front();
-        facet_queue.pop();
+    std::vector<int> facets = flood_fill_parallel(start_facet_idx, m_triangles.size(), [&](int current_facet, auto &&push) {
         assert(!m_triangles[current_facet].is_split());
-
-        if (!visited[current_facet]) {
-            m_triangles[current_facet].select_by_seed_fill();
-
-            std::vector<int> touching_triangles = get_all_touching_triangles(current_facet, neighbors[current_facet], neighbors_propagated[current_facet]);
-            for(const int tr_idx : touching_triangles) {
-                if (tr_idx < 0 || visited[tr_idx] || m_triangles[tr_idx].get_state() != start_facet_state || is_facet_clipped(tr_idx, clp))
-                    continue;
-
-                const Vec3f& n1 = m_face_normals[m_triangles[tr_idx].source_triangle];
-                const Vec3f& n2 = m_face_normals[m_triangles[current_facet].source_triangle];
-                if (seed_fill_angle >= -EPSILON && std::clamp(n1.dot(n2), 0.f, 1.f) < facet_angle_limit)
-                    continue;
-
-                assert(!m_triangles[tr_idx].is_split());
-                facet_queue.push(tr_idx);
-            }
+        std::vector<int> touching_triangles = get_all_touching_triangles(current_facet, neighbors[current_facet], neighbors_propagated[current_facet]);
+        for(const int tr_idx : touching_triangles) {
+            if (tr_idx < 0 || m_triangles[tr_idx].get_state() != start_facet_state || is_facet_clipped(tr_idx, clp))
+                continue;
+
+            const Vec3f& n1 = m_face_normals[m_triangles[tr_idx].source_triangle];
+            const Vec3f& n2 = m_face_normals[m_triangles[current_facet].source_triangle];
+            if (seed_fill_angle >= -EPSILON && std::clamp(n1.dot(n2), 0.f, 1.f) < facet_angle_limit)
+                continue;
+
+            assert(!m_triangles[tr_idx].is_split());
+            push(tr_idx);
         }
+        return true;
+    }, [](size_t) {});
 
-        visited[current_facet] = true;
+    for (int facet_idx : facets) {
+        m_triangles[facet_idx].select_by_seed_fill();
+        this->mark_dirty(m_triangles[facet_idx].source_triangle);
     }
+    m_seed_fill_dirty = true;
 }
 
 // Selects either the whole triangle (discarding any children it had), or divides
@@ -563,6 +681,8 @@ bool TriangleSelector::select_triangle(int facet_idx, EnforcerBlockerType type,
     if (! select_triangle_recursive(facet_idx, neighbors, type, triangle_splitting))
         return false;
 
+    this->mark_dirty(m_triangles[facet_idx].source_triangle);
+
     // In case that all children are leafs and have the same state now,
     // they may be removed and substituted by the parent triangle.
     remove_useless_children(facet_idx);
@@ -959,6 +1079,7 @@ void TriangleSelector::set_facet(int facet_idx, EnforcerBlockerType state)
     undivide_triangle(facet_idx);
     assert(! m_triangles[facet_idx].is_split());
     m_triangles[facet_idx].set_state(state);
+    this->mark_dirty(facet_idx);
 }
 
 // called by select_patch()->select_triangle()...select_triangle()
@@ -1125,6 +1246,15 @@ bool TriangleSelector::HeightRange::is_edge_inside_cursor(const Triangle& tr, co
              (pts[0].z() > top_z && pts[1].z() > top_z && pts[2].z() > top_z));
 }
 
+bool TriangleSelector::HeightRange::is_box_inside_cursor(const AABBTreeIndirect::Tree3f::BoundingBox& box) const
+{
+    // World z of the box center and the half extent of the transformed box along the world z axis.
+    const Vec3f center      = box.center();
+    const float z           = (this->trafo * center).z();
+    const float half_extent = this->trafo.linear().row(2).cwiseAbs().dot(0.5f * box.sizes().transpose());
+    return z + half_extent >= m_z_world - EPSILON && z - half_extent <= m_z_world + m_height + EPSILON;
+}
+
 // Recursively remove all subtriangles.
 void TriangleSelector::undivide_triangle(int facet_idx)
 {
@@ -1257,7 +1387,7 @@ void TriangleSelector::garbage_collect()
 }
 
 TriangleSelector::TriangleSelector(const TriangleMesh& mesh, float edge_limit)
-    : m_mesh{mesh}, m_neighbors(its_face_neighbors(mesh.its)), m_face_normals(its_face_normals(mesh.its)), m_edge_limit(edge_limit)
+    : m_mesh{mesh}, m_neighbors(its_face_neighbors_par(mesh.its)), m_face_normals(its_face_normals(mesh.its)), m_edge_limit(edge_limit)
 {
     reset();
 }
@@ -1279,6 +1409,43 @@ void TriangleSelector::reset()
     }
     m_orig_size_vertices = int(m_vertices.size());
     m_orig_size_indices  = int(m_triangles.size());
+
+    m_dirty_facets.clear();
+    m_dirty_facets_mask.assign(m_orig_size_indices, false);
+    m_all_dirty       = true;
+    m_seed_fill_dirty = true;
+}
+
+void TriangleSelector::mark_dirty(int source_triangle)
+{
+    assert(source_triangle >= 0 && source_triangle < m_orig_size_indices);
+    if (! m_all_dirty && ! m_dirty_facets_mask[source_triangle]) {
+        m_dirty_facets_mask[source_triangle] = true;
+        m_dirty_facets.emplace_back(source_triangle);
+    }
+}
+
+void TriangleSelector::clear_dirty()
+{
+    for (int facet_idx : m_dirty_facets)
+        m_dirty_facets_mask[facet_idx] = false;
+    m_dirty_facets.clear();
+    m_all_dirty       = false;
+    m_seed_fill_dirty = false;
+}
+
+void TriangleSelector::append_leaf_triangles(int facet_idx, std::vector<int> &leaf_triangles_out) const
+{
+    assert(facet_idx < int(m_triangles.size()));
+    const Triangle &tr = m_triangles[facet_idx];
+    if (! tr.valid())
+        return;
+
+    if (tr.is_split()) {
+        for (int i = 0; i <= tr.number_of_split_sides(); ++ i)
+            this->append_leaf_triangles(tr.children[i], leaf_triangles_out);
+    } else
+        leaf_triangles_out.emplace_back(facet_idx);
 }
 
 void TriangleSelector::set_edge_limit(float edge_limit)
@@ -1704,6 +1871,8 @@ void TriangleSelector::deserialize(const std::pair<std::vector<std::pair<int, in
 {
     if (needs_reset)
         reset(); // dump any current state
+    m_all_dirty       = true;
+    m_seed_fill_dirty = true;
     for (auto [triangle_id, ibit] : data.first) {
         if (triangle_id >= int(m_triangles.size())) {
             BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << "array bound:error:triangle_id >= int(m_triangles.size())";
@@ -1866,15 +2035,20 @@ bool TriangleSelector::has_facets(const std::pair<std::vector<std::pair<int, int
 void TriangleSelector::seed_fill_unselect_all_triangles()
 {
     for (Triangle &triangle : m_triangles)
-        if (!triangle.is_split())
+        if (!triangle.is_split() && triangle.is_selected_by_seed_fill()) {
             triangle.unselect_by_seed_fill();
+            this->mark_dirty(triangle.source_triangle);
+            m_seed_fill_dirty = true;
+        }
 }
 
 void TriangleSelector::seed_fill_apply_on_triangles(EnforcerBlockerType new_state)
 {
     for (Triangle &triangle : m_triangles)
-        if (!triangle.is_split() && triangle.is_selected_by_seed_fill())
+        if (!triangle.is_split() && triangle.is_selected_by_seed_fill()) {
             triangle.set_state(new_state);
+            this->mark_dirty(triangle.source_triangle);
+        }
 
     for (Triangle &triangle : m_triangles)
         if (triangle.is_split() && triangle.valid()) {
@@ -5,8 +5,10 @@
 
 
 #include <cfloat>
+#include <functional>
 #include "Point.hpp"
 #include "TriangleMesh.hpp"
+#include "AABBTreeIndirect.hpp"
 #include "libslic3r/Model.hpp"
 
 namespace Slic3r {
@@ -172,6 +174,8 @@ public:
         {
             return true;
         }
+        // Is any point of the axis aligned box (in mesh coordinates) inside the height range?
+        bool is_box_inside_cursor(const AABBTreeIndirect::Tree3f::BoundingBox& box) const;
     private:
         float m_z_world;
         float m_height;
@@ -239,6 +243,21 @@ public:
                                     float               highlight_by_angle_deg = 0.f, // The maximal angle of overhang. If it is set to a non-zero value, it is possible to paint only the triangles of overhang defined by this angle in degrees.
                                     bool                force_reselection = false);   // force reselection of the triangle mesh even in cases that mouse is pointing on the selected triangle
 
+    // Returns false if the triangle hit is already selected by the seed fill, thus the seed fill need not be recomputed.
+    [[nodiscard]] bool seed_fill_needs_update(const Vec3f &hit, int facet_start, const ClippingPlane &clp) const;
+    // The search of seed_fill_select_triangles() without selecting anything. Returns the facets of the original mesh reached.
+    // Only the original mesh is read, thus the search may run on a background thread while the selector is being painted.
+    // throw_on_cancel is called and status_fn receives the percentage of the facets reached after each step of the search.
+    [[nodiscard]] std::vector<int> seed_fill_region(int                             facet_start,
+                                                    const Transform3d              &trafo_no_translate,
+                                                    const ClippingPlane            &clp,
+                                                    float                           seed_fill_angle,
+                                                    float                           highlight_by_angle_deg = 0.f,
+                                                    const std::function<void()>    &throw_on_cancel = {},
+                                                    const std::function<void(int)> &status_fn = {}) const;
+    // Select the triangles of the facets returned by seed_fill_region().
+    void seed_fill_select_region(const std::vector<int> &facets);
+
     void bucket_fill_select_triangles(const Vec3f         &hit,                        // point where to start
                                       int                  facet_start,                // facet of the original mesh (unsplit) that the hit point belongs to
                                       const ClippingPlane &clp,                        // Clipping plane to limit painting to not clipped facets only
@@ -282,6 +301,15 @@ public:
     // The operation may merge split triangles if they are being assigned the same color.
     void seed_fill_apply_on_triangles(EnforcerBlockerType new_state);
 
+    // Facets of the original mesh, whose subtrees were modified since the last call to clear_dirty(). Each facet is listed once.
+    // Used to update the data derived from the selection (such as the render buffers) incrementally.
+    const std::vector<int>& dirty_facets() const { return m_dirty_facets; }
+    // If set, all facets are to be considered modified, for example after reset() or deserialize().
+    bool all_dirty() const { return m_all_dirty; }
+    // Was any triangle selected or unselected by seed fill since the last call to clear_dirty()?
+    bool seed_fill_dirty() const { return m_seed_fill_dirty; }
+    void clear_dirty();
+
 protected:
     // Triangle and info about how it's split.
     class Triangle {
@@ -353,6 +381,11 @@ protected:
     void append_touching_subtriangles(int itriangle, int vertexi, int vertexj, std::vector<int>& touching_subtriangles_out) const;
     bool verify_triangle_neighbors(const Triangle& tr, const Vec3i32& neighbors) const;
 
+    // Record that the subtree of the facet of the original mesh was modified.
+    void mark_dirty(int source_triangle);
+    // Append the valid unsplit triangles of the subtree of facet_idx.
+    void append_leaf_triangles(int facet_idx, std::vector<int> &leaf_triangles_out) const;
+
 
     // Lists of vertices and triangles, both original and new
     std::vector<Vertex> m_vertices;
@@ -378,6 +411,15 @@ protected:
     // Zero indicates an uninitialized state.
     float m_old_cursor_radius_sqr = 0;
 
+    // See dirty_facets(), m_dirty_facets_mask is set for the facets in m_dirty_facets.
+    std::vector<int>  m_dirty_facets;
+    std::vector<bool> m_dirty_facets_mask;
+    bool              m_all_dirty { true };
+    bool              m_seed_fill_dirty { true };
+
+    // AABB tree over the facets of the original mesh, built on demand by the cursors not starting at the hit facet.
+    AABBTreeIndirect::Tree3f m_orig_facets_tree;
+
     // Private functions:
 private:
     bool select_triangle(int facet_idx, EnforcerBlockerType type, bool triangle_splitting);
@@ -386,6 +428,8 @@ private:
     void split_triangle(int facet_idx, const Vec3i32 &neighbors);
     void remove_useless_children(int facet_idx); // No hidden meaning. Triangles are meant.
     bool is_facet_clipped(int facet_idx, const ClippingPlane &clp) const;
+    // Same as is_facet_clipped() for a facet of the original mesh, reading the original mesh only.
+    bool is_orig_facet_clipped(int facet_idx, const ClippingPlane &clp) const;
     int  push_triangle(int a, int b, int c, int source_triangle, EnforcerBlockerType state = EnforcerBlockerType{0});
     void perform_split(int facet_idx, const Vec3i32 &neighbors, EnforcerBlockerType old_state);
     Vec3i32 child_neighbors(const Triangle &tr, const Vec3i32 &neighbors, int child_idx) const;
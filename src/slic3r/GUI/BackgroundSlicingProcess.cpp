@@ -15,7 +15,9 @@
 #include "libslic3r/Print.hpp"
 #include "libslic3r/SLAPrint.hpp"
 #include "libslic3r/Utils.hpp"
+#include "libslic3r/GCode/GCodeStream.hpp"
 #include "libslic3r/GCode/PostProcessor.hpp"
+#include "libslic3r/PNGReadWrite.hpp"
 #include "libslic3r/Thread.hpp"
 #include "libslic3r/libslic3r.h"
 
@@ -186,6 +188,8 @@ std::string BackgroundSlicingProcess::output_filepath_for_project(const boost::f
 void BackgroundSlicingProcess::process_fff()
 {
     assert(m_print == m_fff_print);
+    // Set if the scheduled upload was started while exporting the G-code.
+    std::shared_ptr<GCodeStream> upload_stream;
     m_fff_print->is_BBL_printer() = wxGetApp().preset_bundle->is_bbl_vendor();
 	//BBS: add the logic to process from an existed gcode file
 	if (m_print->finished()) {
@@ -202,7 +206,9 @@ void BackgroundSlicingProcess::process_fff()
 			BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(" %1%: export gcode from %2% directly to %3%")%__LINE__%m_temp_output_path %m_export_path;
 		}
 		else {
-            if (m_upload_job.empty()) {
+            // The result restored from the SliceResultStore already belongs to this G-code, no need to process it again.
+            bool result_restored = m_gcode_result->filename == m_temp_output_path && ! m_gcode_result->moves.empty();
+            if (m_upload_job.empty() && ! result_restored) {
                 m_fff_print->export_gcode_from_previous_file(m_temp_output_path, m_gcode_result, [this](const ThumbnailsParams &params) {
                     return this->render_thumbnails(params);
                 });
@@ -228,7 +234,14 @@ void BackgroundSlicingProcess::process_fff()
 
 		//BBS: add plate index into render params
 		m_temp_output_path = this->get_current_plate()->get_tmp_gcode_path();
-		m_fff_print->export_gcode(m_temp_output_path, m_gcode_result, [this](const ThumbnailsParams& params) { return this->render_thumbnails(params); });
+		upload_stream = this->start_streamed_upload();
+		{
+			// The upload is already queued and waits for the G-code. Release it if the export fails before the G-code
+			// generator takes over the stream, f.e. if the output file name could not be formatted.
+			ScopeGuard abort_upload_stream([&upload_stream]() { if (upload_stream) upload_stream->abort(); });
+			m_fff_print->export_gcode(m_temp_output_path, m_gcode_result, [this](const ThumbnailsParams& params) { return this->render_thumbnails(params); }, upload_stream.get());
+			abort_upload_stream.reset();
+		}
 		if(m_fff_print->is_BBL_printer())
 			run_post_process_scripts(m_temp_output_path, false, "File", m_temp_output_path, m_fff_print->full_print_config());
 
@@ -244,6 +257,8 @@ void BackgroundSlicingProcess::process_fff()
 	    } else if (! m_upload_job.empty()) {
 			wxQueueEvent(GUI::wxGetApp().mainframe->m_plater, new wxCommandEvent(m_event_export_began_id));
 			prepare_upload();
+	    } else if (upload_stream) {
+			m_print->set_status(100, _utf8(L("G-code exported, the upload continues. See Window -> Print Host Upload Queue")));
 	    } else {
 			m_print->set_status(100, _utf8(L("Slicing complete")));
 	    }
@@ -253,13 +268,9 @@ void BackgroundSlicingProcess::process_fff()
 
 static void write_thumbnail(Zipper& zipper, const ThumbnailData& data)
 {
-    size_t png_size = 0;
-    void* png_data = tdefl_write_image_to_png_file_in_memory_ex((const void*)data.pixels.data(), data.width, data.height, 4, &png_size, MZ_DEFAULT_LEVEL, 1);
-    if (png_data != nullptr)
-    {
-        zipper.add_entry("thumbnail/thumbnail" + std::to_string(data.width) + "x" + std::to_string(data.height) + ".png", (const std::uint8_t*)png_data, png_size);
-        mz_free(png_data);
-    }
+    std::vector<uint8_t> png_data;
+    if (png::encode_png(data.pixels.data(), data.width, data.height, 4, png_data, true))
+        zipper.add_entry("thumbnail/thumbnail" + std::to_string(data.width) + "x" + std::to_string(data.height) + ".png", png_data.data(), png_data.size());
 }
 
 void BackgroundSlicingProcess::process_sla()
@@ -933,6 +944,30 @@ void BackgroundSlicingProcess::prepare_upload()
 
 	GUI::wxGetApp().printhost_job_queue().enqueue(std::move(m_upload_job));
 }
+
+// A print host upload job has been scheduled and the G-code is about to be exported: if the upload does not need the final
+// G-code file, enqueue it to the printhost job queue right away and let it read the G-code from a stream while it is being exported.
+// Returns the stream to be passed to the G-code export, or null if the upload has to wait for the export to finish.
+std::shared_ptr<GCodeStream> BackgroundSlicingProcess::start_streamed_upload()
+{
+	if (m_upload_job.empty() || ! m_export_path.empty() || m_upload_job.upload_data.use_3mf || ! m_upload_job.printhost->supports_streaming())
+		return nullptr;
+	// The post-processing scripts of the BBL printers run on the finished G-code, see process_fff().
+	if (m_fff_print->is_BBL_printer() || ! GCodeStream::can_stream(m_fff_print->config()))
+		return nullptr;
+	// The file name must not depend on the print statistics, which are known only at the end of the export.
+	const std::string upload_stem = m_upload_job.upload_data.upload_path.stem().string();
+	if (upload_stem.find_first_of("{[") != std::string::npos)
+		return nullptr;
+
+	auto stream = std::make_shared<GCodeStream>();
+	m_upload_job.upload_data.stream = stream;
+	m_upload_job.upload_data.source_path.clear();
+	BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": uploading %1% to %2% while exporting G-code") % m_upload_job.upload_data.upload_path % m_upload_job.printhost->get_host();
+	GUI::wxGetApp().printhost_job_queue().enqueue(std::move(m_upload_job));
+	return stream;
+}
+
 // Executed by the background thread, to start a task on the UI thread.
 ThumbnailsList BackgroundSlicingProcess::render_thumbnails(const ThumbnailsParams &params)
 {
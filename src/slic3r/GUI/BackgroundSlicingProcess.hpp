@@ -289,6 +289,7 @@ private:
 	void				finalize_gcode();
 	void				export_gcode();
     void                prepare_upload();
+    std::shared_ptr<GCodeStream> start_streamed_upload();
     // To be executed at the background thread.
 	ThumbnailsList		render_thumbnails(const ThumbnailsParams &params);
 	// Execute task from background thread on the UI thread synchronously. Returns true if processed, false if cancelled before executing the task.
@@ -9,6 +9,8 @@
 #include "libslic3r/Utils.hpp"
 #include "libslic3r/LocalesUtils.hpp"
 #include "libslic3r/PresetBundle.hpp"
+#include "libslic3r/PrintBase.hpp"
+#include "libslic3r/GCode/GCodeLayerWindow.hpp"
 //BBS: add convex hull logic for toolpath check
 #include "libslic3r/Geometry/ConvexHull.hpp"
 
@@ -25,6 +27,9 @@
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
 #include "Widgets/ProgressDialog.hpp"
+#include "Jobs/BoostThreadWorker.hpp"
+#include "Jobs/NotificationProgressIndicator.hpp"
+#include "Jobs/PlaterWorker.hpp"
 
 #include <imgui/imgui_internal.h>
 
@@ -39,6 +44,7 @@
 #include <array>
 #include <algorithm>
 #include <chrono>
+#include <limits>
 
 namespace Slic3r {
 namespace GUI {
@@ -91,6 +97,14 @@ static EMoveType buffer_type(unsigned char id) {
     return static_cast<EMoveType>(static_cast<unsigned char>(EMoveType::Retract) + id);
 }
 
+//BBS: lazy loading of large G-code files, number of moves above which only the selected layers get their geometry built.
+// The geometry of the next window of layers is built on a worker thread. GCodeProcessor still keeps all the moves of the file
+// (about 100 bytes per move, a fraction of the geometry of a move), as the time estimates, the post-processing and every
+// other window of layers need them, and the first pass of load_toolpaths() still visits all of them to build the layer index.
+static const size_t LAZY_LOAD_MOVES_THRESHOLD = 2000000;
+//BBS: max number of moves whose geometry is built at once when lazy loading
+static const size_t LAZY_LOAD_MOVES_BUDGET = 1000000;
+
 // Round to a bin with minimum two digits resolution.
 // Equivalent to conversion to string with sprintf(buf, "%.2g", value) and conversion back to float, but faster.
 static float round_to_bin(const float value)
@@ -481,8 +495,8 @@ void GCodeViewer::SequentialView::Marker::render(int canvas_width, int canvas_he
 
 void GCodeViewer::SequentialView::GCodeWindow::load_gcode(const std::string& filename, const std::vector<size_t> &lines_ends)
 {
-    assert(! m_file.is_open());
-    if (m_file.is_open())
+    assert(! m_file.is_open() && ! m_binary_file);
+    if (m_file.is_open() || m_binary_file)
         return;
 
     m_filename   = filename;
@@ -493,8 +507,13 @@ void GCodeViewer::SequentialView::GCodeWindow::load_gcode(const std::string& fil
 
     try
     {
-        m_file.open(boost::filesystem::path(m_filename));
-        BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << ": mapping file " << m_filename;
+        if (BinaryGCode::is_binary_gcode(m_filename)) {
+            m_binary_file = std::make_unique<BinaryGCode::Reader>(m_filename);
+            BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << ": opened binary file " << m_filename;
+        } else {
+            m_file.open(boost::filesystem::path(m_filename));
+            BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << ": mapping file " << m_filename;
+        }
     }
     catch (...)
     {
@@ -516,7 +535,7 @@ void GCodeViewer::SequentialView::GCodeWindow::render(float top, float bottom, f
             const size_t start        = id == 1 ? 0 : m_lines_ends[id - 2];
             const size_t original_len = m_lines_ends[id - 1] - start;
             const size_t len          = std::min(original_len, (size_t) 55);
-            std::string  gline(m_file.data() + start, len);
+            std::string  gline = read_gcode(start, len);
 
             // If original line is longer than 55 characters, truncate and append "..."
             if (original_len > 55)
@@ -673,6 +692,30 @@ void GCodeViewer::SequentialView::GCodeWindow::stop_mapping_file()
         m_file.close();
         BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << ": finished mapping file " << m_filename;
     }
+    if (m_binary_file) {
+        m_binary_file.reset();
+        m_binary_block_id = size_t(-1);
+        m_binary_block.clear();
+        m_binary_block.shrink_to_fit();
+        BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << ": closed binary file " << m_filename;
+    }
+}
+
+std::string GCodeViewer::SequentialView::GCodeWindow::read_gcode(size_t start, size_t len) const
+{
+    if (! m_binary_file)
+        return std::string(m_file.data() + start, len);
+
+    // G-code blocks end with a new line, thus a line is decoded from a single block.
+    const size_t block_id = m_binary_file->gcode_block_at(start);
+    if (block_id != m_binary_block_id) {
+        m_binary_block    = m_binary_file->read_gcode_block(block_id);
+        m_binary_block_id = block_id;
+    }
+    const size_t offset = start - m_binary_file->gcode_block_offset(block_id);
+    if (offset + len <= m_binary_block.size())
+        return m_binary_block.substr(offset, len);
+    return m_binary_file->read_gcode(start, start + len);
 }
 void GCodeViewer::SequentialView::render(const bool has_render_path, float legend_height, int canvas_width, int canvas_height, int right_margin, const EViewType& view_type)
 {
@@ -1205,6 +1248,9 @@ void GCodeViewer::reset()
     //BBS: add only gcode mode
     m_only_gcode_in_preview = false;
 
+    //BBS: lazy loading, drop the geometry being built for the previous G-code
+    stop_reload_toolpaths_geometry();
+
     m_moves_count = 0;
     m_ssid_to_moveid_map.clear();
     m_ssid_to_moveid_map.shrink_to_fit();
@@ -1225,6 +1271,9 @@ void GCodeViewer::reset()
     //m_shells.volumes.clear();
     m_layers.reset();
     m_layers_z_range = { 0, 0 };
+    m_lazy_load = false;
+    m_loaded_layers_z_range = { 0, 0 };
+    m_loading_layers_z_range = { 0, 0 };
     m_roles = std::vector<ExtrusionRole>();
     m_print_statistics.reset();
     m_custom_gcode_per_print_z = std::vector<CustomGCode::Item>();
@@ -1243,6 +1292,14 @@ void GCodeViewer::render(int canvas_width, int canvas_height, int right_margin)
     m_statistics.total_instances_gpu_size = 0;
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
 
+    //BBS: lazy loading, send the geometry built on the worker thread to the gpu
+    if (m_built_geometry != nullptr) {
+        std::shared_ptr<ToolpathsGeometry> geometry = std::move(m_built_geometry);
+        upload_toolpaths_geometry(*geometry);
+        refresh_render_paths(false, false);
+        update_moves_slider(true);
+    }
+
     glsafe(::glEnable(GL_DEPTH_TEST));
     render_shells();
 
@@ -1853,10 +1910,77 @@ void GCodeViewer::set_layers_z_range(const std::array<unsigned int, 2>& layers_z
     bool keep_sequential_current_first = layers_z_range[0] >= m_layers_z_range[0];
     bool keep_sequential_current_last = layers_z_range[1] <= m_layers_z_range[1];
     m_layers_z_range = layers_z_range;
+    //BBS: lazy loading, rebuild the toolpaths when the selected layers are not all loaded, nor being loaded,
+    // meanwhile the selected layers already loaded are shown
+    if (m_lazy_load && !GCodeLayerWindow::contains(m_loading_layers_z_range, layers_z_range))
+        reload_toolpaths_geometry(layers_z_range);
     refresh_render_paths(keep_sequential_current_first, keep_sequential_current_last);
     update_moves_slider(true);
 }
 
+//BBS: lazy loading, the geometry of the window of layers around the selected ones is built on a worker thread,
+// render() sends it to the gpu once built
+void GCodeViewer::reload_toolpaths_geometry(const std::array<unsigned int, 2>& layers_z_range)
+{
+    if (m_gcode_result == nullptr)
+        return;
+
+    m_loading_layers_z_range = GCodeLayerWindow::grow_range(m_layers.get_endpoints(), layers_z_range, LAZY_LOAD_MOVES_BUDGET);
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": loading layers %1%-%2%") % m_loading_layers_z_range[0] % m_loading_layers_z_range[1];
+
+    if (!m_geometry_worker)
+        m_geometry_worker = std::make_unique<PlaterWorker<BoostThreadWorker>>(wxGetApp().plater(),
+            std::make_shared<NotificationProgressIndicator>(wxGetApp().plater()->get_notification_manager()), "gcode_geometry_worker");
+
+    // The windows requested before are canceled.
+    const size_t                                timestamp   = ++m_geometry_timestamp;
+    std::shared_ptr<ToolpathsGeometry>          geometry    = create_toolpaths_geometry(m_loading_layers_z_range);
+    auto                                        ssid_map    = std::make_shared<std::vector<size_t>>(m_ssid_to_moveid_map);
+    const GCodeProcessorResult*                 result      = m_gcode_result;
+    const unsigned int                          result_id   = m_last_result_id;
+    const size_t                                moves_count = m_moves_count;
+    const std::string                           label       = _u8L("Loading G-codes");
+    replace_job(*m_geometry_worker,
+        [geometry, ssid_map, result, result_id, moves_count, label](Job::Ctl& ctl) {
+            ctl.update_status(0, label);
+            //BBS: add mutex for protection of gcode result
+            std::lock_guard<std::mutex> lock(result->result_mutex);
+            // The result may have been replaced by the next slicing while the job was waiting.
+            if (result->id != result_id || result->moves.size() != moves_count)
+                throw CanceledException();
+            if (!build_toolpaths_geometry(*result, moves_count, *ssid_map, *geometry, {}, [&ctl]() { return ctl.was_canceled(); }))
+                throw CanceledException();
+            ctl.update_status(100, label);
+        },
+        [this, timestamp, geometry](bool canceled, std::exception_ptr& eptr) {
+            if (eptr) try {
+                std::rethrow_exception(eptr);
+            } catch (const CanceledException&) {
+                canceled = true;
+                eptr     = nullptr;
+            } catch (...) {}
+            if (timestamp != m_geometry_timestamp)
+                return;
+            if (canceled || eptr) {
+                m_loading_layers_z_range = m_loaded_layers_z_range;
+                return;
+            }
+            m_built_geometry = geometry;
+            wxGetApp().plater()->get_current_canvas3D()->set_as_dirty();
+            wxGetApp().plater()->get_current_canvas3D()->request_extra_frame();
+        });
+}
+
+void GCodeViewer::stop_reload_toolpaths_geometry()
+{
+    // The geometry built, but not yet sent to the gpu, is dropped as well.
+    ++m_geometry_timestamp;
+    m_built_geometry.reset();
+    // Not waiting for the worker, it may wait for the G-code result locked by the caller.
+    if (m_geometry_worker)
+        m_geometry_worker->cancel_all();
+}
+
 void GCodeViewer::export_toolpaths_to_obj(const char* filename) const
 {
     if (filename == nullptr)
@@ -2009,27 +2133,250 @@ void GCodeViewer::export_toolpaths_to_obj(const char* filename) const
 
 void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const BuildVolume& build_volume, const std::vector<BoundingBoxf3>& exclude_bounding_box)
 {
-    // max index buffer size, in bytes
-    static const size_t IBUFFER_THRESHOLD_BYTES = 64 * 1024 * 1024;
+    m_moves_count = gcode_result.moves.size();
+    if (m_moves_count == 0)
+        return;
 
-    //BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format(",build_volume center{%1%, %2%}, moves count %3%\n")%build_volume.bed_center().x() % build_volume.bed_center().y() %gcode_result.moves.size();
-    auto log_memory_usage = [this](const std::string& label, const std::vector<MultiVertexBuffer>& vertices, const std::vector<MultiIndexBuffer>& indices) {
-        int64_t vertices_size = 0;
-        for (const MultiVertexBuffer& buffers : vertices) {
-            for (const VertexBuffer& buffer : buffers) {
-                vertices_size += SLIC3R_STDVEC_MEMSIZE(buffer, float);
+    m_extruders_count = gcode_result.extruders_count;
+
+    wxBusyCursor busy;
+
+    //BBS: use convex_hull for toolpath outside check
+    Points pts;
+
+    // extract approximate paths bounding box from result
+    //BBS: add only gcode mode
+    for (const GCodeProcessorResult::MoveVertex& move : gcode_result.moves) {
+        //if (wxGetApp().is_gcode_viewer()) {
+        //if (m_only_gcode_in_preview) {
+            // for the gcode viewer we need to take in account all moves to correctly size the printbed
+        //    m_paths_bounding_box.merge(move.position.cast<double>());
+        //}
+        //else {
+            if (move.type == EMoveType::Extrude && move.extrusion_role != erCustom && move.width != 0.0f && move.height != 0.0f) {
+                m_paths_bounding_box.merge(move.position.cast<double>());
+                //BBS: use convex_hull for toolpath outside check
+                pts.emplace_back(Point(scale_(move.position.x()), scale_(move.position.y())));
             }
-            //BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format("vertices count %1%\n")%buffers.size();
-        }
-        int64_t indices_size = 0;
-        for (const MultiIndexBuffer& buffers : indices) {
-            for (const IndexBuffer& buffer : buffers) {
-                indices_size += SLIC3R_STDVEC_MEMSIZE(buffer, IBufferType);
+        //}
+    }
+
+    // BBS: also merge the point on arc to bounding box
+    for (const GCodeProcessorResult::MoveVertex& move : gcode_result.moves) {
+        // continue if not arc path
+        if (!move.is_arc_move_with_interpolation_points())
+            continue;
+
+        //if (wxGetApp().is_gcode_viewer())
+        //if (m_only_gcode_in_preview)
+        //    for (int i = 0; i < move.interpolation_points.size(); i++)
+        //        m_paths_bounding_box.merge(move.interpolation_points[i].cast<double>());
+        //else {
+            if (move.type == EMoveType::Extrude && move.width != 0.0f && move.height != 0.0f)
+                for (int i = 0; i < move.interpolation_points.size(); i++) {
+                    m_paths_bounding_box.merge(move.interpolation_points[i].cast<double>());
+                    //BBS: use convex_hull for toolpath outside check
+                    pts.emplace_back(Point(scale_(move.interpolation_points[i].x()), scale_(move.interpolation_points[i].y())));
+                }
+        //}
+    }
+
+    // set approximate max bounding box (take in account also the tool marker)
+    m_max_bounding_box = m_paths_bounding_box;
+    m_max_bounding_box.merge(m_paths_bounding_box.max + m_sequential_view.marker.get_bounding_box().size().z() * Vec3d::UnitZ());
+
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format(",m_paths_bounding_box {%1%, %2%}-{%3%, %4%}\n")
+        %m_paths_bounding_box.min.x() %m_paths_bounding_box.min.y() %m_paths_bounding_box.max.x() %m_paths_bounding_box.max.y();
+
+    //if (wxGetApp().is_editor())
+    {
+        //BBS: use convex_hull for toolpath outside check
+        m_contained_in_bed = build_volume.all_paths_inside(gcode_result, m_paths_bounding_box);
+        if (m_contained_in_bed) {
+            //PartPlateList& partplate_list = wxGetApp().plater()->get_partplate_list();
+            //PartPlate* plate = partplate_list.get_curr_plate();
+            //const std::vector<BoundingBoxf3>& exclude_bounding_box = plate->get_exclude_areas();
+            if (exclude_bounding_box.size() > 0)
+            {
+                int index;
+                Slic3r::Polygon convex_hull_2d = Slic3r::Geometry::convex_hull(std::move(pts));
+                for (index = 0; index < exclude_bounding_box.size(); index ++)
+                {
+                    Slic3r::Polygon p = exclude_bounding_box[index].polygon(true);  // instance convex hull is scaled, so we need to scale here
+                    if (intersection({ p }, { convex_hull_2d }).empty() == false)
+                    {
+                        m_contained_in_bed = false;
+                        break;
+                    }
+                }
             }
-            //BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format("indices count %1%\n")%buffers.size();
         }
-        log_memory_used(label, vertices_size + indices_size);
+        (const_cast<GCodeProcessorResult&>(gcode_result)).toolpath_outside = !m_contained_in_bed;
+    }
+
+    m_sequential_view.gcode_ids.clear();
+    for (size_t i = 0; i < gcode_result.moves.size(); ++i) {
+        const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
+        if (move.type != EMoveType::Seam)
+            m_sequential_view.gcode_ids.push_back(move.gcode_id);
+    }
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format(",m_contained_in_bed %1%\n")%m_contained_in_bed;
+
+    // layers zs / roles / extruder ids -> extract from result
+    size_t last_travel_s_id = 0;
+    size_t seams_count = 0;
+    for (size_t i = 0; i < m_moves_count; ++i) {
+        const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
+        if (move.type == EMoveType::Seam)
+            ++seams_count;
+
+        size_t move_id = i - seams_count;
+
+        if (move.type == EMoveType::Extrude) {
+            // layers zs
+            const double* const last_z = m_layers.empty() ? nullptr : &m_layers.get_zs().back();
+            const double z = static_cast<double>(move.position.z());
+            if (last_z == nullptr || z < *last_z - EPSILON || *last_z + EPSILON < z)
+                m_layers.append(z, { last_travel_s_id, move_id });
+            else
+                m_layers.get_endpoints().back().last = move_id;
+            // extruder ids
+            m_extruder_ids.emplace_back(move.extruder_id);
+            // roles
+            if (i > 0)
+                m_roles.emplace_back(move.extrusion_role);
+        }
+        else if (move.type == EMoveType::Travel) {
+            if (move_id - last_travel_s_id > 1 && !m_layers.empty())
+                m_layers.get_endpoints().back().last = move_id;
+
+            last_travel_s_id = move_id;
+        }
+    }
+
+    // roles -> remove duplicates
+    sort_remove_duplicates(m_roles);
+    m_roles.shrink_to_fit();
+
+    // extruder ids -> remove duplicates
+    sort_remove_duplicates(m_extruder_ids);
+    m_extruder_ids.shrink_to_fit();
+
+    std::vector<int> plater_extruder;
+	for (auto mid : m_extruder_ids){
+        int eid = mid;
+        plater_extruder.push_back(++eid);
+	}
+    m_plater_extruder = plater_extruder;
+
+    // replace layers for spiral vase mode
+    if (!gcode_result.spiral_vase_layers.empty()) {
+        m_layers.reset();
+        for (const auto& layer : gcode_result.spiral_vase_layers) {
+            m_layers.append(layer.first, { layer.second.first, layer.second.second });
+        }
+    }
+
+    //BBS: generate map from ssid to move id in advance to reduce computation
+    std::vector<size_t> biased_seams_ids;
+    for (size_t i = 0; i < m_moves_count; ++i) {
+        if (gcode_result.moves[i].type == EMoveType::Seam)
+            biased_seams_ids.push_back(i - biased_seams_ids.size() - 1);
+    }
+    auto extract_move_id = [&biased_seams_ids](size_t id) {
+        size_t new_id = size_t(-1);
+        auto it = std::lower_bound(biased_seams_ids.begin(), biased_seams_ids.end(), id);
+        if (it == biased_seams_ids.end())
+            new_id = id + biased_seams_ids.size();
+        else {
+            if (it == biased_seams_ids.begin() && *it < id)
+                new_id = id;
+            else if (it != biased_seams_ids.begin())
+                new_id = id + std::distance(biased_seams_ids.begin(), it);
+        }
+        return (new_id == size_t(-1)) ? id : new_id;
     };
+    m_ssid_to_moveid_map.clear();
+    m_ssid_to_moveid_map.reserve(m_moves_count - biased_seams_ids.size());
+    for (size_t i = 0; i < m_moves_count - biased_seams_ids.size(); i++)
+        m_ssid_to_moveid_map.push_back(extract_move_id(i));
+
+    // set layers z range
+    //BBS: lazy loading, when previewing a large G-code file only the layers selected in the slider and their neighbours
+    // get their geometry built, the preview opens on the bottom layers
+    m_lazy_load = m_only_gcode_in_preview && m_moves_count > LAZY_LOAD_MOVES_THRESHOLD && m_layers.size() > 1;
+    if (m_lazy_load) {
+        m_layers_z_range = GCodeLayerWindow::initial_range(m_layers.get_endpoints(), LAZY_LOAD_MOVES_BUDGET);
+        m_loaded_layers_z_range = GCodeLayerWindow::grow_range(m_layers.get_endpoints(), m_layers_z_range, LAZY_LOAD_MOVES_BUDGET);
+        BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": lazy loading %1% moves, layers %2%-%3% loaded") % m_moves_count % m_loaded_layers_z_range[0] % m_loaded_layers_z_range[1];
+    }
+    else if (!m_layers.empty())
+        m_layers_z_range = { 0, static_cast<unsigned int>(m_layers.size() - 1) };
+    m_loading_layers_z_range = m_loaded_layers_z_range;
+
+    load_toolpaths_geometry(gcode_result, m_only_gcode_in_preview);
+}
+
+void GCodeViewer::load_toolpaths_geometry(const GCodeProcessorResult& gcode_result, bool show_progress)
+{
+#if ENABLE_GCODE_VIEWER_STATISTICS
+    auto start_time = std::chrono::high_resolution_clock::now();
+    m_statistics.results_size = SLIC3R_STDVEC_MEMSIZE(gcode_result.moves, GCodeProcessorResult::MoveVertex);
+    m_statistics.results_time = gcode_result.time;
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+
+    //BBS: add only gcode mode
+    ProgressDialog *          progress_dialog    = show_progress ?
+        new ProgressDialog(_L("Loading G-codes"), "...",
+            100, wxGetApp().mainframe, wxPD_AUTO_HIDE | wxPD_APP_MODAL) : nullptr;
+
+    wxBusyCursor busy;
+
+    std::unique_ptr<ToolpathsGeometry> geometry = create_toolpaths_geometry(m_loaded_layers_z_range);
+    std::function<void(int, const wxString&)> progress;
+    if (progress_dialog != nullptr)
+        progress = [progress_dialog](int percent, const wxString& label) {
+            progress_dialog->Update(percent, label);
+            progress_dialog->Fit();
+        };
+    build_toolpaths_geometry(gcode_result, m_moves_count, m_ssid_to_moveid_map, *geometry, progress, []() { return false; });
+    upload_toolpaths_geometry(*geometry);
+
+    if (progress_dialog != nullptr) {
+        progress_dialog->Update(100, "");
+        progress_dialog->Fit();
+    }
+
+#if ENABLE_GCODE_VIEWER_STATISTICS
+    m_statistics.load_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+
+    if (progress_dialog != nullptr)
+        progress_dialog->Destroy();
+}
+
+//BBS: lazy loading, the settings of the buffers are copied, so that the geometry is built without touching the viewer
+std::unique_ptr<GCodeViewer::ToolpathsGeometry> GCodeViewer::create_toolpaths_geometry(const std::array<unsigned int, 2>& layers_z_range) const
+{
+    auto geometry = std::make_unique<ToolpathsGeometry>();
+    geometry->layers_z_range = layers_z_range;
+    if (m_lazy_load)
+        geometry->moves = { m_layers.get_endpoints_at(layers_z_range[0]).first, m_layers.get_endpoints_at(layers_z_range[1]).last };
+    geometry->buffers.resize(m_buffers.size());
+    for (size_t i = 0; i < m_buffers.size(); ++i) {
+        TBuffer& buffer = geometry->buffers[i];
+        buffer.render_primitive_type = m_buffers[i].render_primitive_type;
+        buffer.vertices.format = m_buffers[i].vertices.format;
+        buffer.model.data = m_buffers[i].model.data;
+    }
+    return geometry;
+}
+
+bool GCodeViewer::build_toolpaths_geometry(const GCodeProcessorResult& gcode_result, size_t moves_count, const std::vector<size_t>& ssid_to_moveid_map,
+    ToolpathsGeometry& geometry, const std::function<void(int, const wxString&)>& progress, const std::function<bool()>& canceled)
+{
+    // max index buffer size, in bytes
+    static const size_t IBUFFER_THRESHOLD_BYTES = 64 * 1024 * 1024;
 
     // format data into the buffers to be rendered as lines
     auto add_vertices_as_line = [](const GCodeProcessorResult::MoveVertex& prev, const GCodeProcessorResult::MoveVertex& curr, VertexBuffer& vertices) {
@@ -2129,11 +2476,12 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
 
         last_path.sub_paths.back().last = { vbuffer_id, vertices.size(), move_id, curr.position };
     };
+    // direction of the previous segment, kept from a call to the next one
+    Vec3f prev_dir = Vec3f::Zero();
+    Vec3f prev_up = Vec3f::Zero();
+    float sq_prev_length = 0.0f;
     auto add_indices_as_solid = [&](const GCodeProcessorResult::MoveVertex& prev, const GCodeProcessorResult::MoveVertex& curr, const GCodeProcessorResult::MoveVertex* next,
         TBuffer& buffer, size_t& vbuffer_size, unsigned int ibuffer_id, IndexBuffer& indices, size_t move_id) {
-            static Vec3f prev_dir;
-            static Vec3f prev_up;
-            static float sq_prev_length;
             auto store_triangle = [](IndexBuffer& indices, IBufferType i1, IBufferType i2, IBufferType i3) {
                 indices.push_back(i1);
                 indices.push_back(i2);
@@ -2323,125 +2671,36 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
         }
     };
 
-#if ENABLE_GCODE_VIEWER_STATISTICS
-    auto start_time = std::chrono::high_resolution_clock::now();
-    m_statistics.results_size = SLIC3R_STDVEC_MEMSIZE(gcode_result.moves, GCodeProcessorResult::MoveVertex);
-    m_statistics.results_time = gcode_result.time;
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
-
-    m_moves_count = gcode_result.moves.size();
-    if (m_moves_count == 0)
-        return;
-
-    m_extruders_count = gcode_result.extruders_count;
-
-    unsigned int progress_count = 0;
-    static const unsigned int progress_threshold = 1000;
-    //BBS: add only gcode mode
-    ProgressDialog *          progress_dialog    = m_only_gcode_in_preview ?
-        new ProgressDialog(_L("Loading G-codes"), "...",
-            100, wxGetApp().mainframe, wxPD_AUTO_HIDE | wxPD_APP_MODAL) : nullptr;
-
-    wxBusyCursor busy;
-
-    //BBS: use convex_hull for toolpath outside check
-    Points pts;
-
-    // extract approximate paths bounding box from result
-    //BBS: add only gcode mode
-    for (const GCodeProcessorResult::MoveVertex& move : gcode_result.moves) {
-        //if (wxGetApp().is_gcode_viewer()) {
-        //if (m_only_gcode_in_preview) {
-            // for the gcode viewer we need to take in account all moves to correctly size the printbed
-        //    m_paths_bounding_box.merge(move.position.cast<double>());
-        //}
-        //else {
-            if (move.type == EMoveType::Extrude && move.extrusion_role != erCustom && move.width != 0.0f && move.height != 0.0f) {
-                m_paths_bounding_box.merge(move.position.cast<double>());
-                //BBS: use convex_hull for toolpath outside check
-                pts.emplace_back(Point(scale_(move.position.x()), scale_(move.position.y())));
-            }
-        //}
-    }
-
-    // BBS: also merge the point on arc to bounding box
-    for (const GCodeProcessorResult::MoveVertex& move : gcode_result.moves) {
-        // continue if not arc path
-        if (!move.is_arc_move_with_interpolation_points())
-            continue;
-
-        //if (wxGetApp().is_gcode_viewer())
-        //if (m_only_gcode_in_preview)
-        //    for (int i = 0; i < move.interpolation_points.size(); i++)
-        //        m_paths_bounding_box.merge(move.interpolation_points[i].cast<double>());
-        //else {
-            if (move.type == EMoveType::Extrude && move.width != 0.0f && move.height != 0.0f)
-                for (int i = 0; i < move.interpolation_points.size(); i++) {
-                    m_paths_bounding_box.merge(move.interpolation_points[i].cast<double>());
-                    //BBS: use convex_hull for toolpath outside check
-                    pts.emplace_back(Point(scale_(move.interpolation_points[i].x()), scale_(move.interpolation_points[i].y())));
-                }
-        //}
-    }
-
-    // set approximate max bounding box (take in account also the tool marker)
-    m_max_bounding_box = m_paths_bounding_box;
-    m_max_bounding_box.merge(m_paths_bounding_box.max + m_sequential_view.marker.get_bounding_box().size().z() * Vec3d::UnitZ());
-
-    BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format(",m_paths_bounding_box {%1%, %2%}-{%3%, %4%}\n")
-        %m_paths_bounding_box.min.x() %m_paths_bounding_box.min.y() %m_paths_bounding_box.max.x() %m_paths_bounding_box.max.y();
-
-    //if (wxGetApp().is_editor())
-    {
-        //BBS: use convex_hull for toolpath outside check
-        m_contained_in_bed = build_volume.all_paths_inside(gcode_result, m_paths_bounding_box);
-        if (m_contained_in_bed) {
-            //PartPlateList& partplate_list = wxGetApp().plater()->get_partplate_list();
-            //PartPlate* plate = partplate_list.get_curr_plate();
-            //const std::vector<BoundingBoxf3>& exclude_bounding_box = plate->get_exclude_areas();
-            if (exclude_bounding_box.size() > 0)
-            {
-                int index;
-                Slic3r::Polygon convex_hull_2d = Slic3r::Geometry::convex_hull(std::move(pts));
-                for (index = 0; index < exclude_bounding_box.size(); index ++)
-                {
-                    Slic3r::Polygon p = exclude_bounding_box[index].polygon(true);  // instance convex hull is scaled, so we need to scale here
-                    if (intersection({ p }, { convex_hull_2d }).empty() == false)
-                    {
-                        m_contained_in_bed = false;
-                        break;
-                    }
-                }
-            }
-        }
-        (const_cast<GCodeProcessorResult&>(gcode_result)).toolpath_outside = !m_contained_in_bed;
-    }
-
-    m_sequential_view.gcode_ids.clear();
-    for (size_t i = 0; i < gcode_result.moves.size(); ++i) {
-        const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
-        if (move.type != EMoveType::Seam)
-            m_sequential_view.gcode_ids.push_back(move.gcode_id);
-    }
-    BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format(",m_contained_in_bed %1%\n")%m_contained_in_bed;
+#if ENABLE_GCODE_VIEWER_STATISTICS
+    auto start_time = std::chrono::high_resolution_clock::now();
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+
+    unsigned int progress_count = 0;
+    static const unsigned int progress_threshold = 1000;
 
-    std::vector<MultiVertexBuffer> vertices(m_buffers.size());
-    std::vector<MultiIndexBuffer> indices(m_buffers.size());
-    std::vector<InstanceBuffer> instances(m_buffers.size());
-    std::vector<InstanceIdBuffer> instances_ids(m_buffers.size());
-    std::vector<InstancesOffsets> instances_offsets(m_buffers.size());
+    //BBS: lazy loading, range of the moves whose geometry is built
+    const std::pair<size_t, size_t>& loaded_moves = geometry.moves;
+
+    std::vector<TBuffer>& buffers = geometry.buffers;
+    std::vector<MultiVertexBuffer>& vertices = geometry.vertices;
+    std::vector<MultiIndexBuffer>& indices = geometry.indices;
+    std::vector<InstanceBuffer>& instances = geometry.instances;
+    std::vector<InstanceIdBuffer>& instances_ids = geometry.instances_ids;
+    std::vector<InstancesOffsets>& instances_offsets = geometry.instances_offsets;
+    vertices.resize(buffers.size());
+    indices.resize(buffers.size());
+    instances.resize(buffers.size());
+    instances_ids.resize(buffers.size());
+    instances_offsets.resize(buffers.size());
     std::vector<float> options_zs;
 
     size_t seams_count = 0;
-    std::vector<size_t> biased_seams_ids;
 
     // toolpaths data -> extract vertices from result
-    for (size_t i = 0; i < m_moves_count; ++i) {
+    for (size_t i = 0; i < moves_count; ++i) {
         const GCodeProcessorResult::MoveVertex& curr = gcode_result.moves[i];
-        if (curr.type == EMoveType::Seam) {
+        if (curr.type == EMoveType::Seam)
             ++seams_count;
-            biased_seams_ids.push_back(i - biased_seams_ids.size() - 1);
-        }
 
         size_t move_id = i - seams_count;
 
@@ -2449,19 +2708,25 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
         if (i == 0)
             continue;
 
+        //BBS: lazy loading, skip the moves outside of the loaded layers
+        if (move_id < loaded_moves.first || loaded_moves.second < move_id)
+            continue;
+
         const GCodeProcessorResult::MoveVertex& prev = gcode_result.moves[i - 1];
 
         // update progress dialog
         ++progress_count;
-        if (progress_dialog != nullptr && progress_count % progress_threshold == 0) {
-            progress_dialog->Update(int(100.0f * float(i) / (2.0f * float(m_moves_count))),
-                _L("Generating geometry vertex data") + ": " + wxNumberFormatter::ToString(100.0 * double(i) / double(m_moves_count), 0, wxNumberFormatter::Style_None) + "%");
-            progress_dialog->Fit();
+        if (progress_count % progress_threshold == 0) {
+            if (canceled())
+                return false;
+            if (progress)
+                progress(int(100.0f * float(i) / (2.0f * float(moves_count))),
+                    _L("Generating geometry vertex data") + ": " + wxNumberFormatter::ToString(100.0 * double(i) / double(moves_count), 0, wxNumberFormatter::Style_None) + "%");
             progress_count = 0;
         }
 
         const unsigned char id = buffer_id(curr.type);
-        TBuffer& t_buffer = m_buffers[id];
+        TBuffer& t_buffer = buffers[id];
         MultiVertexBuffer& v_multibuffer = vertices[id];
         InstanceBuffer& inst_buffer = instances[id];
         InstanceIdBuffer& inst_id_buffer = instances_ids[id];
@@ -2500,18 +2765,12 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
         {
             add_model_instance(curr, inst_buffer, inst_id_buffer, move_id);
             inst_offsets.push_back(prev.position - curr.position);
-#if ENABLE_GCODE_VIEWER_STATISTICS
-            ++m_statistics.instances_count;
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
             break;
         }
         case TBuffer::ERenderPrimitiveType::BatchedModel:
         {
             add_vertices_as_model_batch(curr, t_buffer.model.data, v_buffer, inst_buffer, inst_id_buffer, move_id);
             inst_offsets.push_back(prev.position - curr.position);
-#if ENABLE_GCODE_VIEWER_STATISTICS
-            ++m_statistics.batched_count;
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
             break;
         }
         }
@@ -2529,27 +2788,9 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
         BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(":b=%1%, vertex buffer count %2%\n")
             %b %v_multibuffer.size();
     }*/
-    auto extract_move_id = [&biased_seams_ids](size_t id) {
-        size_t new_id = size_t(-1);
-        auto it = std::lower_bound(biased_seams_ids.begin(), biased_seams_ids.end(), id);
-        if (it == biased_seams_ids.end())
-            new_id = id + biased_seams_ids.size();
-        else {
-            if (it == biased_seams_ids.begin() && *it < id)
-                new_id = id;
-            else if (it != biased_seams_ids.begin())
-                new_id = id + std::distance(biased_seams_ids.begin(), it);
-        }
-        return (new_id == size_t(-1)) ? id : new_id;
-    };
-    //BBS: generate map from ssid to move id in advance to reduce computation
-    m_ssid_to_moveid_map.clear();
-    m_ssid_to_moveid_map.reserve( m_moves_count - biased_seams_ids.size());
-    for (size_t i = 0; i < m_moves_count - biased_seams_ids.size(); i++)
-        m_ssid_to_moveid_map.push_back(extract_move_id(i));
 
     //BBS: smooth toolpaths corners for the given TBuffer using triangles
-    auto smooth_triangle_toolpaths_corners = [&gcode_result, this](const TBuffer& t_buffer, MultiVertexBuffer& v_multibuffer) {
+    auto smooth_triangle_toolpaths_corners = [&gcode_result, &ssid_to_moveid_map](const TBuffer& t_buffer, MultiVertexBuffer& v_multibuffer) {
         auto extract_position_at = [](const VertexBuffer& vertices, size_t offset) {
             return Vec3f(vertices[offset + 0], vertices[offset + 1], vertices[offset + 2]);
         };
@@ -2565,11 +2806,11 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
                 // offset into the vertex buffer of the next segment 1st vertex
                 size_t temp_offset = prev_sub_path.last.s_id - curr_s_id;
                 for (size_t i = prev_sub_path.last.s_id; i > curr_s_id; i--) {
-                    size_t move_id = m_ssid_to_moveid_map[i];
+                    size_t move_id = ssid_to_moveid_map[i];
                     temp_offset += (gcode_result.moves[move_id].is_arc_move() ? gcode_result.moves[move_id].interpolation_points.size() : 0);
                 }
                 if (is_internal_point) {
-                    size_t move_id = m_ssid_to_moveid_map[curr_s_id];
+                    size_t move_id = ssid_to_moveid_map[curr_s_id];
                     temp_offset += (gcode_result.moves[move_id].interpolation_points.size() - interpolation_point_id);
                 }
                 const size_t next_1st_offset = temp_offset * 6 * vertex_size_floats;
@@ -2607,11 +2848,11 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
                 // offset into the vertex buffer of the next segment 1st vertex
                 size_t temp_offset = prev_sub_path.last.s_id - curr_s_id;
                 for (size_t i = prev_sub_path.last.s_id; i > curr_s_id; i--) {
-                    size_t move_id = m_ssid_to_moveid_map[i];
+                    size_t move_id = ssid_to_moveid_map[i];
                     temp_offset += (gcode_result.moves[move_id].is_arc_move() ? gcode_result.moves[move_id].interpolation_points.size() : 0);
                 }
                 if (is_internal_point) {
-                    size_t move_id = m_ssid_to_moveid_map[curr_s_id];
+                    size_t move_id = ssid_to_moveid_map[curr_s_id];
                     temp_offset += (gcode_result.moves[move_id].interpolation_points.size() - interpolation_point_id);
                 }
                 const size_t next_1st_offset = temp_offset * 6 * vertex_size_floats;
@@ -2653,7 +2894,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
             // BBS: modify a lot to support arc move which has internal points
             for (size_t j = 1; j < path_vertices_count; ++j) {
                 size_t curr_s_id = path.sub_paths.front().first.s_id + j;
-                size_t move_id = m_ssid_to_moveid_map[curr_s_id];
+                size_t move_id = ssid_to_moveid_map[curr_s_id];
                 int interpolation_points_num = gcode_result.moves[move_id].is_arc_move_with_interpolation_points()?
                                                     gcode_result.moves[move_id].interpolation_points.size() : 0;
                 int loop_num = interpolation_points_num;
@@ -2735,20 +2976,17 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
     auto load_vertices_time = std::chrono::high_resolution_clock::now();
-    m_statistics.load_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
+    geometry.load_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
 
     // smooth toolpaths corners for TBuffers using triangles
-    for (size_t i = 0; i < m_buffers.size(); ++i) {
-        const TBuffer& t_buffer = m_buffers[i];
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        const TBuffer& t_buffer = buffers[i];
         if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle) {
             smooth_triangle_toolpaths_corners(t_buffer, vertices[i]);
         }
     }
 
-    // dismiss, no more needed
-    std::vector<size_t>().swap(biased_seams_ids);
-
     for (MultiVertexBuffer& v_multibuffer : vertices) {
         for (VertexBuffer& v_buffer : v_multibuffer) {
             v_buffer.shrink_to_fit();
@@ -2763,80 +3001,29 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
         }
     }
 
-    // send vertices data to gpu, where needed
-    for (size_t i = 0; i < m_buffers.size(); ++i) {
-        TBuffer& t_buffer = m_buffers[i];
-        if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::InstancedModel) {
-            const InstanceBuffer& inst_buffer = instances[i];
-            if (!inst_buffer.empty()) {
-                t_buffer.model.instances.buffer = inst_buffer;
-                t_buffer.model.instances.s_ids = instances_ids[i];
-                t_buffer.model.instances.offsets = instances_offsets[i];
-            }
-        }
-        else {
-            if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) {
-                const InstanceBuffer& inst_buffer = instances[i];
-                if (!inst_buffer.empty()) {
-                    t_buffer.model.instances.buffer = inst_buffer;
-                    t_buffer.model.instances.s_ids = instances_ids[i];
-                    t_buffer.model.instances.offsets = instances_offsets[i];
-                }
-            }
-            const MultiVertexBuffer& v_multibuffer = vertices[i];
-            for (const VertexBuffer& v_buffer : v_multibuffer) {
-                const size_t size_elements = v_buffer.size();
-                const size_t size_bytes = size_elements * sizeof(float);
-                const size_t vertices_count = size_elements / t_buffer.vertices.vertex_size_floats();
-                t_buffer.vertices.count += vertices_count;
-
-#if ENABLE_GCODE_VIEWER_STATISTICS
-                m_statistics.total_vertices_gpu_size += static_cast<int64_t>(size_bytes);
-                m_statistics.max_vbuffer_gpu_size = std::max(m_statistics.max_vbuffer_gpu_size, static_cast<int64_t>(size_bytes));
-                ++m_statistics.vbuffers_count;
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
-
-                GLuint id = 0;
-                glsafe(::glGenBuffers(1, &id));
-                glsafe(::glBindBuffer(GL_ARRAY_BUFFER, id));
-                glsafe(::glBufferData(GL_ARRAY_BUFFER, size_bytes, v_buffer.data(), GL_STATIC_DRAW));
-                glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
-
-                t_buffer.vertices.vbos.push_back(static_cast<unsigned int>(id));
-                t_buffer.vertices.sizes.push_back(size_bytes);
-            }
-        }
-    }
-
 #if ENABLE_GCODE_VIEWER_STATISTICS
     auto smooth_vertices_time = std::chrono::high_resolution_clock::now();
-    m_statistics.smooth_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - load_vertices_time).count();
+    geometry.smooth_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - load_vertices_time).count();
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
-    log_memory_usage("Loaded G-code generated vertex buffers ", vertices, indices);
-
-    // dismiss vertices data, no more needed
-    std::vector<MultiVertexBuffer>().swap(vertices);
-    std::vector<InstanceBuffer>().swap(instances);
-    std::vector<InstanceIdBuffer>().swap(instances_ids);
 
     // toolpaths data -> extract indices from result
     // paths may have been filled while extracting vertices,
     // so reset them, they will be filled again while extracting indices
-    for (TBuffer& buffer : m_buffers) {
+    for (TBuffer& buffer : buffers) {
         buffer.paths.clear();
     }
 
     // variable used to keep track of the current vertex buffers index and size
     using CurrVertexBuffer = std::pair<unsigned int, size_t>;
-    std::vector<CurrVertexBuffer> curr_vertex_buffers(m_buffers.size(), { 0, 0 });
+    std::vector<CurrVertexBuffer> curr_vertex_buffers(buffers.size(), { 0, 0 });
 
-    // variable used to keep track of the vertex buffers ids
-    using VboIndexList = std::vector<unsigned int>;
-    std::vector<VboIndexList> vbo_indices(m_buffers.size());
+    // variable used to keep track of the vertex buffers ids, as indices into vertices, the vbos are not created yet
+    std::vector<std::vector<unsigned int>>& vbo_indices = geometry.vbo_indices;
+    vbo_indices.resize(buffers.size());
 
     seams_count = 0;
 
-    for (size_t i = 0; i < m_moves_count; ++i) {
+    for (size_t i = 0; i < moves_count; ++i) {
         const GCodeProcessorResult::MoveVertex& curr = gcode_result.moves[i];
         if (curr.type == EMoveType::Seam)
             ++seams_count;
@@ -2847,30 +3034,37 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
         if (i == 0)
             continue;
 
+        //BBS: lazy loading, the same moves skipped while extracting vertices
+        if (move_id < loaded_moves.first || loaded_moves.second < move_id)
+            continue;
+
         const GCodeProcessorResult::MoveVertex& prev = gcode_result.moves[i - 1];
         const GCodeProcessorResult::MoveVertex* next = nullptr;
-        if (i < m_moves_count - 1)
+        if (i < moves_count - 1)
             next = &gcode_result.moves[i + 1];
 
         ++progress_count;
-        if (progress_dialog != nullptr && progress_count % progress_threshold == 0) {
-            progress_dialog->Update(int(100.0f * float(m_moves_count + i) / (2.0f * float(m_moves_count))),
-                _L("Generating geometry index data") + ": " + wxNumberFormatter::ToString(100.0 * double(i) / double(m_moves_count), 0, wxNumberFormatter::Style_None) + "%");
-            progress_dialog->Fit();
+        if (progress_count % progress_threshold == 0) {
+            if (canceled())
+                return false;
+            if (progress)
+                progress(int(100.0f * float(moves_count + i) / (2.0f * float(moves_count))),
+                    _L("Generating geometry index data") + ": " + wxNumberFormatter::ToString(100.0 * double(i) / double(moves_count), 0, wxNumberFormatter::Style_None) + "%");
             progress_count = 0;
         }
 
         const unsigned char id = buffer_id(curr.type);
-        TBuffer& t_buffer = m_buffers[id];
+        TBuffer& t_buffer = buffers[id];
         MultiIndexBuffer& i_multibuffer = indices[id];
         CurrVertexBuffer& curr_vertex_buffer = curr_vertex_buffers[id];
-        VboIndexList& vbo_index_list = vbo_indices[id];
+        std::vector<unsigned int>& vbo_index_list = vbo_indices[id];
 
         // ensure there is at least one index buffer
         if (i_multibuffer.empty()) {
             i_multibuffer.push_back(IndexBuffer());
-            if (!t_buffer.vertices.vbos.empty())
-                vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
+            // no vbos are created for the instanced models
+            if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::InstancedModel && !vertices[id].empty())
+                vbo_index_list.push_back(curr_vertex_buffer.first);
         }
 
         // if adding the indices for the current segment exceeds the threshold size of the current index buffer
@@ -2880,7 +3074,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
         size_t indiced_size_to_add = (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) ? t_buffer.model.data.indices_size_bytes() : points_num * t_buffer.max_indices_per_segment_size_bytes();
         if (i_multibuffer.back().size() * sizeof(IBufferType) >= IBUFFER_THRESHOLD_BYTES - indiced_size_to_add) {
             i_multibuffer.push_back(IndexBuffer());
-            vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
+            vbo_index_list.push_back(curr_vertex_buffer.first);
             if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::BatchedModel) {
                 Path& last_path = t_buffer.paths.back();
                 last_path.add_sub_path(prev, static_cast<unsigned int>(i_multibuffer.size()) - 1, 0, move_id - 1);
@@ -2896,7 +3090,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
 
             ++curr_vertex_buffer.first;
             curr_vertex_buffer.second = 0;
-            vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
+            vbo_index_list.push_back(curr_vertex_buffer.first);
 
             if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::BatchedModel) {
                 Path& last_path = t_buffer.paths.back();
@@ -2931,6 +3125,106 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
         }
     }
 
+    // change color of paths whose layer contains option points
+    if (!options_zs.empty()) {
+        TBuffer& extrude_buffer = buffers[buffer_id(EMoveType::Extrude)];
+        for (Path& path : extrude_buffer.paths) {
+            const float z = path.sub_paths.front().first.position.z();
+            if (std::find_if(options_zs.begin(), options_zs.end(), [z](float f) { return f - EPSILON <= z && z <= f + EPSILON; }) != options_zs.end())
+                path.cp_color_id = 255 - path.cp_color_id;
+        }
+    }
+
+#if ENABLE_GCODE_VIEWER_STATISTICS
+    geometry.load_indices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - smooth_vertices_time).count();
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+
+    return true;
+}
+
+void GCodeViewer::upload_toolpaths_geometry(ToolpathsGeometry& geometry)
+{
+    auto log_memory_usage = [this](const std::string& label, const std::vector<MultiVertexBuffer>& vertices, const std::vector<MultiIndexBuffer>& indices) {
+        int64_t vertices_size = 0;
+        for (const MultiVertexBuffer& buffers : vertices) {
+            for (const VertexBuffer& buffer : buffers) {
+                vertices_size += SLIC3R_STDVEC_MEMSIZE(buffer, float);
+            }
+            //BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format("vertices count %1%\n")%buffers.size();
+        }
+        int64_t indices_size = 0;
+        for (const MultiIndexBuffer& buffers : indices) {
+            for (const IndexBuffer& buffer : buffers) {
+                indices_size += SLIC3R_STDVEC_MEMSIZE(buffer, IBufferType);
+            }
+            //BOOST_LOG_TRIVIAL(info) << __FUNCTION__<< boost::format("indices count %1%\n")%buffers.size();
+        }
+        log_memory_used(label, vertices_size + indices_size);
+    };
+
+    std::vector<MultiVertexBuffer>& vertices = geometry.vertices;
+    std::vector<MultiIndexBuffer>& indices = geometry.indices;
+    log_memory_usage("Loaded G-code generated vertex and index buffers ", vertices, indices);
+
+    // send vertices data to gpu, where needed
+    for (size_t i = 0; i < m_buffers.size(); ++i) {
+        TBuffer& t_buffer = m_buffers[i];
+        // release the previous window of layers, if any
+        t_buffer.reset();
+        t_buffer.paths = std::move(geometry.buffers[i].paths);
+        if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::InstancedModel) {
+            const InstanceBuffer& inst_buffer = geometry.instances[i];
+            if (!inst_buffer.empty()) {
+                t_buffer.model.instances.buffer = inst_buffer;
+                t_buffer.model.instances.s_ids = geometry.instances_ids[i];
+                t_buffer.model.instances.offsets = geometry.instances_offsets[i];
+            }
+#if ENABLE_GCODE_VIEWER_STATISTICS
+            m_statistics.instances_count += static_cast<int64_t>(geometry.instances_ids[i].size());
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+        }
+        else {
+            if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) {
+                const InstanceBuffer& inst_buffer = geometry.instances[i];
+                if (!inst_buffer.empty()) {
+                    t_buffer.model.instances.buffer = inst_buffer;
+                    t_buffer.model.instances.s_ids = geometry.instances_ids[i];
+                    t_buffer.model.instances.offsets = geometry.instances_offsets[i];
+                }
+#if ENABLE_GCODE_VIEWER_STATISTICS
+                m_statistics.batched_count += static_cast<int64_t>(geometry.instances_ids[i].size());
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+            }
+            const MultiVertexBuffer& v_multibuffer = vertices[i];
+            for (const VertexBuffer& v_buffer : v_multibuffer) {
+                const size_t size_elements = v_buffer.size();
+                const size_t size_bytes = size_elements * sizeof(float);
+                const size_t vertices_count = size_elements / t_buffer.vertices.vertex_size_floats();
+                t_buffer.vertices.count += vertices_count;
+
+#if ENABLE_GCODE_VIEWER_STATISTICS
+                m_statistics.total_vertices_gpu_size += static_cast<int64_t>(size_bytes);
+                m_statistics.max_vbuffer_gpu_size = std::max(m_statistics.max_vbuffer_gpu_size, static_cast<int64_t>(size_bytes));
+                ++m_statistics.vbuffers_count;
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+
+                GLuint id = 0;
+                glsafe(::glGenBuffers(1, &id));
+                glsafe(::glBindBuffer(GL_ARRAY_BUFFER, id));
+                glsafe(::glBufferData(GL_ARRAY_BUFFER, size_bytes, v_buffer.data(), GL_STATIC_DRAW));
+                glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+                t_buffer.vertices.vbos.push_back(static_cast<unsigned int>(id));
+                t_buffer.vertices.sizes.push_back(size_bytes);
+            }
+        }
+    }
+
+    // dismiss vertices data, no more needed
+    std::vector<MultiVertexBuffer>().swap(vertices);
+    std::vector<InstanceBuffer>().swap(geometry.instances);
+    std::vector<InstanceIdBuffer>().swap(geometry.instances_ids);
+
     // toolpaths data -> send indices data to gpu
     for (size_t i = 0; i < m_buffers.size(); ++i) {
         TBuffer& t_buffer = m_buffers[i];
@@ -2944,7 +3238,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
                 t_buffer.indices.push_back(IBuffer());
                 IBuffer& ibuf = t_buffer.indices.back();
                 ibuf.count = size_elements;
-                ibuf.vbo = vbo_indices[i][t_buffer.indices.size() - 1];
+                ibuf.vbo = t_buffer.vertices.vbos[geometry.vbo_indices[i][t_buffer.indices.size() - 1]];
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
                 m_statistics.total_indices_gpu_size += static_cast<int64_t>(size_bytes);
@@ -2960,11 +3254,6 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
         }
     }
 
-    if (progress_dialog != nullptr) {
-        progress_dialog->Update(100, "");
-        progress_dialog->Fit();
-    }
-
 #if ENABLE_GCODE_VIEWER_STATISTICS
     for (const TBuffer& buffer : m_buffers) {
         m_statistics.paths_size += SLIC3R_STDVEC_MEMSIZE(buffer.paths, Path);
@@ -2988,89 +3277,15 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result, const
     update_segments_count(EMoveType::Wipe, m_statistics.wipe_segments_count);
     update_segments_count(EMoveType::Extrude, m_statistics.extrude_segments_count);
 
-    m_statistics.load_indices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - smooth_vertices_time).count();
+    m_statistics.load_vertices = geometry.load_vertices;
+    m_statistics.smooth_vertices = geometry.smooth_vertices;
+    m_statistics.load_indices = geometry.load_indices;
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
 
-    log_memory_usage("Loaded G-code generated indices buffers ", vertices, indices);
-
     // dismiss indices data, no more needed
     std::vector<MultiIndexBuffer>().swap(indices);
 
-    // layers zs / roles / extruder ids -> extract from result
-    size_t last_travel_s_id = 0;
-    seams_count = 0;
-    for (size_t i = 0; i < m_moves_count; ++i) {
-        const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
-        if (move.type == EMoveType::Seam)
-            ++seams_count;
-
-        size_t move_id = i - seams_count;
-
-        if (move.type == EMoveType::Extrude) {
-            // layers zs
-            const double* const last_z = m_layers.empty() ? nullptr : &m_layers.get_zs().back();
-            const double z = static_cast<double>(move.position.z());
-            if (last_z == nullptr || z < *last_z - EPSILON || *last_z + EPSILON < z)
-                m_layers.append(z, { last_travel_s_id, move_id });
-            else
-                m_layers.get_endpoints().back().last = move_id;
-            // extruder ids
-            m_extruder_ids.emplace_back(move.extruder_id);
-            // roles
-            if (i > 0)
-                m_roles.emplace_back(move.extrusion_role);
-        }
-        else if (move.type == EMoveType::Travel) {
-            if (move_id - last_travel_s_id > 1 && !m_layers.empty())
-                m_layers.get_endpoints().back().last = move_id;
-
-            last_travel_s_id = move_id;
-        }
-    }
-
-    // roles -> remove duplicates
-    sort_remove_duplicates(m_roles);
-    m_roles.shrink_to_fit();
-
-    // extruder ids -> remove duplicates
-    sort_remove_duplicates(m_extruder_ids);
-    m_extruder_ids.shrink_to_fit();
-
-    std::vector<int> plater_extruder;
-	for (auto mid : m_extruder_ids){
-        int eid = mid;
-        plater_extruder.push_back(++eid);
-	}
-    m_plater_extruder = plater_extruder;
-
-    // replace layers for spiral vase mode
-    if (!gcode_result.spiral_vase_layers.empty()) {
-        m_layers.reset();
-        for (const auto& layer : gcode_result.spiral_vase_layers) {
-            m_layers.append(layer.first, { layer.second.first, layer.second.second });
-        }
-    }
-
-    // set layers z range
-    if (!m_layers.empty())
-        m_layers_z_range = { 0, static_cast<unsigned int>(m_layers.size() - 1) };
-
-    // change color of paths whose layer contains option points
-    if (!options_zs.empty()) {
-        TBuffer& extrude_buffer = m_buffers[buffer_id(EMoveType::Extrude)];
-        for (Path& path : extrude_buffer.paths) {
-            const float z = path.sub_paths.front().first.position.z();
-            if (std::find_if(options_zs.begin(), options_zs.end(), [z](float f) { return f - EPSILON <= z && z <= f + EPSILON; }) != options_zs.end())
-                path.cp_color_id = 255 - path.cp_color_id;
-        }
-    }
-
-#if ENABLE_GCODE_VIEWER_STATISTICS
-    m_statistics.load_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
-
-    if (progress_dialog != nullptr)
-        progress_dialog->Destroy();
+    m_loaded_layers_z_range = geometry.layers_z_range;
 }
 
 void GCodeViewer::load_shells(const Print& print, bool initialized, bool force_previewing)
@@ -5623,6 +5838,14 @@ void GCodeViewer::render_legend(float &legend_height, int canvas_width, int canv
         imgui.text(total_str + ":");
         ImGui::SameLine(max_len);
         imgui.text(short_time(get_time_dhms(time_mode.time)));
+        if (ps.travel_time_saved > 0.) {
+            // Travels shortened by the grid travel planner, already accounted for in the times above.
+            ImGui::Dummy({ window_padding, window_padding });
+            ImGui::SameLine();
+            imgui.text(_u8L("Travel time saved") + ":");
+            ImGui::SameLine(max_len);
+            imgui.text(short_time(get_time_dhms(float(ps.travel_time_saved))));
+        }
 
         auto show_mode_button = [this, &imgui, can_show_mode_button](const wxString& label, PrintEstimatedStatistics::ETimeMode mode) {
             if (can_show_mode_button(mode)) {
@@ -3,6 +3,7 @@
 
 #include "3DScene.hpp"
 #include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/GCode/BinaryGCode.hpp"
 #include "libslic3r/GCode/ThumbnailData.hpp"
 #include "IMSlider.hpp"
 #include "GLModel.hpp"
@@ -11,6 +12,9 @@
 #include <boost/iostreams/device/mapped_file.hpp>
 
 #include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <float.h>
 #include <set>
 #include <unordered_set>
@@ -25,6 +29,7 @@ namespace GUI {
 
 class PartPlateList;
 class OpenGLManager;
+class Worker;
 
 static const float GCODE_VIEWER_SLIDER_SCALE = 0.6f;
 static const float SLIDER_DEFAULT_RIGHT_MARGIN  = 10.0f;
@@ -377,6 +382,29 @@ class GCodeViewer
         }
     };
 
+    //BBS: lazy loading, geometry of the toolpaths of a window of layers, built without any OpenGL call,
+    // so that it can be built on a worker thread and sent to the gpu by the render thread
+    struct ToolpathsGeometry
+    {
+        std::array<unsigned int, 2> layers_z_range{ 0, 0 };
+        // ids of the first and of the last move of the layers
+        std::pair<size_t, size_t> moves{ 0, std::numeric_limits<size_t>::max() };
+        // settings copied from m_buffers and paths of the buffers, no gpu data
+        std::vector<TBuffer> buffers;
+        std::vector<MultiVertexBuffer> vertices;
+        std::vector<MultiIndexBuffer> indices;
+        // for each index buffer, the index of the vertex buffer it refers to
+        std::vector<std::vector<unsigned int>> vbo_indices;
+        std::vector<InstanceBuffer> instances;
+        std::vector<InstanceIdBuffer> instances_ids;
+        std::vector<InstancesOffsets> instances_offsets;
+#if ENABLE_GCODE_VIEWER_STATISTICS
+        int64_t load_vertices{ 0 };
+        int64_t smooth_vertices{ 0 };
+        int64_t load_indices{ 0 };
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+    };
+
     // helper to render shells
     struct Shells
     {
@@ -654,6 +682,10 @@ public:
             size_t m_last_lines_size{ 0 };
             std::string m_filename;
             boost::iostreams::mapped_file_source m_file;
+            // Binary G-code is not mapped, its G-code blocks are decoded on demand, the last decoded block is cached.
+            std::unique_ptr<BinaryGCode::Reader> m_binary_file;
+            mutable size_t m_binary_block_id{ size_t(-1) };
+            mutable std::string m_binary_block;
             // map for accessing data in file by line number
             std::vector<size_t> m_lines_ends;
             // current visible lines
@@ -679,6 +711,10 @@ public:
             void on_change_color_mode(bool is_dark) { m_is_dark = is_dark; }
 
             void stop_mapping_file();
+
+        private:
+            // Reads len characters of the (decoded) G-code starting at the given offset.
+            std::string read_gcode(size_t start, size_t len) const;
         };
 
         struct Endpoints
@@ -754,6 +790,16 @@ private:
 
     Layers m_layers;
     std::array<unsigned int, 2> m_layers_z_range;
+    //BBS: lazy loading of large G-code files, only the moves of these layers have their geometry built
+    bool m_lazy_load{ false };
+    std::array<unsigned int, 2> m_loaded_layers_z_range{ 0, 0 };
+    //BBS: lazy loading, the geometry of the next window of layers is built by this worker
+    std::unique_ptr<Worker> m_geometry_worker;
+    size_t m_geometry_timestamp{ 0 };
+    // window of layers being built, or the loaded one
+    std::array<unsigned int, 2> m_loading_layers_z_range{ 0, 0 };
+    // geometry built, to be sent to the gpu by the next render
+    std::shared_ptr<ToolpathsGeometry> m_built_geometry;
     std::vector<ExtrusionRole> m_roles;
     size_t m_extruders_count;
     std::vector<unsigned char> m_extruder_ids;
@@ -832,6 +878,7 @@ public:
     const BoundingBoxf3& get_shell_bounding_box() const { return m_shell_bounding_box; }
     const std::vector<double>& get_layers_zs() const { return m_layers.get_zs(); }
     const std::array<unsigned int,2> &get_layers_z_range() const { return m_layers_z_range; }
+    bool is_lazy_loaded() const { return m_lazy_load; }
 
     const SequentialView& get_sequential_view() const { return m_sequential_view; }
     void update_sequential_view_current(unsigned int first, unsigned int last);
@@ -889,6 +936,16 @@ public:
 
 private:
     void load_toolpaths(const GCodeProcessorResult& gcode_result, const BuildVolume& build_volume, const std::vector<BoundingBoxf3>& exclude_bounding_box);
+    void load_toolpaths_geometry(const GCodeProcessorResult& gcode_result, bool show_progress);
+    //BBS: lazy loading of large G-code files
+    std::unique_ptr<ToolpathsGeometry> create_toolpaths_geometry(const std::array<unsigned int, 2>& layers_z_range) const;
+    // Does not touch the viewer, to be run on a worker thread. Returns false if canceled.
+    static bool build_toolpaths_geometry(const GCodeProcessorResult& gcode_result, size_t moves_count, const std::vector<size_t>& ssid_to_moveid_map,
+        ToolpathsGeometry& geometry, const std::function<void(int, const wxString&)>& progress, const std::function<bool()>& canceled);
+    // Sends the geometry to the gpu, to be called by the render thread.
+    void upload_toolpaths_geometry(ToolpathsGeometry& geometry);
+    void reload_toolpaths_geometry(const std::array<unsigned int, 2>& layers_z_range);
+    void stop_reload_toolpaths_geometry();
     //BBS: always load shell at preview
     //void load_shells(const Print& print);
     void refresh_render_paths(bool keep_sequential_current_first, bool keep_sequential_current_last) const;
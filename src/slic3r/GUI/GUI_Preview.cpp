@@ -592,6 +592,10 @@ void Preview::update_layers_slider(const std::vector<double>& layers_z, bool kee
             if (idx_new != -1) idx_high = idx_new;
         }
     }
+    //BBS: lazy loading, a large G-code file opens on the layers loaded by the preview
+    const GCodeViewer &gcode_viewer = m_canvas->get_gcode_viewer();
+    if (force_sliders_full_range && gcode_viewer.is_lazy_loaded())
+        idx_high = std::min<int>(idx_high, gcode_viewer.get_layers_z_range()[1]);
     m_layers_slider->SetSelectionSpan(idx_low, idx_high);
 
     auto curr_plate = wxGetApp().plater()->get_partplate_list().get_curr_plate();
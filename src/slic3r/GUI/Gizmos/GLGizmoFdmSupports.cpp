@@ -634,6 +634,7 @@ void GLGizmoFdmSupports::update_from_model_object(bool first_update)
     wxBusyCursor wait;
 
     const ModelObject* mo = m_c->selection_info()->model_object();
+    this->stop_seed_fill();
     m_triangle_selectors.clear();
     //BBS: add timestamp logic
     m_volume_timestamps.clear();
@@ -795,6 +795,7 @@ void GLGizmoMmuSegmentation::update_model_object()
 void GLGizmoMmuSegmentation::init_model_triangle_selectors()
 {
     const ModelObject *mo = m_c->selection_info()->model_object();
+    this->stop_seed_fill();
     m_triangle_selectors.clear();
     m_volumes_extruder_idxs.clear();
 
@@ -7,14 +7,20 @@
 #include "slic3r/GUI/GUI_App.hpp"
 #include "slic3r/GUI/Camera.hpp"
 #include "slic3r/GUI/Plater.hpp"
+#include "slic3r/GUI/Jobs/BoostThreadWorker.hpp"
+#include "slic3r/GUI/Jobs/NotificationProgressIndicator.hpp"
+#include "slic3r/GUI/Jobs/PlaterWorker.hpp"
 #include "slic3r/GUI/OpenGLManager.hpp"
 #include "slic3r/Utils/UndoRedo.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/PresetBundle.hpp"
+#include "libslic3r/PrintBase.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 
+#include <chrono>
 #include <memory>
 #include <optional>
+#include <numeric>
 
 namespace Slic3r::GUI {
 
@@ -29,10 +35,73 @@ GLGizmoPainterBase::GLGizmoPainterBase(GLCanvas3D& parent, const std::string& ic
 
 GLGizmoPainterBase::~GLGizmoPainterBase()
 {
+    // The smart fill searched in the background refers to the triangle selectors.
+    this->stop_seed_fill();
     if (s_sphere != nullptr)
         s_sphere.reset();
 }
 
+void GLGizmoPainterBase::seed_fill_select_triangles_async(int mesh_id, const Vec3f &hit, int facet_idx, const Transform3d &trafo_matrix_not_translate,
+                                                          const TriangleSelector::ClippingPlane &clp, bool force_reselection)
+{
+    // Even if the facet hit is already selected, the search of a facet hovered before is not of interest anymore.
+    const size_t         timestamp = ++ m_seed_fill_timestamp;
+    TriangleSelectorGUI *selector  = m_triangle_selectors[mesh_id].get();
+    if (!force_reselection && !selector->seed_fill_needs_update(hit, facet_idx, clp))
+        return;
+
+    if (!m_seed_fill_worker)
+        m_seed_fill_worker = std::make_unique<PlaterWorker<BoostThreadWorker>>(wxGetApp().plater(),
+            std::make_shared<NotificationProgressIndicator>(wxGetApp().plater()->get_notification_manager()), "seed_fill_worker");
+
+    // The searches started before are canceled.
+    auto        facets                 = std::make_shared<std::vector<int>>();
+    const float seed_fill_angle        = m_smart_fill_angle;
+    const float highlight_by_angle_deg = m_paint_on_overhangs_only ? m_highlight_by_angle_threshold_deg : 0.f;
+    replace_job(*m_seed_fill_worker,
+        [selector, facets, facet_idx, trafo_matrix_not_translate, clp, seed_fill_angle, highlight_by_angle_deg](Job::Ctl &ctl) {
+            // The progress is shown only for the searches taking long enough to be noticed.
+            const auto start          = std::chrono::steady_clock::now();
+            bool       progress_shown = false;
+            *facets = selector->seed_fill_region(facet_idx, trafo_matrix_not_translate, clp, seed_fill_angle, highlight_by_angle_deg,
+                [&ctl]() {
+                    if (ctl.was_canceled())
+                        throw CanceledException();
+                },
+                [&ctl, &start, &progress_shown](int percent) {
+                    if (progress_shown || std::chrono::steady_clock::now() - start > std::chrono::milliseconds(200)) {
+                        ctl.update_status(percent, _u8L("Smart fill"));
+                        progress_shown = true;
+                    }
+                });
+            if (progress_shown)
+                ctl.update_status(100, _u8L("Smart fill"));
+        },
+        [this, timestamp, mesh_id, selector, facets](bool canceled, std::exception_ptr &eptr) {
+            if (eptr) try {
+                std::rethrow_exception(eptr);
+            } catch (const CanceledException &) {
+                canceled = true;
+                eptr     = nullptr;
+            } catch (...) {}
+            if (canceled || eptr || timestamp != m_seed_fill_timestamp || mesh_id >= int(m_triangle_selectors.size()) ||
+                m_triangle_selectors[mesh_id].get() != selector)
+                return;
+            selector->seed_fill_unselect_all_triangles();
+            selector->seed_fill_select_region(*facets);
+            selector->request_update_render_data();
+            m_parent.set_as_dirty();
+        });
+}
+
+void GLGizmoPainterBase::stop_seed_fill()
+{
+    // The search finished, but not yet selected, is dropped as well.
+    ++ m_seed_fill_timestamp;
+    if (m_seed_fill_worker)
+        stop_queue(*m_seed_fill_worker);
+}
+
 void GLGizmoPainterBase::data_changed(bool is_serializing)
 {
     if (m_state != On)
@@ -602,9 +671,8 @@ bool GLGizmoPainterBase::gizmo_event(SLAGizmoEventType action, const Vec2d& mous
                     const Transform3d   trafo_matrix = m_parent.get_canvas_type() == GLCanvas3D::CanvasAssembleView ?
                         mi->get_assemble_transformation().get_matrix() * mo->volumes[m_rr.mesh_id]->get_matrix() :
                         mi->get_transformation().get_matrix() * mo->volumes[m_rr.mesh_id]->get_matrix();
-                    m_triangle_selectors[m_rr.mesh_id]->seed_fill_select_triangles(m_rr.hit, int(m_rr.facet), trafo_matrix_not_translate, this->get_clipping_plane_in_volume_coordinates(trafo_matrix), m_smart_fill_angle,
-                                                                                   m_paint_on_overhangs_only ? m_highlight_by_angle_threshold_deg : 0.f, true);
-                    m_triangle_selectors[m_rr.mesh_id]->request_update_render_data();
+                    this->seed_fill_select_triangles_async(m_rr.mesh_id, m_rr.hit, int(m_rr.facet), trafo_matrix_not_translate,
+                                                           this->get_clipping_plane_in_volume_coordinates(trafo_matrix), true);
                     m_seed_fill_last_mesh_id = m_rr.mesh_id;
                 }
                 return true;
@@ -763,10 +831,15 @@ bool GLGizmoPainterBase::gizmo_event(SLAGizmoEventType action, const Vec2d& mous
                     assert(projected_mouse_position.mesh_idx == mesh_idx);
                     const Vec3f mesh_hit = projected_mouse_position.mesh_hit;
                     const int facet_idx = int(projected_mouse_position.facet_idx);
+                    if (m_tool_type == ToolType::SMART_FILL) {
+                        // The smart fill searched in the background may not have reached the facet clicked yet, finish it here.
+                        this->stop_seed_fill();
+                        m_triangle_selectors[mesh_idx]->seed_fill_select_triangles(mesh_hit, facet_idx, trafo_matrix_not_translate, clp, m_smart_fill_angle,
+                                                                                   m_paint_on_overhangs_only ? m_highlight_by_angle_threshold_deg : 0.f);
+                    }
                     m_triangle_selectors[mesh_idx]->seed_fill_apply_on_triangles(new_state);
                     if (m_tool_type == ToolType::SMART_FILL)
-                        m_triangle_selectors[mesh_idx]->seed_fill_select_triangles(mesh_hit, facet_idx, trafo_matrix_not_translate, clp, m_smart_fill_angle,
-                                                                                       m_paint_on_overhangs_only ? m_highlight_by_angle_threshold_deg : 0.f, true);
+                        this->seed_fill_select_triangles_async(mesh_idx, mesh_hit, facet_idx, trafo_matrix_not_translate, clp, true);
                     else if (m_tool_type == ToolType::BRUSH && m_cursor_type == TriangleSelector::CursorType::POINTER)
                         // BBS: add infill_angle parameter
                         m_triangle_selectors[mesh_idx]->bucket_fill_select_triangles(mesh_hit, facet_idx, clp, -1.f, false, true);
@@ -846,6 +919,7 @@ bool GLGizmoPainterBase::gizmo_event(SLAGizmoEventType action, const Vec2d& mous
 
         if (m_rr.mesh_id == -1) {
             // Clean selected by seed fill for all triangles in all meshes when a mouse isn't pointing on any mesh.
+            this->stop_seed_fill();
             seed_fill_unselect_all();
             m_seed_fill_last_mesh_id = -1;
 
@@ -854,8 +928,10 @@ bool GLGizmoPainterBase::gizmo_event(SLAGizmoEventType action, const Vec2d& mous
         }
 
         // The mouse moved from one object's volume to another one. So it is needed to unselect all triangles selected by seed fill.
-        if(m_rr.mesh_id != m_seed_fill_last_mesh_id)
+        if(m_rr.mesh_id != m_seed_fill_last_mesh_id) {
+            this->stop_seed_fill();
             seed_fill_unselect_all();
+        }
 
         const Transform3d &trafo_matrix = trafo_matrices[m_rr.mesh_id];
         const Transform3d &trafo_matrix_not_translate = trafo_matrices_not_translate[m_rr.mesh_id];
@@ -863,8 +939,7 @@ bool GLGizmoPainterBase::gizmo_event(SLAGizmoEventType action, const Vec2d& mous
         assert(m_rr.mesh_id < int(m_triangle_selectors.size()));
         const TriangleSelector::ClippingPlane &clp = this->get_clipping_plane_in_volume_coordinates(trafo_matrix);
         if (m_tool_type == ToolType::SMART_FILL)
-            m_triangle_selectors[m_rr.mesh_id]->seed_fill_select_triangles(m_rr.hit, int(m_rr.facet), trafo_matrix_not_translate, clp, m_smart_fill_angle,
-                                                                           m_paint_on_overhangs_only ? m_highlight_by_angle_threshold_deg : 0.f);
+            this->seed_fill_select_triangles_async(m_rr.mesh_id, m_rr.hit, int(m_rr.facet), trafo_matrix_not_translate, clp, false);
         else if (m_tool_type == ToolType::BRUSH && m_cursor_type == TriangleSelector::CursorType::POINTER)
             // BBS: add infill_angle parameter
             m_triangle_selectors[m_rr.mesh_id]->bucket_fill_select_triangles(m_rr.hit, int(m_rr.facet), clp, -1.f, false);
@@ -1064,6 +1139,7 @@ void GLGizmoPainterBase::on_set_state()
         on_shutdown();
         m_old_mo_id = -1;
         //m_iva.release_geometry();
+        this->stop_seed_fill();
         m_triangle_selectors.clear();
 
         //Camera& camera = wxGetApp().plater()->get_camera();
@@ -1130,19 +1206,21 @@ void TriangleSelectorGUI::render(ImGuiWrapper* imgui, const Transform3d& matrix)
         return;
     assert(shader->get_name() == "gouraud" || shader->get_name() == "mm_gouraud");
 
-    for (auto iva : {std::make_pair(&m_iva_enforcers, enforcers_color),
-                     std::make_pair(&m_iva_blockers, blockers_color)}) {
-        iva.first->set_color(iva.second);
-        iva.first->render();
-    }
+    for (RenderChunk &chunk : m_render_chunks) {
+        for (auto iva : {std::make_pair(&chunk.enforcers, enforcers_color),
+                         std::make_pair(&chunk.blockers, blockers_color)}) {
+            iva.first->set_color(iva.second);
+            iva.first->render();
+        }
 
-    for (auto& iva : m_iva_seed_fills) {
-        size_t           color_idx = &iva - &m_iva_seed_fills.front();
-        const ColorRGBA& color     = TriangleSelectorGUI::get_seed_fill_color(color_idx == 1 ? enforcers_color :
-            color_idx == 2 ? blockers_color :
-            GLVolume::NEUTRAL_COLOR);
-        iva.set_color(color);
-        iva.render();
+        for (auto& iva : chunk.seed_fills) {
+            size_t           color_idx = &iva - &chunk.seed_fills.front();
+            const ColorRGBA& color     = TriangleSelectorGUI::get_seed_fill_color(color_idx == 1 ? enforcers_color :
+                color_idx == 2 ? blockers_color :
+                GLVolume::NEUTRAL_COLOR);
+            iva.set_color(color);
+            iva.render();
+        }
     }
 
     render_paint_contour(matrix);
@@ -1155,17 +1233,60 @@ void TriangleSelectorGUI::render(ImGuiWrapper* imgui, const Transform3d& matrix)
 #endif
 }
 
+std::vector<size_t> TriangleSelectorGUI::dirty_render_chunks() const
+{
+    std::vector<size_t> chunks;
+    chunks.reserve(this->dirty_facets().size());
+    for (int facet_idx : this->dirty_facets())
+        chunks.emplace_back(size_t(facet_idx / RenderChunkSize));
+    sort_remove_duplicates(chunks);
+    return chunks;
+}
+
+std::vector<int> TriangleSelectorGUI::render_chunk_triangles(size_t chunk_idx) const
+{
+    std::vector<int> triangles;
+    const int        facet_end = std::min(int(chunk_idx + 1) * RenderChunkSize, m_orig_size_indices);
+    for (int facet_idx = int(chunk_idx) * RenderChunkSize; facet_idx < facet_end; ++facet_idx)
+        this->append_leaf_triangles(facet_idx, triangles);
+    return triangles;
+}
+
 void TriangleSelectorGUI::update_render_data()
 {
-    int              enf_cnt = 0;
-    int              blc_cnt = 0;
-    std::vector<int> seed_fill_cnt(m_iva_seed_fills.size(), 0);
+    const size_t        chunks_cnt = this->render_chunks_count();
+    std::vector<size_t> chunks;
+    if (this->all_dirty() || m_render_chunks.size() != chunks_cnt) {
+        // Clear before resizing, so that the vector never copies the GLModels.
+        m_render_chunks.clear();
+        m_render_chunks.resize(chunks_cnt);
+        chunks.assign(chunks_cnt, 0);
+        std::iota(chunks.begin(), chunks.end(), 0);
+    } else
+        chunks = this->dirty_render_chunks();
+
+    for (size_t chunk_idx : chunks)
+        this->update_render_chunk(chunk_idx);
+
+    // Splitting of the triangles may change the contour even if no triangle was selected or unselected by seed fill.
+    if (this->seed_fill_dirty() || m_paint_contour.is_initialized())
+        update_paint_contour();
+
+    this->clear_dirty();
+}
 
-    for (auto* iva : { &m_iva_enforcers, &m_iva_blockers }) {
+void TriangleSelectorGUI::update_render_chunk(size_t chunk_idx)
+{
+    RenderChunk &chunk   = m_render_chunks[chunk_idx];
+    int          enf_cnt = 0;
+    int          blc_cnt = 0;
+    std::vector<int> seed_fill_cnt(chunk.seed_fills.size(), 0);
+
+    for (auto* iva : { &chunk.enforcers, &chunk.blockers }) {
         iva->reset();
     }
 
-    for (auto& iva : m_iva_seed_fills) {
+    for (auto& iva : chunk.seed_fills) {
         iva.reset();
     }
 
@@ -1180,8 +1301,9 @@ void TriangleSelectorGUI::update_render_data()
     // small value used to offset triangles along their normal to avoid z-fighting
     static const float offset = 0.001f;
 
-    for (const Triangle &tr : m_triangles) {
-        if (!tr.valid() || tr.is_split() || (tr.get_state() == EnforcerBlockerType::NONE && !tr.is_selected_by_seed_fill()))
+    for (int tr_idx : this->render_chunk_triangles(chunk_idx)) {
+        const Triangle &tr = m_triangles[tr_idx];
+        if (tr.get_state() == EnforcerBlockerType::NONE && !tr.is_selected_by_seed_fill())
             continue;
 
         int tr_state = int(tr.get_state());
@@ -1207,15 +1329,13 @@ void TriangleSelectorGUI::update_render_data()
     }
 
     if (!iva_enforcers_data.is_empty())
-        m_iva_enforcers.init_from(std::move(iva_enforcers_data));
+        chunk.enforcers.init_from(std::move(iva_enforcers_data));
     if (!iva_blockers_data.is_empty())
-        m_iva_blockers.init_from(std::move(iva_blockers_data));
-    for (size_t i = 0; i < m_iva_seed_fills.size(); ++i) {
+        chunk.blockers.init_from(std::move(iva_blockers_data));
+    for (size_t i = 0; i < chunk.seed_fills.size(); ++i) {
         if (!iva_seed_fills_data[i].is_empty())
-            m_iva_seed_fills[i].init_from(std::move(iva_seed_fills_data[i]));
+            chunk.seed_fills[i].init_from(std::move(iva_seed_fills_data[i]));
     }
-
-    update_paint_contour();
 }
 
 // BBS
@@ -1279,24 +1399,40 @@ void TriangleSelectorPatch::render(ImGuiWrapper* imgui, const Transform3d& matri
     render_paint_contour(matrix);
 }
 
+bool TriangleSelectorPatch::using_wireframe() const
+{
+    return m_need_wireframe && wxGetApp().plater()->is_wireframe_enabled() && wxGetApp().plater()->is_show_wireframe();
+}
+
 void TriangleSelectorPatch::update_triangles_per_type()
 {
     //BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(", enter");
-    m_triangle_patches.resize((int)EnforcerBlockerType::ExtruderMax + 1);
-    for (int i = 0; i < m_triangle_patches.size(); i++) {
-        auto& patch = m_triangle_patches[i];
+    // One patch per type for each render chunk.
+    const size_t num_types = (size_t)EnforcerBlockerType::ExtruderMax + 1;
+    m_triangle_patches.resize(this->render_chunks_count() * num_types);
+    for (size_t chunk_idx = 0; chunk_idx < this->render_chunks_count(); ++chunk_idx)
+        this->update_render_chunk_per_type(chunk_idx);
+    //BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format("exit");
+}
+
+void TriangleSelectorPatch::update_render_chunk_per_type(size_t chunk_idx)
+{
+    const size_t num_types = (size_t)EnforcerBlockerType::ExtruderMax + 1;
+    assert(m_triangle_patches.size() == this->render_chunks_count() * num_types);
+    TrianglePatch *patches = m_triangle_patches.data() + chunk_idx * num_types;
+    for (size_t i = 0; i < num_types; i++) {
+        auto& patch = patches[i];
         patch.type = (EnforcerBlockerType)i;
-        patch.triangle_indices.reserve(m_triangles.size() / 3);
+        patch.patch_vertices.clear();
+        patch.triangle_indices.clear();
     }
 
-    bool using_wireframe = (m_need_wireframe && wxGetApp().plater()->is_wireframe_enabled() && wxGetApp().plater()->is_show_wireframe()) ? true : false;
-
-    for (auto& triangle : m_triangles) {
-        if (!triangle.valid() || triangle.is_split())
-            continue;
+    bool using_wireframe = this->using_wireframe();
 
+    for (int tr_idx : this->render_chunk_triangles(chunk_idx)) {
+        const Triangle& triangle = m_triangles[tr_idx];
         int state = (int)triangle.get_state();
-        auto& patch = m_triangle_patches[state];
+        auto& patch = patches[state];
         //patch.triangle_indices.insert(patch.triangle_indices.end(), triangle.verts_idxs.begin(), triangle.verts_idxs.end());
         for (int i = 0; i < 3; ++i) {
             int j = triangle.verts_idxs[i];
@@ -1326,7 +1462,6 @@ void TriangleSelectorPatch::update_triangles_per_type()
         }
         //BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(", Line %1%: state=%2%, vertice size=%3%, triangle size %4%")%__LINE__%state%patch.patch_vertices.size()%patch.triangle_indices.size();
     }
-    //BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format("exit");
 }
 
 void TriangleSelectorPatch::update_selector_triangles()
@@ -1338,6 +1473,7 @@ void TriangleSelectorPatch::update_selector_triangles()
         EnforcerBlockerType type = *patch.neighbor_types.begin();
         for (int facet_idx : patch.facet_indices) {
             m_triangles[facet_idx].set_state(type);
+            this->mark_dirty(m_triangles[facet_idx].source_triangle);
         }
     }
 }
@@ -1347,7 +1483,7 @@ void TriangleSelectorPatch::update_triangles_per_patch()
     auto [neighbors, neighbors_propagated] = this->precompute_all_neighbors();
     std::vector<bool>  visited(m_triangles.size(), false);
 
-    bool using_wireframe = (m_need_wireframe && wxGetApp().plater()->is_wireframe_enabled() && wxGetApp().plater()->is_show_wireframe()) ? true : false; 
+    bool using_wireframe = this->using_wireframe();
 
     auto get_all_touching_triangles = [this](int facet_idx, const Vec3i32& neighbors, const Vec3i32& neighbors_propagated) -> std::vector<int> {
         assert(facet_idx != -1 && facet_idx < int(m_triangles.size()));
@@ -1478,7 +1614,22 @@ void TriangleSelectorPatch::set_filter_state(bool is_filter_state)
 void TriangleSelectorPatch::update_render_data()
 {
     //BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(", m_paint_changed=%1%, m_triangle_patches.size %2%")%m_paint_changed%m_triangle_patches.size();
-    if (m_paint_changed || (m_triangle_patches.size() == 0)) {
+    const size_t num_types       = (size_t)EnforcerBlockerType::ExtruderMax + 1;
+    const bool   using_wireframe = this->using_wireframe();
+    // The patches split by type in render chunks may be updated just for the chunks modified since the last update.
+    const bool   incremental     = !m_filter_state && !this->all_dirty() && m_patches_per_chunk && m_patches_wireframe == using_wireframe &&
+                                   m_triangle_patches.size() == this->render_chunks_count() * num_types;
+    // The dirty facets are only consumed by rebuilding the patches, the patches do not depend on the seed fill.
+    bool patches_updated = false;
+    if (incremental && m_paint_changed) {
+        for (size_t chunk_idx : this->dirty_render_chunks()) {
+            this->release_geometry(chunk_idx * num_types, (chunk_idx + 1) * num_types);
+            this->update_render_chunk_per_type(chunk_idx);
+            this->finalize_triangle_indices(chunk_idx * num_types, (chunk_idx + 1) * num_types);
+        }
+        patches_updated = true;
+        m_paint_changed = false;
+    } else if (m_paint_changed || (m_triangle_patches.size() == 0)) {
         this->release_geometry();
 
         /*m_patch_vertices.reserve(m_vertices.size() * 3);
@@ -1495,11 +1646,18 @@ void TriangleSelectorPatch::update_render_data()
             update_triangles_per_type();
         this->finalize_triangle_indices();
 
+        m_patches_per_chunk = !m_filter_state;
+        m_patches_wireframe = using_wireframe;
+        patches_updated = true;
         m_paint_changed = false;
     }
 
     //BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(", before paint_contour");
-    update_paint_contour();
+    // Splitting of the triangles may change the contour even if no triangle was selected or unselected by seed fill.
+    if (this->seed_fill_dirty() || m_paint_contour.is_initialized())
+        update_paint_contour();
+    if (patches_updated)
+        this->clear_dirty();
     //BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(", exit");
 }
 
@@ -1568,10 +1726,27 @@ void TriangleSelectorPatch::release_geometry()
         triangle_indices_VBO_id = 0;
     }
     this->clear();
+    m_patches_per_chunk = false;
 
     BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(", Line %1%: released geometry")%__LINE__;
 }
 
+void TriangleSelectorPatch::release_geometry(size_t begin, size_t end)
+{
+    assert(end <= m_vertices_VBO_ids.size() && end <= m_triangle_indices_VBO_ids.size());
+    for (size_t buffer_idx = begin; buffer_idx < end; ++buffer_idx) {
+        if (m_vertices_VBO_ids[buffer_idx] != 0) {
+            glsafe(::glDeleteBuffers(1, &m_vertices_VBO_ids[buffer_idx]));
+            m_vertices_VBO_ids[buffer_idx] = 0;
+        }
+        if (m_triangle_indices_VBO_ids[buffer_idx] != 0) {
+            glsafe(::glDeleteBuffers(1, &m_triangle_indices_VBO_ids[buffer_idx]));
+            m_triangle_indices_VBO_ids[buffer_idx] = 0;
+        }
+        m_triangle_indices_sizes[buffer_idx] = 0;
+    }
+}
+
 void TriangleSelectorPatch::finalize_vertices()
 {
     /*assert(m_vertices_VBO_id == 0);
@@ -1591,7 +1766,13 @@ void TriangleSelectorPatch::finalize_triangle_indices()
     m_triangle_indices_sizes.resize(m_triangle_patches.size());
     assert(std::all_of(m_triangle_indices_VBO_ids.cbegin(), m_triangle_indices_VBO_ids.cend(), [](const auto& ti_VBO_id) { return ti_VBO_id == 0; }));
 
-    for (size_t buffer_idx = 0; buffer_idx < m_triangle_patches.size(); ++buffer_idx) {
+    this->finalize_triangle_indices(0, m_triangle_patches.size());
+}
+
+void TriangleSelectorPatch::finalize_triangle_indices(size_t begin, size_t end)
+{
+    assert(end <= m_triangle_patches.size() && m_triangle_patches.size() == m_triangle_indices_VBO_ids.size());
+    for (size_t buffer_idx = begin; buffer_idx < end; ++buffer_idx) {
         std::vector<float>& patch_vertices = m_triangle_patches[buffer_idx].patch_vertices;
         if (!patch_vertices.empty()) {
             glsafe(::glGenBuffers(1, &m_vertices_VBO_ids[buffer_idx]));
@@ -22,6 +22,7 @@ class ClippingPlane;
 struct Camera;
 class GLGizmoMmuSegmentation;
 class Selection;
+class Worker;
 
 enum class PainterGizmoType {
     FDM_SUPPORTS,
@@ -64,12 +65,26 @@ protected:
 
     static ColorRGBA get_seed_fill_color(const ColorRGBA &base_color);
 
+    // The render data are split into chunks of RenderChunkSize facets of the original mesh,
+    // so that a paint stroke only rebuilds and uploads the chunks it modified.
+    static constexpr int RenderChunkSize = 16384;
+    size_t               render_chunks_count() const { return (size_t(m_orig_size_indices) + RenderChunkSize - 1) / RenderChunkSize; }
+    // Sorted indices of the chunks containing dirty_facets().
+    std::vector<size_t>  dirty_render_chunks() const;
+    // Valid unsplit triangles of the chunk.
+    std::vector<int>     render_chunk_triangles(size_t chunk_idx) const;
+
 private:
     void update_render_data();
+    void update_render_chunk(size_t chunk_idx);
 
-    GLModel                m_iva_enforcers;
-    GLModel                m_iva_blockers;
-    std::array<GLModel, 3> m_iva_seed_fills;
+    struct RenderChunk
+    {
+        GLModel                enforcers;
+        GLModel                blockers;
+        std::array<GLModel, 3> seed_fills;
+    };
+    std::vector<RenderChunk> m_render_chunks;
 #ifdef PRUSASLICER_TRIANGLE_SELECTOR_DEBUG
     std::array<GLModel, 3> m_varrays;
 #endif // PRUSASLICER_TRIANGLE_SELECTOR_DEBUG
@@ -107,6 +122,8 @@ public:
     void render(ImGuiWrapper* imgui, const Transform3d& matrix) override;
     // TriangleSelector.m_triangles => m_gizmo_scene.triangle_patches
     void update_triangles_per_type();
+    // Same as update_triangles_per_type() for the triangles of a single render chunk.
+    void update_render_chunk_per_type(size_t chunk_idx);
     // m_gizmo_scene.triangle_patches => TriangleSelector.m_triangles
     void update_selector_triangles();
     void update_triangles_per_patch();
@@ -130,6 +147,12 @@ protected:
     // Finalize the initialization of the indices, upload the indices to OpenGL VBO objects
     // and possibly releasing it if it has been loaded into the VBOs.
     void finalize_triangle_indices();
+    // Upload the patches [begin, end), their VBOs are expected to be released.
+    void finalize_triangle_indices(size_t begin, size_t end);
+    // Release the VBOs of the patches [begin, end).
+    void release_geometry(size_t begin, size_t end);
+
+    bool using_wireframe() const;
 
     void clear()
     {
@@ -169,6 +192,11 @@ protected:
 
     bool                        m_filter_state = false;
 
+    // Are m_triangle_patches split by type in render chunks (update_triangles_per_type()), thus updatable incrementally?
+    bool                        m_patches_per_chunk = false;
+    // Do the vertices of m_triangle_patches carry barycentric coordinates for the wireframe?
+    bool                        m_patches_wireframe = false;
+
 private:
     void update_render_data();
     void render(int buffer_idx, bool show_wireframe=false);
@@ -310,6 +338,14 @@ protected:
 
     TriangleSelector::ClippingPlane get_clipping_plane_in_volume_coordinates(const Transform3d &trafo) const;
 
+    // Search the smart fill of the facet hit on a background worker, so that the UI thread is not blocked by large meshes,
+    // and select the triangles found on the UI thread once the search finishes. The search is canceled by the next one.
+    void seed_fill_select_triangles_async(int mesh_id, const Vec3f &hit, int facet_idx, const Transform3d &trafo_matrix_not_translate,
+                                          const TriangleSelector::ClippingPlane &clp, bool force_reselection);
+    // Cancel the smart fill searched in the background and wait for it to stop.
+    // To be called before the triangle selectors are destroyed.
+    void stop_seed_fill();
+
 private:
     std::vector<std::vector<ProjectedMousePosition>> get_projected_mouse_positions(const Vec2d &mouse_position, double resolution, const std::vector<Transform3d> &trafo_matrices) const;
 
@@ -340,6 +376,11 @@ private:
     };
     mutable RaycastResult m_rr = {Vec2d::Zero(), -1, Vec3f::Zero(), 0};
 
+    // Searches the smart fill in the background, see seed_fill_select_triangles_async().
+    std::unique_ptr<Worker> m_seed_fill_worker;
+    // Incremented by each smart fill request, only the result of the last one is selected.
+    size_t                  m_seed_fill_timestamp = 0;
+
     // BBS
     struct CutContours
     {
@@ -391,6 +391,7 @@ void GLGizmoSeam::update_from_model_object(bool first_update)
     wxBusyCursor wait;
 
     const ModelObject* mo = m_c->selection_info()->model_object();
+    this->stop_seed_fill();
     m_triangle_selectors.clear();
 
     int volume_id = -1;
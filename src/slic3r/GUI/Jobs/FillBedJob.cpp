@@ -233,7 +233,14 @@ void FillBedJob::process(Ctl &ctl)
     // final align用的是凸包，在有fixed item的情况下可能找到的参考点位置是错的，这里就不做了。见STUDIO-3265
     params.do_final_align = !is_bbl;
 
-    if (m_selected.size() > 100){
+    m_placed_on_grid = false;
+    if (! params.is_seq_print && arrangement::is_lattice_fillable(m_selected)) {
+        // The copies of one object are tiled on a lattice, which packs them tighter and much faster than the NFP placer.
+        // The lattice does not consider the extruder clearance, sequential printing is left to the NFP placer.
+        arrangement::fill_bed_lattice(m_selected, m_unselected, m_bedpts, params);
+    }
+    else if (m_selected.size() > 100){
+        m_placed_on_grid = true;
         // too many items, just find grid empty cells to put them
         Vec2f step = unscaled<float>(get_extents(m_selected.front().poly).size()) + Vec2f(m_selected.front().brim_width, m_selected.front().brim_width);
         std::vector<Vec2f> empty_cells = Plater::get_empty_cells(step);
@@ -291,7 +298,7 @@ void FillBedJob::finalize(bool canceled, std::exception_ptr &eptr)
             else
                 ap.bed_idx = cur_plate;
 
-            if (m_selected.size() <= 100) {
+            if (!m_placed_on_grid) {
                 ap.row = ap.bed_idx / plate_cols;
                 ap.col = ap.bed_idx % plate_cols;
                 ap.translation(X) += bed_stride_x(m_plater) * ap.col;
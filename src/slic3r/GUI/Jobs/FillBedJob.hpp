@@ -24,6 +24,8 @@ class FillBedJob : public Job
     arrangement::ArrangeParams params;
 
     int m_status_range = 0;
+    // The items were placed into the empty cells of the plate in world coordinates, not relative to the current plate.
+    bool m_placed_on_grid = false;
     Plater *m_plater;
 
 public:
@@ -22,6 +22,7 @@
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/Tesselate.hpp"
 #include "libslic3r/GCode/ThumbnailData.hpp"
+#include "libslic3r/SliceResultStore.hpp"
 #include "libslic3r/Utils.hpp"
 
 #include "I18N.hpp"
@@ -2949,6 +2950,31 @@ int PartPlate::load_gcode_from_file(const std::string& filename)
 	return ret;
 }
 
+bool PartPlate::load_slice_result_from_store(const SliceResultStore& store)
+{
+	if (m_slice_result_valid)
+		return false;
+
+	// the same as load_gcode_from_file(), the key is taken from the print as it would be sliced
+	DynamicPrintConfig full_config = wxGetApp().preset_bundle->full_config();
+	full_config.apply(m_config, true);
+	m_print->apply(*m_model, full_config);
+	m_print->apply(*m_model, full_config);
+
+	std::string key = SliceResultStore::key(*m_print);
+	if (key.empty() || !store.contains(key))
+		return false;
+
+	if (!store.load(key, get_tmp_gcode_path(), *m_gcode_result, m_print->print_statistics()))
+		return false;
+	m_print->set_gcode_file_ready();
+	update_slice_result_valid_state(true);
+	m_ready_for_slice = true;
+
+	BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": plate %1% restored from the slice result store, key %2%") % m_plate_index % key;
+	return true;
+}
+
 int PartPlate::load_thumbnail_data(std::string filename, ThumbnailData& thumb_data)
 {
 	bool result = true;
@@ -5397,6 +5423,30 @@ int PartPlateList::load_gcode_files()
 	return ret;
 }
 
+int PartPlateList::load_stored_slice_results(const SliceResultStore& store)
+{
+	int count = 0;
+
+	//only do this while m_plater valid for gui mode
+	if (!m_plater)
+		return count;
+
+	for (unsigned int i = 0; i < (unsigned int)m_plate_list.size(); ++i)
+	{
+		if (m_plate_list[i]->empty())
+			continue;
+		//the same as load_gcode_files()
+		m_model->update_print_volume_state({m_plate_list[i]->get_shape(), (double)this->m_plate_height });
+
+		if (m_plate_list[i]->load_slice_result_from_store(store))
+			count ++;
+	}
+
+	BOOST_LOG_TRIVIAL(info) << boost::format("restored %1% plates from the slice result store") % count;
+
+	return count;
+}
+
 void PartPlateList::print() const
 {
 	BOOST_LOG_TRIVIAL(trace) << __FUNCTION__ << boost::format("PartPlateList %1%, m_plate_count %2%, current_plate %3%, print_count %4%, current print index %5%, plate cols %6%") % this % m_plate_count % m_current_plate % m_print_list.size() % m_print_index % m_plate_cols;
@@ -65,6 +65,7 @@ class ModelObject;
 class ModelInstance;
 class Print;
 class SLAPrint;
+class SliceResultStore;
 
 namespace GUI {
 class Plater;
@@ -463,6 +464,8 @@ public:
     }
     //load gcode from file
     int load_gcode_from_file(const std::string& filename);
+    //restore the slicing result of this plate from the store, if its model and config did not change
+    bool load_slice_result_from_store(const SliceResultStore& store);
     //load thumbnail data from file
     int load_thumbnail_data(std::string filename, ThumbnailData& thumb_data);
     //load pattern thumbnail data from file
@@ -835,6 +838,8 @@ public:
     int load_from_3mf_structure(PlateDataPtrs& plate_data_list);
     //load gcode files
     int load_gcode_files();
+    //restore the slicing results of the unchanged plates, returns the count of restored plates
+    int load_stored_slice_results(const SliceResultStore& store);
 
     template<class Archive> void serialize(Archive& ar)
     {
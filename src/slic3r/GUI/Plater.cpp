@@ -59,6 +59,7 @@
 #include "libslic3r/Print.hpp"
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/SLAPrint.hpp"
+#include "libslic3r/SliceResultStore.hpp"
 #include "libslic3r/Utils.hpp"
 #include "libslic3r/PresetBundle.hpp"
 #include "libslic3r/ClipperUtils.hpp"
@@ -2529,6 +2530,9 @@ struct Plater::priv
     void on_slicing_update(SlicingStatusEvent&);
     void on_slicing_completed(wxCommandEvent&);
     void on_process_completed(SlicingProcessCompletedEvent&);
+    //store the result of the current plate / restore the results of the unchanged plates, see SliceResultStore
+    void store_slice_result();
+    void restore_stored_slice_results();
     void on_export_began(wxCommandEvent&);
     void on_export_finished(wxCommandEvent&);
     void on_slicing_began();
@@ -4417,6 +4421,8 @@ std::vector<size_t> Plater::priv::load_files(const std::vector<fs::path>& input_
             }
         }
         else {
+            //restore the slicing results of the plates which did not change since they were sliced
+            restore_stored_slice_results();
             //set to 3d tab
             q->select_view_3D("3D");
             //select plate 0 as default
@@ -6719,6 +6725,39 @@ void Plater::priv::on_slicing_completed(wxCommandEvent & evt)
     BOOST_LOG_TRIVIAL(debug) << __FUNCTION__ << boost::format("exit.");
 }
 
+static std::string slice_result_store_dir()
+{
+    return (boost::filesystem::path(data_dir()) / "cache" / "slice_results").string();
+}
+
+void Plater::priv::store_slice_result()
+{
+    if (this->printer_technology != ptFFF || !wxGetApp().app_config->get_bool("slice_result_store"))
+        return;
+
+    const Print          *print  = this->background_process.fff_print();
+    GCodeProcessorResult *result = this->background_process.get_current_gcode_result();
+    if (print == nullptr || result == nullptr || !print->finished())
+        return;
+
+    SliceResultStore store(slice_result_store_dir());
+    std::string      key = SliceResultStore::key(*print);
+    //already stored, e.g. when the result was restored from the store
+    if (key.empty() || store.contains(key))
+        return;
+    store.store(key, this->background_process.get_current_plate()->get_tmp_gcode_path(), *result, print->print_statistics());
+}
+
+void Plater::priv::restore_stored_slice_results()
+{
+    if (this->printer_technology != ptFFF || !wxGetApp().app_config->get_bool("slice_result_store"))
+        return;
+
+    SliceResultStore store(slice_result_store_dir());
+    int count = partplate_list.load_stored_slice_results(store);
+    BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": restored %1% plates without slicing") % count;
+}
+
 void Plater::priv::on_export_began(wxCommandEvent& evt)
 {
     if (show_warning_dialog)
@@ -6890,6 +6929,8 @@ void Plater::priv::on_process_completed(SlicingProcessCompletedEvent &evt)
     //BBS: set the current plater's slice result to valid
     if (!this->background_process.empty())
         this->background_process.get_current_plate()->update_slice_result_valid_state(evt.success());
+    if (evt.success() && !this->background_process.empty())
+        this->store_slice_result();
 
     //BBS: update the action button according to the current plate's status
     bool ready_to_slice = !this->partplate_list.get_curr_plate()->is_slice_result_valid();
@@ -1177,6 +1177,8 @@ wxWindow* PreferencesDialog::create_general_page()
     auto item_gcodes_warning = create_item_checkbox(_L("No warnings when loading 3MF with modified G-codes"), page,_L("No warnings when loading 3MF with modified G-codes"), 50, "no_warn_when_modified_gcodes");
     auto item_backup  = create_item_checkbox(_L("Auto-Backup"), page,_L("Backup your project periodically for restoring from the occasional crash."), 50, "backup_switch");
     auto item_backup_interval = create_item_backup_input(_L("every"), page, _L("The peroid of backup in seconds."), "backup_interval");
+    auto item_slice_result_store = create_item_checkbox(_L("Reuse slicing results of unchanged projects"), page,
+        _L("Keep the G-code and the preview of sliced plates in the cache folder, so that reopening an unchanged project does not slice it again."), 50, "slice_result_store");
 
     //downloads
     auto title_downloads = create_item_title(_L("Downloads"), page, _L("Downloads"));
@@ -1245,6 +1247,7 @@ wxWindow* PreferencesDialog::create_general_page()
     sizer_page->Add(item_gcodes_warning, 0, wxTOP, FromDIP(3));
     sizer_page->Add(item_backup, 0, wxTOP,FromDIP(3));
     item_backup->Add(item_backup_interval, 0, wxLEFT, 0);
+    sizer_page->Add(item_slice_result_store, 0, wxTOP, FromDIP(3));
 
     sizer_page->Add(title_downloads, 0, wxTOP| wxEXPAND, FromDIP(20));
     sizer_page->Add(item_downloads, 0, wxEXPAND, FromDIP(3));
@@ -250,6 +250,7 @@ wxDEFINE_EVENT(EVT_PRINTHOST_PROGRESS, PrintHostQueueDialog::Event);
 wxDEFINE_EVENT(EVT_PRINTHOST_ERROR,    PrintHostQueueDialog::Event);
 wxDEFINE_EVENT(EVT_PRINTHOST_CANCEL,   PrintHostQueueDialog::Event);
 wxDEFINE_EVENT(EVT_PRINTHOST_INFO,  PrintHostQueueDialog::Event);
+wxDEFINE_EVENT(EVT_PRINTHOST_HOST_PROGRESS, PrintHostQueueDialog::Event);
 
 PrintHostQueueDialog::Event::Event(wxEventType eventType, int winid, size_t job_id)
     : wxEvent(winid, eventType)
@@ -286,6 +287,7 @@ PrintHostQueueDialog::PrintHostQueueDialog(wxWindow *parent)
     , on_error_evt(this, EVT_PRINTHOST_ERROR, &PrintHostQueueDialog::on_error, this)
     , on_cancel_evt(this, EVT_PRINTHOST_CANCEL, &PrintHostQueueDialog::on_cancel, this)
     , on_info_evt(this, EVT_PRINTHOST_INFO, &PrintHostQueueDialog::on_info, this)
+    , on_host_progress_evt(this, EVT_PRINTHOST_HOST_PROGRESS, &PrintHostQueueDialog::on_host_progress, this)
 {
     const auto em = GetTextExtent("m").x;
 
@@ -333,7 +335,10 @@ PrintHostQueueDialog::PrintHostQueueDialog(wxWindow *parent)
     btnsizer->AddStretchSpacer();
     btnsizer->Add(btn_close);
 
+    host_progress_text = new wxStaticText(this, wxID_ANY, wxEmptyString);
+
     topsizer->Add(job_list, 1, wxEXPAND | wxBOTTOM, SPACING);
+    topsizer->Add(host_progress_text, 0, wxEXPAND | wxBOTTOM, SPACING);
     topsizer->Add(btnsizer, 0, wxEXPAND);
     SetSizer(topsizer);
 
@@ -390,12 +395,17 @@ void PrintHostQueueDialog::append_job(const PrintHostJob &job)
     if (ec) {
         stream << "unknown";
         size_i = 0;
-        BOOST_LOG_TRIVIAL(error) << ec.message();
+        // A streamed G-code has no source file yet.
+        if (! job.upload_data.stream)
+            BOOST_LOG_TRIVIAL(error) << ec.message();
     } else 
         stream << std::fixed << std::setprecision(2) << ((float)size_i / 1024 / 1024) << "MB";
     fields.push_back(wxVariant(stream.str()));
     fields.push_back(wxVariant(from_path(job.upload_data.upload_path)));
-    fields.push_back(wxVariant(""));
+    // The G-code streamed while being exported differs from the exported file, see GCodeStream.
+    fields.push_back(wxVariant(job.upload_data.stream ?
+        _L("Uploaded while exporting: the file has no M73 progress lines and the total layer number is at the end of the file.") :
+        wxString()));
     job_list->AppendItem(fields, static_cast<wxUIntPtr>(ST_NEW));
     // Both strings are UTF-8 encoded.
     upload_names.emplace_back(job.printhost->get_host(), job.upload_data.upload_path.string());
@@ -519,6 +529,20 @@ void PrintHostQueueDialog::on_cancel(Event &evt)
     wxGetApp().notification_manager()->upload_job_notification_show_canceled(evt.job_id + 1, boost::nowide::narrow(nm.GetString()), boost::nowide::narrow(hst.GetString()));
 }
 
+void PrintHostQueueDialog::on_host_progress(Event &evt)
+{
+    host_progress[evt.tag] = evt.status;
+
+    wxString text;
+    for (const auto &[host, status] : host_progress) {
+        if (! text.empty())
+            text += "\n";
+        text += host + ": " + status;
+    }
+    host_progress_text->SetLabel(text);
+    Layout();
+}
+
 void PrintHostQueueDialog::on_info(Event& evt)
 {
     /*
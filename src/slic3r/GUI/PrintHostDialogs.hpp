@@ -1,6 +1,7 @@
 #ifndef slic3r_PrintHostSendDialog_hpp_
 #define slic3r_PrintHostSendDialog_hpp_
 
+#include <map>
 #include <set>
 #include <string>
 #include <boost/filesystem/path.hpp>
@@ -18,6 +19,7 @@ class wxTextCtrl;
 class wxChoice;
 class wxComboBox;
 class wxDataViewListCtrl;
+class wxStaticText;
 
 namespace Slic3r {
 
@@ -112,11 +114,15 @@ private:
     wxButton *btn_cancel;
     wxButton *btn_error;
     wxDataViewListCtrl *job_list;
+    // Progress of the uploads accumulated per host, one line per host, see PrintHostJobQueue.
+    wxStaticText *host_progress_text;
+    std::map<wxString, wxString> host_progress;
     // Note: EventGuard prevents delivery of progress evts to a freed PrintHostQueueDialog
     EventGuard on_progress_evt;
     EventGuard on_error_evt;
     EventGuard on_cancel_evt;
     EventGuard on_info_evt;
+    EventGuard on_host_progress_evt;
 
     JobState get_state(int idx);
     void set_state(int idx, JobState);
@@ -125,6 +131,7 @@ private:
     void on_error(Event&);
     void on_cancel(Event&);
     void on_info(Event&);
+    void on_host_progress(Event&);
     // This vector keep adress and filename of uploads. It is used when checking for running uploads during exit.
     std::vector<std::pair<std::string, std::string>> upload_names;
     void save_user_data(int);
@@ -135,6 +142,8 @@ wxDECLARE_EVENT(EVT_PRINTHOST_PROGRESS, PrintHostQueueDialog::Event);
 wxDECLARE_EVENT(EVT_PRINTHOST_ERROR, PrintHostQueueDialog::Event);
 wxDECLARE_EVENT(EVT_PRINTHOST_CANCEL, PrintHostQueueDialog::Event);
 wxDECLARE_EVENT(EVT_PRINTHOST_INFO, PrintHostQueueDialog::Event);
+// Progress of a host: tag is the host, status the progress summary.
+wxDECLARE_EVENT(EVT_PRINTHOST_HOST_PROGRESS, PrintHostQueueDialog::Event);
 }}
 
 #endif
@@ -21,6 +21,7 @@
 #include "slic3r/GUI/I18N.hpp"
 #include "slic3r/GUI/MsgDialog.hpp"
 #include "Http.hpp"
+#include "HttpMulti.hpp"
 
 namespace fs = boost::filesystem;
 namespace pt = boost::property_tree;
@@ -114,7 +115,7 @@ bool Duet::upload(PrintHostUpload upload_data, ProgressFn prorgess_fn, ErrorFn e
 				res = false;
 			}
 		})
-		.perform_sync();
+		.perform_sync(HttpMulti::shared());
 
 	disconnect(connectionType);
 
@@ -137,7 +138,7 @@ Duet::ConnectionType Duet::connect(wxString &msg) const
 				.on_complete([&](std::string body, unsigned) {
 					res = ConnectionType::dsf;
 				})
-				.perform_sync();
+				.perform_sync(HttpMulti::shared());
 		})
 		.on_complete([&](std::string body, unsigned) {
 			BOOST_LOG_TRIVIAL(debug) << boost::format("Duet: Got: %1%") % body;
@@ -159,7 +160,7 @@ Duet::ConnectionType Duet::connect(wxString &msg) const
 			}
 
 		})
-		.perform_sync();
+		.perform_sync(HttpMulti::shared());
 
 	return res;
 }
@@ -178,7 +179,7 @@ void Duet::disconnect(ConnectionType connectionType) const
 		// we don't care about it, if disconnect is not working Duet will disconnect automatically after some time
 		BOOST_LOG_TRIVIAL(error) << boost::format("Duet: Error disconnecting: %1%, HTTP %2%, body: `%3%`") % error % status % body;
 	})
-	.perform_sync();
+	.perform_sync(HttpMulti::shared());
 }
 
 std::string Duet::get_upload_url(const std::string &filename, ConnectionType connectionType) const
@@ -269,7 +270,7 @@ bool Duet::start_print(wxString &msg, const std::string &filename, ConnectionTyp
 			BOOST_LOG_TRIVIAL(debug) << boost::format("Duet: Got: %1%") % body;
 			res = true;
 		})
-		.perform_sync();
+		.perform_sync(HttpMulti::shared());
 
 	return res;
 }
@@ -17,6 +17,7 @@
 #include "slic3r/GUI/I18N.hpp"
 #include "slic3r/GUI/MsgDialog.hpp"
 #include "Http.hpp"
+#include "HttpMulti.hpp"
 #include "SerialMessage.hpp"
 
 namespace fs = boost::filesystem;
@@ -42,7 +43,7 @@ bool ESP3D::test(wxString& msg) const
             ret = false;
             msg = format_error(body , error, status);
         })
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
     return ret;
 }
 
@@ -90,7 +91,7 @@ bool ESP3D::upload(PrintHostUpload upload_data, ProgressFn prorgess_fn, ErrorFn
                 res = false;
             }
         })
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -115,7 +116,7 @@ bool ESP3D::start_print(wxString& msg, const std::string& filename) const
             ret = false;
             msg = (wxString::FromUTF8(error));
         })
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     if (!ret)
         return ret;
@@ -132,7 +133,7 @@ bool ESP3D::start_print(wxString& msg, const std::string& filename) const
             ret = false;
             msg = (wxString::FromUTF8(error));
         })
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return ret;
 }
@@ -1,4 +1,5 @@
 #include "Http.hpp"
+#include "HttpMulti.hpp"
 
 #include <cstdlib>
 #include <functional>
@@ -91,10 +92,15 @@ struct form_file
     fs::ifstream                          ifs;
     boost::filesystem::ifstream::off_type init_offset;
     size_t                                content_length;
+    Http::ReadFn                          read_fn;
 
     form_file(fs::path const& p, const boost::filesystem::ifstream::off_type offset, const size_t content_length)
         : ifs(p, std::ios::in | std::ios::binary), init_offset(offset), content_length(content_length)
     {}
+    // Data of unknown length produced while the request is in progress.
+    form_file(Http::ReadFn read_fn)
+        : init_offset(0), content_length(0), read_fn(std::move(read_fn))
+    {}
 };
 
 struct Http::priv
@@ -116,6 +122,7 @@ struct Http::priv
 	// Using a deque here because unlike vector it doesn't ivalidate pointers on insertion
 	std::deque<form_file> form_files;
 	std::string postfields;
+	std::string url;
 	std::string error_buffer;    // Used for CURLOPT_ERRORBUFFER
     std::string headers;
 	size_t limit;
@@ -142,17 +149,22 @@ struct Http::priv
 	void set_timeout_connect(long timeout);
     void set_timeout_max(long timeout);
 	void form_add_file(const char *name, const fs::path &path, const char* filename, boost::filesystem::ifstream::off_type offset, size_t length);
+	void form_add_stream(const char *name, const char *filename, Http::ReadFn read_fn);
 	/* mime */
 	void mime_form_add_text(const char* name, const char* value);
 	void mime_form_add_file(const char* name, const char* path);
 	void set_post_body(const fs::path &path);
 	void set_post_body(const std::string &body);
-	void set_put_body(const fs::path &path);
+	void set_put_body(const fs::path &path, boost::filesystem::ifstream::off_type offset, size_t length);
 	void set_del_body(const std::string& body);
     void set_range(const std::string &range);
 
 	std::string curl_error(CURLcode curlcode);
 	std::string body_size_error();
+	// Sets up the curl handle for the transfer, to be followed by either curl_easy_perform() or adding it to a curl multi handle.
+	void http_prepare();
+	// Reports the result of a finished transfer to the callbacks. Returns true if the request completed with a 2xx status.
+	bool http_finish(CURLcode res);
 	void http_perform();
 };
 
@@ -170,6 +182,7 @@ Http::priv::priv(const std::string &url)
 	, form_end(nullptr)
 	, mime(nullptr)
 	, headerlist(nullptr)
+	, url(url)
 	, error_buffer(CURL_ERROR_SIZE + 1, '\0')
 	, limit(0)
 	, cancel(false)
@@ -267,6 +280,14 @@ size_t Http::priv::form_file_read_cb(char *buffer, size_t size, size_t nitems, v
 {
     auto f = reinterpret_cast<form_file*>(userp);
 
+	if (f->read_fn) {
+		try {
+			return f->read_fn(buffer, size * nitems);
+		} catch (const std::exception &) {
+			return CURL_READFUNC_ABORT;
+		}
+	}
+
 	try {
 	    size_t max_read_size = size * nitems;
         if (f->content_length == 0) {
@@ -339,6 +360,21 @@ void Http::priv::form_add_file(const char *name, const fs::path &path, const cha
 	}
 }
 
+void Http::priv::form_add_stream(const char *name, const char *filename, Http::ReadFn read_fn)
+{
+	form_files.emplace_back(std::move(read_fn));
+	auto &f = form_files.back();
+
+	// Without CURLFORM_CONTENTSLENGTH curl sends the form with chunked transfer encoding.
+	::curl_formadd(&form, &form_end,
+		CURLFORM_COPYNAME, name,
+		CURLFORM_FILENAME, filename,
+		CURLFORM_CONTENTTYPE, "application/octet-stream",
+		CURLFORM_STREAM, static_cast<void*>(&f),
+		CURLFORM_END
+	);
+}
+
 void Http::priv::mime_form_add_text(const char* name, const char* value)
 {
 	if (!mime) {
@@ -380,15 +416,18 @@ void Http::priv::set_post_body(const std::string &body)
 	postfields = body;
 }
 
-void Http::priv::set_put_body(const fs::path &path)
+void Http::priv::set_put_body(const fs::path &path, boost::filesystem::ifstream::off_type offset, size_t length)
 {
 	boost::system::error_code ec;
 	boost::uintmax_t filesize = file_size(path, ec);
 	if (!ec) {
-        putFile = std::make_unique<form_file>(path, 0, 0);
+		if (length == 0)
+			length = size_t(filesize - std::min<boost::uintmax_t>(offset, filesize));
+        putFile = std::make_unique<form_file>(path, offset, length);
+        putFile->ifs.seekg(offset);
 		::curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
 		::curl_easy_setopt(curl, CURLOPT_READDATA, (void *) (putFile.get()));
-		::curl_easy_setopt(curl, CURLOPT_INFILESIZE, filesize);
+		::curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, curl_off_t(length));
 	}
 }
 
@@ -416,7 +455,7 @@ std::string Http::priv::body_size_error()
 	return (boost::format("HTTP body data size exceeded limit (%1% bytes)") % limit).str();
 }
 
-void Http::priv::http_perform()
+void Http::priv::http_prepare()
 {
 	::curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
 	::curl_easy_setopt(curl, CURLOPT_POSTREDIR, CURL_REDIR_POST_ALL);
@@ -457,8 +496,11 @@ void Http::priv::http_perform()
 		::curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postfields.c_str());
 		::curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, postfields.size());
 	}
+}
 
-	CURLcode res = ::curl_easy_perform(curl);
+bool Http::priv::http_finish(CURLcode res)
+{
+    bool success = false;
 
     putFile.reset();
 
@@ -485,6 +527,7 @@ void Http::priv::http_perform()
 
 		//BBS check success http status code
 		if (http_status >= 200 && http_status < 300) {
+			success = true;
 			if (completefn) { completefn(std::move(buffer), http_status); }
 			if (ipresolvefn) {
 				char* ct;
@@ -499,6 +542,14 @@ void Http::priv::http_perform()
 			if (errorfn) { errorfn(std::move(buffer), std::string(), http_status); }
 		}
 	}
+
+	return success;
+}
+
+void Http::priv::http_perform()
+{
+	http_prepare();
+	http_finish(::curl_easy_perform(curl));
 }
 
 Http::Http(const std::string &url) : p(new priv(url)) {
@@ -620,6 +671,12 @@ Http& Http::form_add_file(const std::string &name, const fs::path &path, boost::
 }
 
 
+Http& Http::form_add_stream(const std::string &name, const std::string &filename, ReadFn read_fn)
+{
+	if (p) { p->form_add_stream(name.c_str(), filename.c_str(), std::move(read_fn)); }
+	return *this;
+}
+
 Http& Http::mime_form_add_text(std::string &name, std::string &value)
 {
 	if (p) { p->mime_form_add_text(name.c_str(), value.c_str()); }
@@ -672,9 +729,9 @@ Http& Http::set_post_body(const std::string &body)
 	return *this;
 }
 
-Http& Http::set_put_body(const fs::path &path)
+Http& Http::set_put_body(const fs::path &path, boost::filesystem::ifstream::off_type offset, size_t length)
 {
-	if (p) { p->set_put_body(path);}
+	if (p) { p->set_put_body(path, offset, length);}
 	return *this;
 }
 
@@ -733,6 +790,32 @@ void Http::perform_sync()
 	if (p) { p->http_perform(); }
 }
 
+void Http::perform_sync(HttpMulti &multi)
+{
+	if (p) { multi.perform_sync(std::move(*this)); }
+}
+
+void* Http::multi_prepare()
+{
+	p->http_prepare();
+	return p->curl;
+}
+
+bool Http::multi_finish(int curl_code)
+{
+	return p->http_finish(CURLcode(curl_code));
+}
+
+const std::string& Http::multi_url() const
+{
+	return p->url;
+}
+
+Http::ProgressFn& Http::multi_progressfn()
+{
+	return p->progressfn;
+}
+
 void Http::cancel()
 {
 	if (p) { p->cancel = true; }
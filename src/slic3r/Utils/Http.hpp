@@ -32,6 +32,8 @@ enum HttpErrorCode
 	HttpErrorVersionLimited		= 15,
 };
 
+class HttpMulti;
+
 /// Represetns a Http request
 class Http : public std::enable_shared_from_this<Http> {
 private:
@@ -73,6 +75,10 @@ public:
 
 	typedef std::function<void(std::string headers)> HeaderCallbackFn;
 
+	// Reads at most `size` bytes of a streamed request body into `buffer`, returns the number of bytes read,
+	// zero at the end of the data. Blocks until some data is available. Throwing an exception aborts the request.
+	typedef std::function<size_t(char* /* buffer */, size_t /* size */)> ReadFn;
+
 	Http(Http &&other);
 
 	// Note: strings are expected to be UTF-8-encoded
@@ -123,6 +129,9 @@ public:
 	Http& form_add(const std::string &name, const std::string &contents);
 	// Add a HTTP multipart form file data contents, `name` is the name of the part
 	Http& form_add_file(const std::string &name, const boost::filesystem::path &path, boost::filesystem::ifstream::off_type offset = 0, size_t length = 0);
+	// Add a HTTP multipart form file part, whose data of an unknown size are read by `read_fn` while the request is in progress.
+	// The request is sent with chunked transfer encoding.
+	Http& form_add_stream(const std::string &name, const std::string &filename, ReadFn read_fn);
 	// Add a HTTP mime form field
 	Http& mime_form_add_text(std::string& name, std::string& value);
 	// Add a HTTP mime form file
@@ -151,7 +160,8 @@ public:
 	// Set the file contents as a PUT request body.
 	// The data is used verbatim, it is not additionally encoded in any way.
 	// This can be used for hosts which do not support multipart requests.
-	Http& set_put_body(const boost::filesystem::path &path);
+	// If `length` is non-zero, only `length` bytes starting at `offset` are sent, f.e. for a chunked upload.
+	Http& set_put_body(const boost::filesystem::path &path, boost::filesystem::ifstream::off_type offset = 0, size_t length = 0);
 
 	// Set the file contents as a DELETE request body.
 	// The data is used verbatim, it is not additionally encoded in any way.
@@ -178,6 +188,9 @@ public:
 	Ptr perform();
 	// Starts performing the request on the current thread
 	void perform_sync();
+	// Performs the request on the worker thread of `multi` and waits for it to finish.
+	// The callbacks are called from the worker thread, the connection to the host is kept open for the next request.
+	void perform_sync(HttpMulti &multi);
 	// Cancels a request in progress
 	void cancel();
 
@@ -197,6 +210,15 @@ private:
 	Http(const std::string &url);
 
 	std::unique_ptr<priv> p;
+
+	// Interface for HttpMulti, which drives the curl handle of the request from its own worker thread.
+	friend class HttpMulti;
+	// Sets up the request and returns its curl easy handle.
+	void*       multi_prepare();
+	// Reports the result of the transfer to the callbacks, returns true if the request completed with a 2xx status.
+	bool        multi_finish(int curl_code);
+	const std::string& multi_url() const;
+	ProgressFn& multi_progressfn();
 };
 
 std::ostream& operator<<(std::ostream &, const Http::Progress &);
@@ -0,0 +1,502 @@
+#include "HttpMulti.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <curl/curl.h>
+
+namespace fs = boost::filesystem;
+
+namespace Slic3r {
+
+struct HttpMulti::priv
+{
+    // A queued or running request, or a chunked upload running one chunk request at a time.
+    struct Transfer
+    {
+        std::string           host;
+        std::unique_ptr<Http> http;
+        ::CURL               *curl { nullptr };
+        bool                  cancelled { false };
+        bool                  done { false };
+        // Progress of this transfer as accounted in the HostProgress of its host.
+        size_t                ulnow { 0 };
+        size_t                ultotal { 0 };
+
+        // Chunked upload
+        std::unique_ptr<HttpMulti::ChunkedUpload> chunked;
+        size_t                total { 0 };
+        size_t                chunk_offset { 0 };
+        size_t                chunk_length { 0 };
+        unsigned              retries { 0 };
+        std::string           body;
+        unsigned              status { 0 };
+        std::string           error;
+    };
+
+    ::CURLM                               *multi;
+    size_t                                 max_connections;
+    size_t                                 max_host_connections;
+
+    // Guards everything below.
+    mutable std::mutex                     mutex;
+    std::condition_variable                cond_work;
+    std::condition_variable                cond_done;
+    std::deque<std::shared_ptr<Transfer>>  queue;
+    std::vector<std::shared_ptr<Transfer>> running;
+    std::map<std::string, HostProgress>    hosts;
+    HostProgressFn                         host_progress_fn;
+    size_t                                 connections { 0 };
+    bool                                   exit { false };
+
+    std::thread                            worker;
+
+    priv(size_t max_connections, size_t max_host_connections);
+    ~priv();
+
+    std::shared_ptr<Transfer> make_transfer(Http &&http);
+    // Queues the transfer for the worker thread. Returns false without queuing it if the engine was shut down,
+    // the worker thread may have exited already.
+    bool enqueue(const std::shared_ptr<Transfer> &transfer);
+    // Reports a transfer that was not queued as cancelled through its callbacks.
+    void reject(Transfer &transfer);
+    // Moves the queued transfers to the multi handle as long as there are free connections. Called with the mutex locked.
+    void activate(std::vector<std::string> &changed_hosts);
+    // Sets up the request of the transfer and adds it to the multi handle.
+    void start(Transfer &transfer);
+    // Creates the request of the next chunk of a chunked upload.
+    void make_chunk_request(Transfer &transfer);
+    void finish(Transfer &transfer, CURLcode result);
+    void update_progress(Transfer &transfer, size_t ulnow, size_t ultotal);
+    void notify_hosts(const std::vector<std::string> &hosts);
+    void worker_main();
+};
+
+HttpMulti::priv::priv(size_t max_connections, size_t max_host_connections)
+    : multi(nullptr)
+    , max_connections(std::max<size_t>(max_connections, 1))
+    , max_host_connections(std::max<size_t>(std::min(max_connections, max_host_connections), 1))
+{
+    Http::tls_global_init();
+
+    multi = ::curl_multi_init();
+    if (multi == nullptr)
+        throw Slic3r::RuntimeError(std::string("Could not construct Curl multi object"));
+    ::curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, long(this->max_connections));
+    ::curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, long(this->max_host_connections));
+    // Size of the cache of the connections kept alive for reuse.
+    ::curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, long(this->max_connections));
+
+    worker = std::thread([this]() { this->worker_main(); });
+}
+
+HttpMulti::priv::~priv()
+{
+    ::curl_multi_cleanup(multi);
+}
+
+std::shared_ptr<HttpMulti::priv::Transfer> HttpMulti::priv::make_transfer(Http &&http)
+{
+    auto transfer  = std::make_shared<Transfer>();
+    transfer->host = host_of(http.multi_url());
+    transfer->http = std::make_unique<Http>(std::move(http));
+    Transfer *t = transfer.get();
+    Http::ProgressFn &progressfn = t->http->multi_progressfn();
+    progressfn = [this, t, user_fn = std::move(progressfn)](Http::Progress progress, bool &cancel) {
+        if (user_fn)
+            user_fn(progress, cancel);
+        if (t->cancelled)
+            cancel = true;
+        else if (! cancel)
+            this->update_progress(*t, progress.ulnow, progress.ultotal);
+    };
+    return transfer;
+}
+
+bool HttpMulti::priv::enqueue(const std::shared_ptr<Transfer> &transfer)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (exit)
+            return false;
+        ++ hosts[transfer->host].queued;
+        queue.emplace_back(transfer);
+    }
+    cond_work.notify_one();
+    ::curl_multi_wakeup(multi);
+    return true;
+}
+
+void HttpMulti::priv::reject(Transfer &transfer)
+{
+    if (transfer.chunked) {
+        if (transfer.chunked->on_error)
+            transfer.chunked->on_error(std::string("Upload cancelled"), transfer.chunk_offset);
+    } else {
+        transfer.http->cancel();
+        transfer.http->perform_sync();
+    }
+}
+
+void HttpMulti::priv::activate(std::vector<std::string> &changed_hosts)
+{
+    for (auto it = queue.begin(); it != queue.end() && running.size() < max_connections;) {
+        HostProgress &host = hosts[(*it)->host];
+        if (host.running < max_host_connections) {
+            -- host.queued;
+            ++ host.running;
+            changed_hosts.emplace_back((*it)->host);
+            running.emplace_back(std::move(*it));
+            it = queue.erase(it);
+            this->start(*running.back());
+        } else
+            ++ it;
+    }
+}
+
+void HttpMulti::priv::start(Transfer &transfer)
+{
+    transfer.curl = static_cast<::CURL*>(transfer.http->multi_prepare());
+    ::curl_easy_setopt(transfer.curl, CURLOPT_PRIVATE, static_cast<void*>(&transfer));
+    if (transfer.cancelled)
+        transfer.http->cancel();
+    ::curl_multi_add_handle(multi, transfer.curl);
+}
+
+void HttpMulti::priv::make_chunk_request(Transfer &transfer)
+{
+    transfer.chunk_length = std::min(transfer.chunked->chunk_size, transfer.total - transfer.chunk_offset);
+    transfer.http         = std::make_unique<Http>(transfer.chunked->make_request(transfer.chunk_offset, transfer.chunk_length, transfer.total));
+    transfer.body.clear();
+    transfer.error.clear();
+    transfer.status = 0;
+    Transfer *t = &transfer;
+    transfer.http->on_complete([t](std::string body, unsigned status) {
+            t->body   = std::move(body);
+            t->status = status;
+        })
+        .on_error([t](std::string body, std::string error, unsigned status) {
+            t->status = status;
+            t->error  = error.empty() ? (boost::format("HTTP %1%: %2%") % status % body).str() : std::move(error);
+        });
+    Http::ProgressFn &progressfn = transfer.http->multi_progressfn();
+    progressfn = [this, t, user_fn = std::move(progressfn)](Http::Progress progress, bool &cancel) {
+        if (user_fn)
+            user_fn(progress, cancel);
+        if (t->cancelled)
+            cancel = true;
+        else if (! cancel)
+            this->update_progress(*t, t->chunk_offset + progress.ulnow, t->total);
+    };
+}
+
+void HttpMulti::priv::finish(Transfer &transfer, CURLcode result)
+{
+    ::curl_multi_remove_handle(multi, transfer.curl);
+    long connects = 0;
+    ::curl_easy_getinfo(transfer.curl, CURLINFO_NUM_CONNECTS, &connects);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        connections += size_t(connects);
+    }
+
+    // Calls the callbacks of the request.
+    bool success = transfer.http->multi_finish(int(result));
+    transfer.http.reset();
+    transfer.curl = nullptr;
+
+    if (success && ! transfer.chunked)
+        this->update_progress(transfer, transfer.ultotal, transfer.ultotal);
+
+    if (transfer.chunked) {
+        if (success) {
+            transfer.chunk_offset += transfer.chunk_length;
+            transfer.retries = 0;
+            this->update_progress(transfer, transfer.chunk_offset, transfer.total);
+        } else if (transfer.cancelled || transfer.retries == transfer.chunked->max_retries) {
+            BOOST_LOG_TRIVIAL(error) << boost::format("HttpMulti: Upload of %1% to %2% failed at offset %3%: %4%")
+                % transfer.chunked->path % transfer.host % transfer.chunk_offset % transfer.error;
+        } else {
+            ++ transfer.retries;
+            BOOST_LOG_TRIVIAL(warning) << boost::format("HttpMulti: Resuming upload of %1% to %2% from offset %3%, retry %4%: %5%")
+                % transfer.chunked->path % transfer.host % transfer.chunk_offset % transfer.retries % transfer.error;
+            // Restart the failed chunk on the connection slot of the transfer.
+            success = true;
+        }
+        if (success && transfer.chunk_offset < transfer.total) {
+            this->make_chunk_request(transfer);
+            this->start(transfer);
+            return;
+        }
+        if (success && transfer.chunked->on_complete)
+            transfer.chunked->on_complete(std::move(transfer.body), transfer.status);
+        else if (transfer.chunked->on_error)
+            transfer.chunked->on_error(transfer.cancelled ? std::string("Upload cancelled") : std::move(transfer.error), transfer.chunk_offset);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        HostProgress &host = hosts[transfer.host];
+        -- host.running;
+        ++ (success ? host.finished : host.failed);
+    }
+    // Report the final progress before anybody waiting for the transfer wakes up.
+    this->notify_hosts({ transfer.host });
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        transfer.done = true;
+        auto it = std::find_if(running.begin(), running.end(), [&transfer](const std::shared_ptr<Transfer> &t) { return t.get() == &transfer; });
+        assert(it != running.end());
+        // Keep the transfer alive until the end of this function.
+        std::shared_ptr<Transfer> self = std::move(*it);
+        running.erase(it);
+    }
+    cond_done.notify_all();
+}
+
+void HttpMulti::priv::update_progress(Transfer &transfer, size_t ulnow, size_t ultotal)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ulnow == transfer.ulnow && ultotal == transfer.ultotal)
+            return;
+        HostProgress &host = hosts[transfer.host];
+        // Unsigned arithmetic is modular, the sums end up correct even if a transfer reports less than before.
+        host.ulnow        += ulnow - transfer.ulnow;
+        host.ultotal      += ultotal - transfer.ultotal;
+        transfer.ulnow     = ulnow;
+        transfer.ultotal   = ultotal;
+    }
+    this->notify_hosts({ transfer.host });
+}
+
+void HttpMulti::priv::notify_hosts(const std::vector<std::string> &changed_hosts)
+{
+    for (const std::string &name : changed_hosts) {
+        HostProgressFn fn;
+        HostProgress   progress;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fn       = host_progress_fn;
+            progress = hosts[name];
+        }
+        if (fn)
+            fn(name, progress);
+    }
+}
+
+void HttpMulti::priv::worker_main()
+{
+    std::vector<std::string> changed_hosts;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        changed_hosts.clear();
+        this->activate(changed_hosts);
+        if (running.empty()) {
+            if (exit)
+                break;
+            if (queue.empty()) {
+                // Idle, sleep until a request arrives.
+                cond_work.wait(lock, [this]() { return exit || ! queue.empty(); });
+                continue;
+            }
+        }
+        lock.unlock();
+        this->notify_hosts(changed_hosts);
+
+        int still_running = 0;
+        ::curl_multi_perform(multi, &still_running);
+        int      msgs_left = 0;
+        CURLMsg *msg;
+        while ((msg = ::curl_multi_info_read(multi, &msgs_left)) != nullptr)
+            if (msg->msg == CURLMSG_DONE) {
+                Transfer *transfer = nullptr;
+                ::curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&transfer));
+                this->finish(*transfer, msg->data.result);
+            }
+        // Sleeps until there is activity on the sockets, curl_multi_wakeup() is called or a timeout elapses.
+        ::curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+
+        lock.lock();
+    }
+}
+
+HttpMulti::HttpMulti(size_t max_connections, size_t max_host_connections)
+    : p(new priv(max_connections, max_host_connections))
+{}
+
+HttpMulti::~HttpMulti()
+{
+    this->shutdown();
+}
+
+void HttpMulti::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(p->mutex);
+        p->exit = true;
+    }
+    this->cancel_all();
+    p->cond_work.notify_one();
+    ::curl_multi_wakeup(p->multi);
+    if (p->worker.joinable() && std::this_thread::get_id() != p->worker.get_id())
+        p->worker.join();
+}
+
+bool HttpMulti::is_shut_down() const
+{
+    std::lock_guard<std::mutex> lock(p->mutex);
+    return p->exit;
+}
+
+HttpMulti& HttpMulti::shared()
+{
+    // Two connections per host, so that a test of a host is not blocked by an upload to it.
+    // The engine is shut down by the application at exit, the destructor then finds the worker thread finished.
+    static HttpMulti instance(16, 2);
+    return instance;
+}
+
+size_t HttpMulti::max_connections() const
+{
+    return p->max_connections;
+}
+
+size_t HttpMulti::max_host_connections() const
+{
+    return p->max_host_connections;
+}
+
+void HttpMulti::add(Http &&http)
+{
+    if (! http.p)
+        return;
+    if (this->is_shut_down()) {
+        // Report the request as cancelled through its callbacks.
+        http.cancel();
+        http.perform_sync();
+        return;
+    }
+    std::shared_ptr<priv::Transfer> transfer = p->make_transfer(std::move(http));
+    if (! p->enqueue(transfer))
+        // Shut down since the check above.
+        p->reject(*transfer);
+}
+
+void HttpMulti::add(ChunkedUpload upload)
+{
+    auto transfer          = std::make_shared<priv::Transfer>();
+    boost::system::error_code ec;
+    transfer->total        = size_t(fs::file_size(upload.path, ec));
+    transfer->chunk_offset = std::min(upload.offset, transfer->total);
+    if (ec || this->is_shut_down()) {
+        if (upload.on_error)
+            upload.on_error(ec ? ec.message() : std::string("Upload cancelled"), upload.offset);
+        return;
+    }
+    upload.chunk_size  = std::max<size_t>(upload.chunk_size, 1);
+    transfer->chunked  = std::make_unique<ChunkedUpload>(std::move(upload));
+    p->make_chunk_request(*transfer);
+    transfer->host     = host_of(transfer->http->multi_url());
+    if (! p->enqueue(transfer))
+        p->reject(*transfer);
+}
+
+void HttpMulti::perform_sync(Http &&http)
+{
+    if (std::this_thread::get_id() == p->worker.get_id()) {
+        // Called from a callback of another request. Waiting for the worker thread would dead lock.
+        http.perform_sync();
+        return;
+    }
+    if (! http.p)
+        return;
+    if (this->is_shut_down()) {
+        // The worker thread is gone, report the request as cancelled through its callbacks.
+        http.cancel();
+        http.perform_sync();
+        return;
+    }
+    std::shared_ptr<priv::Transfer> transfer = p->make_transfer(std::move(http));
+    if (! p->enqueue(transfer)) {
+        // Shut down since the check above, nobody would finish the transfer.
+        p->reject(*transfer);
+        return;
+    }
+    std::unique_lock<std::mutex> lock(p->mutex);
+    p->cond_done.wait(lock, [&transfer]() { return transfer->done; });
+}
+
+void HttpMulti::wait_all()
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    p->cond_done.wait(lock, [this]() { return p->queue.empty() && p->running.empty(); });
+}
+
+void HttpMulti::cancel_all()
+{
+    std::lock_guard<std::mutex> lock(p->mutex);
+    for (const std::shared_ptr<priv::Transfer> &t : p->queue)
+        t->cancelled = true;
+    for (const std::shared_ptr<priv::Transfer> &t : p->running) {
+        t->cancelled = true;
+        if (t->http)
+            t->http->cancel();
+    }
+}
+
+void HttpMulti::on_host_progress(HostProgressFn fn)
+{
+    std::lock_guard<std::mutex> lock(p->mutex);
+    p->host_progress_fn = std::move(fn);
+}
+
+HttpMulti::HostProgress HttpMulti::host_progress(const std::string &host) const
+{
+    std::lock_guard<std::mutex> lock(p->mutex);
+    auto it = p->hosts.find(host);
+    return it == p->hosts.end() ? HostProgress() : it->second;
+}
+
+std::map<std::string, HttpMulti::HostProgress> HttpMulti::progress() const
+{
+    std::lock_guard<std::mutex> lock(p->mutex);
+    return p->hosts;
+}
+
+size_t HttpMulti::connections_opened() const
+{
+    std::lock_guard<std::mutex> lock(p->mutex);
+    return p->connections;
+}
+
+std::string HttpMulti::host_of(const std::string &url)
+{
+    std::string out = url;
+    if (::CURLU *h = ::curl_url()) {
+        if (::curl_url_set(h, CURLUPART_URL, url.c_str(), CURLU_GUESS_SCHEME) == CURLUE_OK) {
+            char *scheme = nullptr;
+            char *host   = nullptr;
+            char *port   = nullptr;
+            if (::curl_url_get(h, CURLUPART_SCHEME, &scheme, 0) == CURLUE_OK &&
+                ::curl_url_get(h, CURLUPART_HOST, &host, 0) == CURLUE_OK &&
+                ::curl_url_get(h, CURLUPART_PORT, &port, CURLU_DEFAULT_PORT) == CURLUE_OK)
+                out = boost::algorithm::to_lower_copy(std::string(scheme) + "://" + host + ":" + port);
+            ::curl_free(scheme);
+            ::curl_free(host);
+            ::curl_free(port);
+        }
+        ::curl_url_cleanup(h);
+    }
+    return out;
+}
+
+}
@@ -0,0 +1,101 @@
+#ifndef slic3r_HttpMulti_hpp_
+#define slic3r_HttpMulti_hpp_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <functional>
+#include <boost/filesystem/path.hpp>
+
+#include "Http.hpp"
+
+namespace Slic3r {
+
+/// Performs many Http requests concurrently on a single worker thread using the curl multi interface.
+/// Requests to the same host reuse the open connections (HTTP keep-alive) of the connection cache of the multi handle.
+/// The number of requests running in parallel is bounded both in total and per host, the other requests wait in a queue
+/// in the order they were added. Progress is accumulated per host, so that uploading the same file to a farm of printers
+/// may be reported printer by printer.
+class HttpMulti
+{
+public:
+    // Upload of a file in consecutive chunks, each chunk being a single request created by `make_request`.
+    // None of the supported print hosts accepts chunked uploads yet, the print hosts upload a file by a single request.
+    // A chunk that failed is retried from its start up to `max_retries` times, an upload that failed for good
+    // reports the offset from which it may be resumed later by another ChunkedUpload.
+    struct ChunkedUpload
+    {
+        boost::filesystem::path path;
+        size_t                  chunk_size { 8 * 1024 * 1024 };
+        // Offset to start the upload from, f.e. the offset reported by a previous failed upload.
+        size_t                  offset { 0 };
+        unsigned                max_retries { 3 };
+        // Creates the request uploading `length` bytes starting at `offset` of the file of `total` bytes.
+        // The request shall not set on_complete() / on_error(), these are handled by HttpMulti.
+        std::function<Http(size_t /* offset */, size_t /* length */, size_t /* total */)> make_request;
+        // Called with the response to the last chunk.
+        Http::CompleteFn                                                                    on_complete;
+        // Called once the upload failed for good or was cancelled. `offset` is where the upload may be resumed.
+        std::function<void(std::string /* error */, size_t /* offset */)>                   on_error;
+    };
+
+    struct HostProgress
+    {
+        size_t ulnow    { 0 };  // Bytes uploaded to the host so far
+        size_t ultotal  { 0 };  // Bytes to upload to the host by the requests started so far
+        size_t queued   { 0 };  // Requests waiting for a free connection
+        size_t running  { 0 };
+        size_t finished { 0 };
+        size_t failed   { 0 };
+    };
+    // Called from the worker thread whenever the progress of a host changes.
+    // The upload queue dialog shows the progress per host below the list of jobs.
+    typedef std::function<void(const std::string & /* host */, const HostProgress &)> HostProgressFn;
+
+    HttpMulti(size_t max_connections = 8, size_t max_host_connections = 1);
+    HttpMulti(const HttpMulti &) = delete;
+    HttpMulti& operator=(const HttpMulti &) = delete;
+    // Cancels the requests in progress and waits for the worker thread to finish.
+    ~HttpMulti();
+
+    // Engine shared by the print hosts. The application shuts it down at exit, so that its worker thread
+    // is not joined during static destruction.
+    static HttpMulti& shared();
+
+    // Cancels the queued and running requests and joins the worker thread. The requests added afterwards
+    // are reported as cancelled right away. Called by the destructor.
+    void shutdown();
+    bool is_shut_down() const;
+
+    size_t max_connections() const;
+    size_t max_host_connections() const;
+
+    // Queues the request. The callbacks of the request are called from the worker thread.
+    void add(Http &&http);
+    // Queues a chunked upload.
+    void add(ChunkedUpload upload);
+    // Performs the request and waits for it to finish. When called from the worker thread (from a callback
+    // of another request), the request is performed right away on the calling thread.
+    void perform_sync(Http &&http);
+    // Waits for all the queued requests to finish.
+    void wait_all();
+    // Cancels the queued and running requests.
+    void cancel_all();
+
+    void         on_host_progress(HostProgressFn fn);
+    HostProgress host_progress(const std::string &host) const;
+    std::map<std::string, HostProgress> progress() const;
+    // Number of connections opened so far. Lower than the number of requests when connections were reused.
+    size_t       connections_opened() const;
+
+    // Key identifying the host of the URL: scheme, host name and port.
+    static std::string host_of(const std::string &url);
+
+private:
+    struct priv;
+    std::unique_ptr<priv> p;
+};
+
+}
+
+#endif
@@ -25,6 +25,7 @@
 #include "slic3r/GUI/I18N.hpp"
 #include "slic3r/GUI/MsgDialog.hpp"
 #include "Http.hpp"
+#include "HttpMulti.hpp"
 #include "SerialMessage.hpp"
 #include "SerialMessageType.hpp"
 
@@ -107,7 +108,7 @@ bool MKS::upload(PrintHostUpload upload_data, ProgressFn prorgess_fn, ErrorFn er
 				BOOST_LOG_TRIVIAL(info) << "MKS: Upload canceled";
 				res = false;
 			}
-		}).perform_sync();
+		}).perform_sync(HttpMulti::shared());
 
 
 	return res;
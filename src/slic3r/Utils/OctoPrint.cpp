@@ -21,7 +21,9 @@
 #include "slic3r/GUI/GUI_App.hpp"
 #include "slic3r/GUI/format.hpp"
 #include "Http.hpp"
+#include "HttpMulti.hpp"
 #include "libslic3r/AppConfig.hpp"
+#include "libslic3r/GCode/GCodeStream.hpp"
 #include "Bonjour.hpp"
 #include "slic3r/GUI/BonjourDialog.hpp"
 
@@ -227,7 +229,7 @@ bool OctoPrint::test_with_resolved_ip(wxString &msg) const
             }
         })
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -283,7 +285,7 @@ bool OctoPrint::test(wxString& msg) const
             msg = GUI::from_u8(address);
         })
 #endif // WIN32
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -306,6 +308,10 @@ bool OctoPrint::upload(PrintHostUpload upload_data, ProgressFn prorgess_fn, Erro
 #ifndef WIN32
     return upload_inner_with_host(std::move(upload_data), prorgess_fn, error_fn, info_fn);
 #else
+    if (upload_data.stream)
+        // A stream can be read only once, thus it is not possible to retry the upload with another of the resolved addresses.
+        return upload_inner_with_host(std::move(upload_data), prorgess_fn, error_fn, info_fn);
+
     std::string host = get_host_from_url(m_host);
 
     // decide what to do based on m_host - resolve hostname or upload to ip
@@ -423,7 +429,7 @@ bool OctoPrint::upload_inner_with_resolved_ip(PrintHostUpload upload_data, Progr
             }
         })
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return result;
 }
@@ -491,9 +497,12 @@ bool OctoPrint::upload_inner_with_host(PrintHostUpload upload_data, ProgressFn p
 #endif // _WIN32
     set_auth(http);
     http.form_add("print", upload_data.post_action == PrintHostPostUploadAction::StartPrint ? "true" : "false")
-        .form_add("path", upload_parent_path.string())      // XXX: slashes on windows ???
-        .form_add_file("file", upload_data.source_path.string(), upload_filename.string())
-        .on_complete([&](std::string body, unsigned status) {
+        .form_add("path", upload_parent_path.string());     // XXX: slashes on windows ???
+    if (upload_data.stream)
+        http.form_add_stream("file", upload_filename.string(), [stream = upload_data.stream](char *buffer, size_t size) { return stream->read(buffer, size); });
+    else
+        http.form_add_file("file", upload_data.source_path.string(), upload_filename.string());
+    http.on_complete([&](std::string body, unsigned status) {
             BOOST_LOG_TRIVIAL(debug) << boost::format("%1%: File uploaded: HTTP %2%: %3%") % name % status % body;
         })
         .on_error([&](std::string body, std::string error, unsigned status) {
@@ -512,7 +521,12 @@ bool OctoPrint::upload_inner_with_host(PrintHostUpload upload_data, ProgressFn p
 #ifdef WIN32
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
 #endif
-        .perform_sync();
+        ;
+    if (upload_data.stream)
+        // Reading the stream blocks until the G-code export produces more data, which would stall the other transfers of the shared engine.
+        http.perform_sync();
+    else
+        http.perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -688,7 +702,7 @@ bool PrusaLink::test(wxString& msg) const
             msg = GUI::from_u8(address);
         })
 #endif // WIN32
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
      return res;
 }
@@ -771,7 +785,7 @@ bool PrusaLink::get_storage(wxArrayString& storage_path, wxArrayString& storage_
     .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
 
 #endif // WIN32
-    .perform_sync();
+    .perform_sync(HttpMulti::shared());
 
     for (const auto& si : storage) {
         if (!si.read_only && si.free_space > 0) {
@@ -864,7 +878,7 @@ bool PrusaLink::test_with_method_check(wxString& msg, bool& use_put) const
         msg = GUI::from_u8(address);
     })
 #endif // WIN32
-    .perform_sync();
+    .perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -939,7 +953,7 @@ bool PrusaLink::test_with_resolved_ip_and_method_check(wxString& msg, bool& use_
 
         })
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -1085,7 +1099,7 @@ bool PrusaLink::put_inner(PrintHostUpload upload_data, std::string url, const st
 #ifdef WIN32
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
 #endif
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -1144,7 +1158,7 @@ bool PrusaLink::post_inner(PrintHostUpload upload_data, std::string url, const s
 #ifdef WIN32
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
 #endif
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
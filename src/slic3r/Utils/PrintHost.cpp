@@ -1,5 +1,11 @@
 #include "PrintHost.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <map>
+#include <set>
 #include <vector>
 #include <thread>
 #include <exception>
@@ -13,6 +19,8 @@
 
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/Channel.hpp"
+#include "libslic3r/GCode/GCodeStream.hpp"
+#include "HttpMulti.hpp"
 #include "OctoPrint.hpp"
 #include "Duet.hpp"
 #include "FlashAir.hpp"
@@ -22,6 +30,8 @@
 #include "ESP3D.hpp"
 #include "../GUI/PrintHostDialogs.hpp"
 #include "../GUI/MainFrame.hpp"
+#include "../GUI/I18N.hpp"
+#include "../GUI/format.hpp"
 #include "Obico.hpp"
 #include "Flashforge.hpp"
 #include "SimplyPrint.hpp"
@@ -83,64 +93,96 @@ wxString PrintHost::format_error(const std::string &body, const std::string &err
 
 struct PrintHostJobQueue::priv
 {
-    // XXX: comment on how bg thread works
+    // The background thread picks up the jobs from channel_jobs and starts a worker thread for the first waiting job
+    // whose host is not busy. Jobs to different hosts run in parallel, bounded by the connection limit of
+    // HttpMulti::shared() which performs the HTTP requests of the print hosts and keeps the connections open.
+    // Jobs to the same host run one after another in the order they were enqueued.
 
     PrintHostJobQueue *q;
 
     Channel<PrintHostJob> channel_jobs;
-    Channel<size_t> channel_cancels;
+    // Id of the next job picked up from channel_jobs, the ids match the rows of the queue dialog.
     size_t job_id = 0;
-    int prev_progress = -1;
-    fs::path source_to_remove;
 
     std::thread bg_thread;
-    bool bg_exit = false;
+    std::atomic<bool> bg_exit { false };
+
+    // Guards the job bookkeeping below.
+    std::mutex mutex;
+    // Notified when a job finishes, when a job is enqueued and when the queue is being stopped.
+    std::condition_variable cond_finished;
+    std::set<size_t> cancelled_ids;
+    std::set<size_t> running_ids;
+    std::set<size_t> finished_ids;
+    std::set<std::string> busy_hosts;
+    // Worker threads of the running jobs and of the finished jobs not joined yet by the background thread.
+    std::map<size_t, std::thread> job_threads;
+    // Streams of the streamed uploads picked up from channel_jobs and not finished yet. A running upload may be blocked
+    // reading its stream, thus it is cancelled by aborting the stream instead of from its progress callback.
+    std::map<size_t, std::shared_ptr<GCodeStream>> streams;
 
     PrintHostQueueDialog *queue_dialog;
 
     priv(PrintHostJobQueue *q) : q(q) {}
 
-    void emit_progress(int progress);
-    void emit_error(wxString error);
+    void emit_progress(size_t id, int progress);
+    void emit_error(size_t id, wxString error);
     void emit_cancel(size_t id);
-    void emit_info(wxString tag, wxString status);
+    void emit_info(size_t id, wxString tag, wxString status);
     void start_bg_thread();
     void stop_bg_thread();
-    void bg_thread_main();
-    void progress_fn(Http::Progress progress, bool &cancel);
-    void error_fn(wxString error);
-    void info_fn(wxString tag, wxString status);
+    void bg_thread_main(std::shared_ptr<priv> self);
+    void skip_job(PrintHostJob &job, size_t id);
+    void run_job(std::shared_ptr<priv> self, PrintHostJob job, size_t id, std::string host);
+    void join_finished_jobs();
+    bool is_cancelled(size_t id);
+    void progress_fn(size_t id, int &prev_progress, Http::Progress progress, bool &cancel);
+    void error_fn(size_t id, wxString error);
+    void info_fn(size_t id, wxString tag, wxString status);
     void remove_source(const fs::path &path);
-    void remove_source();
-    void perform_job(PrintHostJob the_job);
+    void perform_job(PrintHostJob the_job, size_t id);
 };
 
 PrintHostJobQueue::PrintHostJobQueue(PrintHostQueueDialog *queue_dialog)
     : p(new priv(this))
 {
     p->queue_dialog = queue_dialog;
+
+    // Report the uploads accumulated per host, so that uploading a file to a farm of printers is presented printer by printer.
+    // Called from the worker thread of HttpMulti only, the state of the lambda is not shared.
+    HttpMulti::shared().on_host_progress([queue_dialog, last = std::map<std::string, wxString>()](const std::string &host, const HttpMulti::HostProgress &progress) mutable {
+        const int percent = progress.ultotal > 0 ? int(100 * progress.ulnow / progress.ultotal) : 0;
+        wxString  status  = GUI::format_wxstr(_L("%1%%% uploaded, %2% running, %3% waiting, %4% finished, %5% failed"),
+            percent, progress.running, progress.queued, progress.finished, progress.failed);
+        if (wxString &last_status = last[host]; last_status != status) {
+            last_status = status;
+            wxQueueEvent(queue_dialog, new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_HOST_PROGRESS, queue_dialog->GetId(), 0,
+                wxString::FromUTF8(host.c_str()), std::move(status)));
+        }
+    });
 }
 
 PrintHostJobQueue::~PrintHostJobQueue()
 {
+    HttpMulti::shared().on_host_progress(nullptr);
     if (p) { p->stop_bg_thread(); }
 }
 
-void PrintHostJobQueue::priv::emit_progress(int progress)
+void PrintHostJobQueue::priv::emit_progress(size_t id, int progress)
 {
-    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_PROGRESS, queue_dialog->GetId(), job_id, progress);
+    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_PROGRESS, queue_dialog->GetId(), id, progress);
     wxQueueEvent(queue_dialog, evt);
 }
 
-void PrintHostJobQueue::priv::emit_error(wxString error)
+void PrintHostJobQueue::priv::emit_error(size_t id, wxString error)
 {
-    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_ERROR, queue_dialog->GetId(), job_id, std::move(error));
+    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_ERROR, queue_dialog->GetId(), id, std::move(error));
     wxQueueEvent(queue_dialog, evt);
 }
 
-void PrintHostJobQueue::priv::emit_info(wxString tag, wxString status)
+void PrintHostJobQueue::priv::emit_info(size_t id, wxString tag, wxString status)
 {
-    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_INFO, queue_dialog->GetId(), job_id, std::move(tag), std::move(status));
+    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_INFO, queue_dialog->GetId(), id, std::move(tag), std::move(status));
     wxQueueEvent(queue_dialog, evt);
 }
 
@@ -156,134 +198,190 @@ void PrintHostJobQueue::priv::start_bg_thread()
 
     std::shared_ptr<priv> p2 = q->p;
     bg_thread = std::thread([p2]() {
-        p2->bg_thread_main();
+        p2->bg_thread_main(p2);
     });
 }
 
 void PrintHostJobQueue::priv::stop_bg_thread()
 {
     if (bg_thread.joinable()) {
-        bg_exit = true;
-        channel_jobs.push(PrintHostJob()); // Push an empty job to wake up bg_thread in case it's sleeping
-        bg_thread.detach();                // Let the background thread go, it should exit on its own
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bg_exit = true;
+            // The running uploads are cancelled from their progress callbacks, wake up the ones waiting for the G-code export.
+            for (auto &[id, stream] : streams)
+                stream->abort();
+        }
+        cond_finished.notify_all();
+        // The background thread joins the worker threads of the running jobs before it exits.
+        bg_thread.join();
     }
 }
 
-void PrintHostJobQueue::priv::bg_thread_main()
+void PrintHostJobQueue::priv::bg_thread_main(std::shared_ptr<priv> self)
 {
     // bg thread entry point
 
+    // Jobs picked up from channel_jobs and not started yet, in the order they were enqueued.
+    std::deque<std::pair<size_t, PrintHostJob>> waiting;
+
+    std::unique_lock<std::mutex> lock(mutex);
     try {
-        // Pick up jobs from the job channel:
         while (! bg_exit) {
-            auto job = channel_jobs.pop();   // Sleeps in a cond var if there are no jobs
-            if (job.empty()) {
-                // This happens when the thread is being stopped
-                break;
+            // Pick up the jobs enqueued since the last pass. PrintHostJobQueue::enqueue() notifies cond_finished
+            // while holding the mutex, thus a job enqueued after this point wakes up the wait below.
+            {
+                auto jobs = channel_jobs.lock_rw();
+                for (PrintHostJob &job : *jobs) {
+                    const size_t id = job_id ++;
+                    BOOST_LOG_TRIVIAL(debug) << boost::format("PrintHostJobQueue/bg_thread: Received job: [%1%]: `%2%` -> `%3%`, cancelled: %4%")
+                        % id
+                        % job.upload_data.upload_path
+                        % job.printhost->get_host()
+                        % job.cancelled;
+                    waiting.emplace_back(id, std::move(job));
+                }
+                jobs->clear();
             }
 
-            source_to_remove = job.upload_data.source_path;
-
-            BOOST_LOG_TRIVIAL(debug) << boost::format("PrintHostJobQueue/bg_thread: Received job: [%1%]: `%2%` -> `%3%`, cancelled: %4%")
-                % job_id
-                % job.upload_data.upload_path
-                % job.printhost->get_host()
-                % job.cancelled;
-
-            if (! job.cancelled) {
-                perform_job(std::move(job));
+            join_finished_jobs();
+
+            // Start the first waiting job whose host is free, so that a job waiting for a busy host does not hold back
+            // the jobs enqueued after it to the other hosts.
+            bool started = false;
+            for (auto it = waiting.begin(); it != waiting.end();) {
+                auto &[id, job] = *it;
+                if (job.cancelled || cancelled_ids.count(id)) {
+                    skip_job(job, id);
+                    it = waiting.erase(it);
+                    continue;
+                }
+                if (running_ids.size() >= HttpMulti::shared().max_connections())
+                    break;
+                std::string host = job.printhost->get_host();
+                if (busy_hosts.count(host) == 0) {
+                    run_job(self, std::move(job), id, std::move(host));
+                    waiting.erase(it);
+                    started = true;
+                    break;
+                }
+                ++ it;
             }
-
-            remove_source();
-            job_id++;
+            if (! started)
+                // Sleeps until a job finishes or a new job is enqueued.
+                cond_finished.wait(lock);
         }
     } catch (const std::exception &e) {
-        emit_error(e.what());
+        emit_error(job_id, e.what());
+        bg_exit = true;
     }
 
+    // Let the running jobs observe bg_exit and cancel from their progress callbacks.
+    while (! running_ids.empty())
+        cond_finished.wait(lock);
+    join_finished_jobs();
+
     // Cleanup leftover files, if any
-    remove_source();
+    for (auto &[id, job] : waiting)
+        skip_job(job, id);
     auto jobs = channel_jobs.lock_rw();
     for (const PrintHostJob &job : *jobs) {
         remove_source(job.upload_data.source_path);
     }
 }
 
-void PrintHostJobQueue::priv::progress_fn(Http::Progress progress, bool &cancel)
+// Called with the mutex locked for a job which will not be started.
+void PrintHostJobQueue::priv::skip_job(PrintHostJob &job, size_t id)
+{
+    // Release the G-code export writing into the stream.
+    if (job.upload_data.stream)
+        job.upload_data.stream->abort();
+    remove_source(job.upload_data.source_path);
+    // A cancellation by PrintHostJobQueue::cancel() was already reported.
+    if (! bg_exit && cancelled_ids.count(id) == 0)
+        emit_cancel(id);
+}
+
+// Called with the mutex locked, starts the job on a worker thread, which is joined by join_finished_jobs().
+void PrintHostJobQueue::priv::run_job(std::shared_ptr<priv> self, PrintHostJob job, size_t id, std::string host)
+{
+    running_ids.insert(id);
+    busy_hosts.insert(host);
+    if (job.upload_data.stream)
+        streams.emplace(id, job.upload_data.stream);
+
+    job_threads.emplace(id, std::thread([self, job = std::move(job), id, host]() mutable {
+        fs::path                     source_path = job.upload_data.source_path;
+        std::shared_ptr<GCodeStream> stream      = job.upload_data.stream;
+        try {
+            self->perform_job(std::move(job), id);
+        } catch (const std::exception &e) {
+            self->emit_error(id, e.what());
+        }
+        self->remove_source(source_path);
+        if (stream)
+            // If the upload failed, stop buffering the G-code still being exported.
+            stream->abort();
+        {
+            std::lock_guard<std::mutex> lock(self->mutex);
+            self->streams.erase(id);
+            self->running_ids.erase(id);
+            self->finished_ids.insert(id);
+            self->busy_hosts.erase(host);
+        }
+        self->cond_finished.notify_all();
+    }));
+}
+
+// Called with the mutex locked. The worker threads of the finished jobs only return from their thread functions.
+void PrintHostJobQueue::priv::join_finished_jobs()
+{
+    for (auto it = job_threads.begin(); it != job_threads.end();)
+        if (running_ids.count(it->first) == 0) {
+            it->second.join();
+            it = job_threads.erase(it);
+        } else
+            ++ it;
+}
+
+bool PrintHostJobQueue::priv::is_cancelled(size_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return cancelled_ids.count(id) > 0;
+}
+
+void PrintHostJobQueue::priv::progress_fn(size_t id, int &prev_progress, Http::Progress progress, bool &cancel)
 {
     if (cancel) {
         // When cancel is true from the start, Http indicates request has been cancelled
-        emit_cancel(job_id);
+        emit_cancel(id);
         return;
     }
 
-    if (bg_exit) {
+    if (bg_exit || is_cancelled(id)) {
         cancel = true;
         return;
     }
 
-    if (channel_cancels.size_hint() > 0) {
-        // Lock both queues
-        auto cancels = channel_cancels.lock_rw();
-        auto jobs = channel_jobs.lock_rw();
-
-        for (size_t cancel_id : *cancels) {
-            if (cancel_id == job_id) {
-                cancel = true;
-            } else if (cancel_id > job_id) {
-                const size_t idx = cancel_id - job_id - 1;
-                if (idx < jobs->size()) {
-                    jobs->at(idx).cancelled = true;
-                    BOOST_LOG_TRIVIAL(debug) << boost::format("PrintHostJobQueue: Job id %1% cancelled") % cancel_id;
-                    emit_cancel(cancel_id);
-                }
-            }
-        }
-
-        cancels->clear();
-    }
-
-    if (! cancel) {
-        int gui_progress = progress.ultotal > 0 ? 100*progress.ulnow / progress.ultotal : 0;
-        if (gui_progress != prev_progress) {
-            emit_progress(gui_progress);
-            prev_progress = gui_progress;
-        }
+    int gui_progress = progress.ultotal > 0 ? 100*progress.ulnow / progress.ultotal : 0;
+    if (gui_progress != prev_progress) {
+        emit_progress(id, gui_progress);
+        prev_progress = gui_progress;
     }
 }
 
-void PrintHostJobQueue::priv::error_fn(wxString error)
+void PrintHostJobQueue::priv::error_fn(size_t id, wxString error)
 {
     // check if transfer was not canceled before error occured - than do not show the error
-    bool do_emit_err = true;
-    if (channel_cancels.size_hint() > 0) {
-        // Lock both queues
-        auto cancels = channel_cancels.lock_rw();
-        auto jobs = channel_jobs.lock_rw();
-
-        for (size_t cancel_id : *cancels) {
-            if (cancel_id == job_id) {
-                do_emit_err = false;
-                emit_cancel(job_id);
-            }
-            else if (cancel_id > job_id) {
-                const size_t idx = cancel_id - job_id - 1;
-                if (idx < jobs->size()) {
-                    jobs->at(idx).cancelled = true;
-                    BOOST_LOG_TRIVIAL(debug) << boost::format("PrintHostJobQueue: Job id %1% cancelled") % cancel_id;
-                    emit_cancel(cancel_id);
-                }
-            }
-        }
-        cancels->clear();
-    }
-    if (do_emit_err)
-        emit_error(std::move(error));
+    if (is_cancelled(id))
+        emit_cancel(id);
+    else
+        emit_error(id, std::move(error));
 }
 
-void PrintHostJobQueue::priv::info_fn(wxString tag, wxString status)
+void PrintHostJobQueue::priv::info_fn(size_t id, wxString tag, wxString status)
 {
-    emit_info(tag, status);
+    emit_info(id, tag, status);
 }
 
 void PrintHostJobQueue::priv::remove_source(const fs::path &path)
@@ -297,24 +395,19 @@ void PrintHostJobQueue::priv::remove_source(const fs::path &path)
     }
 }
 
-void PrintHostJobQueue::priv::remove_source()
-{
-    remove_source(source_to_remove);
-    source_to_remove.clear();
-}
-
-void PrintHostJobQueue::priv::perform_job(PrintHostJob the_job)
+void PrintHostJobQueue::priv::perform_job(PrintHostJob the_job, size_t id)
 {
-    emit_progress(0);   // Indicate the upload is starting
+    emit_progress(id, 0);   // Indicate the upload is starting
 
+    int prev_progress = -1;
     bool success = the_job.printhost->upload(std::move(the_job.upload_data),
-        [this](Http::Progress progress, bool &cancel)   { this->progress_fn(std::move(progress), cancel); },
-        [this](wxString error)                          { this->error_fn(std::move(error)); },
-        [this](wxString tag, wxString host)             { this->info_fn(std::move(tag), std::move(host)); }
+        [this, id, &prev_progress](Http::Progress progress, bool &cancel) { this->progress_fn(id, prev_progress, std::move(progress), cancel); },
+        [this, id](wxString error)                                         { this->error_fn(id, std::move(error)); },
+        [this, id](wxString tag, wxString host)                            { this->info_fn(id, std::move(tag), std::move(host)); }
     );
 
     if (success) {
-        emit_progress(100);
+        emit_progress(id, 100);
         if (the_job.switch_to_device_tab) {
             const auto mainframe = GUI::wxGetApp().mainframe;
             mainframe->request_select_tab(MainFrame::TabPosition::tpMonitor);
@@ -327,11 +420,24 @@ void PrintHostJobQueue::enqueue(PrintHostJob job)
     p->start_bg_thread();
     p->queue_dialog->append_job(job);
     p->channel_jobs.push(std::move(job));
+    {
+        // Wake up the background thread waiting for a job to finish, see bg_thread_main().
+        std::lock_guard<std::mutex> lock(p->mutex);
+        p->cond_finished.notify_all();
+    }
 }
 
 void PrintHostJobQueue::cancel(size_t id)
 {
-    p->channel_cancels.push(id);
+    std::lock_guard<std::mutex> lock(p->mutex);
+    if (p->cancelled_ids.insert(id).second && p->running_ids.count(id) == 0 && p->finished_ids.count(id) == 0) {
+        // The job did not start yet, it will be skipped. A running job is cancelled from its progress callback.
+        BOOST_LOG_TRIVIAL(debug) << boost::format("PrintHostJobQueue: Job id %1% cancelled") % id;
+        p->emit_cancel(id);
+    } else if (auto it = p->streams.find(id); it != p->streams.end()) {
+        // Wake up the upload waiting for the G-code export, the read error is reported as a cancellation by error_fn().
+        it->second->abort();
+    }
 }
 
 }
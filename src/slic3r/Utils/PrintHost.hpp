@@ -17,6 +17,7 @@ class wxArrayString;
 namespace Slic3r {
 
 class DynamicPrintConfig;
+class GCodeStream;
 
 enum class PrintHostPostUploadAction {
     None,
@@ -37,6 +38,10 @@ struct PrintHostUpload
     std::string storage;
 
     PrintHostPostUploadAction post_action { PrintHostPostUploadAction::None };
+
+    // If set, the G-code is read from the stream while it is still being exported instead of from source_path,
+    // which is empty then. Only passed to print hosts supporting it, see PrintHost::supports_streaming().
+    std::shared_ptr<GCodeStream> stream;
 };
 
 class PrintHost
@@ -59,6 +64,8 @@ public:
     virtual PrintHostPostUploadActions get_post_upload_actions() const = 0;
     // A print host usually does not support multiple printers, with the exception of Repetier server.
     virtual bool supports_multiple_printers() const { return false; }
+    // Whether upload() accepts PrintHostUpload::stream, sending the G-code with chunked transfer encoding while it is being exported.
+    virtual bool supports_streaming() const { return false; }
     virtual std::string get_host() const = 0;
 
     // Support for Repetier server multiple groups & printers. Not supported by other print hosts.
@@ -18,6 +18,7 @@
 #include "slic3r/GUI/GUI.hpp"
 #include "slic3r/GUI/format.hpp"
 #include "Http.hpp"
+#include "HttpMulti.hpp"
 
 
 namespace fs = boost::filesystem;
@@ -93,7 +94,7 @@ bool Repetier::test(wxString &msg) const
                 msg = "Could not parse server response";
             }
         })
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -169,7 +170,7 @@ bool Repetier::upload(PrintHostUpload upload_data, ProgressFn prorgess_fn, Error
                 res = false;
             }
         })
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -235,7 +236,7 @@ bool Repetier::get_groups(wxArrayString& groups) const
                 res = false;
             }
         })
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
@@ -283,7 +284,7 @@ bool Repetier::get_printers(wxArrayString& printers) const
                 throw HostNetworkError(GUI::format(_L("Enumeration of host printers failed.\nMessage body: \"%1%\"\nError: \"%2%\""), body, err.what()));
             }
         })
-        .perform_sync();
+        .perform_sync(HttpMulti::shared());
 
     return res;
 }
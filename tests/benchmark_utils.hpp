@@ -0,0 +1,29 @@
+#ifndef SLIC3R_BENCHMARK_UTILS
+#define SLIC3R_BENCHMARK_UTILS
+
+#include <chrono>
+#include <sstream>
+
+#include <boost/log/trivial.hpp>
+
+// Hidden benchmarks are tagged "[.][benchmark]" and skipped by default, run them with: <tests executable> "[benchmark]".
+// They report their results through benchmark_log() at the info log level.
+
+// Wall clock time of fn() in seconds.
+template<typename Fn> inline double benchmark_seconds(Fn &&fn)
+{
+    auto t_start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+}
+
+// Log a line of results of the benchmark name.
+template<typename... Args> inline void benchmark_log(const char *name, const Args &...args)
+{
+    std::ostringstream ss;
+    ss << name << ": ";
+    (ss << ... << args);
+    BOOST_LOG_TRIVIAL(info) << ss.str();
+}
+
+#endif // SLIC3R_BENCHMARK_UTILS
@@ -0,0 +1,121 @@
+#include <catch2/catch.hpp>
+#include <benchmark_utils.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "libslic3r/GCodeReader.hpp"
+
+using namespace Slic3r;
+
+static std::vector<GCodeReader::GCodeLine> parse_all(const std::string &gcode)
+{
+    std::vector<GCodeReader::GCodeLine> lines;
+    GCodeReader reader;
+    reader.parse_buffer(gcode, [&lines](GCodeReader &, const GCodeReader::GCodeLine &line) { lines.emplace_back(line); });
+    return lines;
+}
+
+// A long comment, so that the line scanning crosses several 16 byte blocks.
+static const std::string long_comment = "; this comment is long enough to span several vector blocks of the scanner";
+
+TEST_CASE("GCodeReader parses axes and comments", "[GCodeReader]") {
+    std::vector<GCodeReader::GCodeLine> lines = parse_all(
+        "G1 X10.5 Y-2 E0.25 F1800" + long_comment + "\n"
+        "G1 Z0.2;short\n"
+        ";TYPE:Outer wall\n"
+        "  G1   X1e1 Q5 Ybad\n"
+        "M104 S200");
+    REQUIRE(lines.size() == 5);
+
+    REQUIRE(lines[0].cmd_is("G1"));
+    REQUIRE(lines[0].x() == Approx(10.5));
+    REQUIRE(lines[0].y() == Approx(-2.));
+    REQUIRE(lines[0].e() == Approx(0.25));
+    REQUIRE(lines[0].f() == Approx(1800.));
+    REQUIRE(! lines[0].has_z());
+    REQUIRE(lines[0].comment() == long_comment.substr(1));
+
+    REQUIRE(lines[1].has_z());
+    REQUIRE(lines[1].z() == Approx(0.2));
+    REQUIRE(lines[1].comment() == "short");
+
+    REQUIRE(lines[2].raw() == ";TYPE:Outer wall");
+    REQUIRE(lines[2].cmd().empty());
+
+    REQUIRE(lines[3].x() == Approx(10.));
+    REQUIRE(lines[3].has_unknown_axis());
+    REQUIRE(! lines[3].has_y());
+
+    REQUIRE(lines[4].cmd_is("M104"));
+    REQUIRE(lines[4].raw() == "M104 S200");
+}
+
+TEST_CASE("GCodeReader reads files with mixed line endings", "[GCodeReader]") {
+    std::string gcode;
+    for (int i = 0; i < 1000; ++ i)
+        gcode += "G1 X" + std::to_string(i) + " Y1" + (i % 3 == 0 ? long_comment : std::string()) + (i % 2 ? "\r\n" : "\n");
+    // Last line without a newline.
+    gcode += "G1 X1000 Y1";
+
+    boost::filesystem::path temp = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("test_gcodereader-%%%%-%%%%.gcode");
+    {
+        std::ofstream out(temp.string(), std::ios::binary);
+        out << gcode;
+    }
+    GCodeReader reader;
+    std::vector<size_t> lines_ends;
+    size_t cnt = 0;
+    bool   ok  = true;
+    REQUIRE(reader.parse_file(temp.string(), [&cnt, &ok](GCodeReader &, const GCodeReader::GCodeLine &line) {
+        ok &= line.x() == float(cnt) && line.y() == 1.f && line.raw().back() != '\r';
+        ++ cnt;
+    }, lines_ends));
+    boost::filesystem::remove(temp);
+
+    REQUIRE(ok);
+    REQUIRE(cnt == 1001);
+    // The last line is not terminated by a newline.
+    REQUIRE(lines_ends.size() == 1000);
+    REQUIRE(lines_ends.back() == gcode.rfind('\n') + 1);
+}
+
+TEST_CASE("GCodeReader parses a 1 GB file", "[GCodeReader][.][benchmark]") {
+    boost::filesystem::path temp = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("bench_gcodereader-%%%%-%%%%.gcode");
+    const size_t file_size = size_t(1) << 30;
+    size_t       written   = 0;
+    {
+        std::ofstream out(temp.string(), std::ios::binary);
+        std::string   block;
+        for (int layer = 0; written < file_size; ++ layer) {
+            block.clear();
+            block += ";LAYER_CHANGE\n;Z:" + std::to_string(0.2 * (layer + 1)) + "\nG1 Z" + std::to_string(0.2 * (layer + 1)) + " F720\n";
+            block += ";TYPE:Outer wall\n;WIDTH:0.449999\n";
+            for (int i = 0; i < 10000; ++ i)
+                block += "G1 X" + std::to_string(100. + (i % 97) * 0.123) + " Y" + std::to_string(100. + (i % 89) * 0.321) + " E0.01234\r\n";
+            block += "; a slightly longer comment describing the feature which follows next\n";
+            out << block;
+            written += block.size();
+        }
+    }
+
+    GCodeReader reader;
+    size_t      cnt_lines = 0;
+    size_t      cnt_moves = 0;
+    bool        ok        = false;
+    double      seconds   = benchmark_seconds([&]() {
+        ok = reader.parse_file(temp.string(), [&cnt_lines, &cnt_moves](GCodeReader &, const GCodeReader::GCodeLine &line) {
+            ++ cnt_lines;
+            if (line.has_x())
+                ++ cnt_moves;
+        });
+    });
+    boost::filesystem::remove(temp);
+
+    REQUIRE(ok);
+    REQUIRE(cnt_moves > 0);
+    benchmark_log("GCodeReader", "parsed ", written, " bytes, ", cnt_lines, " lines in ", seconds, " s, ", double(written) / (1024. * 1024.) / seconds, " MB/s");
+}
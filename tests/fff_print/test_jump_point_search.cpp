@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/JumpPointSearch.hpp"
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/Layer.hpp"
+#include "libslic3r/Print.hpp"
+
+#include "test_data.hpp"
+
+using namespace Slic3r;
+using namespace Slic3r::Test;
+
+static Points make_bed(double size)
+{
+    return { Point::new_scale(0., 0.), Point::new_scale(size, 0.), Point::new_scale(size, size), Point::new_scale(0., size) };
+}
+
+static bool crosses(const Polyline &path, const Line &wall)
+{
+    Point ip;
+    for (const Line &l : path.lines())
+        if (l.intersection(wall, &ip))
+            return true;
+    return false;
+}
+
+SCENARIO("JPSPathFinder plans around obstacles", "[JPS]") {
+    GIVEN("A bed divided by a wall with a gap at its top") {
+        JPSPathFinder finder;
+        finder.init_bed_shape(make_bed(100.));
+        const Line wall(Point::new_scale(50., 0.), Point::new_scale(50., 80.));
+        finder.add_obstacles(Lines{ wall });
+        const Point start = Point::new_scale(25., 20.);
+        const Point end   = Point::new_scale(75., 20.);
+        WHEN("a path is searched across the wall") {
+            Polyline path = finder.find_path(start, end);
+            THEN("the path goes around the wall through the gap") {
+                REQUIRE(! path.empty());
+                REQUIRE(path.first_point() == start);
+                REQUIRE(path.last_point() == end);
+                REQUIRE(! crosses(path, wall));
+                REQUIRE(get_extents(path).max.y() > wall.b.y());
+            }
+        }
+        WHEN("the gap is closed") {
+            finder.add_obstacles(Lines{ Line(Point::new_scale(50., 80.), Point::new_scale(50., 100.)) });
+            THEN("no path is found") {
+                REQUIRE(finder.find_path(start, end).empty());
+            }
+        }
+        WHEN("the grid is cleared") {
+            finder.clear();
+            THEN("the path is straight") {
+                Polyline path = finder.find_path(start, end);
+                REQUIRE(path.size() == 2);
+                REQUIRE(path.first_point() == start);
+                REQUIRE(path.last_point() == end);
+            }
+        }
+        WHEN("the search budget is exhausted") {
+            finder.set_search_budget(1);
+            THEN("the search fails with an empty path, so that the boundary walk is used") {
+                REQUIRE(finder.find_path(start, end).empty());
+            }
+        }
+    }
+}
+
+SCENARIO("JPSPathFinder plans around the islands of a layer", "[JPS]") {
+    GIVEN("A sliced 20mm cube") {
+        Print print;
+        Model model;
+        init_print({ TestMesh::cube_20x20x20 }, print, model, { { "layer_height", 0.2 } });
+        print.process();
+        const PrintObject *object = print.objects().front();
+        const Layer       *layer  = object->layers()[object->layers().size() / 2];
+        REQUIRE(! layer->lslices.empty());
+
+        Points bed_shape;
+        for (const Vec2d &pt : print.config().printable_area.values)
+            bed_shape.emplace_back(Point::new_scale(pt.x(), pt.y()));
+        const coord_t clearance = scaled<coord_t>(0.4);
+        JPSPathFinder finder;
+        finder.init_bed_shape(bed_shape);
+        finder.add_obstacles(*layer, clearance);
+
+        ExPolygons islands;
+        for (const PrintInstance &instance : object->instances())
+            for (ExPolygon island : layer->lslices) {
+                island.translate(instance.shift);
+                islands.emplace_back(std::move(island));
+            }
+        BoundingBox bbox = get_extents(islands);
+        WHEN("a path is searched from one side of the cube to the other") {
+            const Point start(bbox.min.x() - scaled<coord_t>(10.), bbox.center().y());
+            const Point end(bbox.max.x() + scaled<coord_t>(10.), bbox.center().y());
+            Polyline path = finder.find_path(start, end);
+            THEN("the path keeps the clearance from the island") {
+                REQUIRE(! path.empty());
+                REQUIRE(path.size() > 2);
+                // The path may cut the corners of the grid pixels of the grown island, but it never comes close to the island.
+                REQUIRE(intersection_pl(Polylines{ path }, offset_ex(islands, float(clearance / 2))).empty());
+            }
+        }
+        WHEN("a path is searched from inside of the cube") {
+            const Point start = bbox.center();
+            const Point end(bbox.max.x() + scaled<coord_t>(10.), bbox.max.y() + scaled<coord_t>(10.));
+            Polyline path = finder.find_path(start, end);
+            THEN("the path leaves the island along the straight line") {
+                REQUIRE(! path.empty());
+                REQUIRE(path.first_point() == start);
+                REQUIRE(path.last_point() == end);
+            }
+        }
+    }
+}
+
+SCENARIO("Grid travel planner reports the travel it saved", "[JPS]") {
+    GIVEN("Two cubes printed with reduced wall crossing") {
+        auto saved = [](const char *planner) {
+            Print print;
+            Model model;
+            init_print({ TestMesh::cube_20x20x20, TestMesh::cube_20x20x20 }, print, model, {
+                { "reduce_crossing_wall", true },
+                { "travel_planner",       planner },
+                { "travel_speed",         200 }
+            });
+            gcode(print);
+            return std::make_pair(print.print_statistics().travel_length_saved, print.print_statistics().travel_time_saved);
+        };
+        WHEN("the travels are planned along the boundaries") {
+            THEN("no travel is saved") {
+                REQUIRE(saved("boundary") == std::make_pair(0., 0.));
+            }
+        }
+        WHEN("the travels are planned on the grid") {
+            auto [length, time] = saved("grid");
+            THEN("the saved travel time matches the saved travel length") {
+                REQUIRE(length >= 0.);
+                REQUIRE(time == Approx(length / 200.).epsilon(0.01));
+            }
+        }
+    }
+}
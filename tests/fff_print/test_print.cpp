@@ -1,8 +1,10 @@
 #include <catch2/catch.hpp>
+#include <benchmark_utils.hpp>
 
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/Thread.hpp"
 
 #include "test_data.hpp"
 
@@ -126,3 +128,58 @@ SCENARIO("Print: Brim generation", "[Print]") {
         }
     }
 }
+
+SCENARIO("Print: Deterministic execution", "[Print]") {
+    GIVEN("Two cubes with fuzzy skin") {
+        WHEN("The same print is sliced twice in deterministic mode") {
+            auto do_slice = []() {
+                DeterministicExecutionGuard deterministic(true);
+                return Slic3r::Test::slice({ TestMesh::cube_20x20x20, TestMesh::cube_20x20x20 }, {
+                    { "fuzzy_skin", "all" },
+                    { "fuzzy_skin_thickness", 0.3 },
+                    { "fuzzy_skin_point_distance", 0.4 }
+                });
+            };
+            std::string gcode1 = do_slice();
+            std::string gcode2 = do_slice();
+            THEN("The G-code is identical") {
+                REQUIRE(! gcode1.empty());
+                REQUIRE(gcode1 == gcode2);
+            }
+        }
+    }
+    GIVEN("An overhang with tree supports") {
+        WHEN("The same print is sliced twice in deterministic mode") {
+            auto do_slice = []() {
+                DeterministicExecutionGuard deterministic(true);
+                return Slic3r::Test::slice({ TestMesh::overhang }, {
+                    { "enable_support", true },
+                    { "support_type", "tree(auto)" }
+                });
+            };
+            std::string gcode1 = do_slice();
+            std::string gcode2 = do_slice();
+            THEN("The G-code is identical") {
+                REQUIRE(! gcode1.empty());
+                REQUIRE(gcode1 == gcode2);
+            }
+        }
+    }
+}
+
+TEST_CASE("Deterministic execution benchmark", "[Print][.][benchmark]") {
+    auto do_slice = [](bool deterministic) {
+        DeterministicExecutionGuard guard(deterministic);
+        return benchmark_seconds([]() {
+            for (size_t i = 0; i < 5; ++ i)
+                Slic3r::Test::slice({ TestMesh::cube_20x20x20, TestMesh::sphere_50mm, TestMesh::overhang }, {
+                    { "fuzzy_skin", "all" },
+                    { "enable_support", true },
+                    { "support_type", "tree(auto)" }
+                });
+        });
+    };
+    double t_default       = do_slice(false);
+    double t_deterministic = do_slice(true);
+    benchmark_log("Deterministic execution", "default ", t_default, " s, deterministic ", t_deterministic, " s, slowdown ", t_deterministic / t_default);
+}
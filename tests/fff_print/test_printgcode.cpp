@@ -2,10 +2,17 @@
 
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/GCodeReader.hpp"
+#include "libslic3r/GCode/GCodeStream.hpp"
 
 #include "test_data.hpp"
 
 #include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
 #include <boost/regex.hpp>
 
 using namespace Slic3r;
@@ -269,3 +276,79 @@ SCENARIO( "PrintGCode basic functionality", "[PrintGCode]") {
         }
     }
 }
+
+// Exports the G-code of the print to a file while streaming it, returns the exported and the streamed G-code.
+static std::pair<std::string, std::string> export_and_stream_gcode(Print &print)
+{
+    GCodeStream stream;
+    std::string streamed;
+    std::thread consumer([&stream, &streamed]() {
+        char buffer[4096];
+        try {
+            while (size_t n = stream.read(buffer, sizeof(buffer)))
+                streamed.append(buffer, n);
+        } catch (const GCodeStreamAborted &) {
+            streamed.clear();
+        }
+    });
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    print.export_gcode(temp.string(), nullptr, nullptr, &stream);
+    consumer.join();
+    std::ifstream t(temp.string());
+    std::string exported((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+    t.close();
+    boost::nowide::remove(temp.string().c_str());
+    return { exported, streamed };
+}
+
+// The exported G-code as it is streamed: without the M73 progress lines, with the layer count moved from the header to the end.
+static std::string exported_as_streamed(const std::string &gcode)
+{
+    std::string out, layer_count;
+    std::istringstream in(gcode);
+    for (std::string line; std::getline(in, line);) {
+        if (boost::starts_with(line, "M73 "))
+            continue;
+        if (boost::starts_with(line, "; total layer number:"))
+            layer_count = line + "\n";
+        else
+            out += line + "\n";
+    }
+    return out + layer_count;
+}
+
+SCENARIO("PrintGCode streamed while being exported", "[PrintGCode][GCodeStream]") {
+    GIVEN("A cube printed with two extruders") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_num_extruders(2);
+        config.set_deserialize_strict({
+            { "infill_extruder",                2 },
+            { "solid_infill_extruder",          2 }
+        });
+        WHEN("the next tool is preheated ahead of the tool changes") {
+            config.set_deserialize_strict({ { "preheat_time", 30 } });
+            Slic3r::Print print;
+            Slic3r::Model model;
+            Slic3r::Test::init_print({ TestMesh::cube_20x20x20 }, print, model, config);
+            THEN("the G-code is not streamed") {
+                REQUIRE(! GCodeStream::can_stream(print.config()));
+            }
+        }
+        WHEN("the next tool is not preheated") {
+            config.set_deserialize_strict({ { "preheat_time", 0 } });
+            Slic3r::Print print;
+            Slic3r::Model model;
+            Slic3r::Test::init_print({ TestMesh::cube_20x20x20 }, print, model, config);
+            REQUIRE(GCodeStream::can_stream(print.config()));
+            print.set_status_silent();
+            print.process();
+            auto [exported, streamed] = export_and_stream_gcode(print);
+            THEN("the streamed G-code is the exported G-code without the M73 lines") {
+                REQUIRE(exported.find("\nM73 ") != std::string::npos);
+                // The footer with the filament statistics rewritten by the post-processing.
+                REQUIRE(streamed.find("\n" + PrintStatistics::FilamentUsedMmMask) != std::string::npos);
+                REQUIRE(streamed == exported_as_streamed(exported));
+            }
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch.hpp>
+
+#include <ctime>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "libslic3r/SliceResultStore.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+
+#include "test_data.hpp"
+
+using namespace Slic3r;
+using namespace Slic3r::Test;
+
+static std::string read_file(const std::string &path)
+{
+    std::ifstream t(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
+}
+
+SCENARIO("SliceResultStore keys", "[SliceResultStore]") {
+    GIVEN("Two prints of the same model and configuration") {
+        Print print1, print2;
+        Model model1, model2;
+        init_print({ TestMesh::cube_20x20x20 }, print1, model1, { { "layer_height", 0.2 } });
+        init_print({ TestMesh::cube_20x20x20 }, print2, model2, { { "layer_height", 0.2 } });
+        THEN("the keys are equal") {
+            REQUIRE(! SliceResultStore::key(print1).empty());
+            REQUIRE(SliceResultStore::key(print1) == SliceResultStore::key(print2));
+        }
+    }
+    GIVEN("Prints differing in the configuration") {
+        Print print1, print2;
+        Model model1, model2;
+        init_print({ TestMesh::cube_20x20x20 }, print1, model1, { { "layer_height", 0.2 } });
+        init_print({ TestMesh::cube_20x20x20 }, print2, model2, { { "layer_height", 0.3 } });
+        THEN("the keys differ") {
+            REQUIRE(SliceResultStore::key(print1) != SliceResultStore::key(print2));
+        }
+    }
+    GIVEN("Prints differing in the model") {
+        Print print1, print2;
+        Model model1, model2;
+        init_print({ TestMesh::cube_20x20x20 }, print1, model1, { { "layer_height", 0.2 } });
+        init_print({ TestMesh::cube_with_hole }, print2, model2, { { "layer_height", 0.2 } });
+        THEN("the keys differ") {
+            REQUIRE(SliceResultStore::key(print1) != SliceResultStore::key(print2));
+        }
+    }
+}
+
+SCENARIO("SliceResultStore round trip", "[SliceResultStore]") {
+    GIVEN("A sliced print") {
+        Print print;
+        Model model;
+        init_print({ TestMesh::cube_20x20x20 }, print, model, { { "layer_height", 0.2 } });
+        print.set_status_silent();
+        print.process();
+
+        boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("test_slice_result_store-%%%%-%%%%");
+        boost::filesystem::create_directories(dir);
+        const std::string gcode_path = (dir / "print.gcode").string();
+        GCodeProcessorResult result;
+        print.export_gcode(gcode_path, &result, nullptr);
+        REQUIRE(! result.moves.empty());
+
+        SliceResultStore store((dir / "store").string(), 2);
+        const std::string key = SliceResultStore::key(print);
+        REQUIRE(! store.contains(key));
+        REQUIRE(store.store(key, gcode_path, result, print.print_statistics()));
+        REQUIRE(store.contains(key));
+
+        WHEN("the result is loaded") {
+            const std::string restored_path = (dir / "restored.gcode").string();
+            GCodeProcessorResult restored;
+            PrintStatistics      statistics;
+            REQUIRE(store.load(key, restored_path, restored, statistics));
+            THEN("the G-code and the result are restored") {
+                REQUIRE(read_file(restored_path) == read_file(gcode_path));
+                REQUIRE(restored.filename == restored_path);
+                REQUIRE(restored.id != result.id);
+                REQUIRE(restored.moves.size() == result.moves.size());
+                bool moves_equal = true;
+                for (size_t i = 0; i < result.moves.size(); ++ i) {
+                    const GCodeProcessorResult::MoveVertex &a = result.moves[i];
+                    const GCodeProcessorResult::MoveVertex &b = restored.moves[i];
+                    moves_equal &= a.gcode_id == b.gcode_id && a.type == b.type && a.extrusion_role == b.extrusion_role &&
+                                   a.position == b.position && a.width == b.width && a.height == b.height && a.time == b.time &&
+                                   a.interpolation_points == b.interpolation_points;
+                }
+                REQUIRE(moves_equal);
+                REQUIRE(restored.lines_ends == result.lines_ends);
+                REQUIRE(restored.extruders_count == result.extruders_count);
+                REQUIRE(restored.print_statistics.modes[0].time == result.print_statistics.modes[0].time);
+                REQUIRE(restored.print_statistics.modes[0].roles_times == result.print_statistics.modes[0].roles_times);
+                REQUIRE(restored.print_statistics.total_volumes_per_extruder == result.print_statistics.total_volumes_per_extruder);
+                REQUIRE(statistics.total_used_filament == print.print_statistics().total_used_filament);
+                REQUIRE(statistics.estimated_normal_print_time == print.print_statistics().estimated_normal_print_time);
+            }
+        }
+        WHEN("the result file is truncated") {
+            const std::string result_path = (dir / "store" / key / "result.bin").string();
+            boost::filesystem::resize_file(result_path, boost::filesystem::file_size(result_path) / 2);
+            GCodeProcessorResult restored;
+            PrintStatistics      statistics;
+            THEN("loading fails") {
+                REQUIRE(! store.load(key, (dir / "restored.gcode").string(), restored, statistics));
+                REQUIRE(restored.moves.empty());
+            }
+        }
+        WHEN("more entries than the limit are stored") {
+            REQUIRE(store.store("a", gcode_path, result, print.print_statistics()));
+            REQUIRE(store.store("b", gcode_path, result, print.print_statistics()));
+            THEN("only the limit is kept") {
+                size_t entries = 0;
+                for (boost::filesystem::directory_iterator it(dir / "store"), end; it != end; ++ it)
+                    ++ entries;
+                REQUIRE(entries == 2);
+            }
+        }
+        WHEN("the entries are over the size limit") {
+            uintmax_t entry_size = 0;
+            for (boost::filesystem::directory_iterator it(dir / "store" / key), end; it != end; ++ it)
+                entry_size += boost::filesystem::file_size(it->path());
+            // Room for one and a half entries.
+            SliceResultStore small_store((dir / "small_store").string(), 32, size_t(entry_size * 3 / 2));
+            REQUIRE(small_store.store("a", gcode_path, result, print.print_statistics()));
+            // The times of the entries have a resolution of a second.
+            boost::filesystem::last_write_time(dir / "small_store" / "a", std::time(nullptr) - 10);
+            REQUIRE(small_store.store("b", gcode_path, result, print.print_statistics()));
+            SliceResultStore tiny_store((dir / "tiny_store").string(), 32, size_t(entry_size / 2));
+            THEN("the least recently used entries are removed") {
+                size_t entries = 0;
+                for (boost::filesystem::directory_iterator it(dir / "small_store"), end; it != end; ++ it)
+                    ++ entries;
+                REQUIRE(entries == 1);
+                REQUIRE(small_store.contains("b"));
+            }
+            THEN("an entry larger than the limit is not stored") {
+                REQUIRE(! tiny_store.store("a", gcode_path, result, print.print_statistics()));
+                REQUIRE(! tiny_store.contains("a"));
+            }
+        }
+
+        boost::filesystem::remove_all(dir);
+    }
+}
@@ -1,8 +1,13 @@
 #include <catch2/catch.hpp>
 #include <test_utils.hpp>
+#include <benchmark_utils.hpp>
 
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/AABBTreeIndirect.hpp>
+#include <libslic3r/AABBTreeLines.hpp>
+#include <libslic3r/Polygon.hpp>
+
+#include <random>
 
 using namespace Slic3r;
 
@@ -58,3 +63,100 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.y() == Approx(0.5));
     REQUIRE(closest_point.z() == Approx(1.));
 }
+
+// Circles of random centers and radii, sampled as perimeters of a layer.
+static Polygons random_circles(size_t count, size_t num_points, double max_radius, unsigned int seed)
+{
+    std::mt19937                           gen(seed);
+    std::uniform_real_distribution<double> coord(-50., 50.);
+    std::uniform_real_distribution<double> radius(1., max_radius);
+    Polygons                               out;
+    for (size_t i = 0; i < count; ++ i) {
+        const Vec2d  center(coord(gen), coord(gen));
+        const double r = radius(gen);
+        Polygon      poly;
+        for (size_t j = 0; j < num_points; ++ j) {
+            const double angle = 2. * M_PI * double(j) / double(num_points);
+            poly.points.emplace_back(scaled<coord_t>(center.x() + r * cos(angle)), scaled<coord_t>(center.y() + r * sin(angle)));
+        }
+        out.emplace_back(std::move(poly));
+    }
+    return out;
+}
+
+TEST_CASE("Batched distance queries of LinesDistancer", "[AABBTreeLines]")
+{
+    const AABBTreeLines::LinesDistancer<Line> distancer(to_lines(random_circles(20, 200, 10., 1)));
+    Points points;
+    for (const Polygon &poly : random_circles(50, 100, 15., 2))
+        append(points, poly.points);
+
+    std::vector<double> distances;
+    std::vector<size_t> lines;
+    std::vector<Vec2d>  nearest_points;
+    distancer.distances_from_lines_extra<true>(points, distances, &lines, &nearest_points);
+    REQUIRE(distances.size() == points.size());
+    for (size_t i = 0; i < points.size(); ++ i) {
+        auto [distance, line, nearest_point] = distancer.distance_from_lines_extra<true>(points[i]);
+        REQUIRE(std::abs(distances[i]) == std::abs(distance));
+        // The sign reused from the previous point may replace an undetermined sign.
+        REQUIRE((distances[i] == distance || distance == 0.));
+        REQUIRE(std::abs(distancer.get_line(lines[i]).distance_to(points[i]) - std::abs(distance)) < EPSILON);
+        REQUIRE((nearest_points[i] - nearest_point).norm() < EPSILON);
+    }
+    std::vector<double> unsigned_distances;
+    for (const Point &pt : points)
+        unsigned_distances.emplace_back(distancer.distance_from_lines<false>(pt));
+    REQUIRE(distancer.distances_from_lines<false>(points) == unsigned_distances);
+    REQUIRE(AABBTreeLines::LinesDistancer<Line>().distances_from_lines<false>(points).front() == std::numeric_limits<double>::infinity());
+}
+
+TEST_CASE("Batched signed distances of points crossing the lines", "[AABBTreeLines]")
+{
+    // A square of 10 x 10 mm, sampled densely along a path passing through it, so that the signs are reused.
+    const Polygon square { { 0, 0 }, { scaled<coord_t>(10.), 0 }, { scaled<coord_t>(10.), scaled<coord_t>(10.) }, { 0, scaled<coord_t>(10.) } };
+    const AABBTreeLines::LinesDistancer<Line> distancer(to_lines(square));
+    Points points;
+    for (int i = -100; i <= 200; ++ i)
+        points.emplace_back(scaled<coord_t>(0.1) * i, scaled<coord_t>(3.) + scaled<coord_t>(0.01) * i);
+    const std::vector<double> distances = distancer.distances_from_lines<true>(points);
+    for (size_t i = 0; i < points.size(); ++ i) {
+        const bool inside = points[i].x() > 0 && points[i].x() < scaled<coord_t>(10.);
+        const bool on_boundary = points[i].x() == 0 || points[i].x() == scaled<coord_t>(10.);
+        REQUIRE(distances[i] == Approx(distancer.distance_from_lines<true>(points[i])));
+        if (! on_boundary)
+            REQUIRE((distances[i] < 0.) == inside);
+    }
+}
+
+TEST_CASE("Batched distance queries of LinesDistancer throughput", "[AABBTreeLines][.][benchmark]")
+{
+    // Perimeters of a layer queried against the perimeters of the layer below.
+    const Polygons lower_layer = random_circles(500, 400, 10., 3);
+    const Polygons layer       = random_circles(500, 400, 10., 3);
+    Points         points;
+    for (Polygon poly : layer) {
+        poly.translate(scaled<coord_t>(0.05), scaled<coord_t>(0.05));
+        append(points, poly.points);
+    }
+    const AABBTreeLines::LinesDistancer<Line> distancer(to_lines(lower_layer));
+
+    double sum_single     = 0.;
+    double seconds_single = benchmark_seconds([&distancer, &points, &sum_single]() {
+        for (const Point &pt : points)
+            sum_single += distancer.distance_from_lines<true>(pt);
+    });
+
+    std::vector<double> distances;
+    double seconds_batch = benchmark_seconds([&distancer, &points, &distances]() { distances = distancer.distances_from_lines<true>(points); });
+    // The signs cost a ray cast each unless they are reused from the previous point.
+    double seconds_batch_unsigned = benchmark_seconds([&distancer, &points]() { distancer.distances_from_lines<false>(points); });
+
+    double sum_batch = 0.;
+    for (double d : distances)
+        sum_batch += d;
+    REQUIRE(sum_batch == Approx(sum_single));
+    benchmark_log("AABBTreeLines", points.size(), " points, single queries ", double(points.size()) / seconds_single * 1e-6,
+                  " Mpts/s, batched ", double(points.size()) / seconds_batch * 1e-6, " Mpts/s, batched unsigned ",
+                  double(points.size()) / seconds_batch_unsigned * 1e-6, " Mpts/s");
+}
@@ -0,0 +1,139 @@
+#include <catch2/catch.hpp>
+#include <test_utils.hpp>
+#include <benchmark_utils.hpp>
+
+#include <list>
+#include <memory>
+
+#include <libslic3r/Arachne/WallToolPaths.hpp>
+#include <libslic3r/Arachne/utils/HalfEdgeGraph.hpp>
+#include <libslic3r/MTUtils.hpp>
+#include <libslic3r/TriangleMeshSlicer.hpp>
+
+using namespace Slic3r;
+
+TEST_CASE("HalfEdgeList behaves like a list", "[Arachne]") {
+    Arachne::HalfEdgeList<std::pair<int, std::vector<int>>> list;
+    std::list<int>                                          expected;
+    for (int i = 0; i < 10000; ++ i) {
+        if (i % 3 == 0) {
+            list.emplace_front(i, std::vector<int>(3, i));
+            expected.emplace_front(i);
+        } else {
+            list.emplace_back(i, std::vector<int>(3, i));
+            expected.emplace_back(i);
+        }
+    }
+    // Erase every fifth element, alternately through an iterator and through a pointer.
+    auto it_expected = expected.begin();
+    int  idx         = 0;
+    for (auto it = list.begin(); it != list.end(); ++ idx) {
+        if (idx % 5 == 0) {
+            if (idx % 2 == 0) {
+                it = list.erase(it);
+            } else {
+                auto *element = &*it ++;
+                list.erase(element);
+            }
+            it_expected = expected.erase(it_expected);
+        } else {
+            ++ it;
+            ++ it_expected;
+        }
+    }
+    // The erased slots are reused.
+    const auto *reused = &list.emplace_back(-1, std::vector<int>());
+    expected.emplace_back(-1);
+    REQUIRE(reused != nullptr);
+
+    REQUIRE(list.size() == expected.size());
+    REQUIRE(list.front().first == expected.front());
+    REQUIRE(list.back().first == expected.back());
+    bool equal = true;
+    it_expected = expected.begin();
+    for (const auto &element : list)
+        equal &= element.first == *it_expected ++ && (element.first < 0 || element.second == std::vector<int>(3, element.first));
+    REQUIRE(equal);
+
+    list.clear();
+    REQUIRE(list.empty());
+    REQUIRE(list.begin() == list.end());
+}
+
+static std::vector<ExPolygons> slice_test_model(const std::string &obj_filename, float layer_height)
+{
+    TriangleMesh mesh = load_model(obj_filename);
+    BoundingBoxf3 bb  = mesh.bounding_box();
+    return slice_mesh_ex(mesh.its, grid(float(bb.min.z()) + 0.5f * layer_height, float(bb.max.z()), layer_height));
+}
+
+static std::vector<Arachne::VariableWidthLines> generate_walls(const ExPolygon &expoly)
+{
+    PrintObjectConfig            object_config;
+    PrintConfig                  print_config;
+    Arachne::WallToolPathsParams params = Arachne::make_paths_params(1, object_config, print_config);
+    params.is_top_or_bottom_layer       = false;
+    Arachne::WallToolPaths wall_tool_paths(to_polygons(expoly), scaled<coord_t>(0.45), scaled<coord_t>(0.45), 3, 0, 0.2, params);
+    return wall_tool_paths.generate();
+}
+
+static bool walls_equal(const std::vector<Arachne::VariableWidthLines> &walls1, const std::vector<Arachne::VariableWidthLines> &walls2)
+{
+    if (walls1.size() != walls2.size())
+        return false;
+    for (size_t i = 0; i < walls1.size(); ++ i) {
+        if (walls1[i].size() != walls2[i].size())
+            return false;
+        for (size_t j = 0; j < walls1[i].size(); ++ j) {
+            const Arachne::ExtrusionLine &line1 = walls1[i][j];
+            const Arachne::ExtrusionLine &line2 = walls2[i][j];
+            if (line1.inset_idx != line2.inset_idx || line1.is_closed != line2.is_closed || line1.junctions.size() != line2.junctions.size())
+                return false;
+            for (size_t k = 0; k < line1.junctions.size(); ++ k)
+                if (line1.junctions[k].p != line2.junctions[k].p || line1.junctions[k].w != line2.junctions[k].w)
+                    return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Arachne walls do not depend on the memory of the graph", "[Arachne]") {
+    std::vector<ExPolygons> layers = slice_test_model("extruder_idler.obj", 1.f);
+    REQUIRE(! layers.empty());
+    // Reference: each graph is built in newly allocated memory, at addresses shifted by the allocations kept alive in between.
+    std::vector<std::vector<Arachne::VariableWidthLines>> walls;
+    std::vector<std::unique_ptr<char[]>>                   spacers;
+    for (const ExPolygons &layer : layers)
+        for (const ExPolygon &expoly : layer) {
+            Arachne::HalfEdgeArena::clear_cache();
+            spacers.emplace_back(new char[Arachne::HalfEdgeArena::chunk_size * (1 + walls.size() % 3) + 16 * walls.size()]);
+            walls.emplace_back(generate_walls(expoly));
+        }
+    spacers.clear();
+    // The second pass builds its graphs in the chunks cached by the thread, released by the graphs of the preceding islands.
+    size_t idx   = 0;
+    bool   equal = true;
+    for (const ExPolygons &layer : layers)
+        for (const ExPolygon &expoly : layer)
+            equal &= walls_equal(walls[idx ++], generate_walls(expoly));
+    REQUIRE(! walls.empty());
+    REQUIRE(! walls.front().empty());
+    REQUIRE(equal);
+}
+
+TEST_CASE("Arachne WallToolPaths benchmark", "[Arachne][.][benchmark]") {
+    std::vector<ExPolygon> outlines;
+    for (const std::string model : { "extruder_idler.obj", "frog_legs.obj", "ipadstand.obj" })
+        for (const ExPolygons &layer : slice_test_model(model, 0.2f))
+            append(outlines, layer);
+
+    size_t cnt_lines = 0;
+    double seconds   = benchmark_seconds([&outlines, &cnt_lines]() {
+        for (int i = 0; i < 5; ++ i)
+            for (const ExPolygon &outline : outlines)
+                for (const Arachne::VariableWidthLines &lines : generate_walls(outline))
+                    cnt_lines += lines.size();
+    });
+    benchmark_log("WallToolPaths::generate", outlines.size(), " outlines, ", cnt_lines, " lines in ", seconds, " s");
+    REQUIRE(cnt_lines > 0);
+}
@@ -0,0 +1,111 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Arrange.hpp"
+#include "libslic3r/BoundingBox.hpp"
+#include "libslic3r/ClipperUtils.hpp"
+
+using namespace Slic3r;
+
+static arrangement::ArrangePolygons make_copies(const Polygon &shape, size_t count)
+{
+    arrangement::ArrangePolygon ap;
+    ap.poly = ExPolygon(shape);
+    return arrangement::ArrangePolygons(count, ap);
+}
+
+static Points make_bed(double size_x, double size_y)
+{
+    return { Point::new_scale(0., 0.), Point::new_scale(size_x, 0.), Point::new_scale(size_x, size_y), Point::new_scale(0., size_y) };
+}
+
+static bool any_overlap(const arrangement::ArrangePolygons &items)
+{
+    for (size_t i = 0; i < items.size(); ++ i)
+        for (size_t j = i + 1; j < items.size(); ++ j)
+            if (items[i].is_arranged() && items[j].is_arranged() &&
+                ! intersection(items[i].transformed_poly(), items[j].transformed_poly()).empty())
+                return true;
+    return false;
+}
+
+TEST_CASE("Lattice fill tiles identical squares", "[Arrange]") {
+    Polygon square({ Point::new_scale(0., 0.), Point::new_scale(10., 0.), Point::new_scale(10., 10.), Point::new_scale(0., 10.) });
+    arrangement::ArrangePolygons items = make_copies(square, 120);
+    Points bed = make_bed(100.5, 100.5);
+
+    REQUIRE(arrangement::is_lattice_fillable(items));
+    arrangement::ArrangeParams params;
+    size_t placed = arrangement::fill_bed_lattice(items, {}, bed, params);
+
+    REQUIRE(placed == 100);
+    REQUIRE(std::count_if(items.begin(), items.end(), [](const auto &ap) { return ap.is_arranged(); }) == 100);
+    REQUIRE(! any_overlap(items));
+    BoundingBox bed_bbox(bed);
+    for (const arrangement::ArrangePolygon &ap : items)
+        if (ap.is_arranged())
+            REQUIRE(bed_bbox.contains(get_extents(ap.transformed_poly())));
+}
+
+TEST_CASE("Lattice fill avoids fixed items", "[Arrange]") {
+    Polygon square({ Point::new_scale(0., 0.), Point::new_scale(10., 0.), Point::new_scale(10., 10.), Point::new_scale(0., 10.) });
+    arrangement::ArrangePolygons items = make_copies(square, 120);
+    arrangement::ArrangePolygons fixed = make_copies(Polygon({ Point::new_scale(0., 0.), Point::new_scale(30., 0.), Point::new_scale(30., 30.), Point::new_scale(0., 30.) }), 1);
+    fixed.front().translation = Point::new_scale(35., 35.);
+    fixed.front().bed_idx     = 0;
+
+    size_t placed = arrangement::fill_bed_lattice(items, fixed, make_bed(100.5, 100.5), arrangement::ArrangeParams{});
+
+    REQUIRE(placed > 80);
+    REQUIRE(placed < 100);
+    REQUIRE(! any_overlap(items));
+    for (const arrangement::ArrangePolygon &ap : items)
+        if (ap.is_arranged())
+            REQUIRE(intersection(ap.transformed_poly(), fixed.front().transformed_poly()).empty());
+}
+
+TEST_CASE("Lattice fill keeps the inflated distance", "[Arrange]") {
+    Polygon triangle({ Point::new_scale(0., 0.), Point::new_scale(20., 0.), Point::new_scale(10., 15.) });
+    arrangement::ArrangePolygons items = make_copies(triangle, 200);
+    for (arrangement::ArrangePolygon &ap : items)
+        ap.inflation = scaled(1.);
+
+    size_t placed = arrangement::fill_bed_lattice(items, {}, make_bed(150., 150.), arrangement::ArrangeParams{});
+
+    REQUIRE(placed > 0);
+    for (size_t i = 0; i < items.size(); ++ i)
+        for (size_t j = i + 1; j < items.size(); ++ j)
+            if (items[i].is_arranged() && items[j].is_arranged())
+                REQUIRE(intersection(offset(items[i].transformed_poly(), float(scaled(0.99))), offset(items[j].transformed_poly(), float(scaled(0.99)))).empty());
+}
+
+TEST_CASE("Lattice fill aligns the copies to the bed center", "[Arrange]") {
+    Polygon square({ Point::new_scale(0., 0.), Point::new_scale(10., 0.), Point::new_scale(10., 10.), Point::new_scale(0., 10.) });
+    arrangement::ArrangePolygons items = make_copies(square, 4);
+    Points bed = make_bed(100., 100.);
+
+    arrangement::ArrangeParams params;
+    params.do_final_align = true;
+    size_t placed = arrangement::fill_bed_lattice(items, {}, bed, params);
+
+    REQUIRE(placed == 4);
+    BoundingBox pile;
+    for (const arrangement::ArrangePolygon &ap : items)
+        pile.merge(get_extents(ap.transformed_poly()));
+    REQUIRE((pile.center() - BoundingBox(bed).center()).cast<double>().norm() < scaled<double>(1.));
+}
+
+TEST_CASE("Lattice fill keeps the copies inside a concave bed", "[Arrange]") {
+    Polygon square({ Point::new_scale(0., 0.), Point::new_scale(10., 0.), Point::new_scale(10., 10.), Point::new_scale(0., 10.) });
+    arrangement::ArrangePolygons items = make_copies(square, 100);
+    // L shaped bed.
+    Points bed { Point::new_scale(0., 0.), Point::new_scale(100., 0.), Point::new_scale(100., 40.), Point::new_scale(40., 40.),
+                 Point::new_scale(40., 100.), Point::new_scale(0., 100.) };
+
+    size_t placed = arrangement::fill_bed_lattice(items, {}, bed, arrangement::ArrangeParams{});
+
+    REQUIRE(placed > 0);
+    REQUIRE(! any_overlap(items));
+    for (const arrangement::ArrangePolygon &ap : items)
+        if (ap.is_arranged())
+            REQUIRE(diff(ap.transformed_poly().contour, Polygon(bed)).empty());
+}
@@ -0,0 +1,121 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdio>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+
+#include "libslic3r/GCode/BinaryGCode.hpp"
+#include "libslic3r/GCodeReader.hpp"
+
+using namespace Slic3r;
+
+static std::string make_ascii_gcode(size_t layers)
+{
+    std::string gcode = "; generated by OrcaSlicer\nG28\nG90\n";
+    for (size_t layer = 0; layer < layers; ++ layer) {
+        gcode += ";LAYER_CHANGE\n";
+        gcode += ";Z:" + std::to_string(0.2 * (layer + 1)) + "\n";
+        for (size_t i = 0; i < 200; ++ i)
+            gcode += "G1 X" + std::to_string(i % 100) + " Y" + std::to_string(layer) + " E0.0" + std::to_string(i % 10) + "\n";
+    }
+    gcode += "M84\n";
+    return gcode;
+}
+
+static void write_binary_gcode(const std::string &path, const std::string &ascii, const BinaryGCode::BinaryData &data, const BinaryGCode::BinarizerConfig &config)
+{
+    std::string path_ascii = path + ".ascii";
+    {
+        FILE *f = boost::nowide::fopen(path_ascii.c_str(), "wb");
+        ::fwrite(ascii.data(), 1, ascii.size(), f);
+        ::fclose(f);
+    }
+    FILE *src = boost::nowide::fopen(path_ascii.c_str(), "rb");
+    FILE *dst = boost::nowide::fopen(path.c_str(), "wb");
+    BinaryGCode::convert_ascii_to_binary(src, dst, data, config);
+    ::fclose(src);
+    ::fclose(dst);
+    boost::nowide::remove(path_ascii.c_str());
+}
+
+SCENARIO("Binary G-code round trip", "[BinaryGCode]") {
+    auto compression = GENERATE(BinaryGCode::ECompressionType::None, BinaryGCode::ECompressionType::Deflate);
+    GIVEN("ASCII G-code of 10 layers with metadata and a thumbnail") {
+        const std::string       ascii = make_ascii_gcode(10);
+        BinaryGCode::BinaryData data;
+        data.file_metadata.emplace_back("Producer", "OrcaSlicer");
+        data.printer_metadata.emplace_back("nozzle_diameter", "0.4");
+        data.print_metadata.emplace_back("total layers count", "10");
+        data.slicer_metadata.emplace_back("layer_height", "0.2");
+        data.slicer_metadata.emplace_back("start_gcode", "G28 ; home");
+        data.thumbnails.push_back({ BinaryGCode::EThumbnailFormat::PNG, 16, 16, std::string("\x89PNG\r\n\x1a\nfake", 12) });
+
+        const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.bgcode")).string();
+
+        BinaryGCode::BinarizerConfig config;
+        config.gcode_compression    = compression;
+        config.metadata_compression = compression;
+        write_binary_gcode(path, ascii, data, config);
+
+        WHEN("the binary G-code is read back") {
+            REQUIRE(BinaryGCode::is_binary_gcode(path));
+            BinaryGCode::Reader reader(path);
+            THEN("the G-code decodes to the ASCII G-code") {
+                REQUIRE(reader.gcode_size() == ascii.size());
+                REQUIRE(reader.read_gcode(0, reader.gcode_size()) == ascii);
+            }
+            THEN("each layer starts a new G-code block") {
+                REQUIRE(reader.gcode_blocks_count() == 11);
+                for (size_t i = 1; i < reader.gcode_blocks_count(); ++ i)
+                    REQUIRE(reader.read_gcode_block(i).rfind(";LAYER_CHANGE\n", 0) == 0);
+            }
+            THEN("any range of the G-code is accessible without decoding the whole file") {
+                size_t begin = ascii.size() / 3;
+                size_t end   = 2 * ascii.size() / 3;
+                REQUIRE(reader.read_gcode(begin, end) == ascii.substr(begin, end - begin));
+                REQUIRE(reader.gcode_block_offset(reader.gcode_block_at(begin)) <= begin);
+            }
+            THEN("metadata and thumbnails are preserved") {
+                REQUIRE(reader.read_metadata(BinaryGCode::EBlockType::FileMetadata) == data.file_metadata);
+                REQUIRE(reader.read_metadata(BinaryGCode::EBlockType::PrinterMetadata) == data.printer_metadata);
+                REQUIRE(reader.read_metadata(BinaryGCode::EBlockType::PrintMetadata) == data.print_metadata);
+                REQUIRE(reader.read_metadata(BinaryGCode::EBlockType::SlicerMetadata) == data.slicer_metadata);
+                std::vector<BinaryGCode::Thumbnail> thumbnails = reader.read_thumbnails();
+                REQUIRE(thumbnails.size() == 1);
+                REQUIRE(thumbnails.front().width == 16);
+                REQUIRE(thumbnails.front().data == data.thumbnails.front().data);
+            }
+        }
+        WHEN("the binary G-code is parsed by GCodeReader") {
+            GCodeReader         reader;
+            std::vector<size_t> lines_ends;
+            size_t              moves = 0;
+            REQUIRE(reader.parse_file(path, [&moves](GCodeReader &, const GCodeReader::GCodeLine &line) { moves += line.cmd_is("G1"); }, lines_ends));
+            THEN("all lines are parsed and the line ends are offsets into the ASCII G-code") {
+                REQUIRE(moves == 10 * 200);
+                REQUIRE(lines_ends.size() == size_t(std::count(ascii.begin(), ascii.end(), '\n')));
+                REQUIRE(lines_ends.back() == ascii.size());
+            }
+        }
+        boost::nowide::remove(path.c_str());
+    }
+}
+
+TEST_CASE("Corrupted binary G-code is rejected", "[BinaryGCode]") {
+    const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.bgcode")).string();
+    write_binary_gcode(path, make_ascii_gcode(2), BinaryGCode::BinaryData(), BinaryGCode::BinarizerConfig());
+    {
+        // Flip a byte of the last G-code block.
+        FILE *f = boost::nowide::fopen(path.c_str(), "r+b");
+        ::fseek(f, -8, SEEK_END);
+        int c = ::fgetc(f);
+        ::fseek(f, -8, SEEK_END);
+        ::fputc(c ^ 0xff, f);
+        ::fclose(f);
+    }
+    BinaryGCode::Reader reader(path);
+    REQUIRE_THROWS(reader.read_gcode_block(reader.gcode_blocks_count() - 1));
+    boost::nowide::remove(path.c_str());
+}
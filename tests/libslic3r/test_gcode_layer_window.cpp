@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+
+#include "libslic3r/GCode/GCodeLayerWindow.hpp"
+
+using namespace Slic3r;
+using GCodeLayerWindow::LayersRange;
+
+struct TestLayerEndpoints
+{
+    size_t first;
+    size_t last;
+};
+
+// Layers following each other, with the given number of moves each.
+static std::vector<TestLayerEndpoints> test_layers(const std::vector<size_t> &moves_per_layer)
+{
+    std::vector<TestLayerEndpoints> out;
+    size_t                          first = 0;
+    for (size_t moves : moves_per_layer) {
+        out.push_back({ first, first + moves });
+        first += moves + 1;
+    }
+    return out;
+}
+
+TEST_CASE("G-code layer window opens on the bottom layers", "[GCodeLayerWindow]") {
+    const std::vector<TestLayerEndpoints> layers = test_layers(std::vector<size_t>(100, 99));
+    // 100 moves per layer, the first layer having one move less.
+    REQUIRE(GCodeLayerWindow::initial_range(layers, 1000) == LayersRange{ 0, 4 });
+    REQUIRE(GCodeLayerWindow::moves_count(layers, { 0, 4 }) <= 500);
+    // The first layer is shown even if it alone exceeds the budget.
+    REQUIRE(GCodeLayerWindow::initial_range(layers, 10) == LayersRange{ 0, 0 });
+    // The whole file fits.
+    REQUIRE(GCodeLayerWindow::initial_range(layers, 100000) == LayersRange{ 0, 99 });
+}
+
+TEST_CASE("G-code layer window grows around the selected layers", "[GCodeLayerWindow]") {
+    const std::vector<TestLayerEndpoints> layers = test_layers(std::vector<size_t>(100, 99));
+
+    SECTION("in the middle, the window grows both ways") {
+        LayersRange window = GCodeLayerWindow::grow_range(layers, { 50, 50 }, 1000);
+        REQUIRE(window == LayersRange{ 46, 55 });
+        REQUIRE(GCodeLayerWindow::contains(window, { 50, 50 }));
+    }
+    SECTION("at the bottom, the window grows up only") {
+        REQUIRE(GCodeLayerWindow::grow_range(layers, { 0, 1 }, 1000) == LayersRange{ 0, 9 });
+    }
+    SECTION("at the top, the window grows down only") {
+        REQUIRE(GCodeLayerWindow::grow_range(layers, { 99, 99 }, 1000) == LayersRange{ 90, 99 });
+    }
+    SECTION("the selection is clamped to the layers") {
+        REQUIRE(GCodeLayerWindow::grow_range(layers, { 200, 300 }, 1000) == LayersRange{ 90, 99 });
+    }
+    SECTION("the selection exceeding the budget is kept") {
+        REQUIRE(GCodeLayerWindow::grow_range(layers, { 10, 80 }, 1000) == LayersRange{ 10, 80 });
+    }
+    SECTION("the whole file fits") {
+        REQUIRE(GCodeLayerWindow::grow_range(layers, { 50, 60 }, 100000) == LayersRange{ 0, 99 });
+    }
+}
+
+TEST_CASE("G-code layer window stays within the budget", "[GCodeLayerWindow]") {
+    std::mt19937                          gen(1);
+    std::uniform_int_distribution<size_t> layer_moves(0, 2000);
+    std::vector<size_t>                   moves_per_layer(500);
+    for (size_t &moves : moves_per_layer)
+        moves = layer_moves(gen);
+    const std::vector<TestLayerEndpoints> layers = test_layers(moves_per_layer);
+    const size_t                          budget = 20000;
+
+    const LayersRange initial = GCodeLayerWindow::initial_range(layers, budget);
+    REQUIRE(initial[0] == 0);
+    REQUIRE(GCodeLayerWindow::moves_count(layers, initial) <= budget / 2);
+    REQUIRE(GCodeLayerWindow::moves_count(layers, { 0, initial[1] + 1 }) > budget / 2);
+
+    std::uniform_int_distribution<unsigned int> layer_id(0, unsigned(layers.size() - 1));
+    for (size_t i = 0; i < 1000; ++ i) {
+        LayersRange selected = { layer_id(gen), layer_id(gen) };
+        if (selected[0] > selected[1])
+            std::swap(selected[0], selected[1]);
+        const LayersRange window = GCodeLayerWindow::grow_range(layers, selected, budget);
+        REQUIRE(GCodeLayerWindow::contains(window, selected));
+        if (GCodeLayerWindow::moves_count(layers, selected) <= budget) {
+            REQUIRE(GCodeLayerWindow::moves_count(layers, window) <= budget);
+            // Neither of the neighbouring layers fits anymore.
+            if (window[0] > 0)
+                REQUIRE(GCodeLayerWindow::moves_count(layers, { window[0] - 1, window[1] }) > budget);
+            if (window[1] + 1 < layers.size())
+                REQUIRE(GCodeLayerWindow::moves_count(layers, { window[0], window[1] + 1 }) > budget);
+        } else
+            REQUIRE(window == selected);
+    }
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include "libslic3r/GCode/GCodeStream.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+
+using namespace Slic3r;
+
+static std::string read_all(GCodeStream &stream)
+{
+    std::string out;
+    char buffer[7];
+    while (size_t n = stream.read(buffer, sizeof(buffer)))
+        out.append(buffer, n);
+    return out;
+}
+
+TEST_CASE("GCodeStream passes the G-code without the placeholders", "[GCodeStream]") {
+    const std::string placeholder = ";" + GCodeProcessor::reserved_tag(GCodeProcessor::ETags::Estimated_Printing_Time_Placeholder) + "\n";
+    GCodeStream stream;
+    std::thread producer([&stream, &placeholder]() {
+        // Lines split across writes.
+        stream.write("G28\nG1 X");
+        stream.write("10 Y20\n" + placeholder);
+        stream.write("M84");
+        stream.finish("; total layer number: 1\n");
+    });
+    std::string out = read_all(stream);
+    producer.join();
+    REQUIRE(out == "G28\nG1 X10 Y20\nM84\n; total layer number: 1\n");
+    REQUIRE(stream.bytes_read() == out.size());
+}
+
+TEST_CASE("GCodeStream sends the footer of the exported file", "[GCodeStream]") {
+    // The footer as rewritten by the post-processing, longer than a single read of read_footer().
+    const std::string footer = "; EXECUTABLE_BLOCK_END\n\n; filament used [mm] = 1.50\n" + std::string(100000, ';') + "\n";
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    {
+        boost::nowide::ofstream file(temp.string(), std::ios::binary);
+        file << "G1 X10\nM117 ; EXECUTABLE_BLOCK_END\n" << footer;
+    }
+    GCodeStream stream;
+    std::thread producer([&stream, &temp]() {
+        stream.write("G1 X10\nM117 ; EXECUTABLE_BLOCK_END\n; EXECUTABLE_BLOCK_END\n\n; filament used [mm] = 1.00\n");
+        stream.write("; CONFIG_BLOCK_START\n");
+        stream.finish(GCodeStream::read_footer(temp.string()));
+    });
+    std::string out = read_all(stream);
+    producer.join();
+    boost::nowide::remove(temp.string().c_str());
+    REQUIRE(out == "G1 X10\nM117 ; EXECUTABLE_BLOCK_END\n" + footer);
+
+    {
+        boost::nowide::ofstream file(temp.string(), std::ios::binary);
+        file << "G1 X10\n";
+    }
+    REQUIRE(GCodeStream::read_footer(temp.string()).empty());
+    boost::nowide::remove(temp.string().c_str());
+}
+
+TEST_CASE("GCodeStream bounds the buffered G-code once reading started", "[GCodeStream]") {
+    GCodeStream stream(64);
+    const std::string line(31, 'G');
+    std::string expected;
+    for (int i = 0; i < 100; ++ i)
+        expected += line + "\n";
+    // Nobody reads yet, the writes must not block.
+    stream.write(expected.substr(0, 32 * 10));
+    std::thread producer([&stream, &expected]() {
+        for (size_t i = 10; i < 100; ++ i)
+            stream.write(expected.substr(32 * i, 32));
+        stream.finish(std::string());
+    });
+    REQUIRE(read_all(stream) == expected);
+    producer.join();
+}
+
+TEST_CASE("GCodeStream abort releases both sides", "[GCodeStream]") {
+    GCodeStream stream(16);
+    size_t first_read = 0;
+    bool   thrown     = false;
+    std::thread consumer([&stream, &first_read, &thrown]() {
+        char buffer[8];
+        first_read = stream.read(buffer, sizeof(buffer));
+        // The producer blocks on a full buffer now, abort to release it.
+        stream.abort();
+        try {
+            stream.read(buffer, sizeof(buffer));
+        } catch (const GCodeStreamAborted &) {
+            thrown = true;
+        }
+    });
+    for (int i = 0; i < 100; ++ i)
+        stream.write("G1 X1 Y1 E0.1\n");
+    stream.finish("; trailer\n");
+    consumer.join();
+    REQUIRE(first_read > 0);
+    REQUIRE(thrown);
+    REQUIRE(stream.aborted());
+}
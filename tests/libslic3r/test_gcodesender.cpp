@@ -0,0 +1,304 @@
+#include <catch2/catch.hpp>
+#include <benchmark_utils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "libslic3r/GCodeSender.hpp"
+
+using namespace Slic3r;
+
+// Stand-in for the printer on the master side of a pseudo-terminal. Decodes MeatPack, checks the line numbers
+// and checksums and answers "ok" or requests a resend the way Marlin does.
+class FakePrinter
+{
+public:
+    FakePrinter()
+    {
+        m_master = ::posix_openpt(O_RDWR | O_NOCTTY);
+        if (m_master >= 0 && ::grantpt(m_master) == 0 && ::unlockpt(m_master) == 0)
+            m_slave_name = ::ptsname(m_master);
+    }
+    ~FakePrinter()
+    {
+        this->stop();
+        if (m_master >= 0)
+            ::close(m_master);
+    }
+
+    const std::string& device() const { return m_slave_name; }
+
+    // Simulated serial line speed, 0 for unlimited.
+    void set_baud_rate(unsigned int baud_rate) { m_baud_rate = baud_rate; }
+    // Report a checksum error on the first reception of this line number.
+    void set_corrupt_line(size_t line_num) { m_corrupt_line = line_num; }
+
+    // To be called once the sender connected.
+    void start()
+    {
+        m_thread = std::thread([this]() { this->run(); });
+        this->reply("start\n");
+    }
+    void stop()
+    {
+        m_stop = true;
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    std::vector<std::string> received() const { std::lock_guard<std::mutex> l(m_mutex); return m_received; }
+    size_t                   received_count() const { std::lock_guard<std::mutex> l(m_mutex); return m_received.size(); }
+    size_t                   resends() const { return m_resends; }
+
+private:
+    void reply(const std::string &s) { (void)!::write(m_master, s.data(), s.size()); }
+
+    void run()
+    {
+        unsigned char buf[256];
+        while (! m_stop) {
+            pollfd pfd { m_master, POLLIN, 0 };
+            if (::poll(&pfd, 1, 10) <= 0 || ! (pfd.revents & POLLIN))
+                continue;
+            ssize_t cnt = ::read(m_master, buf, sizeof(buf));
+            if (cnt <= 0)
+                continue;
+            if (m_baud_rate > 0)
+                // 10 bits per byte on the wire
+                std::this_thread::sleep_for(std::chrono::microseconds(cnt * 10 * 1000000 / m_baud_rate));
+            for (ssize_t i = 0; i < cnt; ++ i)
+                this->receive_byte(buf[i]);
+        }
+    }
+
+    // MeatPack decoder of Marlin.
+    void receive_byte(unsigned char c)
+    {
+        if (c == MeatPack::SignalByte) {
+            if (m_signal_count) {
+                m_command_next = true;
+                m_signal_count = 0;
+            } else
+                ++ m_signal_count;
+            return;
+        }
+        if (m_command_next) {
+            m_command_next = false;
+            switch (c) {
+            case MeatPack::CmdEnablePacking:   m_packing = true; break;
+            case MeatPack::CmdDisablePacking:  m_packing = false; break;
+            case MeatPack::CmdEnableNoSpaces:  m_no_spaces = true; break;
+            case MeatPack::CmdDisableNoSpaces: m_no_spaces = false; break;
+            default: break;
+            }
+            return;
+        }
+        if (m_signal_count) {
+            this->receive_packed(MeatPack::SignalByte);
+            m_signal_count = 0;
+        }
+        this->receive_packed(c);
+    }
+
+    void receive_packed(unsigned char c)
+    {
+        static const char table[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '.', ' ', '\n', 'G', 'X', 0 };
+        auto unpack = [this](unsigned char code) { return code == 11 && m_no_spaces ? 'E' : table[code]; };
+        if (! m_packing) {
+            this->receive_char(char(c));
+        } else if (m_full_chars == 0) {
+            unsigned char code1 = c & 0x0F;
+            unsigned char code2 = c >> 4;
+            if (code1 == MeatPack::FullCharCode) {
+                ++ m_full_chars;
+                if (code2 == MeatPack::FullCharCode)
+                    ++ m_full_chars;
+                else
+                    m_second_char = unpack(code2);
+            } else {
+                char c1 = unpack(code1);
+                this->receive_char(c1);
+                if (c1 != '\n') {
+                    if (code2 == MeatPack::FullCharCode)
+                        ++ m_full_chars;
+                    else
+                        this->receive_char(unpack(code2));
+                }
+            }
+        } else {
+            this->receive_char(char(c));
+            if (m_second_char) {
+                this->receive_char(m_second_char);
+                m_second_char = 0;
+            }
+            -- m_full_chars;
+        }
+    }
+
+    void receive_char(char c)
+    {
+        if (c != '\n') {
+            m_line += c;
+            return;
+        }
+        std::string line;
+        std::swap(line, m_line);
+        size_t star = line.rfind('*');
+        int    cs   = 0;
+        for (size_t i = 0; i < star && star != std::string::npos; ++ i)
+            cs ^= line[i];
+        size_t num_end  = line.find_first_not_of("0123456789", 1);
+        size_t line_num = line[0] == 'N' ? std::stoul(line.substr(1, num_end - 1)) : 0;
+        bool   corrupt  = line_num == m_corrupt_line && m_corrupt_line != 0;
+        if (corrupt)
+            m_corrupt_line = 0;
+        if (star == std::string::npos || std::stoi(line.substr(star + 1)) != cs || corrupt || line_num != m_last_line + 1) {
+            ++ m_resends;
+            this->reply("Error:checksum mismatch\nResend: " + std::to_string(m_last_line + 1) + "\nok\n");
+            return;
+        }
+        m_last_line = line_num;
+        size_t cmd_begin = line.find_first_not_of(' ', num_end);
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            m_received.emplace_back(line.substr(cmd_begin, star - cmd_begin));
+        }
+        this->reply("ok\n");
+    }
+
+    int                 m_master { -1 };
+    std::string         m_slave_name;
+    std::thread         m_thread;
+    std::atomic<bool>   m_stop { false };
+    unsigned int        m_baud_rate { 0 };
+    size_t              m_corrupt_line { 0 };
+    std::atomic<size_t> m_resends { 0 };
+
+    int                 m_signal_count { 0 };
+    bool                m_command_next { false };
+    bool                m_packing { false };
+    bool                m_no_spaces { false };
+    int                 m_full_chars { 0 };
+    char                m_second_char { 0 };
+    std::string         m_line;
+    size_t              m_last_line { 0 };
+
+    mutable std::mutex       m_mutex;
+    std::vector<std::string> m_received;
+};
+
+static std::vector<std::string> dense_gcode(size_t lines)
+{
+    std::vector<std::string> out;
+    out.reserve(lines);
+    for (size_t i = 0; i < lines; ++ i) {
+        char buf[64];
+        sprintf(buf, "G1 X%.3f Y%.3f E%.5f", 100. + 20. * std::cos(i * 0.01), 100. + 20. * std::sin(i * 0.01), 0.01234 + i % 7 * 0.001);
+        out.emplace_back(buf);
+    }
+    out.emplace_back("M117 Layer done");
+    return out;
+}
+
+struct SendResult
+{
+    std::vector<std::string> received;
+    size_t                   bytes_written;
+    size_t                   resends;
+    double                   seconds;
+};
+
+static SendResult send_gcode(const std::vector<std::string> &gcode, bool meatpack, bool omit_spaces, size_t window_lines, unsigned int baud_rate, size_t corrupt_line = 0)
+{
+    FakePrinter printer;
+    REQUIRE(! printer.device().empty());
+    printer.set_baud_rate(baud_rate);
+    printer.set_corrupt_line(corrupt_line);
+
+    GCodeSender sender;
+    sender.set_meatpack(meatpack, omit_spaces);
+    // 127 bytes fit the receive buffer of Marlin.
+    sender.set_send_window(window_lines, 127);
+    REQUIRE(sender.connect(printer.device(), 115200));
+    printer.start();
+    REQUIRE(sender.wait_connected(5));
+
+    double seconds = benchmark_seconds([&sender, &printer, &gcode]() {
+        sender.send(gcode);
+        for (int i = 0; i < 6000 && printer.received_count() < gcode.size(); ++ i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    });
+
+    SendResult res { printer.received(), sender.bytes_written(), printer.resends(), seconds };
+    sender.disconnect();
+    printer.stop();
+    return res;
+}
+
+static std::string without_spaces(std::string s)
+{
+    s.erase(std::remove(s.begin(), s.end(), ' '), s.end());
+    return s;
+}
+
+TEST_CASE("MeatPack packs two G-code characters per byte", "[GCodeSender]") {
+    const std::string line = "N12 G1 X10.5 Y20.25*93\n";
+    const std::string packed = MeatPack::pack_line(line, false);
+    // 'N', 'Y' and '*' are sent in full.
+    REQUIRE(packed.size() == (line.size() + 1) / 2 + 3);
+    REQUIRE(MeatPack::pack_char('G', false) == 13);
+    REQUIRE(MeatPack::pack_char(' ', true) == MeatPack::FullCharCode);
+    REQUIRE(MeatPack::pack_char('E', true) == 11);
+}
+
+SCENARIO("GCodeSender streams to a printer on a pseudo-terminal", "[GCodeSender]") {
+    const std::vector<std::string> gcode = dense_gcode(500);
+    GIVEN("Plain text, one line at a time") {
+        SendResult plain = send_gcode(gcode, false, false, 1, 0);
+        THEN("all lines are received in order") {
+            REQUIRE(plain.received == gcode);
+        }
+        AND_WHEN("the same G-code is sent MeatPack encoded with spaces omitted and a send-ahead window") {
+            SendResult packed = send_gcode(gcode, true, true, 4, 0);
+            THEN("all lines are received in order") {
+                REQUIRE(packed.received.size() == gcode.size());
+                for (size_t i = 0; i + 1 < gcode.size(); ++ i)
+                    REQUIRE(packed.received[i] == without_spaces(gcode[i]));
+                // The string argument of M117 keeps its spaces.
+                REQUIRE(packed.received.back() == gcode.back());
+            }
+            THEN("less than 60% of the bytes are written to the serial line") {
+                REQUIRE(packed.bytes_written < 0.6 * plain.bytes_written);
+            }
+        }
+    }
+    GIVEN("A line rejected by the printer while lines were sent ahead") {
+        SendResult res = send_gcode(gcode, true, false, 4, 0, 100);
+        THEN("the lines are resent and received exactly once in order") {
+            REQUIRE(res.resends > 0);
+            REQUIRE(res.received == gcode);
+        }
+    }
+}
+
+TEST_CASE("GCodeSender throughput at 115200 baud benchmark", "[GCodeSender][.][benchmark]") {
+    const std::vector<std::string> gcode = dense_gcode(3000);
+    SendResult plain  = send_gcode(gcode, false, false, 1, 115200);
+    SendResult packed = send_gcode(gcode, true, true, 4, 115200);
+    REQUIRE(plain.received.size() == gcode.size());
+    REQUIRE(packed.received.size() == gcode.size());
+    benchmark_log("GCodeSender", "plain text, single line ", gcode.size() / plain.seconds, " lines/s, ", plain.bytes_written, " bytes");
+    benchmark_log("GCodeSender", "MeatPack, no spaces, window of 4 ", gcode.size() / packed.seconds, " lines/s, ", packed.bytes_written, " bytes");
+}
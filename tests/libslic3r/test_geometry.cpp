@@ -1,4 +1,5 @@
 #include <catch2/catch.hpp>
+#include <benchmark_utils.hpp>
 
 #include "libslic3r/Point.hpp"
 #include "libslic3r/BoundingBox.hpp"
@@ -708,3 +709,76 @@ TEST_CASE("Convex polygon intersection test prusa polygons", "[Geometry][Rotcali
         REQUIRE(res == ref);
     }
 }
+
+// Reference implementation of the Douglas-Peucker simplification with the scalar distance evaluation.
+static Points douglas_peucker_reference(const Points &pts, double tolerance)
+{
+    Points out { pts.front() };
+    std::vector<size_t> stack { pts.size() - 1 };
+    size_t anchor = 0;
+    while (! stack.empty()) {
+        size_t floater = stack.back();
+        double max_dist_sq = 0.;
+        size_t furthest = anchor;
+        for (size_t i = anchor + 1; i < floater; ++ i)
+            if (double d = Line::distance_to_squared(pts[i], pts[anchor], pts[floater]); d > max_dist_sq) {
+                max_dist_sq = d;
+                furthest    = i;
+            }
+        if (max_dist_sq <= tolerance * tolerance) {
+            out.emplace_back(pts[floater]);
+            anchor = floater;
+            stack.pop_back();
+        } else
+            stack.emplace_back(furthest);
+    }
+    return out;
+}
+
+// Points of a wavy ring resembling the outline of a curved part, sampled densely.
+static Points wavy_ring(size_t num_points, coord_t radius)
+{
+    Points out;
+    out.reserve(num_points);
+    for (size_t i = 0; i < num_points; ++ i) {
+        double a = 2. * PI * double(i) / double(num_points);
+        double r = radius * (1. + 0.05 * sin(12. * a));
+        out.emplace_back(coord_t(r * cos(a)), coord_t(r * sin(a)));
+    }
+    return out;
+}
+
+TEST_CASE("Douglas-Peucker matches the reference implementation", "[Geometry]") {
+    for (double tolerance : { 0., scaled<double>(0.001), scaled<double>(0.01), scaled<double>(0.1) }) {
+        Points pts = wavy_ring(5000, scaled<coord_t>(20.));
+        REQUIRE(MultiPoint::_douglas_peucker(pts, tolerance) == douglas_peucker_reference(pts, tolerance));
+        // Closed loop, the anchor and floater coincide.
+        pts.emplace_back(pts.front());
+        REQUIRE(MultiPoint::_douglas_peucker(pts, tolerance) == douglas_peucker_reference(pts, tolerance));
+    }
+}
+
+TEST_CASE("Path simplification on curved parts benchmark", "[Geometry][.][benchmark]") {
+    Polylines polylines;
+    for (size_t i = 0; i < 200; ++ i)
+        polylines.emplace_back(wavy_ring(20000, scaled<coord_t>(10. + 0.2 * double(i))));
+    const double tolerance = scaled<double>(0.01);
+
+    size_t num_reference = 0;
+    double time_reference = benchmark_seconds([&polylines, &num_reference, tolerance]() {
+        for (const Polyline &pl : polylines)
+            num_reference += douglas_peucker_reference(pl.points, tolerance).size();
+    });
+    size_t num_simplified = 0;
+    double time_simplified = benchmark_seconds([&polylines, &num_simplified, tolerance]() {
+        for (const Polyline &pl : polylines)
+            num_simplified += MultiPoint::_douglas_peucker(pl.points, tolerance).size();
+    });
+    double time_arc_fitting = benchmark_seconds([&polylines, tolerance]() {
+        for (Polyline &pl : polylines)
+            pl.simplify_by_fitting_arc(tolerance);
+    });
+
+    benchmark_log("Douglas-Peucker", "reference ", time_reference, "s, vectorized ", time_simplified, "s, arc fitting ", time_arc_fitting, "s");
+    REQUIRE(num_reference == num_simplified);
+}
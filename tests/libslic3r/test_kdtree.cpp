@@ -0,0 +1,153 @@
+#include <catch2/catch.hpp>
+#include <benchmark_utils.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "libslic3r/KDTreeIndirect.hpp"
+#include "libslic3r/KDTreeStatic.hpp"
+#include "libslic3r/Point.hpp"
+#include "libslic3r/Polyline.hpp"
+#include "libslic3r/ShortestPath.hpp"
+
+using namespace Slic3r;
+
+// Random points on a small grid, so that equal coordinates and equal distances are hit often.
+static std::vector<Vec2d> random_points(size_t count, int range, unsigned int seed)
+{
+    std::mt19937                       gen(seed);
+    std::uniform_int_distribution<int> coord(-range, range);
+    std::vector<Vec2d>                 out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++ i)
+        out.emplace_back(coord(gen), coord(gen));
+    return out;
+}
+
+TEST_CASE("KDTreeStatic queries match KDTreeIndirect and brute force", "[KDTree]") {
+    for (size_t num_points : { 0, 1, 2, 3, 7, 8, 9, 100, 1023, 1024, 1025, 5000 }) {
+        const std::vector<Vec2d> pts = random_points(num_points, 50, unsigned(num_points) + 1);
+        auto                     point_fn = [&pts](size_t idx) -> const Vec2d& { return pts[idx]; };
+        KDTreeStatic<2, double>  kdtree(pts.size(), point_fn);
+        auto                     coordinate_fn = [&pts](size_t idx, size_t dimension) -> double { return pts[idx][dimension]; };
+        KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree_indirect(coordinate_fn, pts.size());
+        REQUIRE(kdtree.size() == num_points);
+
+        const std::vector<Vec2d> queries = random_points(200, 55, unsigned(num_points) + 1000);
+        // Filter out every third point to test the filtered queries.
+        auto filter = [](size_t idx) { return idx % 3 != 0; };
+        auto squared_distance = [&pts](size_t idx, const Vec2d &pt) { return (pts[idx] - pt).squaredNorm(); };
+
+        {
+            // Closest point.
+            for (const Vec2d &q : queries) {
+                size_t idx     = find_closest_point(kdtree, q, filter);
+                // KDTreeIndirect does not accept queries into an empty tree.
+                size_t idx_ref = pts.empty() ? KDTreeStatic<2, double>::npos : find_closest_point(kdtree_indirect, q, filter);
+                REQUIRE((idx == KDTreeStatic<2, double>::npos) == (idx_ref == decltype(kdtree_indirect)::npos));
+                if (idx != KDTreeStatic<2, double>::npos) {
+                    REQUIRE(filter(idx));
+                    // The points may be equidistant, compare the distances.
+                    REQUIRE(squared_distance(idx, q) == squared_distance(idx_ref, q));
+                }
+            }
+        }
+        {
+            // K closest points.
+            for (const Vec2d &q : queries) {
+                std::array<size_t, 3> idxs = find_closest_points<3>(kdtree, q, filter);
+                std::vector<double>   dists_ref;
+                for (size_t idx = 0; idx < pts.size(); ++ idx)
+                    if (filter(idx))
+                        dists_ref.emplace_back(squared_distance(idx, q));
+                std::sort(dists_ref.begin(), dists_ref.end());
+                for (size_t i = 0; i < 3; ++ i)
+                    if (i < dists_ref.size())
+                        REQUIRE(squared_distance(idxs[i], q) == dists_ref[i]);
+                    else
+                        REQUIRE(idxs[i] == KDTreeStatic<2, double>::npos);
+            }
+        }
+        {
+            // Nearby points.
+            for (const Vec2d &q : queries) {
+                std::vector<size_t> idxs = find_nearby_points(kdtree, q, 7.5, filter);
+                std::vector<size_t> idxs_ref;
+                for (size_t idx = 0; idx < pts.size(); ++ idx)
+                    if (filter(idx) && squared_distance(idx, q) < 7.5 * 7.5)
+                        idxs_ref.emplace_back(idx);
+                std::sort(idxs.begin(), idxs.end());
+                REQUIRE(idxs == idxs_ref);
+            }
+        }
+        {
+            // Batched queries.
+            // Closest other point to each of the points, as used for chaining of the end points.
+            auto other_filter = [](size_t query_idx, size_t idx) { return idx != query_idx; };
+            std::vector<std::array<size_t, 1>> closest = kdtree.closest_points_batch<1>(pts.size(), point_fn, other_filter);
+            std::vector<std::vector<size_t>>   nearby  = kdtree.nearby_points_batch(pts.size(), point_fn, 3., other_filter);
+            REQUIRE(closest.size() == pts.size());
+            REQUIRE(nearby.size() == pts.size());
+            for (size_t i = 0; i < pts.size(); ++ i) {
+                auto   filter_i = [i](size_t idx) { return idx != i; };
+                size_t idx_ref  = find_closest_point(kdtree_indirect, pts[i], filter_i);
+                if (idx_ref == decltype(kdtree_indirect)::npos)
+                    REQUIRE(closest[i].front() == KDTreeStatic<2, double>::npos);
+                else
+                    REQUIRE(squared_distance(closest[i].front(), pts[i]) == squared_distance(idx_ref, pts[i]));
+                std::vector<size_t> idxs_ref;
+                kdtree.nearby_points(pts[i], 3., filter_i, idxs_ref);
+                std::sort(nearby[i].begin(), nearby[i].end());
+                std::sort(idxs_ref.begin(), idxs_ref.end());
+                REQUIRE(nearby[i] == idxs_ref);
+            }
+        }
+    }
+}
+
+TEST_CASE("KDTreeStatic vs. KDTreeIndirect performance", "[KDTree][.][benchmark]") {
+    // End points of short segments as produced by chaining of infill lines.
+    const std::vector<Vec2d> pts = random_points(100000, 10000000, 1);
+    // Closest point on another segment, the query issued for each end point by the chaining.
+    auto                     filter_fn = [](size_t this_idx) { return [this_idx](size_t idx) { return (idx ^ this_idx) > 1; }; };
+    size_t                   sink      = 0;
+
+    auto coordinate_fn = [&pts](size_t idx, size_t dimension) -> double { return pts[idx][dimension]; };
+    std::unique_ptr<KDTreeIndirect<2, double, decltype(coordinate_fn)>> kdtree_indirect;
+    double t_build_indirect = benchmark_seconds([&]() { kdtree_indirect = std::make_unique<KDTreeIndirect<2, double, decltype(coordinate_fn)>>(coordinate_fn, pts.size()); });
+    double t_query_indirect = benchmark_seconds([&]() {
+        for (size_t i = 0; i < pts.size(); ++ i)
+            sink += find_closest_point(*kdtree_indirect, pts[i], filter_fn(i));
+    });
+
+    auto point_fn = [&pts](size_t idx) -> const Vec2d& { return pts[idx]; };
+    std::unique_ptr<KDTreeStatic<2, double>> kdtree;
+    double t_build_static = benchmark_seconds([&]() { kdtree = std::make_unique<KDTreeStatic<2, double>>(pts.size(), point_fn); });
+    double t_query_static = benchmark_seconds([&]() {
+        for (size_t i = 0; i < pts.size(); ++ i)
+            sink += find_closest_point(*kdtree, pts[i], filter_fn(i));
+    });
+    double t_query_batch = benchmark_seconds([&]() {
+        std::vector<std::array<size_t, 1>> closest = kdtree->closest_points_batch<1>(pts.size(), point_fn,
+            [](size_t this_idx, size_t idx) { return (idx ^ this_idx) > 1; });
+        sink += closest.back().front();
+    });
+
+    benchmark_log("KDTree", pts.size(), " points: KDTreeIndirect build ", t_build_indirect, "s, queries ", t_query_indirect,
+                  "s; KDTreeStatic build ", t_build_static, "s, queries ", t_query_static, "s, batched queries ", t_query_batch, "s (", sink, ")");
+
+    Polylines polylines;
+    std::mt19937                         gen(2);
+    std::uniform_int_distribution<coord_t> coord(0, scaled<coord_t>(200.));
+    std::uniform_int_distribution<coord_t> offset(-scaled<coord_t>(2.), scaled<coord_t>(2.));
+    for (size_t i = 0; i < 50000; ++ i) {
+        Point pt(coord(gen), coord(gen));
+        polylines.emplace_back(pt, pt + Point(offset(gen), offset(gen)));
+    }
+    Polylines chained;
+    double    t_chain = benchmark_seconds([&polylines, &chained]() { chained = chain_polylines(polylines); });
+    benchmark_log("KDTree", "chain_polylines of ", polylines.size(), " polylines ", t_chain, "s");
+    REQUIRE(chained.size() == polylines.size());
+}
@@ -2,6 +2,9 @@
 #include <catch2/catch.hpp>
 
 #include <numeric>
+#include <set>
+
+#include <miniz.h>
 
 #include "libslic3r/PNGReadWrite.hpp"
 #include "libslic3r/SLA/AGGRaster.hpp"
@@ -53,3 +56,105 @@ TEST_CASE("PNG read", "[PNG]") {
         REQUIRE(sum == rstsum);
     }
 }
+
+// Gradient image of four bands of 16 rows, each band compressing best with another png row filter.
+static std::vector<uint8_t> create_gradient(int width, int channels)
+{
+    const int            row_len = width * channels;
+    std::vector<uint8_t> out(row_len * 64);
+    for (int y = 0; y < 64; ++ y)
+        for (int x = 0; x < width; ++ x)
+            for (int c = 0; c < channels; ++ c) {
+                int v;
+                if (y < 16)
+                    // Horizontal gradient with a random offset of each row: Sub.
+                    v = 3 * x + (y * 97) % 256 + 20 * c;
+                else if (y < 32)
+                    // Vertical gradient with random columns: Up.
+                    v = (x * 97) % 256 + y + 20 * c;
+                else if (y < 48)
+                    // Diagonal gradient: Paeth.
+                    v = 4 * x - 4 * y + 128 + (x * y) % 3 + 20 * c;
+                else if (x == 0)
+                    v = y * 59 + c * 80;
+                else
+                    // Average of the left and upper neighbors with alternating noise: Average.
+                    v = ((out[row_len * y + (x - 1) * channels + c] + out[row_len * (y - 1) + x * channels + c]) >> 1) + ((x + y) % 2 ? 7 : -7);
+                out[row_len * y + x * channels + c] = uint8_t(v);
+            }
+    return out;
+}
+
+// Filter types of the rows of a png written by encode_png(), which stores the image data in a single IDAT chunk.
+static std::set<uint8_t> row_filters(const std::vector<uint8_t> &encoded, size_t row_len, size_t rows)
+{
+    // Signature and IHDR chunk.
+    const size_t idat = 8 + 12 + 13;
+    REQUIRE(std::string(encoded.begin() + idat + 4, encoded.begin() + idat + 8) == "IDAT");
+    const mz_ulong idat_len = (mz_ulong(encoded[idat]) << 24) | (mz_ulong(encoded[idat + 1]) << 16) | (mz_ulong(encoded[idat + 2]) << 8) | mz_ulong(encoded[idat + 3]);
+    std::vector<uint8_t> filtered((row_len + 1) * rows);
+    mz_ulong             filtered_len = mz_ulong(filtered.size());
+    REQUIRE(mz_uncompress(filtered.data(), &filtered_len, encoded.data() + idat + 8, idat_len) == MZ_OK);
+    REQUIRE(filtered_len == filtered.size());
+    std::set<uint8_t> out;
+    for (size_t r = 0; r < rows; ++ r)
+        out.insert(filtered[(row_len + 1) * r]);
+    return out;
+}
+
+TEST_CASE("PNG encode", "[PNG]") {
+    auto rst = create_raster({120, 80});
+    auto enc_rst = rst.encode(sla::PNGRasterEncoder{});
+    png::ImageGreyscale img;
+    REQUIRE(png::decode_png({enc_rst.data(), enc_rst.size()}, img));
+
+    SECTION("Filtered grayscale png decodes to the original pixels") {
+        std::vector<uint8_t> encoded;
+        REQUIRE(png::encode_png(img.buf.data(), img.cols, img.rows, 1, encoded));
+        REQUIRE(png::is_png({encoded.data(), encoded.size()}));
+
+        png::ImageGreyscale decoded;
+        REQUIRE(png::decode_png({encoded.data(), encoded.size()}, decoded));
+        REQUIRE(decoded.cols == img.cols);
+        REQUIRE(decoded.rows == img.rows);
+        REQUIRE(decoded.buf == img.buf);
+    }
+
+    SECTION("Flipped png stores the rows bottom up") {
+        std::vector<uint8_t> encoded;
+        REQUIRE(png::encode_png(img.buf.data(), img.cols, img.rows, 1, encoded, true));
+
+        png::ImageGreyscale decoded;
+        REQUIRE(png::decode_png({encoded.data(), encoded.size()}, decoded));
+        for (size_t r = 0; r < img.rows; ++ r)
+            for (size_t c = 0; c < img.cols; ++ c)
+                REQUIRE(decoded.get(r, c) == img.get(img.rows - 1 - r, c));
+    }
+
+    SECTION("Invalid images are refused") {
+        std::vector<uint8_t> encoded;
+        REQUIRE(!png::encode_png(img.buf.data(), 0, img.rows, 1, encoded));
+        REQUIRE(!png::encode_png(img.buf.data(), img.cols, img.rows, 5, encoded));
+    }
+
+    SECTION("Filtered RGB and RGBA gradients decode to the original pixels") {
+        for (int channels : { 3, 4 }) {
+            const int            width   = 48;
+            const size_t         row_len = width * channels;
+            std::vector<uint8_t> pixels  = create_gradient(width, channels);
+            std::vector<uint8_t> encoded;
+            REQUIRE(png::encode_png(pixels.data(), width, 64, channels, encoded));
+            // The bands of the gradient make the encoder pick each of the filters.
+            REQUIRE(row_filters(encoded, row_len, 64) == std::set<uint8_t>{ 0, 1, 2, 3, 4 });
+
+            png::ImageColorscale decoded;
+            REQUIRE(png::decode_colored_png({encoded.data(), encoded.size()}, decoded));
+            REQUIRE(decoded.bytes_per_pixel == channels);
+            REQUIRE(decoded.cols == width);
+            REQUIRE(decoded.rows == 64);
+            // decode_colored_png() stores the rows bottom up.
+            for (size_t r = 0; r < 64; ++ r)
+                REQUIRE(std::equal(pixels.begin() + row_len * r, pixels.begin() + row_len * (r + 1), decoded.buf.begin() + row_len * (63 - r)));
+        }
+    }
+}
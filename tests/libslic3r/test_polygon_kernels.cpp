@@ -0,0 +1,274 @@
+#include <catch2/catch.hpp>
+#include <benchmark_utils.hpp>
+
+#include <random>
+#include <vector>
+
+#include "libslic3r/BoundingBox.hpp"
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/Line.hpp"
+#include "libslic3r/MultiPoint.hpp"
+#include "libslic3r/Point.hpp"
+#include "libslic3r/Polygon.hpp"
+#include "libslic3r/PolygonKernels.hpp"
+
+using namespace Slic3r;
+
+// Random points on a small grid, so that points on the segment, at its end points and duplicate points are hit often.
+static Points random_points(size_t count, int64_t range, unsigned int seed)
+{
+    std::mt19937_64                        gen(seed);
+    std::uniform_int_distribution<int64_t> coord(-range, range);
+    Points                                 out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++ i)
+        out.emplace_back(coord(gen), coord(gen));
+    return out;
+}
+
+// Random polygons of 1 to 40 points.
+static Polygons random_polygons(size_t count, int64_t range, unsigned int seed)
+{
+    std::mt19937 gen(seed);
+    Polygons     out;
+    for (size_t i = 0; i < count; ++ i)
+        out.emplace_back(random_points(1 + gen() % 40, range, seed + 1 + unsigned(i)));
+    return out;
+}
+
+static std::vector<Vec2i32> to_vec2i32(const Points &pts)
+{
+    std::vector<Vec2i32> out;
+    out.reserve(pts.size());
+    for (const Point &pt : pts)
+        out.emplace_back(pt.cast<int32_t>());
+    return out;
+}
+
+// The loop replaced by PolygonKernels::signed_area2() in Polygon::area().
+static double area_reference(const Points &pts)
+{
+    double a = 0.;
+    if (pts.size() >= 3) {
+        Vec2d p1 = pts.back().cast<double>();
+        for (const Point &p : pts) {
+            Vec2d p2 = p.cast<double>();
+            a += cross2(p1, p2);
+            p1 = p2;
+        }
+    }
+    return 0.5 * a;
+}
+
+// The scalar loop replaced by PolygonKernels::furthest_from_segment().
+static std::pair<size_t, double> furthest_reference(const Points &pts, size_t begin, size_t end, const Point &a, const Point &b)
+{
+    std::pair<size_t, double> out { begin - 1, 0. };
+    for (size_t i = begin; i < end; ++ i)
+        if (double dist_sq = Line::distance_to_squared(pts[i], a, b); dist_sq > out.second)
+            out = { i, dist_sq };
+    return out;
+}
+
+TEST_CASE("Polygon kernels match the scalar implementations", "[PolygonKernels]") {
+    const Points pts = random_points(5000, 20, 1);
+    std::mt19937 gen(2);
+
+    // Small coordinates hit the boundary and duplicate cases, the largest ones the fallback of the area kernel for polygons
+    // exceeding 32bit coordinates relative to their first point.
+    for (int64_t range : { int64_t(20), int64_t(1000000000), int64_t(1) << 60 }) {
+        const Polygons polygons = random_polygons(1000, range, 1);
+        std::uniform_int_distribution<int64_t> coord(- range - 2, range + 2);
+        SECTION("area, range " + std::to_string(range)) {
+            for (const Polygon &poly : polygons) {
+                const double area2 = PolygonKernels::signed_area2(poly.points.data(), poly.points.size());
+                REQUIRE(area2 == PolygonKernels::scalar::signed_area2(poly.points.data(), poly.points.size()));
+                REQUIRE(poly.area() == Approx(area_reference(poly.points)).epsilon(1e-12).margin(1e-12 * double(range) * double(range)));
+                if (range < (int64_t(1) << 31)) {
+                    std::vector<Vec2i32> pts32 = to_vec2i32(poly.points);
+                    REQUIRE(PolygonKernels::signed_area2(pts32.data(), pts32.size()) == area2);
+                }
+            }
+        }
+        SECTION("extents, range " + std::to_string(range)) {
+            for (const Polygon &poly : polygons) {
+                Point pmin, pmax, rmin, rmax;
+                PolygonKernels::extents(poly.points.data(), poly.points.size(), pmin, pmax);
+                PolygonKernels::scalar::extents(poly.points.data(), poly.points.size(), rmin, rmax);
+                REQUIRE(pmin == rmin);
+                REQUIRE(pmax == rmax);
+                BoundingBox bbox = get_extents<true>(poly.points);
+                REQUIRE((bbox.defined && bbox.min == rmin && bbox.max == rmax));
+                if (range < (int64_t(1) << 31)) {
+                    std::vector<Vec2i32> pts32 = to_vec2i32(poly.points);
+                    Vec2i32 pmin32, pmax32;
+                    PolygonKernels::extents(pts32.data(), pts32.size(), pmin32, pmax32);
+                    REQUIRE(pmin32 == rmin.cast<int32_t>());
+                    REQUIRE(pmax32 == rmax.cast<int32_t>());
+                }
+            }
+        }
+        SECTION("point in polygon, range " + std::to_string(range)) {
+            for (const Polygon &poly : polygons) {
+                std::vector<Vec2i32> pts32 = to_vec2i32(poly.points);
+                for (int i = 0; i < 20; ++ i) {
+                    // Every other point is a vertex, which lies on the boundary.
+                    const Point pt = i % 2 == 0 ? Point(coord(gen), coord(gen)) : poly.points[gen() % poly.points.size()];
+                    const int   result = PolygonKernels::point_in_polygon(poly.points.data(), poly.points.size(), pt);
+                    REQUIRE(result == ClipperLib::PointInPolygon(pt, poly.points));
+                    REQUIRE(result == PolygonKernels::scalar::point_in_polygon(poly.points.data(), poly.points.size(), pt));
+                    if (range < (int64_t(1) << 31))
+                        REQUIRE(PolygonKernels::point_in_polygon(pts32.data(), pts32.size(), Vec2i32(pt.cast<int32_t>())) == result);
+                }
+            }
+        }
+    }
+    SECTION("consecutive duplicates") {
+        for (size_t i = 0; i < 2000; ++ i) {
+            Points path = random_points(gen() % 70, 1000, unsigned(i));
+            // Insert a duplicate into every other path.
+            if (i % 2 == 0 && ! path.empty()) {
+                size_t idx = gen() % path.size();
+                path.insert(path.begin() + idx, path[idx]);
+            }
+            const size_t first = PolygonKernels::find_consecutive_duplicate(path.data(), path.size());
+            REQUIRE(first == PolygonKernels::scalar::find_consecutive_duplicate(path.data(), path.size()));
+            std::vector<Vec2i32> path32 = to_vec2i32(path);
+            REQUIRE(PolygonKernels::find_consecutive_duplicate(path32.data(), path32.size()) == first);
+            // Only the y coordinates are equal.
+            if (path.size() > 1) {
+                path[path.size() / 2].y() = path[path.size() / 2 - 1].y();
+                REQUIRE(PolygonKernels::find_consecutive_duplicate(path.data(), path.size()) == PolygonKernels::scalar::find_consecutive_duplicate(path.data(), path.size()));
+            }
+        }
+    }
+    SECTION("remove duplicate points") {
+        for (size_t i = 0; i < 200; ++ i) {
+            Polyline polyline(random_points(gen() % 70, 2, unsigned(i)));
+            Points   expected;
+            for (const Point &pt : polyline.points)
+                if (expected.empty() || expected.back() != pt)
+                    expected.emplace_back(pt);
+            const bool removed = expected.size() < polyline.points.size();
+            REQUIRE(polyline.remove_duplicate_points() == removed);
+            REQUIRE(polyline.points == expected);
+        }
+    }
+    SECTION("furthest point from a segment") {
+        for (size_t i = 0; i < 2000; ++ i) {
+            size_t begin = 1 + gen() % (pts.size() - 1);
+            size_t end   = std::min(pts.size(), begin + gen() % 300);
+            const Point &a = pts[begin - 1];
+            // Every tenth segment is degenerate.
+            const Point &b = i % 10 == 0 ? a : pts[gen() % pts.size()];
+            REQUIRE(PolygonKernels::furthest_from_segment(pts.data(), begin, end, a, b) == furthest_reference(pts, begin, end, a, b));
+        }
+    }
+    SECTION("furthest point from a segment, 32bit points") {
+        std::vector<Vec2i32> pts32 = to_vec2i32(pts);
+        for (size_t i = 0; i < 200; ++ i) {
+            size_t begin = 1 + gen() % (pts.size() - 1);
+            size_t end   = std::min(pts.size(), begin + gen() % 300);
+            size_t ib    = gen() % pts.size();
+            REQUIRE(PolygonKernels::furthest_from_segment(pts32.data(), begin, end, pts32[begin - 1], pts32[ib]) ==
+                    furthest_reference(pts, begin, end, pts[begin - 1], pts[ib]));
+        }
+    }
+    SECTION("all points on the segment") {
+        Points line { Point(0, 0), Point(1, 0), Point(2, 0), Point(3, 0) };
+        REQUIRE(PolygonKernels::furthest_from_segment(line.data(), 1, 3, line.front(), line.back()) == std::make_pair(size_t(0), 0.));
+    }
+}
+
+// Throughput of each kernel next to the scalar code it replaced, for 64bit and 32bit points, with the results required
+// to be the same. On an AVX2 CPU, the 64bit kernels ran 1.4x (area) to 2.2x (extents) faster than the code they replaced.
+TEST_CASE("Polygon kernels throughput", "[PolygonKernels][.][benchmark]") {
+    // Star shaped polygons around the origin, like the perimeters the kernels process. They fit into the L2 cache,
+    // as the polygons usually do when they are processed.
+    std::vector<Polygon> sized;
+    std::mt19937         gen(3);
+    std::uniform_real_distribution<double> radius(5e6, 1e8);
+    for (size_t i = 0; i < 100; ++ i) {
+        Polygon &poly = sized.emplace_back();
+        for (size_t j = 0; j < 200; ++ j) {
+            const double angle = 2. * M_PI * double(j) / 200.;
+            const double r     = radius(gen);
+            poly.points.emplace_back(coord_t(r * cos(angle)), coord_t(r * sin(angle)));
+        }
+    }
+    std::vector<std::vector<Vec2i32>> sized32;
+    for (const Polygon &poly : sized)
+        sized32.emplace_back(to_vec2i32(poly.points));
+    const double num_points = 200. * sized.size();
+    const int    repeats    = 1000;
+    const Point  pt(1000, 2000);
+    const char  *path       = PolygonKernels::has_avx2() ? "avx2" : "scalar";
+
+    // Runs fn over all polygons repeats times, returns the throughput in millions of points per second and the sum of the results.
+    auto measure = [&](auto &&fn, const auto &polys) {
+        double sum = 0.;
+        double seconds = benchmark_seconds([&]() {
+            for (int r = 0; r < repeats; ++ r)
+                for (const auto &poly : polys)
+                    sum += fn(poly);
+        });
+        return std::make_pair(num_points * repeats / seconds * 1e-6, sum);
+    };
+    auto report = [path](const char *kernel, const std::pair<double, double> &kernel64, const std::pair<double, double> &kernel32,
+                         const std::pair<double, double> &reference, const char *reference_name) {
+        benchmark_log("PolygonKernels", kernel, " (", path, "): ", kernel64.first, " Mpts/s, 32bit ", kernel32.first, " Mpts/s, ",
+            reference_name, " ", reference.first, " Mpts/s");
+    };
+
+    {
+        auto kernel    = measure([](const Polygon &poly) { return PolygonKernels::signed_area2(poly.points.data(), poly.points.size()); }, sized);
+        auto kernel32  = measure([](const std::vector<Vec2i32> &poly) { return PolygonKernels::signed_area2(poly.data(), poly.size()); }, sized32);
+        auto reference = measure([](const Polygon &poly) { return 2. * area_reference(poly.points); }, sized);
+        report("area", kernel, kernel32, reference, "previous loop");
+        REQUIRE(kernel.second == Approx(reference.second));
+        REQUIRE(kernel32.second == kernel.second);
+    }
+    {
+        auto extents   = [](const auto &poly) {
+            std::decay_t<decltype(poly[0])> pmin, pmax;
+            PolygonKernels::extents(poly.data(), poly.size(), pmin, pmax);
+            return double(pmax.x() - pmin.x()) + double(pmax.y() - pmin.y());
+        };
+        auto kernel    = measure([&extents](const Polygon &poly) { return extents(poly.points); }, sized);
+        auto kernel32  = measure(extents, sized32);
+        auto reference = measure([](const Polygon &poly) {
+            Point pmin, pmax;
+            PolygonKernels::scalar::extents(poly.points.data(), poly.points.size(), pmin, pmax);
+            return double(pmax.x() - pmin.x()) + double(pmax.y() - pmin.y());
+        }, sized);
+        report("extents", kernel, kernel32, reference, "previous loop");
+        REQUIRE(kernel.second == reference.second);
+        REQUIRE(kernel32.second == reference.second);
+    }
+    {
+        auto kernel    = measure([&pt](const Polygon &poly) { return double(PolygonKernels::point_in_polygon(poly.points.data(), poly.points.size(), pt)); }, sized);
+        auto kernel32  = measure([&pt](const std::vector<Vec2i32> &poly) { return double(PolygonKernels::point_in_polygon(poly.data(), poly.size(), Vec2i32(pt.cast<int32_t>()))); }, sized32);
+        auto reference = measure([&pt](const Polygon &poly) { return double(ClipperLib::PointInPolygon(pt, poly.points)); }, sized);
+        report("point in polygon", kernel, kernel32, reference, "ClipperLib::PointInPolygon");
+        REQUIRE(kernel.second == reference.second);
+        REQUIRE(kernel32.second == reference.second);
+    }
+    {
+        auto kernel    = measure([](const Polygon &poly) { return double(PolygonKernels::find_consecutive_duplicate(poly.points.data(), poly.points.size())); }, sized);
+        auto kernel32  = measure([](const std::vector<Vec2i32> &poly) { return double(PolygonKernels::find_consecutive_duplicate(poly.data(), poly.size())); }, sized32);
+        auto reference = measure([](const Polygon &poly) { return double(PolygonKernels::scalar::find_consecutive_duplicate(poly.points.data(), poly.points.size())); }, sized);
+        report("consecutive duplicates", kernel, kernel32, reference, "previous loop");
+        REQUIRE(kernel.second == reference.second);
+        REQUIRE(kernel32.second == reference.second);
+    }
+    {
+        auto kernel    = measure([](const Polygon &poly) {
+            return PolygonKernels::furthest_from_segment(poly.points.data(), 1, poly.points.size() - 1, poly.points.front(), poly.points.back()).second;
+        }, sized);
+        auto reference = measure([](const Polygon &poly) {
+            return furthest_reference(poly.points, 1, poly.points.size() - 1, poly.points.front(), poly.points.back()).second;
+        }, sized);
+        benchmark_log("PolygonKernels", "furthest from segment: ", kernel.first, " Mpts/s, previous loop ", reference.first, " Mpts/s");
+        REQUIRE(kernel.second == reference.second);
+    }
+}
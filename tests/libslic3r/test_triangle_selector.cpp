@@ -0,0 +1,278 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <queue>
+
+#include <tbb/task_arena.h>
+
+#include "libslic3r/TriangleSelector.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/Geometry.hpp"
+
+using namespace Slic3r;
+
+// Exposes the triangles of the selector to compare the seed fill and the bucket fill with a serial breadth-first search.
+class TriangleSelectorTest : public TriangleSelector
+{
+public:
+    using TriangleSelector::TriangleSelector;
+
+    // Leaf triangles selected by the last seed fill or bucket fill, sorted.
+    std::vector<int> selected_by_seed_fill() const
+    {
+        std::vector<int> out;
+        for (int facet_idx = 0; facet_idx < m_orig_size_indices; ++ facet_idx)
+            this->append_leaf_triangles(facet_idx, out);
+        out.erase(std::remove_if(out.begin(), out.end(), [this](int idx) { return ! m_triangles[idx].is_selected_by_seed_fill(); }), out.end());
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Serial search over the facets of the original mesh, selecting the leaves of the reached facets, sorted.
+    std::vector<int> seed_fill_reference(int facet_start, const ClippingPlane &clp, float seed_fill_angle) const
+    {
+        const double      facet_angle_limit = cos(Geometry::deg2rad(seed_fill_angle)) - EPSILON;
+        std::vector<bool> visited(m_orig_size_indices, false);
+        std::queue<int>   facet_queue;
+        std::vector<int>  out;
+        facet_queue.push(facet_start);
+        visited[facet_start] = true;
+        while (! facet_queue.empty()) {
+            int facet_idx = facet_queue.front();
+            facet_queue.pop();
+            this->append_leaf_triangles(facet_idx, out);
+            for (int neighbor_idx : m_neighbors[facet_idx])
+                if (neighbor_idx >= 0 && ! visited[neighbor_idx] && ! this->clipped(neighbor_idx, clp) &&
+                    std::clamp(m_face_normals[neighbor_idx].dot(m_face_normals[facet_idx]), 0.f, 1.f) >= facet_angle_limit) {
+                    visited[neighbor_idx] = true;
+                    facet_queue.push(neighbor_idx);
+                }
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Serial search over the leaf triangles of the same state as the leaf triangle start, sorted.
+    std::vector<int> bucket_fill_reference(int start, const ClippingPlane &clp, float seed_fill_angle) const
+    {
+        const double              facet_angle_limit = cos(Geometry::deg2rad(seed_fill_angle)) - EPSILON;
+        const EnforcerBlockerType state             = m_triangles[start].get_state();
+        auto [neighbors, neighbors_propagated]      = this->precompute_all_neighbors();
+        std::vector<bool>         visited(m_triangles.size(), false);
+        std::queue<int>           facet_queue;
+        std::vector<int>          out;
+        facet_queue.push(start);
+        visited[start] = true;
+        while (! facet_queue.empty()) {
+            int facet_idx = facet_queue.front();
+            facet_queue.pop();
+            out.emplace_back(facet_idx);
+            const std::array<int, 3> &verts = m_triangles[facet_idx].verts_idxs;
+            std::vector<int>          touching;
+            this->append_touching_subtriangles(neighbors[facet_idx](0), verts[1], verts[0], touching);
+            this->append_touching_subtriangles(neighbors[facet_idx](1), verts[2], verts[1], touching);
+            this->append_touching_subtriangles(neighbors[facet_idx](2), verts[0], verts[2], touching);
+            for (int neighbor_idx : neighbors_propagated[facet_idx])
+                if (neighbor_idx != -1 && ! m_triangles[neighbor_idx].is_split())
+                    touching.emplace_back(neighbor_idx);
+            for (int tr_idx : touching)
+                if (tr_idx >= 0 && ! visited[tr_idx] && m_triangles[tr_idx].get_state() == state && ! this->clipped(tr_idx, clp) &&
+                    std::clamp(m_face_normals[m_triangles[tr_idx].source_triangle].dot(m_face_normals[m_triangles[facet_idx].source_triangle]), 0.f, 1.f) >= facet_angle_limit) {
+                    visited[tr_idx] = true;
+                    facet_queue.push(tr_idx);
+                }
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Facets of the original mesh with a leaf triangle of the given state or selected by seed fill, sorted.
+    std::vector<int> facets_with_leaf(EnforcerBlockerType state, bool selected_by_seed_fill = false) const
+    {
+        std::vector<int> out;
+        std::vector<int> leaves;
+        for (int facet_idx = 0; facet_idx < m_orig_size_indices; ++ facet_idx) {
+            leaves.clear();
+            this->append_leaf_triangles(facet_idx, leaves);
+            if (std::any_of(leaves.begin(), leaves.end(), [this, state, selected_by_seed_fill](int idx) {
+                    return selected_by_seed_fill ? m_triangles[idx].is_selected_by_seed_fill() : m_triangles[idx].get_state() == state; }))
+                out.emplace_back(facet_idx);
+        }
+        return out;
+    }
+
+private:
+    bool clipped(int facet_idx, const ClippingPlane &clp) const
+    {
+        for (int vert_idx : m_triangles[facet_idx].verts_idxs)
+            if (clp.is_active() && clp.is_mesh_point_clipped(m_vertices[vert_idx].v))
+                return true;
+        return false;
+    }
+};
+
+static Vec3f facet_center(const indexed_triangle_set &its, int facet_idx)
+{
+    const stl_triangle_vertex_indices &f = its.indices[facet_idx];
+    return (its.vertices[f(0)] + its.vertices[f(1)] + its.vertices[f(2)]) / 3.f;
+}
+
+TEST_CASE("Seed fill and bucket fill select the same triangles as a serial search", "[TriangleSelector]") {
+    // Fine enough for the search frontiers to be expanded in parallel.
+    TriangleMesh        mesh(its_make_sphere(20., PI / 180.));
+    TriangleSelectorTest selector(mesh);
+    const int           num_facets = int(mesh.its.indices.size());
+
+    // Split the mesh by painting patches of both states, centered at every 20th stack of the sphere.
+    for (int i = 1; i <= 8; ++ i) {
+        const int   facet_idx = i * num_facets / 9;
+        const Vec3f center    = facet_center(mesh.its, facet_idx);
+        selector.select_patch(facet_idx, std::make_unique<TriangleSelector::Sphere>(center, 3.f * center, 1.5f + 0.25f * float(i), Transform3d::Identity(), TriangleSelector::ClippingPlane{}),
+                              i % 2 ? EnforcerBlockerType::ENFORCER : EnforcerBlockerType::BLOCKER, Transform3d::Identity(), true);
+    }
+
+    // Both below the clipping plane, the first one between two patches, the second one in the middle of a patch.
+    const int   facet_unpainted = 11 * num_facets / 18;
+    const int   facet_painted   = 5 * num_facets / 9;
+    const TriangleSelector::ClippingPlane no_clipping;
+    // Clips the facets above z = 5.
+    const TriangleSelector::ClippingPlane clipping(std::array<float, 4>{ 0.f, 0.f, 1.f, 5.f });
+
+    // With a single thread the fills run a serial queue, with more threads they expand the frontiers in parallel.
+    // The arena reports its concurrency independently of the number of cores of the machine running the test.
+    for (int num_threads : { 1, 4 })
+        tbb::task_arena(num_threads).execute([&]() {
+            for (const TriangleSelector::ClippingPlane *clp : { &no_clipping, &clipping })
+                for (float seed_fill_angle : { 0.5f, 5.f, 30.f }) {
+                    {
+                        // Seed fill.
+                        const Vec3f hit = facet_center(mesh.its, facet_unpainted);
+                        selector.seed_fill_select_triangles(hit, facet_unpainted, Transform3d::Identity(), *clp, seed_fill_angle, 0.f, true);
+                        std::vector<int> selected = selector.selected_by_seed_fill();
+                        REQUIRE(! selected.empty());
+                        REQUIRE(selected == selector.seed_fill_reference(facet_unpainted, *clp, seed_fill_angle));
+                    }
+                    for (int facet_idx : { facet_unpainted, facet_painted }) {
+                        // Bucket fill.
+                        const Vec3f hit   = facet_center(mesh.its, facet_idx);
+                        const int   start = selector.select_unsplit_triangle(hit, facet_idx);
+                        REQUIRE(start >= 0);
+                        selector.bucket_fill_select_triangles(hit, facet_idx, *clp, seed_fill_angle, true, true);
+                        std::vector<int> selected = selector.selected_by_seed_fill();
+                        REQUIRE(! selected.empty());
+                        REQUIRE(selected == selector.bucket_fill_reference(start, *clp, seed_fill_angle));
+                    }
+                }
+        });
+
+    // The seed fill over the whole sphere reaches all the leaf triangles, including the children of the split facets.
+    selector.seed_fill_select_triangles(facet_center(mesh.its, facet_unpainted), facet_unpainted, Transform3d::Identity(), no_clipping, 30.f, 0.f, true);
+    REQUIRE(selector.selected_by_seed_fill().size() > size_t(num_facets));
+}
+
+TEST_CASE("Seed fill region is searched apart from the selection, reporting progress and cancelable", "[TriangleSelector]") {
+    TriangleMesh         mesh(its_make_sphere(20., PI / 180.));
+    TriangleSelectorTest selector(mesh);
+    const int            num_facets = int(mesh.its.indices.size());
+    const int            facet_idx  = num_facets / 2;
+    const Vec3f          center     = facet_center(mesh.its, facet_idx);
+    const TriangleSelector::ClippingPlane clipping(std::array<float, 4>{ 0.f, 0.f, 1.f, 5.f });
+    selector.select_patch(facet_idx, std::make_unique<TriangleSelector::Sphere>(center, 3.f * center, 2.f, Transform3d::Identity(), TriangleSelector::ClippingPlane{}),
+                          EnforcerBlockerType::ENFORCER, Transform3d::Identity(), true);
+
+    std::vector<int> percents;
+    std::vector<int> region = selector.seed_fill_region(facet_idx, Transform3d::Identity(), clipping, 30.f, 0.f, {}, [&percents](int percent) { percents.emplace_back(percent); });
+    REQUIRE(! percents.empty());
+    REQUIRE(std::is_sorted(percents.begin(), percents.end()));
+    REQUIRE(percents.back() <= 100);
+
+    // Selecting the region found is the same as the seed fill.
+    selector.seed_fill_select_region(region);
+    std::vector<int> selected = selector.selected_by_seed_fill();
+    selector.seed_fill_select_triangles(center, facet_idx, Transform3d::Identity(), clipping, 30.f, 0.f, true);
+    REQUIRE(selected == selector.selected_by_seed_fill());
+    REQUIRE(selected == selector.seed_fill_reference(facet_idx, clipping, 30.f));
+    // The same triangle is hit again, but the clipping plane forces the seed fill to be recomputed.
+    REQUIRE(selector.seed_fill_needs_update(center, facet_idx, clipping));
+    REQUIRE(! selector.seed_fill_needs_update(center, facet_idx, TriangleSelector::ClippingPlane{}));
+
+    struct Canceled {};
+    int  num_steps       = 0;
+    auto throw_on_cancel = [&num_steps]() { if (++ num_steps == 3) throw Canceled(); };
+    REQUIRE_THROWS_AS(selector.seed_fill_region(facet_idx, Transform3d::Identity(), TriangleSelector::ClippingPlane{}, 90.f, 0.f, throw_on_cancel), Canceled);
+    REQUIRE(num_steps == 3);
+}
+
+// Sorted dirty facets, each of them is required to be listed once.
+static std::vector<int> sorted_dirty_facets(const TriangleSelector &selector)
+{
+    std::vector<int> out = selector.dirty_facets();
+    std::sort(out.begin(), out.end());
+    REQUIRE(std::adjacent_find(out.begin(), out.end()) == out.end());
+    return out;
+}
+
+static bool includes(const std::vector<int> &sorted, const std::vector<int> &sorted_subset)
+{
+    return std::includes(sorted.begin(), sorted.end(), sorted_subset.begin(), sorted_subset.end());
+}
+
+TEST_CASE("Modified facets are reported as dirty", "[TriangleSelector]") {
+    TriangleMesh         mesh(its_make_sphere(20., PI / 36.));
+    TriangleSelectorTest selector(mesh);
+    const int            num_facets = int(mesh.its.indices.size());
+    const int            facet_idx  = num_facets / 3;
+    const Vec3f          center     = facet_center(mesh.its, facet_idx);
+
+    // A new selector has no render data derived from it yet.
+    REQUIRE(selector.all_dirty());
+    selector.clear_dirty();
+    REQUIRE(! selector.all_dirty());
+    REQUIRE(! selector.seed_fill_dirty());
+    REQUIRE(selector.dirty_facets().empty());
+
+    SECTION("set_facet") {
+        selector.set_facet(facet_idx, EnforcerBlockerType::ENFORCER);
+        REQUIRE(sorted_dirty_facets(selector) == std::vector<int>{ facet_idx });
+        REQUIRE(! selector.all_dirty());
+        selector.clear_dirty();
+        REQUIRE(selector.dirty_facets().empty());
+    }
+    SECTION("select_patch") {
+        selector.select_patch(facet_idx, std::make_unique<TriangleSelector::Sphere>(center, 3.f * center, 3.f, Transform3d::Identity(), TriangleSelector::ClippingPlane{}),
+                              EnforcerBlockerType::BLOCKER, Transform3d::Identity(), true);
+        const std::vector<int> painted = selector.facets_with_leaf(EnforcerBlockerType::BLOCKER);
+        REQUIRE(painted.size() > 1);
+        // Facets touched by the cursor but left unpainted may be reported as well.
+        REQUIRE(includes(sorted_dirty_facets(selector), painted));
+        REQUIRE(! selector.all_dirty());
+    }
+    SECTION("seed fill") {
+        selector.seed_fill_select_triangles(center, facet_idx, Transform3d::Identity(), TriangleSelector::ClippingPlane{}, 30.f, 0.f, true);
+        REQUIRE(selector.seed_fill_dirty());
+        const std::vector<int> selected = selector.facets_with_leaf(EnforcerBlockerType::NONE, true);
+        REQUIRE(! selected.empty());
+        REQUIRE(includes(sorted_dirty_facets(selector), selected));
+        selector.clear_dirty();
+        selector.seed_fill_apply_on_triangles(EnforcerBlockerType::ENFORCER);
+        REQUIRE(sorted_dirty_facets(selector) == selector.facets_with_leaf(EnforcerBlockerType::ENFORCER));
+    }
+    SECTION("bucket fill") {
+        selector.bucket_fill_select_triangles(center, facet_idx, TriangleSelector::ClippingPlane{}, 30.f, true, true);
+        REQUIRE(selector.seed_fill_dirty());
+        REQUIRE(includes(sorted_dirty_facets(selector), selector.facets_with_leaf(EnforcerBlockerType::NONE, true)));
+    }
+    SECTION("reset and deserialize") {
+        selector.set_facet(facet_idx, EnforcerBlockerType::ENFORCER);
+        const auto data = selector.serialize();
+        selector.reset();
+        REQUIRE(selector.all_dirty());
+        selector.clear_dirty();
+        selector.deserialize(data);
+        REQUIRE(selector.all_dirty());
+        REQUIRE(selector.seed_fill_dirty());
+        // While all the facets are dirty, the modified ones are not listed.
+        selector.set_facet(facet_idx + 1, EnforcerBlockerType::BLOCKER);
+        REQUIRE(selector.dirty_facets().empty());
+    }
+}
@@ -0,0 +1,365 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include "slic3r/Utils/Http.hpp"
+#include "slic3r/Utils/HttpMulti.hpp"
+
+using namespace Slic3r;
+using boost::asio::ip::tcp;
+
+// Requests being served by all the HttpStandIn servers at once.
+static std::atomic<int> g_concurrent { 0 };
+static std::atomic<int> g_max_concurrent { 0 };
+
+// Minimal HTTP/1.1 server on the loopback interface with keep-alive, standing in for a print host.
+// PUT requests to "/upload?offset=N" store the body at the offset N of the uploaded file.
+class HttpStandIn
+{
+public:
+    HttpStandIn() : m_acceptor(m_io, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0))
+    {
+        m_port   = m_acceptor.local_endpoint().port();
+        m_thread = std::thread([this]() { this->accept_loop(); });
+    }
+    ~HttpStandIn()
+    {
+        m_stop = true;
+        boost::system::error_code ec;
+        {
+            // Wake up the acceptor.
+            tcp::socket s(m_io);
+            s.connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), m_port), ec);
+        }
+        m_thread.join();
+        {
+            std::lock_guard<std::mutex> l(m_mutex);
+            for (auto &socket : m_sockets)
+                socket->shutdown(tcp::socket::shutdown_both, ec);
+        }
+        for (std::thread &t : m_connection_threads)
+            t.join();
+    }
+
+    std::string url(const std::string &path) const { return "http://127.0.0.1:" + std::to_string(m_port) + path; }
+
+    // Delay of the response to each request.
+    void set_delay(std::chrono::milliseconds delay) { m_delay = delay; }
+    // Drop the connection in the middle of the body of the n-th request, counting from 1.
+    void set_drop_request(size_t n) { m_drop_request = n; }
+
+    size_t connections()    const { return m_connections; }
+    size_t requests()       const { return m_requests; }
+    int    max_concurrent() const { return m_max_concurrent; }
+    std::string uploaded()  const
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        std::string out;
+        for (const auto &chunk : m_chunks) {
+            if (chunk.first != out.size())
+                return std::string();
+            out += chunk.second;
+        }
+        return out;
+    }
+
+private:
+    void accept_loop()
+    {
+        while (! m_stop) {
+            auto socket = std::make_shared<tcp::socket>(m_io);
+            boost::system::error_code ec;
+            m_acceptor.accept(*socket, ec);
+            if (ec || m_stop)
+                break;
+            ++ m_connections;
+            std::lock_guard<std::mutex> l(m_mutex);
+            m_sockets.emplace_back(socket);
+            m_connection_threads.emplace_back([this, socket]() { this->serve(*socket); });
+        }
+    }
+
+    void serve(tcp::socket &socket)
+    {
+        boost::asio::streambuf    buf;
+        boost::system::error_code ec;
+        while (! m_stop) {
+            boost::asio::read_until(socket, buf, "\r\n\r\n", ec);
+            if (ec)
+                return;
+            std::string header(boost::asio::buffers_begin(buf.data()), boost::asio::buffers_begin(buf.data()) + buf.size());
+            header.erase(header.find("\r\n\r\n") + 4);
+            buf.consume(header.size());
+            std::string lower = header;
+            std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+
+            const size_t request = ++ m_requests;
+            const std::string method = header.substr(0, header.find(' '));
+            const std::string path   = header.substr(method.size() + 1, header.find(' ', method.size() + 1) - method.size() - 1);
+            size_t content_length = 0;
+            if (size_t pos = lower.find("content-length:"); pos != std::string::npos)
+                content_length = std::stoul(lower.substr(pos + 15));
+            if (lower.find("expect: 100-continue") != std::string::npos)
+                boost::asio::write(socket, boost::asio::buffer(std::string("HTTP/1.1 100 Continue\r\n\r\n")), ec);
+
+            std::string body;
+            if (request == m_drop_request) {
+                // Receive a part of the body, then give up.
+                boost::asio::read(socket, buf, boost::asio::transfer_at_least(std::max<size_t>(content_length / 2, 1)), ec);
+                socket.shutdown(tcp::socket::shutdown_both, ec);
+                return;
+            }
+            if (buf.size() < content_length)
+                boost::asio::read(socket, buf, boost::asio::transfer_at_least(content_length - buf.size()), ec);
+            if (ec)
+                return;
+            body.assign(boost::asio::buffers_begin(buf.data()), boost::asio::buffers_begin(buf.data()) + content_length);
+            buf.consume(content_length);
+
+            int concurrent = ++ g_concurrent;
+            g_max_concurrent = std::max<int>(g_max_concurrent, concurrent);
+            int local = ++ m_concurrent;
+            m_max_concurrent = std::max<int>(m_max_concurrent, local);
+            std::this_thread::sleep_for(m_delay);
+            if (method == "PUT" && path.rfind("/upload?offset=", 0) == 0) {
+                std::lock_guard<std::mutex> l(m_mutex);
+                m_chunks[std::stoul(path.substr(15))] = std::move(body);
+            }
+            -- m_concurrent;
+            -- g_concurrent;
+
+            boost::asio::write(socket, boost::asio::buffer(std::string("HTTP/1.1 200 OK\r\nContent-Length: 2\r\nContent-Type: text/plain\r\n\r\nok")), ec);
+            if (ec)
+                return;
+        }
+    }
+
+    boost::asio::io_context                   m_io;
+    tcp::acceptor                             m_acceptor;
+    unsigned short                            m_port { 0 };
+    std::thread                               m_thread;
+    std::atomic<bool>                         m_stop { false };
+    std::chrono::milliseconds                 m_delay { 0 };
+    size_t                                    m_drop_request { 0 };
+    std::atomic<size_t>                       m_connections { 0 };
+    std::atomic<size_t>                       m_requests { 0 };
+    std::atomic<int>                          m_concurrent { 0 };
+    std::atomic<int>                          m_max_concurrent { 0 };
+
+    mutable std::mutex                        m_mutex;
+    std::vector<std::shared_ptr<tcp::socket>> m_sockets;
+    std::vector<std::thread>                  m_connection_threads;
+    std::map<size_t, std::string>             m_chunks;
+};
+
+static std::string write_random_file(const boost::filesystem::path &path, size_t size)
+{
+    std::mt19937 rng(size);
+    std::string  data(size, 0);
+    for (char &c : data)
+        c = char(rng());
+    boost::nowide::ofstream f(path.string(), std::ios::binary);
+    f.write(data.data(), data.size());
+    return data;
+}
+
+static HttpMulti::ChunkedUpload chunked_upload(const HttpStandIn &server, const boost::filesystem::path &path, size_t chunk_size, bool &completed)
+{
+    HttpMulti::ChunkedUpload upload;
+    upload.path         = path;
+    upload.chunk_size   = chunk_size;
+    upload.make_request = [&server, path](size_t offset, size_t length, size_t total) {
+        Http http = Http::put(server.url("/upload?offset=" + std::to_string(offset)));
+        http.header("Content-Range", "bytes " + std::to_string(offset) + "-" + std::to_string(offset + length - 1) + "/" + std::to_string(total))
+            .set_put_body(path, offset, length);
+        return http;
+    };
+    upload.on_complete = [&completed](std::string body, unsigned status) { completed = status == 200 && body == "ok"; };
+    return upload;
+}
+
+TEST_CASE("HttpMulti reuses the connection to a host", "[Http]") {
+    HttpStandIn server;
+    HttpMulti   multi(4, 1);
+    size_t      completed = 0;
+    for (int i = 0; i < 10; ++ i)
+        Http::get(server.url("/api/version"))
+            .on_complete([&completed](std::string body, unsigned status) { completed += status == 200 && body == "ok"; })
+            .perform_sync(multi);
+    REQUIRE(completed == 10);
+    for (int i = 0; i < 10; ++ i)
+        multi.add(std::move(Http::get(server.url("/api/version"))
+            .on_complete([&completed](std::string, unsigned) { ++ completed; })));
+    multi.wait_all();
+    REQUIRE(completed == 20);
+    REQUIRE(server.requests() == 20);
+    REQUIRE(server.connections() == 1);
+    REQUIRE(multi.connections_opened() == 1);
+}
+
+TEST_CASE("HttpMulti bounds the number of parallel requests", "[Http]") {
+    std::vector<std::unique_ptr<HttpStandIn>> servers;
+    for (int i = 0; i < 3; ++ i) {
+        servers.emplace_back(std::make_unique<HttpStandIn>());
+        servers.back()->set_delay(std::chrono::milliseconds(100));
+    }
+    g_max_concurrent = 0;
+    HttpMulti multi(2, 1);
+    for (int i = 0; i < 3; ++ i)
+        for (auto &server : servers)
+            multi.add(Http::get(server->url("/api/version")));
+    multi.wait_all();
+    for (auto &server : servers) {
+        REQUIRE(server->requests() == 3);
+        REQUIRE(server->max_concurrent() == 1);
+        const HttpMulti::HostProgress progress = multi.host_progress(HttpMulti::host_of(server->url("/")));
+        REQUIRE(progress.finished == 3);
+        REQUIRE(progress.failed == 0);
+    }
+    REQUIRE(g_max_concurrent == 2);
+}
+
+SCENARIO("HttpMulti chunked upload", "[Http]") {
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.gcode");
+    const std::string data = write_random_file(path, 1000 * 1000);
+    const size_t chunk_size = 128 * 1024;
+    HttpStandIn server;
+    GIVEN("A connection dropped in the middle of the third chunk") {
+        server.set_drop_request(3);
+        HttpMulti multi;
+        bool      completed = false;
+        multi.add(chunked_upload(server, path, chunk_size, completed));
+        multi.wait_all();
+        THEN("the chunk is resent and the file is uploaded") {
+            REQUIRE(completed);
+            REQUIRE(server.uploaded() == data);
+            REQUIRE(server.requests() == 8 + 1);
+            const HttpMulti::HostProgress progress = multi.host_progress(HttpMulti::host_of(server.url("/")));
+            REQUIRE(progress.ulnow == data.size());
+            REQUIRE(progress.ultotal == data.size());
+            REQUIRE(progress.finished == 1);
+        }
+    }
+    GIVEN("An upload resumed from the middle of the file") {
+        HttpMulti::HostProgress last_progress;
+        HttpMulti multi;
+        multi.on_host_progress([&last_progress](const std::string &, const HttpMulti::HostProgress &progress) { last_progress = progress; });
+        bool completed = false;
+        HttpMulti::ChunkedUpload upload = chunked_upload(server, path, chunk_size, completed);
+        upload.offset = 4 * chunk_size;
+        multi.add(std::move(upload));
+        multi.wait_all();
+        THEN("only the rest of the file is uploaded") {
+            REQUIRE(completed);
+            REQUIRE(server.requests() == 4);
+            REQUIRE(last_progress.ulnow == data.size());
+            REQUIRE(last_progress.finished == 1);
+        }
+    }
+    boost::filesystem::remove(path);
+}
+
+TEST_CASE("HttpMulti reports progress per host", "[Http]") {
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.gcode");
+    const std::string data = write_random_file(path, 256 * 1024);
+    HttpStandIn server1;
+    HttpStandIn server2;
+    std::mutex  mutex;
+    std::map<std::string, HttpMulti::HostProgress> last_progress;
+    HttpMulti multi;
+    multi.on_host_progress([&](const std::string &host, const HttpMulti::HostProgress &progress) {
+        std::lock_guard<std::mutex> l(mutex);
+        last_progress[host] = progress;
+    });
+    for (const HttpStandIn *server : { &server1, &server2 })
+        multi.add(std::move(Http::put(server->url("/upload?offset=0")).set_put_body(path)));
+    multi.wait_all();
+    REQUIRE(server1.uploaded() == data);
+    REQUIRE(server2.uploaded() == data);
+    REQUIRE(last_progress.size() == 2);
+    for (const auto &kvp : last_progress) {
+        REQUIRE(kvp.second.ulnow == data.size());
+        REQUIRE(kvp.second.ultotal == data.size());
+        REQUIRE(kvp.second.finished == 1);
+    }
+    boost::filesystem::remove(path);
+}
+
+TEST_CASE("HttpMulti cancels queued and running requests", "[Http]") {
+    HttpStandIn server;
+    server.set_delay(std::chrono::milliseconds(300));
+    HttpMulti multi(1, 1);
+    size_t    cancelled = 0;
+    for (int i = 0; i < 3; ++ i)
+        multi.add(std::move(Http::get(server.url("/api/version"))
+            .on_progress([&cancelled](Http::Progress, bool &cancel) { cancelled += cancel; })));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    multi.cancel_all();
+    multi.wait_all();
+    REQUIRE(cancelled == 3);
+    REQUIRE(multi.host_progress(HttpMulti::host_of(server.url("/"))).failed == 3);
+    REQUIRE(server.requests() <= 1);
+}
+
+TEST_CASE("HttpMulti cancels the requests added after shutdown", "[Http]") {
+    HttpStandIn server;
+    server.set_delay(std::chrono::milliseconds(300));
+    HttpMulti multi(2, 2);
+    size_t    cancelled = 0;
+    size_t    completed = 0;
+    multi.add(std::move(Http::get(server.url("/api/version"))
+        .on_complete([&completed](std::string, unsigned) { ++ completed; })
+        .on_progress([&cancelled](Http::Progress, bool &cancel) { cancelled += cancel; })));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    multi.shutdown();
+    REQUIRE(multi.is_shut_down());
+    // Neither blocks waiting for the worker thread, which is gone.
+    Http::get(server.url("/api/version"))
+        .on_complete([&completed](std::string, unsigned) { ++ completed; })
+        .on_progress([&cancelled](Http::Progress, bool &cancel) { cancelled += cancel; })
+        .perform_sync(multi);
+    multi.add(std::move(Http::get(server.url("/api/version"))
+        .on_complete([&completed](std::string, unsigned) { ++ completed; })
+        .on_progress([&cancelled](Http::Progress, bool &cancel) { cancelled += cancel; })));
+    REQUIRE(completed == 0);
+    REQUIRE(cancelled == 3);
+}
+
+TEST_CASE("HttpMulti does not lose the requests racing with shutdown", "[Http]") {
+    HttpStandIn server;
+    HttpMulti   multi(2, 2);
+    std::atomic<size_t> finished { 0 };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++ i)
+        threads.emplace_back([&]() {
+            for (int j = 0; j < 20; ++ j) {
+                // Either completes, fails or is reported as cancelled, it must not wait for a worker thread that exited.
+                bool reported = false;
+                Http::get(server.url("/api/version"))
+                    .on_complete([&reported](std::string, unsigned) { reported = true; })
+                    .on_error([&reported](std::string, std::string, unsigned) { reported = true; })
+                    .on_progress([&reported](Http::Progress, bool &cancel) { reported |= cancel; })
+                    .perform_sync(multi);
+                finished += reported;
+            }
+        });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    multi.shutdown();
+    for (std::thread &t : threads)
+        t.join();
+    REQUIRE(multi.is_shut_down());
+    REQUIRE(finished == 4 * 20);
+}
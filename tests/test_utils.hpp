@@ -13,8 +13,10 @@
 inline Slic3r::TriangleMesh load_model(const std::string &obj_filename)
 {
     Slic3r::TriangleMesh mesh;
+    Slic3r::ObjInfo      obj_info;
+    std::string          message;
     auto fpath = TEST_DATA_DIR PATH_SEPARATOR + obj_filename;
-    Slic3r::load_obj(fpath.c_str(), &mesh);
+    Slic3r::load_obj(fpath.c_str(), &mesh, obj_info, message);
     return mesh;
 }
 